@@ -165,6 +165,39 @@ Int4 BlastAaLookupTableNew(const LookupTableOptions* opt,
 NCBI_XBLAST_EXPORT
 BlastAaLookupTable* BlastAaLookupTableDestruct(BlastAaLookupTable* lookup);
 
+/** Compute the size of the flat image of a finalized lookup table, 
+ * as written by BlastAaLookupTableSerialize. The image contains no
+ * pointers and can be stored in a file and memory-mapped later.
+ * @param lookup The finalized lookup table [in]
+ * @return size of the image in bytes, 0 if the table is not finalized
+ */
+NCBI_XBLAST_EXPORT
+size_t BlastAaLookupTableImageSize(const BlastAaLookupTable* lookup);
+
+/** Write the flat image of a finalized lookup table to a buffer.
+ * The image uses the native byte order and is only meant to be read back
+ * on the same kind of host.
+ * @param lookup The finalized lookup table [in]
+ * @param buffer Buffer of at least BlastAaLookupTableImageSize bytes [out]
+ * @param buffer_size Size of the buffer [in]
+ * @return 0 if successful, nonzero on failure
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastAaLookupTableSerialize(const BlastAaLookupTable* lookup,
+                                 void* buffer, size_t buffer_size);
+
+/** Create a finalized lookup table from an image written by
+ * BlastAaLookupTableSerialize. The data are copied, so the buffer may be
+ * released (or unmapped) afterwards.
+ * @param buffer The image [in]
+ * @param buffer_size Size of the image [in]
+ * @param lut handle to lookup table structure [in/modified]
+ * @return 0 if successful, nonzero if the image is invalid
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastAaLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastAaLookupTable* * lut);
+
 /** Index a protein query.
  *
  * @param lookup the lookup table [in/modified]
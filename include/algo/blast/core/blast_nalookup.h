@@ -295,6 +295,112 @@ Int2 BlastMBLookupTableNew(BLAST_SequenceBlk* query, BlastSeqLoc* location,
  */
 BlastMBLookupTable* BlastMBLookupTableDestruct(BlastMBLookupTable* mb_lt);
 
+/*----------------------- Lookup table images -------------------------*/
+
+/* The functions below turn a finished nucleotide lookup table into a flat
+ * image without pointers and back, so that the table can be stored in a
+ * file and memory-mapped later. An image uses the native byte order and
+ * is only meant to be read back on the same kind of host. The scanning
+ * callbacks are not part of the image; they are chosen by the
+ * Blast*ChooseScanSubject functions as for a newly built table.
+ */
+
+/** Compute the size of the flat image of a small nucleotide lookup table
+ * @param lookup The lookup table [in]
+ * @return size of the image in bytes, 0 if the table is not finished
+ */
+NCBI_XBLAST_EXPORT
+size_t BlastSmallNaLookupTableImageSize(const BlastSmallNaLookupTable* lookup);
+
+/** Write the flat image of a small nucleotide lookup table to a buffer
+ * @param lookup The lookup table [in]
+ * @param buffer Buffer of at least BlastSmallNaLookupTableImageSize
+ *        bytes [out]
+ * @param buffer_size Size of the buffer [in]
+ * @return 0 if successful, nonzero on failure
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastSmallNaLookupTableSerialize(const BlastSmallNaLookupTable* lookup,
+                                      void* buffer, size_t buffer_size);
+
+/** Create a small nucleotide lookup table from an image written by
+ * BlastSmallNaLookupTableSerialize. The data are copied, so the buffer may
+ * be released afterwards. Scanning with this table needs the compressed
+ * query, see BlastCompressBlastnaSequence.
+ * @param buffer The image [in]
+ * @param buffer_size Size of the image [in]
+ * @param lut Pointer to the lookup table to be created [out]
+ * @return 0 if successful, nonzero if the image is invalid
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastSmallNaLookupTableDeserialize(const void* buffer,
+                                        size_t buffer_size,
+                                        BlastSmallNaLookupTable* * lut);
+
+/** Compute the size of the flat image of a nucleotide lookup table
+ * @param lookup The lookup table [in]
+ * @return size of the image in bytes, 0 if the table is not finished
+ */
+NCBI_XBLAST_EXPORT
+size_t BlastNaLookupTableImageSize(const BlastNaLookupTable* lookup);
+
+/** Write the flat image of a nucleotide lookup table to a buffer
+ * @param lookup The lookup table [in]
+ * @param buffer Buffer of at least BlastNaLookupTableImageSize bytes [out]
+ * @param buffer_size Size of the buffer [in]
+ * @return 0 if successful, nonzero on failure
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastNaLookupTableSerialize(const BlastNaLookupTable* lookup,
+                                 void* buffer, size_t buffer_size);
+
+/** Create a nucleotide lookup table from an image written by
+ * BlastNaLookupTableSerialize. The data are copied, so the buffer may
+ * be released afterwards.
+ * @param buffer The image [in]
+ * @param buffer_size Size of the image [in]
+ * @param lut Pointer to the lookup table to be created [out]
+ * @return 0 if successful, nonzero if the image is invalid
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastNaLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastNaLookupTable* * lut);
+
+/** Compute the size of the flat image of a megablast lookup table. The
+ * table does not record the query length, which sizes its chain arrays,
+ * so the caller passes it.
+ * @param mb_lt The lookup table [in]
+ * @param query_length Length of the query the table was built for [in]
+ * @return size of the image in bytes, 0 if the table is not finished
+ */
+NCBI_XBLAST_EXPORT
+size_t BlastMBLookupTableImageSize(const BlastMBLookupTable* mb_lt,
+                                   Int4 query_length);
+
+/** Write the flat image of a megablast lookup table to a buffer
+ * @param mb_lt The lookup table [in]
+ * @param query_length Length of the query the table was built for [in]
+ * @param buffer Buffer of at least BlastMBLookupTableImageSize bytes [out]
+ * @param buffer_size Size of the buffer [in]
+ * @return 0 if successful, nonzero on failure
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastMBLookupTableSerialize(const BlastMBLookupTable* mb_lt,
+                                 Int4 query_length,
+                                 void* buffer, size_t buffer_size);
+
+/** Create a megablast lookup table from an image written by
+ * BlastMBLookupTableSerialize. The data are copied, so the buffer may
+ * be released afterwards.
+ * @param buffer The image [in]
+ * @param buffer_size Size of the image [in]
+ * @param mb_lt_ptr Pointer to the lookup table to be created [out]
+ * @return 0 if successful, nonzero if the image is invalid
+ */
+NCBI_XBLAST_EXPORT
+Int2 BlastMBLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastMBLookupTable* * mb_lt_ptr);
+
 /*----------------------- Discontiguous Megablast -------------------------*/
 
 /** Forms a lookup table index for the 11-of-16 coding template in
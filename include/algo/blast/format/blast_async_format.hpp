@@ -64,7 +64,8 @@ class NCBI_XBLASTFORMAT_EXPORT CBlastAsyncFormatThread : public CThread
 {
 public:
     CBlastAsyncFormatThread() 
-    : m_ResultsMap(), m_Done(false), m_Semaphore(0, kMax_Int)
+    : m_ResultsMap(), m_Done(false), m_Semaphore(0, kMax_Int),
+      m_NumPrinted(0)
    {
    }
 
@@ -77,6 +78,13 @@ public:
    /// @param results data needed for formatting
    void QueueResults(int batchNumber, vector<SFormatResultValues> results); 
 
+   /// Block until all batches up to and including batchNumber
+   /// have been printed.
+   /// Used by callers that pipeline searching and formatting and need
+   /// to know when the data of a previous batch is no longer in use.
+   /// @param batchNumber number of the batch to wait for
+   void WaitForBatch(int batchNumber);
+
    /// Close queue for printing.  No calls to QueueResults allowed after this.
    void Finalize();
 
@@ -99,6 +107,11 @@ private:
     bool m_Done;
 
     CSemaphore m_Semaphore;
+
+    /// Number of batches printed so far, guarded by m_PrintedMutex
+    int m_NumPrinted;
+    CFastMutex m_PrintedMutex;
+    CConditionVariable m_PrintedCond;
 };
 
 #endif /* ALGO_BLAST_FORMAT___BLAST__ASYNC_FORMAT__HPP */
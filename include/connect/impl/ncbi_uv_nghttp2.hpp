@@ -271,12 +271,16 @@ struct NCBI_XXCONNECT2_EXPORT SUv_Timer : SUv_Handle<uv_timer_t>
 
     uint64_t GetDefaultRepeat() const { return m_Repeat; }
 
-    void Close()
+    void Stop()
     {
         if (auto rc = uv_timer_stop(this)) {
             ERR_POST("uv_timer_stop failed " << SUvNgHttp2_Error::LibuvStr(rc));
         }
+    }
 
+    void Close()
+    {
+        Stop();
         SUv_Handle<uv_timer_t>::Close();
     }
 
@@ -63,6 +63,7 @@ class CServer_ConnectionPool;
 class IServer_ConnectionBase
 {
 public:
+    IServer_ConnectionBase() : reactor(0), reactor_events(eIO_Open) { }
     virtual ~IServer_ConnectionBase() { }
     virtual EIO_Event GetEventsToPollFor(const CTime** /*alarm_time*/) const
         { return eIO_Read; }
@@ -84,6 +85,14 @@ private:
     CTime expiration;
     CFastMutex type_lock;
     volatile EServerConnType type;
+
+    // Used in the epoll reactor mode only (see
+    // SServer_Parameters::reactor_threads): the reactor the connection
+    // belongs to, the events its socket is armed for (eIO_Open if it is
+    // not registered) and the alarm time given by GetEventsToPollFor()
+    unsigned int reactor;
+    EIO_Event reactor_events;
+    CTime alarm;
 };
 
 class NCBI_XCONNECT_EXPORT CServer_Connection : public IServer_ConnectionBase,
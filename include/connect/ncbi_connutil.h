@@ -315,6 +315,8 @@ typedef struct {  /* NCBI_FAKE_WARNING: ICC */
 #define REG_CONN_LINKERD_ENABLE     "LINKERD_ENABLE"
 #define REG_CONN_NAMERD_ENABLE      "NAMERD_ENABLE"
 #define REG_CONN_DISPD_DISABLE      "DISPD_DISABLE"
+/* Time-to-live (seconds) of cached service resolutions, 0 (default) = off */
+#define REG_CONN_SERVICE_CACHE      "SERVICE_CACHE"
 
 /* Substitute (redirected) service name */
 #define REG_CONN_SERVICE_NAME       DEF_CONN_REG_SECTION "_" "SERVICE_NAME"
@@ -36,6 +36,9 @@
 BEGIN_NCBI_SCOPE
 
 
+struct SH2S_Async;
+
+
 /// @sa CHttpSession_Base
 class NCBI_XXCONNECT2_EXPORT CHttp2Session : public CHttpSession_Base
 {
@@ -50,6 +53,56 @@ public:
     using TApiLock = shared_ptr<void>;
     static TApiLock GetApiLock();
 
+    /// Response to an asynchronous request.
+    struct SAsyncResponse
+    {
+        /// HTTP status code, zero if the request has failed without a response
+        int status_code = 0;
+
+        /// Error message if the request has failed without a response (or timed out)
+        string error;
+
+        /// Response headers
+        CHttpHeaders::THeaders headers;
+
+        /// Response body (content or error page, depending on the status code)
+        string body;
+    };
+
+    /// Completion callback of an asynchronous request.
+    using TAsyncCallback = function<void(SAsyncResponse& response)>;
+
+    /// Start an asynchronous request.
+    /// Unlike CHttpRequest::Execute(), this returns immediately and does not need a thread per request.
+    /// Any number of asynchronous requests can be in flight at once,
+    /// they are multiplexed over the HTTP/2 connections kept per host
+    /// (the same connections are used by blocking requests).
+    /// The request must be created by this session (NewRequest()),
+    /// its URL, method, headers, cookies and credentials are used.
+    /// Unlike blocking requests, there is no downgrade to HTTP/1.1 on failure.
+    /// The request timeout (the default connection timeout, if not set) limits the entire request,
+    /// as does the request deadline (if set). The request that has not completed by then
+    /// is reported to the callback as failed.
+    /// @param req
+    ///   Request to start.
+    /// @param callback
+    ///   Called from Poll() once the response is complete or the request has failed.
+    /// @param body
+    ///   Request body (if any).
+    /// @sa Poll
+    void StartAsync(CHttpRequest& req, TAsyncCallback callback, string body = string());
+
+    /// Perform I/O for asynchronous requests of this session and
+    /// call completion callbacks (on the calling thread).
+    /// Asynchronous requests of a session must be started and polled by the same thread,
+    /// use separate sessions for other threads.
+    /// @param timeout
+    ///   How long to wait for at least one request to complete.
+    /// @return
+    ///   Number of asynchronous requests still in progress.
+    /// @sa StartAsync
+    size_t Poll(const CTimeout& timeout = CTimeout(CTimeout::eZero));
+
 private:
     void x_StartRequest(CHttpSession_Base::EProtocol protocol, CHttpRequest& req, bool use_form_data) override;
     bool x_Downgrade(CHttpResponse& resp, CHttpSession_Base::EProtocol& protocol) const override;
@@ -57,6 +110,7 @@ private:
     static void UpdateResponse(CHttpRequest& req, CHttpHeaders::THeaders headers);
 
     TApiLock m_ApiLock;
+    shared_ptr<SH2S_Async> m_Async;
 };
 
 
@@ -776,6 +776,47 @@ extern NCBI_XCONNECT_EXPORT ESERV_Type SERV_GetImplicitServerType
  );
 
 
+/** Statistics of the service resolution cache.
+ *
+ * The cache is enabled per service (or globally) with a non-zero
+ * time-to-live (in seconds) set in the "[<service>]CONN_SERVICE_CACHE"
+ * (or "[CONN]SERVICE_CACHE") registry key, or in the respective
+ * "<SERVICE>_CONN_SERVICE_CACHE" ("CONN_SERVICE_CACHE") environment variable.
+ * While cached, whole server lists, as found by the actual service mappers,
+ * are shared process-wide, and iterators get opened off them without going
+ * through the mappers.  A cached list gets re-resolved shortly before it
+ * expires (when the first iterator to notice that, is closed).
+ *
+ * @note The hit ratio is "hits / (hits + misses)".
+ * @sa
+ *  SERV_GetCacheStats, SERV_FlushCache
+ */
+typedef struct {
+    unsigned long hits;        /**< iterators opened off the cache           */
+    unsigned long misses;      /**< cacheable lookups not found (or expired) */
+    unsigned long refreshes;   /**< lists re-resolved ahead of expiration    */
+    unsigned long resolutions; /**< resolutions done by the actual mappers   */
+    double        latency;     /**< total time of the resolutions, seconds   */
+    double        max_latency; /**< longest resolution time, seconds         */
+} SSERV_CacheStats;
+
+
+/** Obtain the service resolution cache statistics.
+ * @sa
+ *  SSERV_CacheStats, SERV_FlushCache
+ */
+extern NCBI_XCONNECT_EXPORT void SERV_GetCacheStats
+(SSERV_CacheStats* stats
+ );
+
+
+/** Drop all cached service resolutions, and reset the statistics.
+ * @sa
+ *  SSERV_CacheStats, SERV_GetCacheStats
+ */
+extern NCBI_XCONNECT_EXPORT void SERV_FlushCache(void);
+
+
 #ifdef __cplusplus
 }  /* extern "C" */
 #endif
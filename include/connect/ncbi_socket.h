@@ -78,10 +78,12 @@
  *  SOCK_SetTimeout
  *  SOCK_GetTimeout
  *  SOCK_Read (including "peek" and "persistent read")
+ *  SOCK_ReadV
  *  SOCK_ReadLine
  *  SOCK_Pushback
  *  SOCK_Status
  *  SOCK_Write
+ *  SOCK_WriteV
  *  SOCK_Abort
  *  SOCK_GetLocalPort[Ex]
  *  SOCK_GetRemotePort
@@ -1258,6 +1260,38 @@ extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_Read
  );
 
 
+/** Segment of an I/O vector for the scatter/gather socket I/O.
+ * @note  SOCK_WriteV() never modifies the data.
+ * @sa SOCK_ReadV(), SOCK_WriteV()
+ */
+typedef struct {
+    void*  data;  /** data buffer (can be NULL if "size" is 0)            */
+    size_t size;  /** # of bytes (starting at "data") to read to/write from */
+} SSOCK_IOVec;
+
+
+/** Scatter version of SOCK_Read():  read up to the total size of the "n_iov"
+ * I/O vector segments of "iov", filling the segments in order, each one in
+ * full before the next one.  With eIO_ReadPlain, only the first segment read
+ * may wait for data to come;  the remaining segments receive the data that
+ * have already been read ahead from the system and buffered internally (if
+ * any), so that a small header and the following payload usually take just a
+ * single system call to receive.  eIO_ReadPersist fills all segments
+ * completely, or stops on an error.  The return status and "*n_read" (the
+ * total # of bytes read, can be NULL) are as for SOCK_Read().
+ * @note  eIO_ReadPeek is not supported.
+ * @sa
+ *  SOCK_Read, SOCK_WriteV
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_ReadV
+(SOCK               sock,
+ const SSOCK_IOVec* iov,
+ size_t             n_iov,
+ size_t*            n_read,
+ EIO_ReadMethod     how
+ );
+
+
 /** Read a line from SOCK.  A line is terminated by either '\n' (with an
  * optional preceding '\r') or '\0', and is stored in the buffer "line" of
  * "size" characters long.  "*n_read" (if "n_read" passed non-NULL) receives
@@ -1399,6 +1433,27 @@ extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_Write
  );
 
 
+/** Gather version of SOCK_Write():  write the "n_iov" I/O vector segments of
+ * "iov" one after another, as if they were a single contiguous buffer.  For
+ * stream sockets (other than secure ones), the segments go out in a single
+ * system call (whenever possible) without being copied, so there is no need
+ * to concatenate e.g. a protocol header and its payload prior to writing.
+ * For datagram sockets, the segments get appended to the message being
+ * composed (see DSOCK_SendMsg()).  The return status and "*n_written" (the
+ * total # of bytes written, can be NULL) are as for SOCK_Write().
+ * @note  eIO_WriteOutOfBand is not supported.
+ * @sa
+ *  SOCK_Write, SOCK_ReadV
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_WriteV
+(SOCK               sock,
+ const SSOCK_IOVec* iov,
+ size_t             n_iov,
+ size_t*            n_written,
+ EIO_WriteMethod    how
+ );
+
+
 /** If there is outstanding connection or output data pending, cancel it.
  * Mark the socket as if it has been shut down for both reading and writing.
  * Break actual connection if any was established.
@@ -428,6 +428,22 @@ public:
                     size_t*        n_read = 0,
                     EIO_ReadMethod how = eIO_ReadPlain);
 
+    /// Read from socket to several buffers (scatter read).
+    /// @param iov
+    ///
+    /// @param n_iov
+    ///
+    /// @param n_read
+    ///
+    /// @param how
+    ///
+    /// @sa
+    ///  SOCK_ReadV
+    EIO_Status ReadV(const SSOCK_IOVec* iov,
+                     size_t             n_iov,
+                     size_t*            n_read = 0,
+                     EIO_ReadMethod     how = eIO_ReadPlain);
+
     /// Read a line from socket (up to CR-LF, LF, or null character,
     /// discarding any of the EOLs).
     /// @param str
@@ -476,6 +492,22 @@ public:
                      size_t*         n_written = 0,
                      EIO_WriteMethod how = eIO_WritePersist);
 
+    /// Write to socket from several buffers (gather write).
+    /// @param iov
+    ///
+    /// @param n_iov
+    ///
+    /// @param n_written
+    ///
+    /// @param how
+    ///
+    /// @sa
+    ///  SOCK_WriteV
+    EIO_Status WriteV(const SSOCK_IOVec* iov,
+                      size_t             n_iov,
+                      size_t*            n_written = 0,
+                      EIO_WriteMethod    how = eIO_WritePersist);
+
     /// Abort socket connection.
     /// @sa
     ///  SOCK_Abort
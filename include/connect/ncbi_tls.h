@@ -99,6 +99,22 @@ SOCKSSL NcbiSetupTls(void);
  */
 
 
+/* Kernel TLS offload:  when turned on, and if supported by both the provider
+ * and the OS, the record encryption and decryption of a secure session get
+ * handed over to the kernel right after the handshake, so that the session
+ * data then go through the socket directly, in as large chunks as requested.
+ * If any of the session parameters (protocol version, cipher) is not
+ * supported by the kernel, the session quietly stays in the user space.
+ * Looked up as "CONN_TLS_KTLS" in the environment or "[CONN]TLS_KTLS" in the
+ * registry; off by default.
+ *
+ * @note Currently, only GNUTLS on Linux (with the "tls" kernel module loaded)
+ * can make use of this setting.
+ */
+#define REG_CONN_TLS_KTLS      "TLS_KTLS"
+#define DEF_CONN_TLS_KTLS      ""
+
+
 /** Build NCBI_CRED from memory buffers containing an X.509 certificate and a
  *  private key, respectively, in either PEM or DER format (independently of
  *  each other).
@@ -154,6 +154,10 @@ public:
     /// Force poll cycle to make another iteration.
     /// Should be called if IsReadyToProcess() for some connection handler
     /// became true.
+    /// NOTE: in the epoll reactor mode (see
+    /// NOTE: SServer_Parameters::reactor_threads) the events of all idle
+    /// NOTE: connections are re-queried, i.e. the cost is proportional to
+    /// NOTE: the number of connections.
     void WakeUpPollCycle(void);
     /// Set custom suffix to use on all threads in the server's pool.
     /// Value can be set only before call to Run(), any change of the value
@@ -196,8 +200,11 @@ protected:
 
 private:
     void x_DoRun(void);
+    void x_DoRunReactors(void);
+    bool x_ProcessReactorEvents(unsigned int reactor, const STimeout* timeout);
 
     friend class CNetCacheServer;
+    friend class CServer_ReactorThread;
     CPoolOfThreads_ForServer* GetThreadPool(void) { return m_ThreadPool; }
 
     SServer_Parameters*         m_Parameters;
@@ -456,6 +463,16 @@ struct NCBI_XCONNECT_EXPORT SServer_Parameters
     unsigned int    max_threads;     ///< Maximum simultaneous threads
     unsigned int    spawn_threshold; ///< Controls when to spawn more threads
 
+    /// Number of epoll based reactor threads waiting for the socket events
+    /// (Linux only). The first reactor runs in the thread which called
+    /// Run(). Unlike the portable poll() loop the reactors do not rebuild
+    /// the poll vector on each iteration, so their cost does not depend on
+    /// the number of idle connections. 0 means the poll() loop; it is also
+    /// used if epoll is not available.
+    /// (default: [server]/Reactor_Threads config value or
+    /// CSERVER_REACTOR_THREADS environment variable, 0 if not set)
+    unsigned int    reactor_threads;
+
     /// Create structure with the default set of parameters
     SServer_Parameters();
 };
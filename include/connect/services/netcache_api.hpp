@@ -449,6 +449,32 @@ class NCBI_XCONNECT_EXPORT CNetCacheAPI
     EReadResult GetData(const string& key, CSimpleBuffer& buffer,
             const CNamedParameterList* optional = NULL);
 
+    /// Callback for GetBlobs(). Called once for each requested key.
+    /// "data" holds the blob contents if "result" is eReadComplete
+    /// (it is empty otherwise), the callback is free to move from it.
+    typedef function<void(const string& key,
+            EReadResult result, string& data)> TBlobHandler;
+
+    /// Retrieve several BLOBs at once.
+    ///
+    /// The keys are grouped by server, and the read commands for each
+    /// server are pipelined over one connection, that is, several
+    /// commands are sent before their replies are read. This saves a
+    /// round trip per blob, which matters for many small blobs.
+    /// The replies for the keys of the same server are passed to
+    /// "handler" in the order of the keys. Keys that cannot be read
+    /// directly from the server they point to (e.g. version 3 keys or
+    /// keys of a mirrored blob not found on its primary server) are read
+    /// one by one after that, the same way GetData() does.
+    ///
+    /// @throw CNetCacheException
+    ///    Thrown if a protocol error occurred or if access to a blob
+    ///    is denied (the same as GetData() does).
+    /// @throw CNetServiceException
+    ///    Thrown if a communication error occurred.
+    void GetBlobs(const vector<string>& keys, TBlobHandler handler,
+            const CNamedParameterList* optional = NULL);
+
     /// Create an istream object for reading blob data.
     /// @throw CNetCacheException
     ///    The requested blob does not exist.
@@ -558,7 +558,10 @@ typedef enum {
     eMADV_Mergeable,   ///< KSM may merge identical pages
     eMADV_Unmergeable, ///< KSM may not merge identical pages -- by default
     // Available since Linux kernel 2.4.20
-    eMADV_NoReuse      ///< Data will be accessed only once (MADV_NOREUSE)
+    eMADV_NoReuse,     ///< Data will be accessed only once (MADV_NOREUSE)
+    // Available since Linux kernel 2.6.38
+    eMADV_HugePage,    ///< Back the region with transparent huge pages
+    eMADV_NoHugePage   ///< Do not use transparent huge pages -- by default
 } EMemoryAdvise;
 
 
@@ -2487,7 +2487,9 @@ public:
         eMMA_DontFork    = eMADV_DontFork,
         eMMA_Mergeable   = eMADV_Mergeable,
         eMMA_Unmergeable = eMADV_Unmergeable,
-        eMMA_NoReuse     = eMADV_NoReuse
+        eMMA_NoReuse     = eMADV_NoReuse,
+        eMMA_HugePage    = eMADV_HugePage,
+        eMMA_NoHugePage  = eMADV_NoHugePage
     } EMemMapAdvise;
 
     /// Advise on memory map usage for specified region.
@@ -74,6 +74,15 @@ public:
 
     virtual int Write(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string target_id = kEmptyStr) = 0;
     virtual void DumpAll(const CBlastDB_FormatterConfig & config) = 0;
+
+    /// Announce the OIDs which are going to be written next so that their
+    /// sequence data can be read in bulk rather than one OID at a time
+    /// @param oids OIDs to be written, in any order [in]
+    /// @param ranges the m_SeqRange of the configuration each OID is going
+    /// to be written with; same size as oids [in]
+    virtual void Prefetch(const vector<CSeqDB::TOID> & /*oids*/,
+                          const vector<TSeqRange> & /*ranges*/) {}
+
     virtual ~CBlastDB_Formatter() {}
 
 private:
@@ -97,6 +106,12 @@ public:
     int Write(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string target_id = kEmptyStr);
     void DumpAll(const CBlastDB_FormatterConfig & config);
 
+    /// Fetch the sequences of the OIDs with CSeqDB::GetSequencesAsStrings()
+    /// if the format includes them; the following Write() calls use the
+    /// fetched data. Replaces the data of the previous call.
+    void Prefetch(const vector<CSeqDB::TOID> & oids,
+                  const vector<TSeqRange> & ranges);
+
 private:
     /// Fields not in defline
     enum EOtherFields {
@@ -120,11 +135,14 @@ private:
     CBlastDeflineUtil::BlastDeflineFields m_DeflineFields;
     /// Bit Mask for other fields
     unsigned int m_OtherFields;
+    /// Sequences fetched by Prefetch(), by OID and range
+    map<pair<CSeqDB::TOID, TSeqRange>, string> m_PrefetchedSeqs;
     /// Build data for write
     void x_Print(CSeqDB::TOID oid, vector<string> & defline_data, vector<string> & other_fields);
 
     void x_DataRequired();
 
+    TSeqRange x_GetSeqRange(CSeqDB::TOID oid, const TSeqRange & config_range);
     void x_GetSeq(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string & seq);
     string x_GetSeqHash(CSeqDB::TOID oid);
     string x_GetSeqMask(CSeqDB::TOID oid, int algo_id);
@@ -151,6 +169,12 @@ public:
     /// Retun 0 if Sucess otherwise -1
     int Write(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string target_id = kEmptyStr);
 
+    /// The sequences are written from bioseqs so only the kernel read-ahead
+    /// is requested for them
+    void Prefetch(const vector<CSeqDB::TOID> & oids,
+                  const vector<TSeqRange> & /*ranges*/)
+    { m_BlastDb.PrefetchSequences(oids); }
+
 private:
 
     /// The BLAST database from which to extract data
@@ -178,6 +202,12 @@ public:
     /// Retun 0 if Sucess otherwise -1
     int Write(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string target_id = kEmptyStr);
 
+    /// The sequences are written from bioseqs so only the kernel read-ahead
+    /// is requested for them
+    void Prefetch(const vector<CSeqDB::TOID> & oids,
+                  const vector<TSeqRange> & /*ranges*/)
+    { m_BlastDb.PrefetchSequences(oids); }
+
 private:
 
     /// The BLAST database from which to extract data
@@ -583,12 +583,20 @@ public:
     
     int GetMaxFileDescriptors(void) const { return m_MaxFileDescriptors;}
 
+    /// Get memory mapping statistics.
+    ///
+    /// @param stats
+    ///   The statistics are returned here.
+    void GetStats(SSeqDBAtlasStats & stats) const;
+
 private:
 
     class CAtlasMappedFile : public CMemoryFile {
     public:
     	CAtlasMappedFile(const string & filename,
-    	                EMemMapAdvise advise = eMMA_Normal)
+    	                EMemMapAdvise advise = eMMA_Normal,
+    	                const vector<EMemMapAdvise> & extra_advice
+    	                    = vector<EMemMapAdvise>())
     		: CMemoryFile(filename), m_Count(1)
     	{
     		const string exts="hd|hi|nd|ni|pd|pi|si|sd|ti|td";
@@ -602,6 +610,9 @@ private:
     		if (advise != eMMA_Normal) {
     			MemMapAdvise(advise);
     		}
+    		ITERATE(vector<EMemMapAdvise>, it, extra_advice) {
+    			MemMapAdvise(*it);
+    		}
     	}
     	~CAtlasMappedFile() {
     		_ASSERT(m_Count == 0);
@@ -627,7 +638,7 @@ private:
     /// Maxium file size.
     Uint8 m_MaxFileSize;
 
-    std::mutex m_FileMemMapMutex;
+    mutable std::mutex m_FileMemMapMutex;
     map<string, unique_ptr<CAtlasMappedFile> > m_FileMemMap;
     int m_OpenedFilesCount;
     int m_MaxOpenedFilesCount;
@@ -636,6 +647,24 @@ private:
     /// Memory mapping strategy for mmap'd files.
     CMemoryFile_Base::EMemMapAdvise m_MMapStrategy;
 
+    /// Additional advice applied to every newly mapped file, read from
+    /// the NCBI_BLAST_MMAP_ADVICE environment variable.
+    vector<CMemoryFile_Base::EMemMapAdvise> m_MMapAdvice;
+
+    /// Mapping statistics, guarded by m_FileMemMapMutex.
+    Uint8 m_MappedBytes;
+    Uint8 m_PeakMappedBytes;
+    Uint8 m_MapCount;
+    Uint8 m_RemapCount;
+    /// Files unmapped while the atlas was alive, used to count remaps.
+    /// At most kMaxUnmappedFiles are kept; remaps of others are not counted.
+    set<string> m_UnmappedFiles;
+    static const size_t kMaxUnmappedFiles = 4096;
+
+    /// Page fault counters of the process when the atlas was created.
+    Int8 m_StartMinorFaults;
+    Int8 m_StartMajorFaults;
+
     /// BlastDB search path.
     const string m_SearchPath;
 };
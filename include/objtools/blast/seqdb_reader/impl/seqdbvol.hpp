@@ -395,6 +395,18 @@ public:
                            CSeqDB::TSequenceRanges  * partial_ranges,
                            CSeqDB::TSequenceRanges  * masks) const;
 
+    /// Prefetch the sequence data for a set of sequences.
+    ///
+    /// The file regions holding the packed sequence (and ambiguity)
+    /// data of the given OIDs are handed to the kernel for read-ahead
+    /// with madvise(MADV_WILLNEED).  Regions separated by small gaps
+    /// are merged, so a sorted list of nearby OIDs results in a few
+    /// large reads rather than one page fault per sequence.
+    ///
+    /// @param oids
+    ///   The OIDs of the sequences, sorted in increasing order. [in]
+    void PrefetchSeqData(const vector<int> & oids) const;
+
     /// Get the Seq-ids associated with a sequence.
     ///
     /// This method returns a list containing all the CSeq_id objects
@@ -1251,6 +1251,51 @@ public:
                              string & output,
                              TSeqRange range = TSeqRange()) const;
 
+    /// Get a batch of sequences in a given encoding.
+    ///
+    /// This returns the same data as calling GetSequenceAsString() for
+    /// each OID, but the sequences are read in volume and file offset
+    /// order, and the sequence data for each group of OIDs is handed to
+    /// the kernel for read-ahead before it is decoded.  For large sets
+    /// of OIDs in random order this replaces most of the page faults of
+    /// the one-at-a-time calls with a few large sequential reads.
+    /// Repeated OIDs are only decoded once.
+    ///
+    /// @param oids The OIDs of the sequences to fetch. [in]
+    /// @param coding The encoding to use for the data. [in]
+    /// @param output The sequence data, in the same order as oids. [out]
+    /// @param ranges If not NULL, the range of each sequence to retrieve;
+    /// must have the same size as oids, empty ranges select the entire
+    /// sequence [in]
+    void GetSequencesAsStrings(const vector<TOID>        & oids,
+                               CSeqUtil::ECoding           coding,
+                               vector<string>            & output,
+                               const vector<TSeqRange>   * ranges = NULL) const;
+
+    /// Get a batch of sequences in a readable text encoding.
+    ///
+    /// This is equivalent to the four-argument version of this method
+    /// with Iupacaa (protein) or Iupacna (nucleotide) encoding.
+    ///
+    /// @param oids The OIDs of the sequences to fetch. [in]
+    /// @param output The sequence data, in the same order as oids. [out]
+    /// @param ranges If not NULL, the range of each sequence to
+    /// retrieve [in]
+    void GetSequencesAsStrings(const vector<TOID>        & oids,
+                               vector<string>            & output,
+                               const vector<TSeqRange>   * ranges = NULL) const;
+
+    /// Prefetch the sequence data for a set of OIDs.
+    ///
+    /// The OIDs are sorted by volume and file offset and the regions
+    /// of the sequence files holding their data are handed to the
+    /// kernel for asynchronous read-ahead.  This is only a hint, no
+    /// data is returned; it is intended for callers which are about to
+    /// fetch these sequences one at a time in some other order.
+    ///
+    /// @param oids The OIDs of the sequences to prefetch. [in]
+    void PrefetchSequences(const vector<TOID> & oids) const;
+
 
 #if ((!defined(NCBI_COMPILER_WORKSHOP) || (NCBI_COMPILER_VERSION  > 550)) && \
      (!defined(NCBI_COMPILER_MIPSPRO)) )
@@ -1530,6 +1575,16 @@ public:
     /// @sa CMemoryFile_Base::EMemMapAdvise
     void SetMMapStrategy(CMemoryFile_Base::EMemMapAdvise strategy);
 
+    /// Get memory mapping statistics.
+    ///
+    /// The statistics describe the memory mappings of all BLAST database
+    /// files opened by this process, since the database files are managed
+    /// by a single shared atlas.
+    ///
+    /// @param stats
+    ///   The statistics are returned here.
+    void GetAtlasStats(SSeqDBAtlasStats & stats) const;
+
 protected:
     /// Implementation details are hidden.  (See seqdbimpl.hpp).
     class CSeqDBImpl * m_Impl;
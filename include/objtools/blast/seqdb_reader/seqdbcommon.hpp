@@ -1889,6 +1889,58 @@ struct SSeqDBTaxInfo {
 };
 
 
+/// SSeqDBAtlasStats
+///
+/// Memory mapping statistics of the process-wide SeqDB atlas, meant for
+/// tuning the mapping policy (see NCBI_BLAST_MMAP_ADVICE).
+
+struct SSeqDBAtlasStats {
+    /// Default constructor
+    SSeqDBAtlasStats()
+        : mapped_files(0), peak_mapped_files(0), mapped_bytes(0),
+          peak_mapped_bytes(0), map_count(0), remap_count(0),
+          minor_faults(0), major_faults(0)
+    {
+    }
+
+    /// Number of files currently mapped.
+    int mapped_files;
+
+    /// Largest number of files mapped at the same time.
+    int peak_mapped_files;
+
+    /// Number of bytes currently mapped.
+    Uint8 mapped_bytes;
+
+    /// Largest number of bytes mapped at the same time.
+    Uint8 peak_mapped_bytes;
+
+    /// Number of mappings created since the atlas was created.
+    Uint8 map_count;
+
+    /// Number of mappings of files that had been unmapped before
+    /// (of the first few thousand unmapped files only).
+    Uint8 remap_count;
+
+    /// Minor page faults of the process since the atlas was created.
+    Int8 minor_faults;
+
+    /// Major page faults of the process since the atlas was created.
+    Int8 major_faults;
+
+    friend ostream& operator<<(ostream& out, const SSeqDBAtlasStats& rhs) {
+        out << "MappedFiles=" << rhs.mapped_files
+            << "\tPeakMappedFiles=" << rhs.peak_mapped_files
+            << "\tMappedBytes=" << rhs.mapped_bytes
+            << "\tPeakMappedBytes=" << rhs.peak_mapped_bytes
+            << "\tMaps=" << rhs.map_count
+            << "\tRemaps=" << rhs.remap_count
+            << "\tMinorFaults=" << rhs.minor_faults
+            << "\tMajorFaults=" << rhs.major_faults;
+        return out;
+    }
+};
+
 /// Resolve a file path using SeqDB's path algorithms.
 ///
 /// This finds a file using the same algorithm used by SeqDB to find
@@ -408,6 +408,14 @@ public:
     /// @throws CWriteDBException if max_file_size is larger than kMaxVolFileSize
     void SetMaxFileSize(Uint8 max_file_size);
 
+    /// Set the number of threads used to convert sequences.
+    ///
+    /// Header serialization and sequence packing are done by this many
+    /// threads; the database files are still written sequentially.
+    ///
+    /// @param num_threads Number of conversion threads.
+    void SetNumThreads(int num_threads);
+
     /// Define a masking algorithm.
     ///
     /// The returned integer ID will be defined as corresponding to the
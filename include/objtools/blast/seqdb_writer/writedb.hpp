@@ -351,6 +351,18 @@ public:
     /// @param letters Maximum letters to pack in one volume. [in]
     void SetMaxVolumeLetters(Uint8 letters);
 
+    /// Set the number of threads used to convert sequences.
+    ///
+    /// With more than one thread, header serialization, sequence
+    /// packing and masking of added sequences run in parallel batches,
+    /// while the volume files are still appended to by the calling
+    /// thread in the order the sequences were added.  Blob data and
+    /// deflines of a sequence must not be changed once the next
+    /// sequence has been added.  Requires OpenMP; otherwise ignored.
+    ///
+    /// @param num_threads Number of conversion threads. [in]
+    void SetNumThreads(int num_threads);
+
     /// Extract Deflines From Bioseq.
     ///
     /// Deflines are extracted from the CBioseq and returned to the
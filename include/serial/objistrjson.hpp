@@ -116,6 +116,19 @@ public:
     ///   Formatting type
     void SetBinaryDataFormat(EBinaryDataFormat fmt);
 
+    /// Scan input buffer in bulk (using SIMD instructions when available)
+    /// when reading strings, member names and other data,
+    /// rather than char by char.
+    /// Enabled by default; the default can be changed using
+    /// SERIAL_JSON_FAST_SCAN environment variable
+    ///
+    /// @param set
+    ///   Use bulk scanning
+    void SetFastScan(bool set);
+
+    /// Check if the input is scanned in bulk
+    bool GetFastScan(void) const;
+
     virtual string ReadFileHeader(void) override;
 
 protected:
@@ -223,10 +236,13 @@ private:
     char ReadEncodedChar(EStringType type, bool& encoded);
     TUnicodeSymbol ReadUtf8Char(char c);
     string x_ReadString(EStringType type);
+    void x_ReadString(string& str, EStringType type);
+    void x_ScanString(string* str, EStringType type);
+    bool x_ScanData(string& str, EStringType type);
     void x_ReadData(string& data, EStringType type = eStringTypeUTF8);
     bool x_ReadDataAndCheck(string& data, EStringType type = eStringTypeUTF8);
     void   x_SkipData(void);
-    string ReadKey(void);
+    const string& ReadKey(void);
     string ReadValue(EStringType type = eStringTypeVisible);
 
     void StartBlock(char expect);
@@ -234,6 +250,7 @@ private:
     bool NextElement(void);
 
     TMemberIndex FindDeep(const CItemsInfo& items, const CTempString& name, bool& deep) const;
+    TMemberIndex FindMember(const CItemsInfo& items, const CTempString& name) const;
     size_t ReadCustomBytes(ByteBlock& block, char* buffer, size_t count);
     size_t ReadBase64Bytes(ByteBlock& block, char* buffer, size_t count);
     size_t ReadHexBytes(ByteBlock& block, char* buffer, size_t count);
@@ -242,6 +259,7 @@ private:
     bool m_BlockStart;
     bool m_ExpectValue;
     bool m_GotNameless;
+    bool m_FastScan;
     char m_Closing;
     EEncoding m_StringEncoding;
     string m_LastTag;
@@ -249,6 +267,8 @@ private:
     EBinaryDataFormat m_BinaryFormat;
     CStringUTF8 m_Utf8Buf;
     CStringUTF8::const_iterator m_Utf8Pos;
+    // last member found at each stack depth
+    mutable vector< pair<const CItemsInfo*, TMemberIndex> > m_MemberHints;
 };
 
 /* @} */
@@ -119,6 +119,19 @@ public:
             (GetFlags()&fFlagEnforcedStdXml) != 0;
     }
 
+    /// Scan input buffer in bulk (using SIMD instructions when available)
+    /// when reading tag data and attribute values, and look up class
+    /// members by their full tag names, rather than char by char.
+    /// Enabled by default; the default can be changed using
+    /// SERIAL_XML_FAST_SCAN environment variable
+    ///
+    /// @param set
+    ///   Use bulk scanning
+    void SetFastScan(bool set);
+
+    /// Check if the input is scanned in bulk
+    bool GetFastScan(void) const;
+
     virtual string ReadFileHeader(void) override;
     virtual string PeekNextTypeName(void) override;
     void FindFileHeader(bool find_XMLDecl = true);
@@ -283,6 +296,12 @@ private:
     Type x_UseMemberDefault(void);
     int x_VerifyChar(int);
     int x_ReadEncodedChar(char endingChar, EStringType type, bool& encoded);
+    void x_ScanPlainChars(string& str, char endingChar, EStringType type);
+
+    // full tag names of class members, indexed by member index;
+    // empty when the tag cannot be matched by name alone
+    typedef vector<string> TMemberTags;
+    const TMemberTags& x_GetMemberTags(const CClassTypeInfo* classType);
 
     enum ETagState {
         eTagOutside,
@@ -307,6 +326,8 @@ private:
     CStringUTF8 m_Utf8Buf;
     CStringUTF8::const_iterator m_Utf8Pos;
     bool m_SkipNextTag;
+    bool m_FastScan;
+    map<const CClassTypeInfo*, TMemberTags> m_MemberTags;
 };
 
 
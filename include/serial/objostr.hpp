@@ -221,6 +221,26 @@ public:
     // Is explicit writing of values with default enforced
     bool IsWritingDefaultValuesEnforced() const;
 
+    /// Set the number of threads used to write elements of containers
+    /// of class objects (such as Bioseq-set.seq-set) concurrently.
+    ///
+    /// Each worker thread writes elements into a memory buffer, and
+    /// the buffers are copied into the output in the original order,
+    /// so the output is the same as with sequential writing.
+    /// Only ASN.1 text and binary streams support this.
+    /// Containers are written sequentially when the stream has local
+    /// or path write hooks; global write hooks, if any, may be called
+    /// from the worker threads, and so may the cancellation callback.
+    /// The default can be changed using SERIAL_WRITE_THREADS
+    /// environment variable
+    ///
+    /// @param threads
+    ///   Maximum number of worker threads; 0 or 1 disables parallel writing
+    void SetWriteThreads(unsigned threads);
+
+    /// Get the number of threads used to write container elements
+    unsigned GetWriteThreads(void) const;
+
 //---------------------------------------------------------------------------
 // Formatting of the output
 
@@ -793,6 +813,19 @@ protected:
     // Write current separator to the stream
     virtual void WriteSeparator(void);
 
+    // Parallel writing of container elements:
+    // write all elements of the container using worker threads,
+    // return FALSE if the container should be written sequentially
+    bool WriteContainerElementsInParallel(const CContainerTypeInfo* cType,
+                                          TConstObjectPtr containerPtr);
+    // create a writer with the same settings for a worker thread
+    virtual CObjectOStream* OpenElementStream(CNcbiOstream& out) const;
+    // write one element in a worker thread (called on the element stream)
+    virtual void WriteParallelElement(TConstObjectPtr elementPtr,
+                                      TTypeInfo elementType);
+    // put data of one element, written by a worker, into the output
+    virtual void PutParallelElement(const char* data, size_t length);
+
     COStreamBuffer m_Output;
     TFailFlags m_Fail;
     TFlags m_Flags;
@@ -821,6 +854,7 @@ private:
     char m_NonPrintSubst;
     EFixNonPrint m_FixMethod; // method of fixing wrong (eg, non-printable) chars
     ESerialVerifyData   m_VerifyData;
+    unsigned m_WriteThreads;
     CStreamObjectPathHook<CWriteObjectHook*>                m_PathWriteObjectHooks;
     CStreamPathHook<CMemberInfo*, CWriteClassMemberHook*>   m_PathWriteMemberHooks;
     CStreamPathHook<CVariantInfo*,CWriteChoiceVariantHook*> m_PathWriteVariantHooks;
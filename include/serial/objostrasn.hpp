@@ -187,6 +187,11 @@ protected:
     // Write current separator to the stream
     virtual void WriteSeparator(void) override;
 
+    virtual CObjectOStream* OpenElementStream(CNcbiOstream& out) const override;
+    virtual void WriteParallelElement(TConstObjectPtr elementPtr,
+                                      TTypeInfo elementType) override;
+    virtual void PutParallelElement(const char* data, size_t length) override;
+
 private:
     void WriteBytes(const char* bytes, size_t length);
     void WriteString(const char* str, size_t length);
@@ -173,6 +173,7 @@ protected:
     virtual void WriteOtherBegin(TTypeInfo typeInfo) override;
     virtual void WriteOtherEnd(TTypeInfo typeInfo) override;
     virtual void WriteOther(TConstObjectPtr object, TTypeInfo typeInfo) override;
+    virtual CObjectOStream* OpenElementStream(CNcbiOstream& out) const override;
 
 #ifdef VIRTUAL_MID_LEVEL_IO
     virtual void WriteNamedType(TTypeInfo namedTypeInfo,
@@ -121,6 +121,19 @@ public:
     //     (limit if not found)
     size_t PeekFindChar(char c, size_t limit)
         THROWS1((CIOException));
+    // make sure there is at least one char in buffer and return the number
+    // of chars available from current position without further reading;
+    // they can be scanned in place (starting at GetCurrentPos())
+    // and then extracted with SkipChars()
+    size_t GetAvailableChars(void)
+        THROWS1((CIOException));
+    // extract chars up to the first special one, which is either 'stop1'
+    // or 'stop2', a control char (below 0x20), or a non-ASCII char unless
+    // 'allow8bit' is set; append extracted chars to 'str' if it is not null
+    // return: the special char, without extracting it
+    char ExtractPlainChars(string* str, char stop1, char stop2,
+                           bool allow8bit)
+        THROWS1((CIOException));
 
     const char* GetCurrentPos(void) const THROWS1_NONE;
     // returns true if succeeded
@@ -229,6 +242,7 @@ public:
     // The COStreamBuffer will throw an exception when the callback return
     // cancel request. The callback is called from FlushBuffer().
     void SetCanceledCallback(const ICanceled* callback);
+    const ICanceled* GetCanceledCallback(void) const;
 
     // return: current line counter
     size_t GetLine(void) const THROWS1_NONE;
@@ -309,6 +323,9 @@ public:
 
     void Write(const char* data, size_t dataLength)
         THROWS1((CIOException, bad_alloc));
+    // same as Write(), but also counts the lines in data
+    void WriteLines(const char* data, size_t dataLength)
+        THROWS1((CIOException, bad_alloc));
     void Write(CByteSourceReader& reader)
         THROWS1((CIOException, bad_alloc));
 
@@ -148,6 +148,16 @@ void CIStreamBuffer::GetChars(size_t count)
     }
 }
 
+inline
+size_t CIStreamBuffer::GetAvailableChars(void)
+    THROWS1((CIOException))
+{
+    const char* pos = m_CurrentPos;
+    if ( pos >= m_DataEndPos )
+        pos = FillBuffer(pos);
+    return m_DataEndPos - pos;
+}
+
 inline
 const char* CIStreamBuffer::GetCurrentPos(void) const
     THROWS1_NONE
@@ -200,6 +210,12 @@ const char* COStreamBuffer::GetError(void) const
     return m_Error;
 }
 
+inline
+const ICanceled* COStreamBuffer::GetCanceledCallback(void) const
+{
+    return m_CanceledCallback;
+}
+
 inline
 size_t COStreamBuffer::GetLine(void) const
     THROWS1_NONE
@@ -48,9 +48,15 @@
 #include <objects/seqloc/Seq_interval.hpp>
 #include <objects/seqalign/seqalign__.hpp>
 #include <serial/iterator.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbi_process.hpp>
+#include <util/md5.hpp>
 
 // CORE BLAST includes
 #include <algo/blast/core/blast_setup.h>
+#include <algo/blast/core/blast_aalookup.h>
+#include <algo/blast/core/blast_nalookup.h>
+#include <algo/blast/core/blast_util.h>
 #include <algo/blast/core/blast_hspstream.h>
 #include <algo/blast/core/hspfilter_collector.h>
 #include <algo/blast/core/hspfilter_besthit.h>
@@ -196,6 +202,361 @@ CSetupFactory::CreateScoreBlock(const CBlastOptionsMemento* opts_memento,
     return retval;
 }
 
+/// Environment variable naming the directory where lookup tables are
+/// cached between runs
+static const char* kLookupCacheDirEnv = "BLAST_LOOKUP_CACHE_DIR";
+
+/// Environment variable limiting the total size of the cached lookup
+/// tables, in megabytes
+static const char* kLookupCacheMaxSizeEnv = "BLAST_LOOKUP_CACHE_MAX_MB";
+
+/// Default limit of the total size of the cached lookup tables, in megabytes
+static const Int8 kDfltLookupCacheMaxSizeMB = 1024;
+
+/// File name mask matching all the cached lookup tables
+static const char* kLookupCacheFileMask = "blast_*lut_*.bin";
+
+/// Returns the limit of the total size of the lookup table cache in bytes
+static Int8
+s_GetLookupCacheMaxSize(void)
+{
+    Int8 max_mb = kDfltLookupCacheMaxSizeMB;
+    const char* value = getenv(kLookupCacheMaxSizeEnv);
+    if (value != NULL && !NStr::IsBlank(value)) {
+        max_mb = NStr::StringToInt8(value, NStr::fConvErr_NoThrow);
+        if (max_mb <= 0) {
+            ERR_POST(Warning << "Ignoring invalid " << kLookupCacheMaxSizeEnv
+                     << " value '" << value << "'");
+            max_mb = kDfltLookupCacheMaxSizeMB;
+        }
+    }
+    return max_mb * 1024 * 1024;
+}
+
+/** Returns TRUE if the lookup table of a nucleotide search is indexed
+ * only at the words that are not masked (mask at hash)
+ * @param query_opts query setup options [in]
+ */
+static bool
+s_HasMaskAtHash(const QuerySetUpOptions* query_opts)
+{
+    if (query_opts == NULL) {
+        return false;
+    }
+    return SBlastFilterOptionsMaskAtHash(query_opts->filtering_options) ||
+           (query_opts->filter_string &&
+            strchr(query_opts->filter_string, 'm') != NULL);
+}
+
+/** Returns the name of the file caching the lookup table built from the
+ * given queries and options; the name is derived from a digest of
+ * everything that affects the contents of the table. Protein tables
+ * without a PSSM and the nucleotide and megablast tables are cached;
+ * tables that depend on the database (database word counts, indexed
+ * megablast) are not.
+ *
+ * @param queries query sequence block [in]
+ * @param lut_opts lookup table options [in]
+ * @param query_opts query setup options [in]
+ * @param lookup_segments query regions to index [in]
+ * @param score_blk score block providing the substitution matrix [in]
+ *
+ * @return file name or an empty string if the cache is not enabled or
+ * not applicable to this search
+ */
+static string
+s_GetLookupCacheFile(const BLAST_SequenceBlk* queries,
+                     const LookupTableOptions* lut_opts,
+                     const QuerySetUpOptions* query_opts,
+                     const BlastSeqLoc* lookup_segments,
+                     const BlastScoreBlk* score_blk)
+{
+    bool is_protein = false;
+    switch (lut_opts->lut_type) {
+    case eAaLookupTable:
+        if (score_blk->matrix == NULL ||
+            (score_blk->psi_matrix && score_blk->psi_matrix->pssm)) {
+            return kEmptyStr;
+        }
+        is_protein = true;
+        break;
+    case eMixedMBLookupTable:
+    case eSmallNaLookupTable:
+    case eNaLookupTable:
+    case eMBLookupTable:
+        if (lut_opts->db_filter) {
+            return kEmptyStr;
+        }
+        break;
+    default:
+        return kEmptyStr;
+    }
+    const char* cache_dir = getenv(kLookupCacheDirEnv);
+    if (cache_dir == NULL || NStr::IsBlank(cache_dir) ||
+        !CDir(cache_dir).Exists()) {
+        return kEmptyStr;
+    }
+
+    CMD5 md5;
+    const Int4 kParams[] = { lut_opts->word_size, queries->length,
+                             static_cast<Int4>(sizeof(void*)) };
+    md5.Update(reinterpret_cast<const char*>(kParams), sizeof(kParams));
+    if (is_protein) {
+        md5.Update(reinterpret_cast<const char*>(&lut_opts->threshold),
+                   sizeof(lut_opts->threshold));
+    } else {
+        const Int4 kNaParams[] = { lut_opts->lut_type,
+                                   lut_opts->mb_template_length,
+                                   lut_opts->mb_template_type,
+                                   static_cast<Int4>(lut_opts->stride),
+                                   lut_opts->program_number,
+                                   s_HasMaskAtHash(query_opts) };
+        md5.Update(reinterpret_cast<const char*>(kNaParams),
+                   sizeof(kNaParams));
+    }
+    md5.Update(reinterpret_cast<const char*>(queries->sequence),
+               queries->length);
+    for (const BlastSeqLoc* loc = lookup_segments; loc; loc = loc->next) {
+        md5.Update(reinterpret_cast<const char*>(loc->ssr),
+                   sizeof(*loc->ssr));
+    }
+    if (is_protein) {
+        const SBlastScoreMatrix* matrix = score_blk->matrix;
+        for (size_t i = 0; i < matrix->nrows; i++) {
+            md5.Update(reinterpret_cast<const char*>(matrix->data[i]),
+                       matrix->ncols * sizeof(matrix->data[i][0]));
+        }
+    }
+    return CDirEntry::MakePath(cache_dir,
+                               string(is_protein ? "blast_aalut_"
+                                                 : "blast_nalut_") +
+                               md5.GetHexSum(), "bin");
+}
+
+/** Creates a lookup table from a cached image
+ * @param image the image [in]
+ * @param image_size size of the image [in]
+ * @param is_protein TRUE if the image holds a protein lookup table [in]
+ * @param lut_type type of the created table [out]
+ * @return the lookup table or NULL if the image is not valid
+ */
+static void*
+s_DeserializeLookupTable(const void* image, size_t image_size,
+                         bool is_protein, ELookupTableType* lut_type)
+{
+    if (is_protein) {
+        BlastAaLookupTable* lut = NULL;
+        *lut_type = eAaLookupTable;
+        BlastAaLookupTableDeserialize(image, image_size, &lut);
+        return lut;
+    }
+    // Each kind of image starts with its own magic number, so only the
+    // right function accepts it
+    BlastSmallNaLookupTable* small_lut = NULL;
+    if (BlastSmallNaLookupTableDeserialize(image, image_size,
+                                           &small_lut) == 0) {
+        *lut_type = eSmallNaLookupTable;
+        return small_lut;
+    }
+    BlastNaLookupTable* na_lut = NULL;
+    if (BlastNaLookupTableDeserialize(image, image_size, &na_lut) == 0) {
+        *lut_type = eNaLookupTable;
+        return na_lut;
+    }
+    BlastMBLookupTable* mb_lut = NULL;
+    if (BlastMBLookupTableDeserialize(image, image_size, &mb_lut) == 0) {
+        *lut_type = eMBLookupTable;
+        return mb_lut;
+    }
+    return NULL;
+}
+
+/** Loads a lookup table from the cache. A hit refreshes the modification
+ * time of the file, which the cache eviction uses as the time of the last
+ * use.
+ * @param cache_file file written by s_SaveLookupTable [in]
+ * @param queries query sequence block [in|out]
+ * @return the lookup table or NULL if it is not cached or the file is
+ * not usable
+ */
+static LookupTableWrap*
+s_LoadLookupTable(const string& cache_file, BLAST_SequenceBlk* queries)
+{
+    CFile file(cache_file);
+    if ( !file.Exists() ) {
+        return NULL;
+    }
+    const bool kIsProtein =
+        NStr::StartsWith(file.GetName(), "blast_aalut_");
+    LookupTableWrap* retval =
+        (LookupTableWrap*) calloc(1, sizeof(LookupTableWrap));
+    if (retval == NULL) {
+        return NULL;
+    }
+    try {
+        CMemoryFile image(cache_file);
+        retval->lut = s_DeserializeLookupTable(image.GetPtr(),
+                                               image.GetSize(), kIsProtein,
+                                               &retval->lut_type);
+        if (retval->lut == NULL) {
+            ERR_POST(Warning << "Ignoring invalid cached lookup table "
+                     << cache_file);
+        }
+    } catch (const CException& e) {
+        ERR_POST(Warning << "Failed to read cached lookup table "
+                 << cache_file << ": " << e.GetMsg());
+    }
+    if (retval->lut == NULL) {
+        sfree(retval);
+        return NULL;
+    }
+    // A newly built small nucleotide table leaves the compressed query
+    // behind for the ungapped extensions; do the same here
+    if (retval->lut_type == eSmallNaLookupTable &&
+        queries->compressed_nuc_seq_start == NULL) {
+        BlastCompressBlastnaSequence(queries);
+    }
+    time_t now = time(0);
+    file.SetTimeT(&now);
+    return retval;
+}
+
+/** Removes the least recently used lookup tables from the cache until
+ * the total size of the cache is within the limit
+ * @param cache_dir the cache directory [in]
+ * @param max_size the limit in bytes [in]
+ */
+static void
+s_TrimLookupCache(const string& cache_dir, Int8 max_size)
+{
+    typedef pair<time_t, pair<Int8, string> > TCacheEntry;
+    vector<TCacheEntry> entries;
+    Int8 total_size = 0;
+
+    CDir::TEntries files =
+        CDir(cache_dir).GetEntries(kLookupCacheFileMask,
+                                   CDir::fIgnoreRecursive);
+    ITERATE(CDir::TEntries, it, files) {
+        CFile file((*it)->GetPath());
+        time_t mtime = 0;
+        Int8 size = file.GetLength();
+        if (size < 0 || !file.GetTimeT(&mtime)) {
+            // Removed by a concurrent search
+            continue;
+        }
+        entries.push_back(TCacheEntry(mtime, make_pair(size,
+                                                       file.GetPath())));
+        total_size += size;
+    }
+    if (total_size <= max_size) {
+        return;
+    }
+
+    sort(entries.begin(), entries.end());
+    ITERATE(vector<TCacheEntry>, it, entries) {
+        if (total_size <= max_size) {
+            break;
+        }
+        // Another search may be reading the file; on UNIX its mapping
+        // stays valid after the file is removed
+        if (CFile(it->second.second).Remove()) {
+            total_size -= it->second.first;
+        }
+    }
+}
+
+/** Stores a lookup table in the cache. The image is written to a
+ * temporary file first and then renamed, so concurrent searches never see
+ * a partially written table. Afterwards the least recently used tables
+ * are evicted if the cache has grown over its size limit.
+ * @param lookup_wrap the lookup table [in]
+ * @param queries query sequence block [in]
+ * @param cache_file name of the cache file [in]
+ */
+static void
+s_SaveLookupTable(const LookupTableWrap* lookup_wrap,
+                  const BLAST_SequenceBlk* queries,
+                  const string& cache_file)
+{
+    size_t image_size = 0;
+    switch (lookup_wrap->lut_type) {
+    case eAaLookupTable:
+        image_size = BlastAaLookupTableImageSize(
+                         (const BlastAaLookupTable*) lookup_wrap->lut);
+        break;
+    case eSmallNaLookupTable:
+        image_size = BlastSmallNaLookupTableImageSize(
+                         (const BlastSmallNaLookupTable*) lookup_wrap->lut);
+        break;
+    case eNaLookupTable:
+        image_size = BlastNaLookupTableImageSize(
+                         (const BlastNaLookupTable*) lookup_wrap->lut);
+        break;
+    case eMBLookupTable:
+        image_size = BlastMBLookupTableImageSize(
+                         (const BlastMBLookupTable*) lookup_wrap->lut,
+                         queries->length);
+        break;
+    default:
+        break;
+    }
+    const Int8 kMaxSize = s_GetLookupCacheMaxSize();
+    if (image_size == 0 || static_cast<Int8>(image_size) > kMaxSize) {
+        return;
+    }
+
+    vector<char> image(image_size);
+    Int2 status = -1;
+    switch (lookup_wrap->lut_type) {
+    case eAaLookupTable:
+        status = BlastAaLookupTableSerialize(
+                     (const BlastAaLookupTable*) lookup_wrap->lut,
+                     &image[0], image_size);
+        break;
+    case eSmallNaLookupTable:
+        status = BlastSmallNaLookupTableSerialize(
+                     (const BlastSmallNaLookupTable*) lookup_wrap->lut,
+                     &image[0], image_size);
+        break;
+    case eNaLookupTable:
+        status = BlastNaLookupTableSerialize(
+                     (const BlastNaLookupTable*) lookup_wrap->lut,
+                     &image[0], image_size);
+        break;
+    case eMBLookupTable:
+        status = BlastMBLookupTableSerialize(
+                     (const BlastMBLookupTable*) lookup_wrap->lut,
+                     queries->length, &image[0], image_size);
+        break;
+    default:
+        break;
+    }
+    if (status != 0) {
+        return;
+    }
+
+    const string kTmpFile = cache_file + "." +
+        NStr::NumericToString(CCurrentProcess::GetPid()) + ".tmp";
+    try {
+        {{
+            CNcbiOfstream out(kTmpFile.c_str(),
+                              IOS_BASE::out | IOS_BASE::binary);
+            out.write(&image[0], image_size);
+            if ( !out ) {
+                NCBI_THROW(CFileException, eFileIO,
+                           "Cannot write " + kTmpFile);
+            }
+        }}
+        CFile(kTmpFile).Rename(cache_file, CFile::fRF_Overwrite);
+    } catch (const CException& e) {
+        ERR_POST(Warning << "Failed to cache lookup table in "
+                 << cache_file << ": " << e.GetMsg());
+        CFile(kTmpFile).Remove();
+        return;
+    }
+    s_TrimLookupCache(CFile(cache_file).GetDir(), kMaxSize);
+}
+
 LookupTableWrap*
 CSetupFactory::CreateLookupTable(CRef<ILocalQueryData> query_data,
                                  const CBlastOptionsMemento* opts_memento,
@@ -211,6 +572,17 @@ CSetupFactory::CreateLookupTable(CRef<ILocalQueryData> query_data,
 
     BlastSeqLoc * lookup_segments = lookup_segments_wrap->getLocs();
 
+    const string kCacheFile = 
+        s_GetLookupCacheFile(queries, opts_memento->m_LutOpts,
+                             opts_memento->m_QueryOpts,
+                             lookup_segments, score_blk);
+    if ( !kCacheFile.empty() ) {
+        retval = s_LoadLookupTable(kCacheFile, queries);
+        if (retval) {
+            return retval;
+        }
+    }
+
     Int2 status = LookupTableWrapInit_MT(queries,
                                          opts_memento->m_LutOpts,
                                          opts_memento->m_QueryOpts,
@@ -236,6 +608,10 @@ CSetupFactory::CreateLookupTable(CRef<ILocalQueryData> query_data,
          NCBI_THROW(CBlastException, eCoreBlastError, msg);
     }
 
+    if ( !kCacheFile.empty() ) {
+        s_SaveLookupTable(retval, queries, kCacheFile);
+    }
+
     // For PHI BLAST, save information about pattern occurrences in query in
     // the BlastQueryInfo structure
     if (Blast_ProgramIsPhiBlast(opts_memento->m_ProgramType)) {
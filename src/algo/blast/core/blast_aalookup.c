@@ -263,6 +263,200 @@ BlastAaLookupTable *BlastAaLookupTableDestruct(BlastAaLookupTable * lookup)
     return NULL;
 }
 
+/** Identifies a flat protein lookup table image ("BAAL") */
+#define AA_LOOKUP_IMAGE_MAGIC 0x4C414142
+/** Version of the flat protein lookup table image layout */
+#define AA_LOOKUP_IMAGE_VERSION 1
+/** Alignment of the arrays within a lookup table image */
+#define AA_LOOKUP_IMAGE_ALIGN 8
+
+/** Header of a flat protein lookup table image; the thick backbone,
+ *  the presence vector and the overflow array follow it in this order,
+ *  each padded to AA_LOOKUP_IMAGE_ALIGN bytes
+ */
+typedef struct AaLookupImageHeader {
+    Uint4 magic;           /**< AA_LOOKUP_IMAGE_MAGIC */
+    Uint4 version;         /**< AA_LOOKUP_IMAGE_VERSION */
+    Uint4 header_size;     /**< sizeof(AaLookupImageHeader) */
+    Int4 threshold;        /**< see BlastAaLookupTable */
+    Int4 mask;             /**< see BlastAaLookupTable */
+    Int4 charsize;         /**< see BlastAaLookupTable */
+    Int4 word_length;      /**< see BlastAaLookupTable */
+    Int4 lut_word_length;  /**< see BlastAaLookupTable */
+    Int4 alphabet_size;    /**< see BlastAaLookupTable */
+    Int4 backbone_size;    /**< see BlastAaLookupTable */
+    Int4 longest_chain;    /**< see BlastAaLookupTable */
+    Int4 bone_type;        /**< see BlastAaLookupTable */
+    Int4 overflow_size;    /**< see BlastAaLookupTable */
+    Int4 use_pssm;         /**< see BlastAaLookupTable */
+    Int4 neighbor_matches; /**< see BlastAaLookupTable */
+    Int4 exact_matches;    /**< see BlastAaLookupTable */
+} AaLookupImageHeader;
+
+/** Round a size up to the image alignment */
+static size_t s_AaLookupImageAlign(size_t size)
+{
+    return (size + AA_LOOKUP_IMAGE_ALIGN - 1) & 
+           ~((size_t)AA_LOOKUP_IMAGE_ALIGN - 1);
+}
+
+/** Compute the sizes of the arrays of a finalized lookup table
+ * @param backbone_size number of cells in the backbone [in]
+ * @param bone_type type of the backbone cells [in]
+ * @param overflow_size number of elements in the overflow array [in]
+ * @param bone_bytes size of the thick backbone [out]
+ * @param pv_bytes size of the presence vector [out]
+ * @param overflow_bytes size of the overflow array [out]
+ */
+static void s_AaLookupArraySizes(Int4 backbone_size, EBoneType bone_type,
+                                 Int4 overflow_size, size_t* bone_bytes,
+                                 size_t* pv_bytes, size_t* overflow_bytes)
+{
+    if (bone_type == eBackbone) {
+        *bone_bytes = backbone_size * sizeof(AaLookupBackboneCell);
+        *overflow_bytes = overflow_size * sizeof(Int4);
+    } else {
+        *bone_bytes = backbone_size * sizeof(AaLookupSmallboneCell);
+        *overflow_bytes = overflow_size * sizeof(Uint2);
+    }
+    *pv_bytes = ((backbone_size >> PV_ARRAY_BTS) + 1) * sizeof(PV_ARRAY_TYPE);
+}
+
+size_t BlastAaLookupTableImageSize(const BlastAaLookupTable* lookup)
+{
+    size_t bone_bytes, pv_bytes, overflow_bytes;
+
+    if (lookup == NULL || lookup->thick_backbone == NULL || 
+        lookup->pv == NULL)
+        return 0;
+
+    s_AaLookupArraySizes(lookup->backbone_size, lookup->bone_type,
+                         lookup->overflow_size, &bone_bytes, &pv_bytes,
+                         &overflow_bytes);
+    return s_AaLookupImageAlign(sizeof(AaLookupImageHeader)) +
+           s_AaLookupImageAlign(bone_bytes) +
+           s_AaLookupImageAlign(pv_bytes) +
+           s_AaLookupImageAlign(overflow_bytes);
+}
+
+Int2 BlastAaLookupTableSerialize(const BlastAaLookupTable* lookup,
+                                 void* buffer, size_t buffer_size)
+{
+    AaLookupImageHeader header;
+    size_t bone_bytes, pv_bytes, overflow_bytes;
+    Uint1* dest = (Uint1*) buffer;
+
+    if (buffer == NULL || 
+        buffer_size < BlastAaLookupTableImageSize(lookup) ||
+        BlastAaLookupTableImageSize(lookup) == 0)
+        return -1;
+
+    memset(buffer, 0, buffer_size);
+    memset(&header, 0, sizeof(header));
+    header.magic = AA_LOOKUP_IMAGE_MAGIC;
+    header.version = AA_LOOKUP_IMAGE_VERSION;
+    header.header_size = sizeof(AaLookupImageHeader);
+    header.threshold = lookup->threshold;
+    header.mask = lookup->mask;
+    header.charsize = lookup->charsize;
+    header.word_length = lookup->word_length;
+    header.lut_word_length = lookup->lut_word_length;
+    header.alphabet_size = lookup->alphabet_size;
+    header.backbone_size = lookup->backbone_size;
+    header.longest_chain = lookup->longest_chain;
+    header.bone_type = lookup->bone_type;
+    header.overflow_size = lookup->overflow_size;
+    header.use_pssm = lookup->use_pssm;
+    header.neighbor_matches = lookup->neighbor_matches;
+    header.exact_matches = lookup->exact_matches;
+
+    s_AaLookupArraySizes(lookup->backbone_size, lookup->bone_type,
+                         lookup->overflow_size, &bone_bytes, &pv_bytes,
+                         &overflow_bytes);
+
+    memcpy(dest, &header, sizeof(header));
+    dest += s_AaLookupImageAlign(sizeof(header));
+    memcpy(dest, lookup->thick_backbone, bone_bytes);
+    dest += s_AaLookupImageAlign(bone_bytes);
+    memcpy(dest, lookup->pv, pv_bytes);
+    dest += s_AaLookupImageAlign(pv_bytes);
+    if (overflow_bytes > 0)
+        memcpy(dest, lookup->overflow, overflow_bytes);
+
+    return 0;
+}
+
+Int2 BlastAaLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastAaLookupTable* * lut)
+{
+    AaLookupImageHeader header;
+    size_t bone_bytes, pv_bytes, overflow_bytes;
+    const Uint1* src = (const Uint1*) buffer;
+    BlastAaLookupTable* lookup;
+
+    if (lut == NULL)
+        return -1;
+    *lut = NULL;
+    if (buffer == NULL || buffer_size < sizeof(header))
+        return -1;
+
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != AA_LOOKUP_IMAGE_MAGIC ||
+        header.version != AA_LOOKUP_IMAGE_VERSION ||
+        header.header_size != sizeof(AaLookupImageHeader) ||
+        header.backbone_size <= 0 || header.overflow_size < 0 ||
+        (header.bone_type != eBackbone && header.bone_type != eSmallbone))
+        return -1;
+
+    s_AaLookupArraySizes(header.backbone_size, (EBoneType)header.bone_type,
+                         header.overflow_size, &bone_bytes, &pv_bytes,
+                         &overflow_bytes);
+    if (buffer_size < s_AaLookupImageAlign(sizeof(header)) +
+                      s_AaLookupImageAlign(bone_bytes) +
+                      s_AaLookupImageAlign(pv_bytes) +
+                      s_AaLookupImageAlign(overflow_bytes))
+        return -1;
+
+    lookup = (BlastAaLookupTable*) calloc(1, sizeof(BlastAaLookupTable));
+    if (lookup == NULL)
+        return -1;
+
+    lookup->threshold = header.threshold;
+    lookup->mask = header.mask;
+    lookup->charsize = header.charsize;
+    lookup->word_length = header.word_length;
+    lookup->lut_word_length = header.lut_word_length;
+    lookup->alphabet_size = header.alphabet_size;
+    lookup->backbone_size = header.backbone_size;
+    lookup->longest_chain = header.longest_chain;
+    lookup->bone_type = (EBoneType)header.bone_type;
+    lookup->overflow_size = header.overflow_size;
+    lookup->use_pssm = (Boolean)header.use_pssm;
+    lookup->neighbor_matches = header.neighbor_matches;
+    lookup->exact_matches = header.exact_matches;
+
+    lookup->thick_backbone = malloc(bone_bytes);
+    lookup->pv = (PV_ARRAY_TYPE*) malloc(pv_bytes);
+    if (overflow_bytes > 0)
+        lookup->overflow = malloc(overflow_bytes);
+    if (lookup->thick_backbone == NULL || lookup->pv == NULL ||
+        (overflow_bytes > 0 && lookup->overflow == NULL)) {
+        BlastAaLookupTableDestruct(lookup);
+        return -1;
+    }
+
+    src += s_AaLookupImageAlign(sizeof(header));
+    memcpy(lookup->thick_backbone, src, bone_bytes);
+    src += s_AaLookupImageAlign(bone_bytes);
+    memcpy(lookup->pv, src, pv_bytes);
+    src += s_AaLookupImageAlign(pv_bytes);
+    if (overflow_bytes > 0)
+        memcpy(lookup->overflow, src, overflow_bytes);
+
+    *lut = lookup;
+    return 0;
+}
+
 
 Int4 BlastAaLookupFinalize(BlastAaLookupTable * lookup, EBoneType bone_type)
 {
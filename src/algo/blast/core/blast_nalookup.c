@@ -1403,6 +1403,602 @@ BlastMBLookupTable* BlastMBLookupTableDestruct(BlastMBLookupTable* mb_lt)
    return mb_lt;
 }
 
+/** Version of the flat nucleotide lookup table image layouts */
+#define NA_LOOKUP_IMAGE_VERSION 1
+/** Alignment of the arrays within a lookup table image */
+#define NA_LOOKUP_IMAGE_ALIGN 8
+/** Identifies a flat small nucleotide lookup table image ("BSNL") */
+#define SMALL_NA_LOOKUP_IMAGE_MAGIC 0x4C4E5342
+/** Identifies a flat nucleotide lookup table image ("BNAL") */
+#define NA_LOOKUP_IMAGE_MAGIC 0x4C414E42
+/** Identifies a flat megablast lookup table image ("BMBL") */
+#define MB_LOOKUP_IMAGE_MAGIC 0x4C424D42
+
+/** Header of a flat small nucleotide lookup table image; the final
+ *  backbone, the overflow array and the masked locations follow it in
+ *  this order, each padded to NA_LOOKUP_IMAGE_ALIGN bytes
+ */
+typedef struct SmallNaLookupImageHeader {
+    Uint4 magic;           /**< SMALL_NA_LOOKUP_IMAGE_MAGIC */
+    Uint4 version;         /**< NA_LOOKUP_IMAGE_VERSION */
+    Uint4 header_size;     /**< sizeof(SmallNaLookupImageHeader) */
+    Int4 mask;             /**< see BlastSmallNaLookupTable */
+    Int4 word_length;      /**< see BlastSmallNaLookupTable */
+    Int4 lut_word_length;  /**< see BlastSmallNaLookupTable */
+    Int4 scan_step;        /**< see BlastSmallNaLookupTable */
+    Int4 backbone_size;    /**< see BlastSmallNaLookupTable */
+    Int4 longest_chain;    /**< see BlastSmallNaLookupTable */
+    Int4 overflow_size;    /**< see BlastSmallNaLookupTable */
+    Int4 num_masked;       /**< number of masked locations */
+} SmallNaLookupImageHeader;
+
+/** Header of a flat nucleotide lookup table image; the thick backbone,
+ *  the presence vector, the overflow array and the masked locations
+ *  follow it in this order, each padded to NA_LOOKUP_IMAGE_ALIGN bytes
+ */
+typedef struct NaLookupImageHeader {
+    Uint4 magic;           /**< NA_LOOKUP_IMAGE_MAGIC */
+    Uint4 version;         /**< NA_LOOKUP_IMAGE_VERSION */
+    Uint4 header_size;     /**< sizeof(NaLookupImageHeader) */
+    Int4 mask;             /**< see BlastNaLookupTable */
+    Int4 word_length;      /**< see BlastNaLookupTable */
+    Int4 lut_word_length;  /**< see BlastNaLookupTable */
+    Int4 scan_step;        /**< see BlastNaLookupTable */
+    Int4 backbone_size;    /**< see BlastNaLookupTable */
+    Int4 longest_chain;    /**< see BlastNaLookupTable */
+    Int4 overflow_size;    /**< see BlastNaLookupTable */
+    Int4 num_masked;       /**< number of masked locations */
+} NaLookupImageHeader;
+
+/** Header of a flat megablast lookup table image; the hash table, the
+ *  chain array, the second template's hash table and chain array (if
+ *  two templates are used), the presence vector and the masked locations
+ *  follow it in this order, each padded to NA_LOOKUP_IMAGE_ALIGN bytes
+ */
+typedef struct MBLookupImageHeader {
+    Uint4 magic;                /**< MB_LOOKUP_IMAGE_MAGIC */
+    Uint4 version;              /**< NA_LOOKUP_IMAGE_VERSION */
+    Uint4 header_size;          /**< sizeof(MBLookupImageHeader) */
+    Int4 query_length;          /**< length of the indexed query */
+    Int8 hashsize;              /**< see BlastMBLookupTable */
+    Int4 word_length;           /**< see BlastMBLookupTable */
+    Int4 lut_word_length;       /**< see BlastMBLookupTable */
+    Int4 discontiguous;         /**< see BlastMBLookupTable */
+    Int4 template_length;       /**< see BlastMBLookupTable */
+    Int4 template_type;         /**< see BlastMBLookupTable */
+    Int4 two_templates;         /**< see BlastMBLookupTable */
+    Int4 second_template_type;  /**< see BlastMBLookupTable */
+    Int4 stride;                /**< see BlastMBLookupTable */
+    Int4 scan_step;             /**< see BlastMBLookupTable */
+    Int4 pv_array_bts;          /**< see BlastMBLookupTable */
+    Int4 longest_chain;         /**< see BlastMBLookupTable */
+    Int4 num_unique_pos_added;  /**< see BlastMBLookupTable */
+    Int4 num_words_added;       /**< see BlastMBLookupTable */
+    Int4 num_masked;            /**< number of masked locations */
+} MBLookupImageHeader;
+
+/** Round a size up to the image alignment */
+static size_t s_NaLookupImageAlign(size_t size)
+{
+    return (size + NA_LOOKUP_IMAGE_ALIGN - 1) & 
+           ~((size_t)NA_LOOKUP_IMAGE_ALIGN - 1);
+}
+
+/** Count the masked locations of a lookup table */
+static Int4 s_NaLookupImageCountLocs(const BlastSeqLoc* locs)
+{
+    Int4 count = 0;
+    for (; locs; locs = locs->next)
+        count++;
+    return count;
+}
+
+/** Copy an array into an image
+ * @param dest current position in the image [in]
+ * @param src the array [in]
+ * @param bytes size of the array [in]
+ * @return position in the image after the padded array
+ */
+static Uint1* s_NaLookupImagePut(Uint1* dest, const void* src, size_t bytes)
+{
+    if (bytes > 0)
+        memcpy(dest, src, bytes);
+    return dest + s_NaLookupImageAlign(bytes);
+}
+
+/** Copy the masked locations into an image
+ * @param dest current position in the image [in]
+ * @param locs the masked locations [in]
+ * @return position in the image after the padded locations
+ */
+static Uint1* s_NaLookupImagePutLocs(Uint1* dest, const BlastSeqLoc* locs)
+{
+    size_t bytes = 0;
+    for (; locs; locs = locs->next) {
+        memcpy(dest + bytes, locs->ssr, sizeof(SSeqRange));
+        bytes += sizeof(SSeqRange);
+    }
+    return dest + s_NaLookupImageAlign(bytes);
+}
+
+/** Copy an array out of an image
+ * @param src current position in the image [in]
+ * @param bytes size of the array [in]
+ * @param dest the new array, NULL if the array is empty [out]
+ * @return position in the image after the padded array
+ */
+static const Uint1* s_NaLookupImageGet(const Uint1* src, size_t bytes,
+                                       void* * dest)
+{
+    *dest = NULL;
+    if (bytes > 0) {
+        *dest = malloc(bytes);
+        if (*dest != NULL)
+            memcpy(*dest, src, bytes);
+    }
+    return src + s_NaLookupImageAlign(bytes);
+}
+
+/** Rebuild the masked locations from an image
+ * @param src current position in the image [in]
+ * @param num_masked number of masked locations [in]
+ * @param locs the rebuilt list [out]
+ * @return 0 if successful, nonzero if out of memory
+ */
+static Int2 s_NaLookupImageGetLocs(const Uint1* src, Int4 num_masked,
+                                   BlastSeqLoc* * locs)
+{
+    BlastSeqLoc* tail = NULL;
+    Int4 i;
+
+    *locs = NULL;
+    for (i = 0; i < num_masked; i++) {
+        SSeqRange range;
+        memcpy(&range, src + i * sizeof(SSeqRange), sizeof(SSeqRange));
+        tail = BlastSeqLocNew(tail ? &tail : locs, range.left, range.right);
+        if (tail == NULL) {
+            *locs = BlastSeqLocFree(*locs);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/** Compute the sizes of the arrays of a small nucleotide lookup table */
+static void s_SmallNaLookupArraySizes(Int4 backbone_size, Int4 overflow_size,
+                                      Int4 num_masked, size_t* bone_bytes,
+                                      size_t* overflow_bytes,
+                                      size_t* masked_bytes)
+{
+    *bone_bytes = backbone_size * sizeof(Int2);
+    *overflow_bytes = overflow_size * sizeof(Int2);
+    *masked_bytes = num_masked * sizeof(SSeqRange);
+}
+
+size_t BlastSmallNaLookupTableImageSize(const BlastSmallNaLookupTable* lookup)
+{
+    size_t bone_bytes, overflow_bytes, masked_bytes;
+
+    if (lookup == NULL || lookup->final_backbone == NULL)
+        return 0;
+
+    s_SmallNaLookupArraySizes(lookup->backbone_size, lookup->overflow_size,
+                      s_NaLookupImageCountLocs(lookup->masked_locations),
+                      &bone_bytes, &overflow_bytes, &masked_bytes);
+    return s_NaLookupImageAlign(sizeof(SmallNaLookupImageHeader)) +
+           s_NaLookupImageAlign(bone_bytes) +
+           s_NaLookupImageAlign(overflow_bytes) +
+           s_NaLookupImageAlign(masked_bytes);
+}
+
+Int2 BlastSmallNaLookupTableSerialize(const BlastSmallNaLookupTable* lookup,
+                                      void* buffer, size_t buffer_size)
+{
+    SmallNaLookupImageHeader header;
+    size_t bone_bytes, overflow_bytes, masked_bytes;
+    size_t image_size = BlastSmallNaLookupTableImageSize(lookup);
+    Uint1* dest = (Uint1*) buffer;
+
+    if (buffer == NULL || image_size == 0 || buffer_size < image_size)
+        return -1;
+
+    memset(buffer, 0, buffer_size);
+    memset(&header, 0, sizeof(header));
+    header.magic = SMALL_NA_LOOKUP_IMAGE_MAGIC;
+    header.version = NA_LOOKUP_IMAGE_VERSION;
+    header.header_size = sizeof(SmallNaLookupImageHeader);
+    header.mask = lookup->mask;
+    header.word_length = lookup->word_length;
+    header.lut_word_length = lookup->lut_word_length;
+    header.scan_step = lookup->scan_step;
+    header.backbone_size = lookup->backbone_size;
+    header.longest_chain = lookup->longest_chain;
+    header.overflow_size = lookup->overflow_size;
+    header.num_masked = s_NaLookupImageCountLocs(lookup->masked_locations);
+
+    s_SmallNaLookupArraySizes(header.backbone_size, header.overflow_size,
+                              header.num_masked, &bone_bytes,
+                              &overflow_bytes, &masked_bytes);
+
+    dest = s_NaLookupImagePut(dest, &header, sizeof(header));
+    dest = s_NaLookupImagePut(dest, lookup->final_backbone, bone_bytes);
+    dest = s_NaLookupImagePut(dest, lookup->overflow, overflow_bytes);
+    s_NaLookupImagePutLocs(dest, lookup->masked_locations);
+
+    return 0;
+}
+
+Int2 BlastSmallNaLookupTableDeserialize(const void* buffer,
+                                        size_t buffer_size,
+                                        BlastSmallNaLookupTable* * lut)
+{
+    SmallNaLookupImageHeader header;
+    size_t bone_bytes, overflow_bytes, masked_bytes;
+    const Uint1* src = (const Uint1*) buffer;
+    BlastSmallNaLookupTable* lookup;
+
+    if (lut == NULL)
+        return -1;
+    *lut = NULL;
+    if (buffer == NULL || buffer_size < sizeof(header))
+        return -1;
+
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != SMALL_NA_LOOKUP_IMAGE_MAGIC ||
+        header.version != NA_LOOKUP_IMAGE_VERSION ||
+        header.header_size != sizeof(SmallNaLookupImageHeader) ||
+        header.backbone_size <= 0 || header.overflow_size < 0 ||
+        header.num_masked < 0)
+        return -1;
+
+    s_SmallNaLookupArraySizes(header.backbone_size, header.overflow_size,
+                              header.num_masked, &bone_bytes,
+                              &overflow_bytes, &masked_bytes);
+    if (buffer_size < s_NaLookupImageAlign(sizeof(header)) +
+                      s_NaLookupImageAlign(bone_bytes) +
+                      s_NaLookupImageAlign(overflow_bytes) +
+                      s_NaLookupImageAlign(masked_bytes))
+        return -1;
+
+    lookup = (BlastSmallNaLookupTable*) calloc(1,
+                                             sizeof(BlastSmallNaLookupTable));
+    if (lookup == NULL)
+        return -1;
+
+    lookup->mask = header.mask;
+    lookup->word_length = header.word_length;
+    lookup->lut_word_length = header.lut_word_length;
+    lookup->scan_step = header.scan_step;
+    lookup->backbone_size = header.backbone_size;
+    lookup->longest_chain = header.longest_chain;
+    lookup->overflow_size = header.overflow_size;
+
+    src += s_NaLookupImageAlign(sizeof(header));
+    src = s_NaLookupImageGet(src, bone_bytes,
+                             (void**) &lookup->final_backbone);
+    src = s_NaLookupImageGet(src, overflow_bytes,
+                             (void**) &lookup->overflow);
+    if (lookup->final_backbone == NULL ||
+        (overflow_bytes > 0 && lookup->overflow == NULL) ||
+        s_NaLookupImageGetLocs(src, header.num_masked,
+                               &lookup->masked_locations) != 0) {
+        BlastSmallNaLookupTableDestruct(lookup);
+        return -1;
+    }
+
+    *lut = lookup;
+    return 0;
+}
+
+/** Compute the sizes of the arrays of a nucleotide lookup table */
+static void s_NaLookupArraySizes(Int4 backbone_size, Int4 overflow_size,
+                                 Int4 num_masked, size_t* bone_bytes,
+                                 size_t* pv_bytes, size_t* overflow_bytes,
+                                 size_t* masked_bytes)
+{
+    *bone_bytes = backbone_size * sizeof(NaLookupBackboneCell);
+    *pv_bytes = ((backbone_size >> PV_ARRAY_BTS) + 1) * sizeof(PV_ARRAY_TYPE);
+    *overflow_bytes = overflow_size * sizeof(Int4);
+    *masked_bytes = num_masked * sizeof(SSeqRange);
+}
+
+size_t BlastNaLookupTableImageSize(const BlastNaLookupTable* lookup)
+{
+    size_t bone_bytes, pv_bytes, overflow_bytes, masked_bytes;
+
+    if (lookup == NULL || lookup->thick_backbone == NULL ||
+        lookup->pv == NULL)
+        return 0;
+
+    s_NaLookupArraySizes(lookup->backbone_size, lookup->overflow_size,
+                         s_NaLookupImageCountLocs(lookup->masked_locations),
+                         &bone_bytes, &pv_bytes, &overflow_bytes,
+                         &masked_bytes);
+    return s_NaLookupImageAlign(sizeof(NaLookupImageHeader)) +
+           s_NaLookupImageAlign(bone_bytes) +
+           s_NaLookupImageAlign(pv_bytes) +
+           s_NaLookupImageAlign(overflow_bytes) +
+           s_NaLookupImageAlign(masked_bytes);
+}
+
+Int2 BlastNaLookupTableSerialize(const BlastNaLookupTable* lookup,
+                                 void* buffer, size_t buffer_size)
+{
+    NaLookupImageHeader header;
+    size_t bone_bytes, pv_bytes, overflow_bytes, masked_bytes;
+    size_t image_size = BlastNaLookupTableImageSize(lookup);
+    Uint1* dest = (Uint1*) buffer;
+
+    if (buffer == NULL || image_size == 0 || buffer_size < image_size)
+        return -1;
+
+    memset(buffer, 0, buffer_size);
+    memset(&header, 0, sizeof(header));
+    header.magic = NA_LOOKUP_IMAGE_MAGIC;
+    header.version = NA_LOOKUP_IMAGE_VERSION;
+    header.header_size = sizeof(NaLookupImageHeader);
+    header.mask = lookup->mask;
+    header.word_length = lookup->word_length;
+    header.lut_word_length = lookup->lut_word_length;
+    header.scan_step = lookup->scan_step;
+    header.backbone_size = lookup->backbone_size;
+    header.longest_chain = lookup->longest_chain;
+    header.overflow_size = lookup->overflow_size;
+    header.num_masked = s_NaLookupImageCountLocs(lookup->masked_locations);
+
+    s_NaLookupArraySizes(header.backbone_size, header.overflow_size,
+                         header.num_masked, &bone_bytes, &pv_bytes,
+                         &overflow_bytes, &masked_bytes);
+
+    dest = s_NaLookupImagePut(dest, &header, sizeof(header));
+    dest = s_NaLookupImagePut(dest, lookup->thick_backbone, bone_bytes);
+    dest = s_NaLookupImagePut(dest, lookup->pv, pv_bytes);
+    dest = s_NaLookupImagePut(dest, lookup->overflow, overflow_bytes);
+    s_NaLookupImagePutLocs(dest, lookup->masked_locations);
+
+    return 0;
+}
+
+Int2 BlastNaLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastNaLookupTable* * lut)
+{
+    NaLookupImageHeader header;
+    size_t bone_bytes, pv_bytes, overflow_bytes, masked_bytes;
+    const Uint1* src = (const Uint1*) buffer;
+    BlastNaLookupTable* lookup;
+
+    if (lut == NULL)
+        return -1;
+    *lut = NULL;
+    if (buffer == NULL || buffer_size < sizeof(header))
+        return -1;
+
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != NA_LOOKUP_IMAGE_MAGIC ||
+        header.version != NA_LOOKUP_IMAGE_VERSION ||
+        header.header_size != sizeof(NaLookupImageHeader) ||
+        header.backbone_size <= 0 || header.overflow_size < 0 ||
+        header.num_masked < 0)
+        return -1;
+
+    s_NaLookupArraySizes(header.backbone_size, header.overflow_size,
+                         header.num_masked, &bone_bytes, &pv_bytes,
+                         &overflow_bytes, &masked_bytes);
+    if (buffer_size < s_NaLookupImageAlign(sizeof(header)) +
+                      s_NaLookupImageAlign(bone_bytes) +
+                      s_NaLookupImageAlign(pv_bytes) +
+                      s_NaLookupImageAlign(overflow_bytes) +
+                      s_NaLookupImageAlign(masked_bytes))
+        return -1;
+
+    lookup = (BlastNaLookupTable*) calloc(1, sizeof(BlastNaLookupTable));
+    if (lookup == NULL)
+        return -1;
+
+    lookup->mask = header.mask;
+    lookup->word_length = header.word_length;
+    lookup->lut_word_length = header.lut_word_length;
+    lookup->scan_step = header.scan_step;
+    lookup->backbone_size = header.backbone_size;
+    lookup->longest_chain = header.longest_chain;
+    lookup->overflow_size = header.overflow_size;
+
+    src += s_NaLookupImageAlign(sizeof(header));
+    src = s_NaLookupImageGet(src, bone_bytes,
+                             (void**) &lookup->thick_backbone);
+    src = s_NaLookupImageGet(src, pv_bytes, (void**) &lookup->pv);
+    src = s_NaLookupImageGet(src, overflow_bytes,
+                             (void**) &lookup->overflow);
+    if (lookup->thick_backbone == NULL || lookup->pv == NULL ||
+        (overflow_bytes > 0 && lookup->overflow == NULL) ||
+        s_NaLookupImageGetLocs(src, header.num_masked,
+                               &lookup->masked_locations) != 0) {
+        BlastNaLookupTableDestruct(lookup);
+        return -1;
+    }
+
+    *lut = lookup;
+    return 0;
+}
+
+/** Compute the sizes of the arrays of a megablast lookup table; the sizes
+ *  of the second template's arrays are 0 unless two templates are used
+ */
+static void s_MBLookupArraySizes(Int8 hashsize, Int4 query_length,
+                                 Boolean two_templates, Int4 pv_array_bts,
+                                 Int4 num_masked, size_t* hash_bytes,
+                                 size_t* next_pos_bytes,
+                                 size_t* hash2_bytes,
+                                 size_t* next_pos2_bytes, size_t* pv_bytes,
+                                 size_t* masked_bytes)
+{
+    *hash_bytes = (size_t)hashsize * sizeof(Int4);
+    *next_pos_bytes = ((size_t)query_length + 1) * sizeof(Int4);
+    *hash2_bytes = two_templates ? *hash_bytes : 0;
+    *next_pos2_bytes = two_templates ? *next_pos_bytes : 0;
+    *pv_bytes = (size_t)(hashsize >> pv_array_bts) * PV_ARRAY_BYTES;
+    *masked_bytes = num_masked * sizeof(SSeqRange);
+}
+
+size_t BlastMBLookupTableImageSize(const BlastMBLookupTable* mb_lt,
+                                   Int4 query_length)
+{
+    size_t hash_bytes, next_pos_bytes, hash2_bytes, next_pos2_bytes;
+    size_t pv_bytes, masked_bytes;
+
+    if (mb_lt == NULL || mb_lt->hashtable == NULL ||
+        mb_lt->next_pos == NULL || mb_lt->pv_array == NULL ||
+        (mb_lt->two_templates && 
+         (mb_lt->hashtable2 == NULL || mb_lt->next_pos2 == NULL)) ||
+        query_length < 0)
+        return 0;
+
+    s_MBLookupArraySizes(mb_lt->hashsize, query_length,
+                         mb_lt->two_templates, mb_lt->pv_array_bts,
+                         s_NaLookupImageCountLocs(mb_lt->masked_locations),
+                         &hash_bytes, &next_pos_bytes, &hash2_bytes,
+                         &next_pos2_bytes, &pv_bytes, &masked_bytes);
+    return s_NaLookupImageAlign(sizeof(MBLookupImageHeader)) +
+           s_NaLookupImageAlign(hash_bytes) +
+           s_NaLookupImageAlign(next_pos_bytes) +
+           s_NaLookupImageAlign(hash2_bytes) +
+           s_NaLookupImageAlign(next_pos2_bytes) +
+           s_NaLookupImageAlign(pv_bytes) +
+           s_NaLookupImageAlign(masked_bytes);
+}
+
+Int2 BlastMBLookupTableSerialize(const BlastMBLookupTable* mb_lt,
+                                 Int4 query_length,
+                                 void* buffer, size_t buffer_size)
+{
+    MBLookupImageHeader header;
+    size_t hash_bytes, next_pos_bytes, hash2_bytes, next_pos2_bytes;
+    size_t pv_bytes, masked_bytes;
+    size_t image_size = BlastMBLookupTableImageSize(mb_lt, query_length);
+    Uint1* dest = (Uint1*) buffer;
+
+    if (buffer == NULL || image_size == 0 || buffer_size < image_size)
+        return -1;
+
+    memset(buffer, 0, buffer_size);
+    memset(&header, 0, sizeof(header));
+    header.magic = MB_LOOKUP_IMAGE_MAGIC;
+    header.version = NA_LOOKUP_IMAGE_VERSION;
+    header.header_size = sizeof(MBLookupImageHeader);
+    header.query_length = query_length;
+    header.hashsize = mb_lt->hashsize;
+    header.word_length = mb_lt->word_length;
+    header.lut_word_length = mb_lt->lut_word_length;
+    header.discontiguous = mb_lt->discontiguous;
+    header.template_length = mb_lt->template_length;
+    header.template_type = mb_lt->template_type;
+    header.two_templates = mb_lt->two_templates;
+    header.second_template_type = mb_lt->second_template_type;
+    header.stride = mb_lt->stride;
+    header.scan_step = mb_lt->scan_step;
+    header.pv_array_bts = mb_lt->pv_array_bts;
+    header.longest_chain = mb_lt->longest_chain;
+    header.num_unique_pos_added = mb_lt->num_unique_pos_added;
+    header.num_words_added = mb_lt->num_words_added;
+    header.num_masked = s_NaLookupImageCountLocs(mb_lt->masked_locations);
+
+    s_MBLookupArraySizes(header.hashsize, query_length,
+                         mb_lt->two_templates, header.pv_array_bts,
+                         header.num_masked, &hash_bytes, &next_pos_bytes,
+                         &hash2_bytes, &next_pos2_bytes, &pv_bytes,
+                         &masked_bytes);
+
+    dest = s_NaLookupImagePut(dest, &header, sizeof(header));
+    dest = s_NaLookupImagePut(dest, mb_lt->hashtable, hash_bytes);
+    dest = s_NaLookupImagePut(dest, mb_lt->next_pos, next_pos_bytes);
+    dest = s_NaLookupImagePut(dest, mb_lt->hashtable2, hash2_bytes);
+    dest = s_NaLookupImagePut(dest, mb_lt->next_pos2, next_pos2_bytes);
+    dest = s_NaLookupImagePut(dest, mb_lt->pv_array, pv_bytes);
+    s_NaLookupImagePutLocs(dest, mb_lt->masked_locations);
+
+    return 0;
+}
+
+Int2 BlastMBLookupTableDeserialize(const void* buffer, size_t buffer_size,
+                                   BlastMBLookupTable* * mb_lt_ptr)
+{
+    MBLookupImageHeader header;
+    size_t hash_bytes, next_pos_bytes, hash2_bytes, next_pos2_bytes;
+    size_t pv_bytes, masked_bytes;
+    const Uint1* src = (const Uint1*) buffer;
+    BlastMBLookupTable* mb_lt;
+
+    if (mb_lt_ptr == NULL)
+        return -1;
+    *mb_lt_ptr = NULL;
+    if (buffer == NULL || buffer_size < sizeof(header))
+        return -1;
+
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != MB_LOOKUP_IMAGE_MAGIC ||
+        header.version != NA_LOOKUP_IMAGE_VERSION ||
+        header.header_size != sizeof(MBLookupImageHeader) ||
+        header.hashsize <= 0 || header.query_length < 0 ||
+        header.pv_array_bts < 0 || header.pv_array_bts >= 64 ||
+        (header.hashsize >> header.pv_array_bts) == 0 ||
+        header.num_masked < 0)
+        return -1;
+
+    s_MBLookupArraySizes(header.hashsize, header.query_length,
+                         (Boolean)header.two_templates, header.pv_array_bts,
+                         header.num_masked, &hash_bytes, &next_pos_bytes,
+                         &hash2_bytes, &next_pos2_bytes, &pv_bytes,
+                         &masked_bytes);
+    if (buffer_size < s_NaLookupImageAlign(sizeof(header)) +
+                      s_NaLookupImageAlign(hash_bytes) +
+                      s_NaLookupImageAlign(next_pos_bytes) +
+                      s_NaLookupImageAlign(hash2_bytes) +
+                      s_NaLookupImageAlign(next_pos2_bytes) +
+                      s_NaLookupImageAlign(pv_bytes) +
+                      s_NaLookupImageAlign(masked_bytes))
+        return -1;
+
+    mb_lt = (BlastMBLookupTable*) calloc(1, sizeof(BlastMBLookupTable));
+    if (mb_lt == NULL)
+        return -1;
+
+    mb_lt->hashsize = header.hashsize;
+    mb_lt->word_length = header.word_length;
+    mb_lt->lut_word_length = header.lut_word_length;
+    mb_lt->discontiguous = (Boolean)header.discontiguous;
+    mb_lt->template_length = header.template_length;
+    mb_lt->template_type = (EDiscTemplateType)header.template_type;
+    mb_lt->two_templates = (Boolean)header.two_templates;
+    mb_lt->second_template_type = 
+        (EDiscTemplateType)header.second_template_type;
+    mb_lt->stride = (Boolean)header.stride;
+    mb_lt->scan_step = header.scan_step;
+    mb_lt->pv_array_bts = header.pv_array_bts;
+    mb_lt->longest_chain = header.longest_chain;
+    mb_lt->num_unique_pos_added = header.num_unique_pos_added;
+    mb_lt->num_words_added = header.num_words_added;
+
+    src += s_NaLookupImageAlign(sizeof(header));
+    src = s_NaLookupImageGet(src, hash_bytes, (void**) &mb_lt->hashtable);
+    src = s_NaLookupImageGet(src, next_pos_bytes, (void**) &mb_lt->next_pos);
+    src = s_NaLookupImageGet(src, hash2_bytes, (void**) &mb_lt->hashtable2);
+    src = s_NaLookupImageGet(src, next_pos2_bytes,
+                             (void**) &mb_lt->next_pos2);
+    src = s_NaLookupImageGet(src, pv_bytes, (void**) &mb_lt->pv_array);
+    if (mb_lt->hashtable == NULL || mb_lt->next_pos == NULL ||
+        mb_lt->pv_array == NULL ||
+        (mb_lt->two_templates && 
+         (mb_lt->hashtable2 == NULL || mb_lt->next_pos2 == NULL)) ||
+        s_NaLookupImageGetLocs(src, header.num_masked,
+                               &mb_lt->masked_locations) != 0) {
+        BlastMBLookupTableDestruct(mb_lt);
+        return -1;
+    }
+
+    *mb_lt_ptr = mb_lt;
+    return 0;
+}
+
 
 /* Hash function: Fowler-Noll-Vo (FNV) hash 
    http://www.isthe.com/chongo/tech/comp/fnv/index.html */
@@ -52,17 +52,26 @@ CBlastAsyncFormatThread::QueueResults(int batchNumber,
 {
 	if (m_Done == true)
 		NCBI_THROW(CException, eUnknown, "QueueResults called after Finalize");
+	blastProcessGuard.Lock();
         if (m_ResultsMap.find(batchNumber) != m_ResultsMap.end())
         {
+		blastProcessGuard.Unlock();
 		string message = "Duplicate batchNumber entered: " + NStr::NumericToString(batchNumber);
-		NCBI_THROW(CException, eUnknown, "message");
+		NCBI_THROW(CException, eUnknown, message);
 	}
-	blastProcessGuard.Lock();
 	m_ResultsMap.insert(std::pair<int, vector<SFormatResultValues>>(batchNumber, results));
 	blastProcessGuard.Unlock();
 	m_Semaphore.Post();
 }
 
+void
+CBlastAsyncFormatThread::WaitForBatch(int batchNumber)
+{
+	CFastMutexGuard guard(m_PrintedMutex);
+	while (m_NumPrinted <= batchNumber)
+		m_PrintedCond.WaitForSignal(m_PrintedMutex);
+}
+
 
 void 
 CBlastAsyncFormatThread::Finalize()
@@ -116,6 +125,12 @@ void* CBlastAsyncFormatThread::Main(void)
                 	}
 			results_v[index%kVecSize].clear();
         	}
+		if (lastNum != currNum)
+		{
+			CFastMutexGuard guard(m_PrintedMutex);
+			m_NumPrinted = currNum;
+			m_PrintedCond.SignalAll();
+		}
 		lastNum=currNum;
 		if (m_Done == true) // All worker threads done.
 		{
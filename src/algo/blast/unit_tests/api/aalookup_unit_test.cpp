@@ -303,6 +303,52 @@ BOOST_AUTO_TEST_CASE(SmallboneSequenceTest) {
   BOOST_REQUIRE_EQUAL(offset, len-3);
 }
 
+BOOST_AUTO_TEST_CASE(SerializedImageTest) {
+  // build a lookup table with neighboring words and both hits stored in
+  // the backbone and in the overflow array
+  GetSeqBlk("gi|129295");
+  FillLookupTable(true);
+  BOOST_REQUIRE(lookup->overflow_size > 0);
+
+  size_t image_size = BlastAaLookupTableImageSize(lookup);
+  BOOST_REQUIRE(image_size > 0);
+  vector<char> image(image_size);
+  BOOST_REQUIRE_EQUAL(0, BlastAaLookupTableSerialize(lookup, &image[0],
+                                                     image_size));
+  // a truncated buffer is rejected
+  BOOST_REQUIRE(BlastAaLookupTableSerialize(lookup, &image[0],
+                                            image_size - 1) != 0);
+
+  BlastAaLookupTable* copy = NULL;
+  BOOST_REQUIRE_EQUAL(0, BlastAaLookupTableDeserialize(&image[0], image_size,
+                                                       &copy));
+  BOOST_REQUIRE(copy != NULL);
+  BOOST_REQUIRE_EQUAL(lookup->threshold, copy->threshold);
+  BOOST_REQUIRE_EQUAL(lookup->mask, copy->mask);
+  BOOST_REQUIRE_EQUAL(lookup->word_length, copy->word_length);
+  BOOST_REQUIRE_EQUAL(lookup->backbone_size, copy->backbone_size);
+  BOOST_REQUIRE_EQUAL(lookup->longest_chain, copy->longest_chain);
+  BOOST_REQUIRE_EQUAL(lookup->bone_type, copy->bone_type);
+  BOOST_REQUIRE_EQUAL(lookup->overflow_size, copy->overflow_size);
+  BOOST_REQUIRE_EQUAL(lookup->neighbor_matches, copy->neighbor_matches);
+  BOOST_REQUIRE(copy->thin_backbone == NULL);
+  BOOST_REQUIRE_EQUAL(0, memcmp(lookup->thick_backbone, copy->thick_backbone,
+                       lookup->backbone_size * sizeof(AaLookupSmallboneCell)));
+  BOOST_REQUIRE_EQUAL(0, memcmp(lookup->overflow, copy->overflow,
+                       lookup->overflow_size * sizeof(Uint2)));
+  BOOST_REQUIRE_EQUAL(0, memcmp(lookup->pv, copy->pv,
+                       ((lookup->backbone_size >> PV_ARRAY_BTS) + 1) *
+                       sizeof(PV_ARRAY_TYPE)));
+  BlastAaLookupTableDestruct(copy);
+
+  // a damaged image is rejected
+  image[0] ^= 0xFF;
+  copy = NULL;
+  BOOST_REQUIRE(BlastAaLookupTableDeserialize(&image[0], image_size,
+                                              &copy) != 0);
+  BOOST_REQUIRE(copy == NULL);
+}
+
 
 #if 0
 
@@ -0,0 +1,367 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ */
+
+/** @file lookup_cache_perf.cpp
+ * Command line tool comparing the time needed to build the lookup table of
+ * a set of queries with the time needed to load it from the on-disk lookup
+ * table cache (see BLAST_LOOKUP_CACHE_DIR).
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+
+#include <algo/blast/core/blast_setup.h>
+#include <algo/blast/core/blast_util.h>
+#include <algo/blast/core/blast_filter.h>
+#include <algo/blast/core/blast_aalookup.h>
+#include <algo/blast/core/blast_nalookup.h>
+#include <algo/blast/core/lookup_wrap.h>
+#include <blast_setup.hpp>
+
+#ifndef SKIP_DOXYGEN_PROCESSING
+USING_NCBI_SCOPE;
+USING_SCOPE(blast);
+#endif
+
+/// The application class
+class CLookupCachePerfApp : public CNcbiApplication
+{
+public:
+    CLookupCachePerfApp()
+        : m_Queries(NULL), m_Segments(NULL), m_LutOpts(NULL),
+          m_QueryOpts(NULL), m_ScoreBlk(NULL)
+    {}
+
+    ~CLookupCachePerfApp()
+    {
+        BlastSequenceBlkFree(m_Queries);
+        BlastSeqLocFree(m_Segments);
+        LookupTableOptionsFree(m_LutOpts);
+        BlastQuerySetUpOptionsFree(m_QueryOpts);
+        BlastScoreBlkFree(m_ScoreBlk);
+    }
+
+private:
+    virtual void Init();
+    virtual int Run();
+
+    /// Creates the random query set and the options of the search
+    void x_InitSearch();
+    /// Builds the lookup table of the query set
+    LookupTableWrap* x_BuildTable();
+    /// Writes the image of the lookup table to a file
+    /// @return size of the image in bytes
+    size_t x_SaveTable(const LookupTableWrap* lookup_wrap,
+                       const string& file_name);
+    /// Loads the lookup table from a file the way the cache does
+    LookupTableWrap* x_LoadTable(const string& file_name);
+
+    /// The program being measured
+    EBlastProgramType m_Program;
+    /// All the queries, concatenated
+    BLAST_SequenceBlk* m_Queries;
+    /// The indexed region of each query
+    BlastSeqLoc* m_Segments;
+    /// Lookup table options
+    LookupTableOptions* m_LutOpts;
+    /// Query setup options
+    QuerySetUpOptions* m_QueryOpts;
+    /// Score block with the substitution matrix (protein searches only)
+    BlastScoreBlk* m_ScoreBlk;
+};
+
+void CLookupCachePerfApp::Init()
+{
+    HideStdArgs(fHideConffile | fHideFullVersion | fHideXmlHelp | fHideDryRun);
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                  "BLAST lookup table cache performance testing client");
+
+    arg_desc->SetCurrentGroup("Query options");
+    arg_desc->AddDefaultKey("program", "name", "BLAST program",
+                            CArgDescriptions::eString, "blastp");
+    arg_desc->SetConstraint("program", &(*new CArgAllow_Strings,
+                                         "blastp", "blastn", "megablast"));
+    arg_desc->AddDefaultKey("num_queries", "number",
+                            "Number of random queries",
+                            CArgDescriptions::eInteger, "1000");
+    arg_desc->SetConstraint("num_queries",
+                            new CArgAllow_Integers(1, kMax_Int));
+    arg_desc->AddDefaultKey("query_length", "length",
+                            "Length of each query",
+                            CArgDescriptions::eInteger, "300");
+    arg_desc->SetConstraint("query_length",
+                            new CArgAllow_Integers(30, kMax_Int));
+    arg_desc->AddDefaultKey("seed", "number", "Random number generator seed",
+                            CArgDescriptions::eInteger, "1");
+
+    arg_desc->SetCurrentGroup("Testing options");
+    arg_desc->AddDefaultKey("iterations", "number",
+                            "Number of times each table is built and loaded",
+                            CArgDescriptions::eInteger, "5");
+    arg_desc->SetConstraint("iterations",
+                            new CArgAllow_Integers(1, kMax_Int));
+    arg_desc->AddOptionalKey("cache_dir", "directory",
+                             "Directory for the table image (default: the "
+                             "temporary directory)",
+                             CArgDescriptions::eString);
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+void CLookupCachePerfApp::x_InitSearch()
+{
+    const CArgs& args = GetArgs();
+    const string kProgram = args["program"].AsString();
+    const Int4 kNumQueries = args["num_queries"].AsInteger();
+    const Int4 kQueryLength = args["query_length"].AsInteger();
+    const bool kIsProtein = (kProgram == "blastp");
+
+    m_Program = kIsProtein ? eBlastTypeBlastp : eBlastTypeBlastn;
+
+    // Queries are separated (and surrounded) by sentinel bytes
+    const Uint1 kSentinel = kIsProtein ? 0 : 0x0f;
+    const Int4 kTotalLength = kNumQueries * (kQueryLength + 1) - 1;
+    Uint1* buffer = (Uint1*) malloc(kTotalLength + 2);
+    CRandom random(args["seed"].AsInteger());
+    Int4 pos = 0;
+
+    buffer[pos++] = kSentinel;
+    for (Int4 i = 0; i < kNumQueries; i++) {
+        if (i > 0) {
+            buffer[pos++] = kSentinel;
+        }
+        BlastSeqLocNew(&m_Segments, pos - 1, pos - 1 + kQueryLength - 1);
+        for (Int4 j = 0; j < kQueryLength; j++) {
+            // residues A..Y of ncbistdaa or bases of blastna
+            buffer[pos++] = kIsProtein ?
+                (Uint1) random.GetRand(1, 22) : (Uint1) random.GetRand(0, 3);
+        }
+    }
+    buffer[pos++] = kSentinel;
+    _ASSERT(pos == kTotalLength + 2);
+    BlastSetUp_SeqBlkNew(buffer, kTotalLength, &m_Queries, TRUE);
+
+    LookupTableOptionsNew(m_Program, &m_LutOpts);
+    BlastQuerySetUpOptionsNew(&m_QueryOpts);
+    if (kIsProtein) {
+        BLAST_FillLookupTableOptions(m_LutOpts, m_Program, FALSE,
+                                     BLAST_WORD_THRESHOLD_BLASTP,
+                                     BLAST_WORDSIZE_PROT);
+        BlastScoringOptions* score_options = NULL;
+        BlastScoringOptionsNew(m_Program, &score_options);
+        BLAST_FillScoringOptions(score_options, m_Program, FALSE, 0, 0,
+                                 NULL, BLAST_GAP_OPEN_PROT,
+                                 BLAST_GAP_EXTN_PROT);
+        m_ScoreBlk = BlastScoreBlkNew(BLASTAA_SEQ_CODE, 1);
+        Blast_ScoreBlkMatrixInit(m_Program, score_options, m_ScoreBlk,
+                                 &BlastFindMatrixPath);
+        BlastScoringOptionsFree(score_options);
+    } else if (kProgram == "megablast") {
+        BLAST_FillLookupTableOptions(m_LutOpts, m_Program, TRUE, 0,
+                                     BLAST_WORDSIZE_MEGABLAST);
+    } else {
+        BLAST_FillLookupTableOptions(m_LutOpts, m_Program, FALSE, 0,
+                                     BLAST_WORDSIZE_NUCL);
+    }
+}
+
+LookupTableWrap* CLookupCachePerfApp::x_BuildTable()
+{
+    LookupTableWrap* retval = NULL;
+    if (LookupTableWrapInit(m_Queries, m_LutOpts, m_QueryOpts, m_Segments,
+                            m_ScoreBlk, &retval, NULL, NULL, NULL) != 0) {
+        NCBI_THROW(CException, eUnknown, "LookupTableWrapInit failed");
+    }
+    return retval;
+}
+
+size_t CLookupCachePerfApp::x_SaveTable(const LookupTableWrap* lookup_wrap,
+                                        const string& file_name)
+{
+    size_t image_size = 0;
+    vector<char> image;
+    Int2 status = -1;
+    switch (lookup_wrap->lut_type) {
+    case eAaLookupTable: {
+        const BlastAaLookupTable* lut =
+            (const BlastAaLookupTable*) lookup_wrap->lut;
+        image_size = BlastAaLookupTableImageSize(lut);
+        image.resize(image_size);
+        status = BlastAaLookupTableSerialize(lut, &image[0], image_size);
+        break;
+    }
+    case eSmallNaLookupTable: {
+        const BlastSmallNaLookupTable* lut =
+            (const BlastSmallNaLookupTable*) lookup_wrap->lut;
+        image_size = BlastSmallNaLookupTableImageSize(lut);
+        image.resize(image_size);
+        status = BlastSmallNaLookupTableSerialize(lut, &image[0],
+                                                  image_size);
+        break;
+    }
+    case eNaLookupTable: {
+        const BlastNaLookupTable* lut =
+            (const BlastNaLookupTable*) lookup_wrap->lut;
+        image_size = BlastNaLookupTableImageSize(lut);
+        image.resize(image_size);
+        status = BlastNaLookupTableSerialize(lut, &image[0], image_size);
+        break;
+    }
+    case eMBLookupTable: {
+        const BlastMBLookupTable* lut =
+            (const BlastMBLookupTable*) lookup_wrap->lut;
+        image_size = BlastMBLookupTableImageSize(lut, m_Queries->length);
+        image.resize(image_size);
+        status = BlastMBLookupTableSerialize(lut, m_Queries->length,
+                                             &image[0], image_size);
+        break;
+    }
+    default:
+        break;
+    }
+    if (image_size == 0 || status != 0) {
+        NCBI_THROW(CException, eUnknown,
+                   "Cannot serialize lookup table of type " +
+                   NStr::IntToString(lookup_wrap->lut_type));
+    }
+    CNcbiOfstream out(file_name.c_str(), IOS_BASE::out | IOS_BASE::binary);
+    out.write(&image[0], image_size);
+    if ( !out ) {
+        NCBI_THROW(CFileException, eFileIO, "Cannot write " + file_name);
+    }
+    return image_size;
+}
+
+LookupTableWrap* CLookupCachePerfApp::x_LoadTable(const string& file_name)
+{
+    LookupTableWrap* retval =
+        (LookupTableWrap*) calloc(1, sizeof(LookupTableWrap));
+    CMemoryFile image(file_name);
+    Int2 status = -1;
+    switch (m_LutOpts->lut_type) {
+    case eAaLookupTable:
+        retval->lut_type = eAaLookupTable;
+        status = BlastAaLookupTableDeserialize(image.GetPtr(),
+                     image.GetSize(), (BlastAaLookupTable**) &retval->lut);
+        break;
+    default:
+        retval->lut_type = eSmallNaLookupTable;
+        status = BlastSmallNaLookupTableDeserialize(image.GetPtr(),
+                     image.GetSize(),
+                     (BlastSmallNaLookupTable**) &retval->lut);
+        if (status != 0) {
+            retval->lut_type = eNaLookupTable;
+            status = BlastNaLookupTableDeserialize(image.GetPtr(),
+                         image.GetSize(),
+                         (BlastNaLookupTable**) &retval->lut);
+        }
+        if (status != 0) {
+            retval->lut_type = eMBLookupTable;
+            status = BlastMBLookupTableDeserialize(image.GetPtr(),
+                         image.GetSize(),
+                         (BlastMBLookupTable**) &retval->lut);
+        }
+        break;
+    }
+    if (status != 0) {
+        sfree(retval);
+        NCBI_THROW(CException, eUnknown, "Cannot load " + file_name);
+    }
+    return retval;
+}
+
+int CLookupCachePerfApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    const int kIterations = args["iterations"].AsInteger();
+    const string kCacheDir = args["cache_dir"].HasValue() ?
+        args["cache_dir"].AsString() : CDir::GetTmpDir();
+    const string kFileName =
+        CFile::GetTmpNameEx(kCacheDir, "blast_lut_perf_");
+    int status = 0;
+
+    try {
+        x_InitSearch();
+        cout << "Queries: " << args["num_queries"].AsInteger()
+             << " x " << args["query_length"].AsInteger()
+             << " (" << args["program"].AsString() << ")" << endl;
+
+        CStopWatch build_sw;
+        LookupTableWrap* lookup_wrap = NULL;
+        for (int i = 0; i < kIterations; i++) {
+            LookupTableWrapFree(lookup_wrap);
+            build_sw.Start();
+            lookup_wrap = x_BuildTable();
+            build_sw.Stop();
+        }
+
+        CStopWatch save_sw(CStopWatch::eStart);
+        size_t image_size = x_SaveTable(lookup_wrap, kFileName);
+        save_sw.Stop();
+        cout << "Lookup table type: " << lookup_wrap->lut_type
+             << ", image size: "
+             << NStr::UInt8ToString_DataSize(image_size) << endl;
+        LookupTableWrapFree(lookup_wrap);
+
+        CStopWatch load_sw;
+        for (int i = 0; i < kIterations; i++) {
+            load_sw.Start();
+            lookup_wrap = x_LoadTable(kFileName);
+            load_sw.Stop();
+            LookupTableWrapFree(lookup_wrap);
+        }
+        CFile(kFileName).Remove();
+
+        const double kBuildTime = build_sw.Elapsed() / kIterations;
+        const double kLoadTime = load_sw.Elapsed() / kIterations;
+        cout << "Build time: " << kBuildTime << " s" << endl;
+        cout << "Save time: " << save_sw.Elapsed() << " s" << endl;
+        cout << "Load time: " << kLoadTime << " s" << endl;
+        if (kLoadTime > 0) {
+            cout << "Speedup: " << kBuildTime / kLoadTime << endl;
+        }
+    } catch (const exception& e) {
+        ERR_POST(Error << "Error: " << e.what());
+        CFile(kFileName).Remove();
+        status = 1;
+    }
+    return status;
+}
+
+
+#ifndef SKIP_DOXYGEN_PROCESSING
+int main(int argc, const char* argv[] /*, const char* envp[]*/)
+{
+    return CLookupCachePerfApp().AppMain(argc, argv);
+}
+#endif /* SKIP_DOXYGEN_PROCESSING */
@@ -835,6 +835,214 @@ BOOST_AUTO_TEST_CASE(testMegablastTableSmallUnmaskedRegion) {
 }
 
 
+// Test that a small nucleotide lookup table survives a round trip through
+// its flat image, including the masked locations
+BOOST_AUTO_TEST_CASE(testSmallNaLookupTableImage) {
+    SetUpQuery(SMALL_QUERY_GI);
+
+    LookupTableOptions* lookup_options;
+    LookupTableOptionsNew(eBlastTypeBlastn, &lookup_options);
+    BLAST_FillLookupTableOptions(lookup_options, eBlastTypeBlastn, 
+                                 FALSE, 0, 0);
+
+    QuerySetUpOptions* query_options = NULL;
+    BlastQuerySetUpOptionsNew(&query_options);
+    LookupTableWrap* lookup_wrap_ptr;
+    BOOST_REQUIRE_EQUAL((int)LookupTableWrapInit(query_blk, 
+                             lookup_options, query_options, lookup_segments, 
+                             0, &lookup_wrap_ptr, NULL, NULL, NULL), 0);
+    query_options = BlastQuerySetUpOptionsFree(query_options);
+    BOOST_REQUIRE_EQUAL(eSmallNaLookupTable,
+                        (ELookupTableType)lookup_wrap_ptr->lut_type);
+
+    BlastSmallNaLookupTable* lookup = 
+                        (BlastSmallNaLookupTable*) lookup_wrap_ptr->lut;
+    BOOST_REQUIRE(lookup->overflow_size > 0);
+    BOOST_REQUIRE(lookup->masked_locations != NULL);
+
+    size_t image_size = BlastSmallNaLookupTableImageSize(lookup);
+    BOOST_REQUIRE(image_size > 0);
+    vector<char> image(image_size);
+    BOOST_REQUIRE_EQUAL(0, BlastSmallNaLookupTableSerialize(lookup,
+                                               &image[0], image_size));
+    BOOST_REQUIRE(BlastSmallNaLookupTableSerialize(lookup, &image[0],
+                                                   image_size - 1) != 0);
+
+    BlastSmallNaLookupTable* copy = NULL;
+    BOOST_REQUIRE_EQUAL(0, BlastSmallNaLookupTableDeserialize(&image[0],
+                                                   image_size, &copy));
+    BOOST_REQUIRE(copy != NULL);
+    BOOST_REQUIRE_EQUAL(lookup->mask, copy->mask);
+    BOOST_REQUIRE_EQUAL(lookup->word_length, copy->word_length);
+    BOOST_REQUIRE_EQUAL(lookup->lut_word_length, copy->lut_word_length);
+    BOOST_REQUIRE_EQUAL(lookup->scan_step, copy->scan_step);
+    BOOST_REQUIRE_EQUAL(lookup->backbone_size, copy->backbone_size);
+    BOOST_REQUIRE_EQUAL(lookup->longest_chain, copy->longest_chain);
+    BOOST_REQUIRE_EQUAL(lookup->overflow_size, copy->overflow_size);
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->final_backbone,
+                                  copy->final_backbone,
+                                  lookup->backbone_size * sizeof(Int2)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->overflow, copy->overflow,
+                                  lookup->overflow_size * sizeof(Int2)));
+    const BlastSeqLoc* loc = lookup->masked_locations;
+    const BlastSeqLoc* copy_loc = copy->masked_locations;
+    for (; loc && copy_loc; loc = loc->next, copy_loc = copy_loc->next) {
+        BOOST_REQUIRE_EQUAL(loc->ssr->left, copy_loc->ssr->left);
+        BOOST_REQUIRE_EQUAL(loc->ssr->right, copy_loc->ssr->right);
+    }
+    BOOST_REQUIRE(loc == NULL && copy_loc == NULL);
+    copy = BlastSmallNaLookupTableDestruct(copy);
+
+    // an image of another kind of table is rejected
+    BlastNaLookupTable* na_copy = NULL;
+    BOOST_REQUIRE(BlastNaLookupTableDeserialize(&image[0], image_size,
+                                                &na_copy) != 0);
+    BOOST_REQUIRE(na_copy == NULL);
+
+    // a truncated image is rejected
+    BOOST_REQUIRE(BlastSmallNaLookupTableDeserialize(&image[0],
+                                          image_size - 1, &copy) != 0);
+    BOOST_REQUIRE(copy == NULL);
+
+    lookup_wrap_ptr = LookupTableWrapFree(lookup_wrap_ptr);
+    lookup_options = LookupTableOptionsFree(lookup_options);
+}
+
+// Test that a nucleotide lookup table survives a round trip through its
+// flat image
+BOOST_AUTO_TEST_CASE(testNaLookupTableImage) {
+    const int alphabet_size=4;
+    const int word_size=8;
+
+    debruijnInit(word_size, alphabet_size);
+
+    LookupTableOptions* lookup_options;
+    LookupTableOptionsNew(eBlastTypeBlastn, &lookup_options);
+    BLAST_FillLookupTableOptions(lookup_options, eBlastTypeBlastn, 
+                                 FALSE, 0, word_size);
+
+    QuerySetUpOptions* query_options = NULL;
+    BlastQuerySetUpOptionsNew(&query_options);
+    LookupTableWrap* lookup_wrap_ptr;
+    BOOST_REQUIRE_EQUAL((int)LookupTableWrapInit(query_blk, 
+                             lookup_options, query_options, lookup_segments, 
+                             0, &lookup_wrap_ptr, NULL, NULL, NULL), 0);
+    query_options = BlastQuerySetUpOptionsFree(query_options);
+    BOOST_REQUIRE_EQUAL(eNaLookupTable,
+                        (ELookupTableType)lookup_wrap_ptr->lut_type);
+
+    BlastNaLookupTable* lookup = (BlastNaLookupTable*) lookup_wrap_ptr->lut;
+    size_t image_size = BlastNaLookupTableImageSize(lookup);
+    BOOST_REQUIRE(image_size > 0);
+    vector<char> image(image_size);
+    BOOST_REQUIRE_EQUAL(0, BlastNaLookupTableSerialize(lookup, &image[0],
+                                                       image_size));
+
+    BlastNaLookupTable* copy = NULL;
+    BOOST_REQUIRE_EQUAL(0, BlastNaLookupTableDeserialize(&image[0],
+                                                         image_size, &copy));
+    BOOST_REQUIRE(copy != NULL);
+    BOOST_REQUIRE_EQUAL(lookup->mask, copy->mask);
+    BOOST_REQUIRE_EQUAL(lookup->word_length, copy->word_length);
+    BOOST_REQUIRE_EQUAL(lookup->scan_step, copy->scan_step);
+    BOOST_REQUIRE_EQUAL(lookup->backbone_size, copy->backbone_size);
+    BOOST_REQUIRE_EQUAL(lookup->longest_chain, copy->longest_chain);
+    BOOST_REQUIRE_EQUAL(lookup->overflow_size, copy->overflow_size);
+    BOOST_REQUIRE(copy->overflow == NULL);
+    BOOST_REQUIRE(copy->masked_locations == NULL);
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->thick_backbone,
+                          copy->thick_backbone,
+                          lookup->backbone_size * sizeof(NaLookupBackboneCell)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->pv, copy->pv,
+                          ((lookup->backbone_size >> PV_ARRAY_BTS) + 1) *
+                          sizeof(PV_ARRAY_TYPE)));
+    copy = BlastNaLookupTableDestruct(copy);
+
+    // a damaged image is rejected
+    image[0] ^= 0xFF;
+    BOOST_REQUIRE(BlastNaLookupTableDeserialize(&image[0], image_size,
+                                                &copy) != 0);
+    BOOST_REQUIRE(copy == NULL);
+
+    lookup_wrap_ptr = LookupTableWrapFree(lookup_wrap_ptr);
+    lookup_options = LookupTableOptionsFree(lookup_options);
+}
+
+// Test that a discontiguous megablast lookup table with two templates
+// survives a round trip through its flat image
+BOOST_AUTO_TEST_CASE(testMBLookupTableImageTwoTemplates) {
+    SetUpQuery(SMALL_QUERY_GI);
+
+    LookupTableOptions* lookup_options;
+    LookupTableOptionsNew(eBlastTypeBlastn, &lookup_options);
+    BLAST_FillLookupTableOptions(lookup_options, eBlastTypeBlastn, 
+                                 TRUE, 0, 11);
+    lookup_options->mb_template_length = 16; 
+    lookup_options->mb_template_type = eMBWordTwoTemplates;
+
+    QuerySetUpOptions* query_options = NULL;
+    BlastQuerySetUpOptionsNew(&query_options);
+    LookupTableWrap* lookup_wrap_ptr;
+    BOOST_REQUIRE_EQUAL((int)LookupTableWrapInit(query_blk, 
+                             lookup_options, query_options, lookup_segments, 
+                             0, &lookup_wrap_ptr, NULL, NULL, NULL), 0);
+    query_options = BlastQuerySetUpOptionsFree(query_options);
+    BOOST_REQUIRE_EQUAL(eMBLookupTable,
+                        (ELookupTableType)lookup_wrap_ptr->lut_type);
+
+    BlastMBLookupTable* lookup = (BlastMBLookupTable*) lookup_wrap_ptr->lut;
+    BOOST_REQUIRE(lookup->two_templates);
+    const Int4 kQueryLength = query_blk->length;
+
+    // the chain arrays are sized by the query, so a query length is needed
+    BOOST_REQUIRE_EQUAL((size_t)0, BlastMBLookupTableImageSize(lookup, -1));
+    size_t image_size = BlastMBLookupTableImageSize(lookup, kQueryLength);
+    BOOST_REQUIRE(image_size > 0);
+    vector<char> image(image_size);
+    BOOST_REQUIRE_EQUAL(0, BlastMBLookupTableSerialize(lookup, kQueryLength,
+                                                       &image[0],
+                                                       image_size));
+
+    BlastMBLookupTable* copy = NULL;
+    BOOST_REQUIRE_EQUAL(0, BlastMBLookupTableDeserialize(&image[0],
+                                                         image_size, &copy));
+    BOOST_REQUIRE(copy != NULL);
+    BOOST_REQUIRE_EQUAL(lookup->hashsize, copy->hashsize);
+    BOOST_REQUIRE_EQUAL(lookup->word_length, copy->word_length);
+    BOOST_REQUIRE_EQUAL(lookup->lut_word_length, copy->lut_word_length);
+    BOOST_REQUIRE_EQUAL(lookup->discontiguous, copy->discontiguous);
+    BOOST_REQUIRE_EQUAL(lookup->template_length, copy->template_length);
+    BOOST_REQUIRE_EQUAL((int)lookup->template_type,
+                        (int)copy->template_type);
+    BOOST_REQUIRE_EQUAL(lookup->two_templates, copy->two_templates);
+    BOOST_REQUIRE_EQUAL((int)lookup->second_template_type,
+                        (int)copy->second_template_type);
+    BOOST_REQUIRE_EQUAL(lookup->scan_step, copy->scan_step);
+    BOOST_REQUIRE_EQUAL(lookup->pv_array_bts, copy->pv_array_bts);
+    BOOST_REQUIRE_EQUAL(lookup->longest_chain, copy->longest_chain);
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->hashtable, copy->hashtable,
+                                  lookup->hashsize * sizeof(Int4)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->hashtable2, copy->hashtable2,
+                                  lookup->hashsize * sizeof(Int4)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->next_pos, copy->next_pos,
+                                  (kQueryLength + 1) * sizeof(Int4)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->next_pos2, copy->next_pos2,
+                                  (kQueryLength + 1) * sizeof(Int4)));
+    BOOST_REQUIRE_EQUAL(0, memcmp(lookup->pv_array, copy->pv_array,
+                          (lookup->hashsize >> lookup->pv_array_bts) *
+                          sizeof(PV_ARRAY_TYPE)));
+    copy = BlastMBLookupTableDestruct(copy);
+
+    // a truncated image is rejected
+    BOOST_REQUIRE(BlastMBLookupTableDeserialize(&image[0], image_size / 2,
+                                                &copy) != 0);
+    BOOST_REQUIRE(copy == NULL);
+
+    lookup_wrap_ptr = LookupTableWrapFree(lookup_wrap_ptr);
+    lookup_options = LookupTableOptionsFree(lookup_options);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /*
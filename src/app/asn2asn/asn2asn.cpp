@@ -418,6 +418,9 @@ void CAsn2Asn::Init(void)
     d->AddDefaultKey("tc", "threadCount",
                       "perform command in <threadCount> thread",
                       CArgDescriptions::eInteger, "1");
+    d->AddDefaultKey("wt", "writeThreads",
+                      "write output Seq-entries in <writeThreads> threads",
+                      CArgDescriptions::eInteger, "1");
     d->AddFlag("m",
                "Input file contains multiple objects");
     
@@ -986,6 +989,7 @@ void CAsn2Asn::RunAsn2Asn(const string& outFileSuffix)
     bool reset_output = true;
 
     size_t count = args["c"].AsInteger();
+    int writeThreads = args["wt"].AsInteger();
 
     GUARD.Release();
     
@@ -1031,6 +1035,9 @@ void CAsn2Asn::RunAsn2Asn(const string& outFileSuffix)
                     }
                 }
                 out.reset(CObjectOStream::Open(outFormat, *out_byte_stream));
+                if ( writeThreads > 1 ) {
+                    out->SetWriteThreads(writeThreads);
+                }
             }
             
             /* read one Seq-entry or Seq-submit */
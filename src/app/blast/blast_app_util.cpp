@@ -52,6 +52,7 @@
 #include <serial/typeinfo.hpp>      // for CTypeInfo, needed by SerialClone
 #include <objtools/data_loaders/blastdb/bdbloader_rmt.hpp>
 #include <algo/blast/format/blast_format.hpp>
+#include <algo/blast/format/blast_async_format.hpp>
 #include <objtools/align_format/format_flags.hpp>
 
 #if defined(NCBI_OS_LINUX) && HAVE_MALLOC_H
@@ -1027,4 +1028,78 @@ void CheckMTByQueries_QuerySize(EProgram prog, int batch_size)
     ERR_POST(Warning << warning);
 }
 
+bool UsePipelinedFormatting(const CFormattingArgs & fmt_args,
+                            const CArgs & args, bool is_remote)
+{
+	if (is_remote || fmt_args.ArchiveFormatRequested(args)) {
+		return false;
+	}
+	// CBlastFormat::ResetScopeHistory() keeps the scope only for XML
+	if (fmt_args.GetFormattedOutputChoice() != CFormattingArgs::eXml) {
+		return false;
+	}
+	const char * pipeline_env = getenv("BLAST_PIPELINE_FORMAT");
+	if (pipeline_env == NULL || NStr::IsBlank(pipeline_env)) {
+		return false;
+	}
+	return NStr::StringToBool(pipeline_env);
+}
+
+CBatchFormatPipeline::CBatchFormatPipeline(CBlastFormat & formatter,
+                                           CRef<CScope> scope,
+                                           CFormattingArgs::EOutputFormat format_type)
+    : m_Formatter(formatter), m_Scope(scope), m_FormatType(format_type),
+      m_Thread(new CBlastAsyncFormatThread()), m_NumBatches(0)
+{
+	m_Thread->Run();
+}
+
+CBatchFormatPipeline::~CBatchFormatPipeline()
+{
+	try {
+		Finish();
+	}
+	catch (CException & e) {
+		ERR_POST(Error << "Failed to finish formatting: " << e.GetMsg());
+	}
+}
+
+void CBatchFormatPipeline::Format(CRef<CBlastQueryVector> queries,
+                                  CRef<CSearchResultSet> results)
+{
+	_ASSERT(m_Thread.NotEmpty());
+	if (m_NumBatches > 0) {
+		// The formatter and the scope are not used concurrently with
+		// prefetching: wait for the previous batch.  The scope is not reset
+		// here, it already holds the queries of this batch.
+		m_Thread->WaitForBatch(m_NumBatches - 1);
+	}
+	BlastFormatter_PreFetchSequenceData(*results, m_Scope, m_FormatType);
+
+	vector<SFormatResultValues> values;
+	values.push_back(SFormatResultValues(queries, results,
+	                                     CRef<CBlastFormat>(&m_Formatter)));
+	m_Thread->QueueResults(m_NumBatches, values);
+	m_NumBatches++;
+}
+
+void CBatchFormatPipeline::ResetScopeHistory()
+{
+	// Formats other than XML drop all the data from the scope, including
+	// the queries and subjects of the batch still being printed.
+	if (m_FormatType != CFormattingArgs::eXml && m_Thread.NotEmpty() &&
+	    m_NumBatches > 0) {
+		m_Thread->WaitForBatch(m_NumBatches - 1);
+	}
+	m_Formatter.ResetScopeHistory();
+}
+
+void CBatchFormatPipeline::Finish()
+{
+	if (m_Thread.NotEmpty()) {
+		m_Thread->Join();
+		m_Thread.Reset();
+	}
+}
+
 END_NCBI_SCOPE
@@ -51,8 +51,12 @@
 #include <algo/blast/blastinput/blast_scope_src.hpp>    // for SDataLoaderConfig
 #include <algo/blast/api/blast_usage_report.hpp>
 
+class CBlastAsyncFormatThread;
+
 BEGIN_NCBI_SCOPE
 
+class CBlastFormat;
+
 /// Class to mix batch size for BLAST runs
 class CBatchSizeMixer 
 {
@@ -341,6 +345,67 @@ int GetMTByQueriesBatchSize(blast::EProgram p, int num_threads, const string & t
 void MTByQueries_DBSize_Warning(const Int8 length_limit, bool is_db_protein);
 void CheckMTByQueries_QuerySize(blast::EProgram prog, int batch_size);
 
+/// Returns true if the results of consecutive query batches should be
+/// formatted on a separate thread while the next batch is searched
+/// (enabled by setting the BLAST_PIPELINE_FORMAT environment variable).
+/// Archive format and remote searches are never pipelined, nor are the
+/// output formats for which the scope is reset between the batches (all
+/// but XML): the data of the batch being printed would be dropped.
+/// @param fmt_args formatting arguments [in]
+/// @param args command line arguments [in]
+/// @param is_remote true if the search is executed remotely [in]
+bool UsePipelinedFormatting(const blast::CFormattingArgs & fmt_args,
+                            const CArgs & args, bool is_remote);
+
+/// Formats the results of query batches on a separate thread, so that
+/// output for a batch is produced while the next batch is being searched.
+/// At most two batches are kept in memory: the one being formatted and the
+/// one being searched.
+class CBatchFormatPipeline
+{
+public:
+    /// Starts the formatting thread
+    /// @param formatter formatter to print results with, must outlive
+    /// this object [in]
+    /// @param scope scope shared by the query input and the formatter [in]
+    /// @param format_type  Blast output fomat type [in]
+    CBatchFormatPipeline(CBlastFormat & formatter,
+                         CRef<objects::CScope> scope,
+                         blast::CFormattingArgs::EOutputFormat format_type);
+
+    /// Waits for all queued batches to be printed
+    ~CBatchFormatPipeline();
+
+    /// Queue the results of one batch for printing.
+    /// Blocks until the previously queued batch has been printed, then
+    /// prefetches the sequence data needed for this batch.
+    /// @param queries queries of the batch [in]
+    /// @param results results of the batch [in]
+    void Format(CRef<blast::CBlastQueryVector> queries,
+                CRef<blast::CSearchResultSet> results);
+
+    /// Releases the sequence data with CBlastFormat::ResetScopeHistory().
+    /// Must be called before the next batch is loaded, never between loading
+    /// and formatting a batch. If the formatter drops the data from the
+    /// scope, waits for all queued batches to be printed first.
+    void ResetScopeHistory();
+
+    /// Waits for all queued batches to be printed and stops the thread.
+    /// Must be called before the formatter's epilog is printed.
+    void Finish();
+
+private:
+    CBlastFormat & m_Formatter;
+    CRef<objects::CScope> m_Scope;
+    blast::CFormattingArgs::EOutputFormat m_FormatType;
+    CRef<CBlastAsyncFormatThread> m_Thread;
+    int m_NumBatches;
+
+    // Prohibit copy constructor and assignment operator
+    CBatchFormatPipeline(const CBatchFormatPipeline&);
+    CBatchFormatPipeline& operator= (const CBatchFormatPipeline&);
+};
+
 END_NCBI_SCOPE
 
 #endif /* APP__BLAST_APP_UTIL__HPP */
@@ -274,7 +274,13 @@ int CBlastnApp::x_RunMTBySplitDB()
         }
 	BLAST_PROF_ADD( BATCH_SIZE, (int)input.GetBatchSize() );
 	BLAST_PROF_STOP( APP.PRE );
-        for (; !input.End(); formatter.ResetScopeHistory(), QueryBatchCleanup() ) {
+        unique_ptr<CBatchFormatPipeline> fmt_pipeline;
+        if (UsePipelinedFormatting(*fmt_args, args,
+                                   m_CmdLineArgs->ExecuteRemotely())) {
+            fmt_pipeline.reset(new CBatchFormatPipeline(formatter, scope,
+                                   fmt_args->GetFormattedOutputChoice()));
+        }
+        for (; !input.End(); QueryBatchCleanup()) {
 	    BLAST_PROF_START( APP.LOOP.PRE );
             CRef<CBlastQueryVector> query_batch(input.GetNextSeqBatch(*scope));
             if (query_batch->Empty())  continue;
@@ -305,6 +311,8 @@ int CBlastnApp::x_RunMTBySplitDB()
             if (isArchiveFormat) {
                 formatter.WriteArchive(*queries, *m_OptsHndl, *results, 0, m_Bah.GetMessages());
                 m_Bah.ResetMessages();
+            } else if (fmt_pipeline) {
+                fmt_pipeline->Format(query_batch, results);
             } else {
                 BlastFormatter_PreFetchSequenceData(*results, scope,
                 			                        fmt_args->GetFormattedOutputChoice());
@@ -314,6 +322,15 @@ int CBlastnApp::x_RunMTBySplitDB()
             }
 	    BLAST_PROF_STOP( APP.LOOP.FMT );
 	    batch_num++;
+            // Release the data before the next batch is loaded
+            if (fmt_pipeline) {
+                fmt_pipeline->ResetScopeHistory();
+            } else {
+                formatter.ResetScopeHistory();
+            }
+        }
+        if (fmt_pipeline) {
+            fmt_pipeline->Finish();
         }
         BLAST_PROF_START( APP.POST );
         formatter.PrintEpilog(opt);
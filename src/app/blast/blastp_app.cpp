@@ -254,7 +254,13 @@ int CBlastpApp::x_RunMTBySplitDB()
 
 	BLAST_PROF_ADD( BATCH_SIZE, (int)input.GetBatchSize() );
         /*** Process the input ***/
-        for (; !input.End(); formatter.ResetScopeHistory(), QueryBatchCleanup()) {
+        unique_ptr<CBatchFormatPipeline> fmt_pipeline;
+        if (UsePipelinedFormatting(*fmt_args, args,
+                                   m_CmdLineArgs->ExecuteRemotely())) {
+            fmt_pipeline.reset(new CBatchFormatPipeline(formatter, scope,
+                                   fmt_args->GetFormattedOutputChoice()));
+        }
+        for (; !input.End(); QueryBatchCleanup()) {
 	    BLAST_PROF_START( APP.LOOP.PRE );
             CRef<CBlastQueryVector> query_batch(input.GetNextSeqBatch(*scope));
             if (query_batch->Empty())  continue;
@@ -281,6 +287,8 @@ int CBlastpApp::x_RunMTBySplitDB()
             if (fmt_args->ArchiveFormatRequested(args)) {
                 formatter.WriteArchive(*queries, *m_OptsHndl, *results,  0, m_Bah.GetMessages());
                 m_Bah.ResetMessages();
+            } else if (fmt_pipeline) {
+                fmt_pipeline->Format(query_batch, results);
             } else {
                 BlastFormatter_PreFetchSequenceData(*results, scope,
                 		                            fmt_args->GetFormattedOutputChoice());
@@ -290,6 +298,15 @@ int CBlastpApp::x_RunMTBySplitDB()
             }
 	    BLAST_PROF_STOP( APP.LOOP.FMT );
 	    batch_num++;
+            // Release the data before the next batch is loaded
+            if (fmt_pipeline) {
+                fmt_pipeline->ResetScopeHistory();
+            } else {
+                formatter.ResetScopeHistory();
+            }
+        }
+        if (fmt_pipeline) {
+            fmt_pipeline->Finish();
         }
 
         BLAST_PROF_START( APP.POST );
@@ -0,0 +1,53 @@
+#! /bin/sh
+# $Id$
+#
+# Checks that formatting the query batches on a separate thread
+# (BLAST_PIPELINE_FORMAT) produces the same output as sequential formatting.
+# Each query goes to its own batch (BATCH_SIZE), so the formatter's scope
+# history is reset between the batches.  Only XML output is pipelined, the
+# other formats check that the variable does not change their output.
+
+if ! makeblastdb -version > /dev/null 2>&1 ; then
+    echo "makeblastdb is not available; test skipped"
+    exit 0
+fi
+
+TMP=`mktemp -d ${TMPDIR:-/tmp}/blastp_pipeline_test.XXXXXX` || exit 1
+trap 'rm -rf "$TMP"' 0 1 2 15
+
+cat > $TMP/db.fa <<'FASTA'
+>db1 first subject
+MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSGAEKAVQVKVKALPDAQ
+>db2 second subject
+MSDNGPQNQRNAPRITFGGPSDSTGSNQNGERSGARSKQRRPQGLPNNTASWFTALTQHGKEDLKF
+>db3 third subject
+MVLSPADKTNVKAAWGKVGAHAGEYGAEALERMFLSFPTTKTYFPHFDLSHGSAQVKGHGKKVADAL
+>db4 fourth subject
+MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSGAEKAVQVKVKALPDAQF
+FASTA
+
+cat > $TMP/query.fa <<'FASTA'
+>q1
+MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSGAEKAVQ
+>q2
+MSDNGPQNQRNAPRITFGGPSDSTGSNQNGERSGARSKQRRPQGLPNNTASWFTA
+>q3
+MVLSPADKTNVKAAWGKVGAHAGEYGAEALERMFLSFPTTKTYFPHFDLSHGSAQ
+FASTA
+
+makeblastdb -in $TMP/db.fa -dbtype prot -out $TMP/db > /dev/null || exit 1
+
+RETVAL=0
+for fmt in 0 5 6 ; do
+    BATCH_SIZE=1 ./blastp -query $TMP/query.fa -db $TMP/db -outfmt $fmt \
+        -out $TMP/seq.$fmt || exit 1
+    BATCH_SIZE=1 BLAST_PIPELINE_FORMAT=1 ./blastp -query $TMP/query.fa \
+        -db $TMP/db -outfmt $fmt -out $TMP/pipe.$fmt || exit 1
+    if ! cmp -s $TMP/seq.$fmt $TMP/pipe.$fmt ; then
+        echo "Pipelined output differs for -outfmt $fmt:"
+        diff $TMP/seq.$fmt $TMP/pipe.$fmt
+        RETVAL=1
+    fi
+done
+
+exit $RETVAL
@@ -371,6 +371,9 @@ CBlastDBCmdApp::x_InitBlastDB_TaxIdList()
 }
 
 
+/// Number of -entry_batch entries whose sequence data is prefetched at once
+static const size_t kBatchPrefetchSize = 4096;
+
 int
 CBlastDBCmdApp::x_ProcessBatchEntry_NoDup(CBlastDB_Formatter & fmt)
 {
@@ -406,7 +409,7 @@ CBlastDBCmdApp::x_ProcessBatchEntry_NoDup(CBlastDB_Formatter & fmt)
     		NCBI_RETHROW_SAME(e, e.GetMsg());
     	}
     }
-    for(unsigned i=0; i < ids.size(); i++) {
+    for(unsigned i=0; i < oids.size(); i++) {
     	if(oids[i] == kSeqDBEntryNotFound) {
     		TGi num_id = NStr::StringToNumeric<TGi>(ids[i], NStr::fConvErr_NoThrow);
     		if(!errno) {
@@ -416,11 +419,27 @@ CBlastDBCmdApp::x_ProcessBatchEntry_NoDup(CBlastDB_Formatter & fmt)
     				oids[i] = gi_oid;
     			}
     		}
-    		if(oids[i] == kSeqDBEntryNotFound) {
-    			err_found ++;
-    			ERR_POST (Error << "Skipped " << ids[i]);
-    			continue;
+    	}
+    }
+    for(unsigned i=0; i < ids.size(); i++) {
+    	// Let the formatter fetch the sequence data of the next block of
+    	// entries in file order, instead of faulting it in one sequence
+    	// at a time in the order of the input file.
+    	if (i % kBatchPrefetchSize == 0 && i < oids.size()) {
+    		vector<CSeqDB::TOID> block;
+    		vector<TSeqRange> ranges;
+    		for (size_t j = i; j < min<size_t>(i + kBatchPrefetchSize, oids.size()); j++) {
+    			if(oids[j] != kSeqDBEntryNotFound && !x_ModifyConfigForBatchEntry(formats[j])) {
+    				block.push_back(oids[j]);
+    				ranges.push_back(m_Config.m_SeqRange);
+    			}
     		}
+    		fmt.Prefetch(block, ranges);
+    	}
+    	if(oids[i] == kSeqDBEntryNotFound) {
+    		err_found ++;
+    		ERR_POST (Error << "Skipped " << ids[i]);
+    		continue;
     	}
     	if(x_ModifyConfigForBatchEntry(formats[i]))  {
     		err_found ++;
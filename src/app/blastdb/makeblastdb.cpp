@@ -253,6 +253,13 @@ void CMakeBlastDBApp::Init()
     arg_desc->AddFlag("randomize",
                       "Randomize input db seqs", true,  CArgDescriptions::fHidden);
 
+    arg_desc->AddDefaultKey("num_threads", "int_value",
+                            "Number of threads used to convert sequences "
+                            "(requires OpenMP)",
+                            CArgDescriptions::eInteger, "1");
+    arg_desc->SetConstraint("num_threads",
+                            new CArgAllowValuesGreaterThanOrEqual(1));
+
 #if ((!defined(NCBI_COMPILER_WORKSHOP) || (NCBI_COMPILER_VERSION  > 550)) && \
      (!defined(NCBI_COMPILER_MIPSPRO)) )
     arg_desc->SetCurrentGroup("Sequence masking options");
@@ -1253,6 +1260,10 @@ void CMakeBlastDBApp::x_BuildDatabase()
 
     m_DB->SetMaxFileSize(bytes);
 
+    if (args["num_threads"].AsInteger() > 1) {
+        m_DB->SetNumThreads(args["num_threads"].AsInteger());
+    }
+
     if (args["taxid"].HasValue()) {
         _ASSERT( !args["taxid_map"].HasValue() );
         CRef<CTaxIdSet> taxids(new CTaxIdSet(TAX_ID_FROM(int, args["taxid"].AsInteger())));
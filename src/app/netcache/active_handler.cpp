@@ -900,12 +900,17 @@ CNCActiveHandler::SyncStart(CNCActiveSyncControl* ctrl,
     m_CmdToSend += NStr::UInt8ToString(local_rec_no);
     m_CmdToSend.append(1, ' ');
     m_CmdToSend += NStr::UInt8ToString(remote_rec_no);
+    if (m_Peer->AcceptsSyncTree()) {
+        // we can take hash tree instead of full list of blobs
+        m_CmdToSend += " 1";
+    }
 
     x_SetStateAndStartProcessing(&CNCActiveHandler::x_SendCmdToExecute);
 }
 
 void
-CNCActiveHandler::SyncBlobsList(CNCActiveSyncControl* ctrl)
+CNCActiveHandler::SyncBlobsList(CNCActiveSyncControl* ctrl,
+                                const TNCSyncTreeLeaves* leaves)
 {
     m_SyncAction = eSynActionNone;
     m_SyncCtrl = ctrl;
@@ -917,6 +922,15 @@ CNCActiveHandler::SyncBlobsList(CNCActiveSyncControl* ctrl)
     m_CmdToSend += NStr::UInt8ToString(CNCDistributionConf::GetSelfID());
     m_CmdToSend.append(1, ' ');
     m_CmdToSend += NStr::UIntToString(ctrl->GetSyncSlot());
+    if (leaves) {
+        m_CmdToSend += " \"";
+        ITERATE(TNCSyncTreeLeaves, it, *leaves) {
+            if (it != leaves->begin())
+                m_CmdToSend.append(1, ',');
+            m_CmdToSend += NStr::UIntToString(*it);
+        }
+        m_CmdToSend.append(1, '"');
+    }
 
     x_SetStateAndStartProcessing(&CNCActiveHandler::x_SendCmdToExecute);
 }
@@ -1753,7 +1767,12 @@ CNCActiveHandler::x_ReadSyncStartAnswer(void)
     bool by_blobs = m_CurCmd  == eSyncBList
                     ||  NStr::FindCase(m_Response, "ALL_BLOBS") != NPOS;
 
-    m_SyncCtrl->StartResponse(local_rec_no, remote_rec_no, by_blobs);
+    if (m_CurCmd == eSyncBList)
+        m_SyncCtrl->BlobsListResponse(remote_rec_no);
+    else
+        m_SyncCtrl->StartResponse(local_rec_no, remote_rec_no, by_blobs);
+    if (by_blobs  &&  NStr::FindCase(m_Response, "HASH_TREE") != NPOS)
+        return &CNCActiveHandler::x_ReadSyncTree;
     if (by_blobs)
         return &CNCActiveHandler::x_ReadBlobsListKeySize;
     else
@@ -1916,6 +1935,29 @@ CNCActiveHandler::x_ReadBlobsListBody(void)
     return &CNCActiveHandler::x_ReadBlobsListKeySize;
 }
 
+CNCActiveHandler::State
+CNCActiveHandler::x_ReadSyncTree(void)
+{
+    if (m_Proxy->NeedEarlyClose())
+        return &CNCActiveHandler::x_CloseCmdAndConn;
+
+    Uint8 leaf = 0;
+    while (m_SizeToRead >= sizeof(leaf)) {
+        if (!m_Proxy->ReadNumber(&leaf))
+            return NULL;
+        m_SizeToRead -= sizeof(leaf);
+        if (!m_SyncCtrl->AddStartTreeLeaf(leaf)) {
+            x_FinishSyncCmd(eSynAborted, NC_SYNC_HINT);
+            return &CNCActiveHandler::x_FinishCommand;
+        }
+    }
+    if (m_SizeToRead != 0)
+        return &CNCActiveHandler::x_ProcessProtocolError;
+
+    x_FinishSyncCmd(eSynOK, NC_SYNC_HINT);
+    return &CNCActiveHandler::x_ReadSyncStartExtra;
+}
+
 CNCActiveHandler::State
 CNCActiveHandler::x_SendSyncGetCmd(void)
 {
@@ -2305,10 +2347,24 @@ CNCActiveHandler::x_WriteBlobData(void)
             m_ErrMsg = "ERR:Blob data is corrupted";
             return &CNCActiveHandler::x_CloseCmdAndConn;
         }
+        if (want_read == 0)
+            return NULL;
         if (m_ChunkSize < want_read)
             want_read = m_ChunkSize;
 
-        Uint4 n_written = Uint4(m_Proxy->Write(m_BlobAccess->GetReadMemPtr(), want_read));
+        Uint8 sendfile_size = CNCBlobStorage::GetSendFileMinSize();
+        int file_fd = -1;
+        Uint8 file_pos = 0;
+        Uint4 n_written;
+        if (sendfile_size != 0
+            &&  m_BlobAccess->GetCurBlobSize() >= sendfile_size
+            &&  m_BlobAccess->GetReadFileRange(file_fd, file_pos))
+        {
+            n_written = Uint4(m_Proxy->WriteFile(file_fd, file_pos, want_read));
+        }
+        else {
+            n_written = Uint4(m_Proxy->Write(m_BlobAccess->GetReadMemPtr(), want_read));
+        }
         if (n_written != 0)
             CNCStat::PeerDataRead(n_written);
         if (m_Proxy->NeedEarlyClose()  ||  (m_CmdFromClient  &&  !m_Client))
@@ -224,7 +224,10 @@ public:
     bool GotClientResponse(void);
 
     void SyncStart(CNCActiveSyncControl* ctrl, Uint8 local_rec_no, Uint8 remote_rec_no);
-    void SyncBlobsList(CNCActiveSyncControl* ctrl);
+    /// Request list of blobs in the slot. If leaves is not NULL then only
+    /// blobs from given leaves of the synchronization hash tree are listed.
+    void SyncBlobsList(CNCActiveSyncControl* ctrl,
+                       const TNCSyncTreeLeaves* leaves = NULL);
     void SyncSend(CNCActiveSyncControl* ctrl, SNCSyncEvent* event);
     void SyncSend(CNCActiveSyncControl* ctrl, const CNCBlobKeyLight& key);
     void SyncRead(CNCActiveSyncControl* ctrl, SNCSyncEvent* event);
@@ -332,6 +335,7 @@ private:
     State x_ReadEventsListBody(void);
     State x_ReadBlobsListKeySize(void);
     State x_ReadBlobsListBody(void);
+    State x_ReadSyncTree(void);
     State x_SendSyncGetCmd(void);
     State x_ReadSyncGetHeader(void);
     State x_ReadSyncGetAnswer(void);
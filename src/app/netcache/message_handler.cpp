@@ -983,7 +983,11 @@ static CNCMessageHandler::SCommandDef s_CommandMap[] = {
     // sync logs of this server which need to be synchronized. Or if this
     // server understands that synchronization using blob lists is needed then
     // first line of response will contain ALL_BLOBS word and then full list
-    // of blobs in this slot will be sent.
+    // of blobs in this slot will be sent. If command version is 1 then
+    // instead of full list of blobs the response contains words
+    // ALL_BLOBS,HASH_TREE and leaves of the synchronization hash tree of the
+    // slot, so that only blobs from leaves that differ are requested later
+    // by SYNC_BLIST.
     { "SYNC_START",
         {&CNCMessageHandler::x_DoCmd_SyncStart,
             "SYNC_START",
@@ -1000,7 +1004,11 @@ static CNCMessageHandler::SCommandDef s_CommandMap[] = {
           { "rec_my",  eNSPT_Int,  eNSPA_Required },
           // Last synchronized record number (in sync log) of _this_ server
           // as _that_ server thinks.
-          { "rec_your",eNSPT_Int,  eNSPA_Required } } },
+          { "rec_your",eNSPT_Int,  eNSPA_Required },
+          // Version of the command. Added in 6.11.8, 1 means that server
+          // starting synchronization accepts hash tree instead of full list
+          // of blobs.
+          { "cmd_ver", eNSPT_Int,  eNSPA_Optional, "0" } } },
     // Get full list of blobs for the slot. Command is sent only by other NC
     // servers when that server decides that synchronization using blob lists
     // is needed. Command can be sent only after successful execution of
@@ -1012,7 +1020,10 @@ static CNCMessageHandler::SCommandDef s_CommandMap[] = {
           // Server id of the server managing the synchronization.
         { { "srv_id",  eNSPT_Int,  eNSPA_Required },
           // Slot that synchronization is started on.
-          { "slot",    eNSPT_Int,  eNSPA_Required } } },
+          { "slot",    eNSPT_Int,  eNSPA_Required },
+          // Comma-separated list of leaves of the synchronization hash tree
+          // to list blobs from. Added in 6.11.8.
+          { "leaves",  eNSPT_Str,  eNSPA_Optional } } },
     // Write blob contents. This command is sent only by other NC servers
     // during synchronization session if some blob was written on that server
     // and the same data didn't make it to this server yet.
@@ -1963,6 +1974,7 @@ CNCMessageHandler::x_AssignCmdParams(void)
     m_ForceLocal = false;
     m_AgeMax = m_AgeCur = 0;
     m_SlotsDone.clear();
+    m_SyncLeaves.clear();
     m_CmdParams.clear();
     bool quorum_was_set = false;
     bool search_was_set = false;
@@ -2096,6 +2108,13 @@ CNCMessageHandler::x_AssignCmdParams(void)
                 else if (key == "local") {
                     m_ForceLocal = val == "1";
                 }
+                else if (key == "leaves") {
+                    list<CTempString> leaves;
+                    ncbi_NStr_Split(val, ",", leaves);
+                    ITERATE(list<CTempString>, it_leaf, leaves) {
+                        m_SyncLeaves.insert(NStr::StringToUInt(*it_leaf));
+                    }
+                }
                 break;
             case 'm':
                 if (key == "md5_pass") {
@@ -3432,10 +3451,24 @@ CNCMessageHandler::x_WriteBlobData(void)
             GetDiagCtx()->SetRequestStatus(eStatus_ServerError);
             return &CNCMessageHandler::x_CloseCmdAndConn;
         }
+        if (want_read == 0)
+            return NULL;
         if (m_Size != Uint8(-1)  &&  m_Size < want_read)
             want_read = Uint4(m_Size);
 
-        Uint4 n_written = Uint4(Write(m_BlobAccess->GetReadMemPtr(), want_read));
+        Uint8 sendfile_size = CNCBlobStorage::GetSendFileMinSize();
+        int file_fd = -1;
+        Uint8 file_pos = 0;
+        Uint4 n_written;
+        if (sendfile_size != 0
+            &&  m_BlobAccess->GetCurBlobSize() >= sendfile_size
+            &&  m_BlobAccess->GetReadFileRange(file_fd, file_pos))
+        {
+            n_written = Uint4(WriteFile(file_fd, file_pos, want_read));
+        }
+        else {
+            n_written = Uint4(Write(m_BlobAccess->GetReadMemPtr(), want_read));
+        }
 //        x_LogCmdEvent("Write");
         if (n_written != 0) {
             if (m_Flags & fComesFromClient)
@@ -4474,11 +4507,22 @@ CNCMessageHandler::x_DoCmd_IC_Store(void)
 }
 
 void
-CNCMessageHandler::x_WriteFullBlobsList(void)
+CNCMessageHandler::x_WriteSyncTree(void)
+{
+    LOG_CURRENT_FUNCTION
+    TNCSyncTree tree;
+    CNCBlobStorage::GetSyncTree(m_Slot, tree);
+    m_SendBuff.reset(new TNCBufferType());
+    m_SendBuff->append(tree.data(), tree.size() * sizeof(tree[0]));
+}
+
+void
+CNCMessageHandler::x_WriteFullBlobsList(const TNCSyncTreeLeaves* leaves)
 {
     LOG_CURRENT_FUNCTION
     TNCBlobSumList blobs_list;
-    CNCBlobStorage::GetFullBlobsList(m_Slot, blobs_list, CNCPeerControl::Peer(m_SrvId));
+    CNCBlobStorage::GetFullBlobsList(m_Slot, blobs_list,
+                                     CNCPeerControl::Peer(m_SrvId), leaves);
     m_SendBuff.reset(new TNCBufferType());
     m_SendBuff->reserve_mem(blobs_list.size() * 200);
     NON_CONST_ITERATE(TNCBlobSumList, it_blob, blobs_list) {
@@ -4583,10 +4627,16 @@ CNCMessageHandler::x_DoCmd_SyncStart(void)
     else {
         _ASSERT(sync_res == eProceedWithBlobs);
         m_LocalRecNo = CNCSyncLog::GetCurrentRecNo(m_Slot);
-        x_WriteFullBlobsList();
         GetDiagCtx()->SetRequestStatus(eStatus_SyncBList);
         x_SetFlag(fSyncCmdSuccessful);
         result += "ALL_BLOBS,";
+        if (m_CmdVersion >= 1) {
+            x_WriteSyncTree();
+            result += "HASH_TREE,";
+        }
+        else {
+            x_WriteFullBlobsList();
+        }
     }
 
     if (NeedEarlyClose())
@@ -4607,7 +4657,7 @@ CNCMessageHandler::x_DoCmd_SyncBlobsList(void)
     LOG_CURRENT_FUNCTION
     CNCPeriodicSync::MarkCurSyncByBlobs(m_SrvId, m_Slot, m_SyncId);
     Uint8 rec_no = CNCSyncLog::GetCurrentRecNo(m_Slot);
-    x_WriteFullBlobsList();
+    x_WriteFullBlobsList(m_SyncLeaves.empty()? NULL: &m_SyncLeaves);
 
     if (NeedEarlyClose())
         return &CNCMessageHandler::x_CloseCmdAndConn;
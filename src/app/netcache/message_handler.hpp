@@ -34,6 +34,7 @@
 #include <connect/services/netservice_protocol_parser.hpp>
 
 #include "nc_utils.hpp"
+#include "nc_db_info.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -291,7 +292,8 @@ private:
 
     void x_ProlongBlobDeadTime(unsigned int add_time);
     void x_ProlongVersionLife(void);
-    void x_WriteFullBlobsList(void);
+    void x_WriteFullBlobsList(const TNCSyncTreeLeaves* leaves = NULL);
+    void x_WriteSyncTree(void);
     void x_GetCurSlotServers(void);
 
     void x_JournalBlobPutResult(int status, const string& blob_key, Uint2 blob_slot);
@@ -381,6 +383,7 @@ private:
     Uint8                     m_AgeCur;
     SNCBlobFilter*            m_BlobFilter;
     set<Uint2>                m_SlotsDone;
+    TNCSyncTreeLeaves         m_SyncLeaves;
 
     string m_PosponedCmd;
     enum EHttpMode {
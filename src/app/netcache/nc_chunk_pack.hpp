@@ -0,0 +1,195 @@
+#ifndef NETCACHE__NC_CHUNK_PACK__HPP
+#define NETCACHE__NC_CHUNK_PACK__HPP
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: zstd compression of blob chunks in NetCache storage
+ *
+ * Packer doesn't depend on the rest of the storage, so that it can be
+ * tested separately from the server.
+ */
+
+#include <corelib/ncbistd.hpp>
+
+#ifdef HAVE_LIBZSTD
+# include <zstd.h>
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// Chunks smaller than that are never compressed
+static const Uint4 kNCMinPackSize = 512;
+
+
+/// Compression and decompression contexts of one thread together with
+/// the buffer for compressed data. Contexts are created on first use.
+class CNCChunkPacker
+{
+public:
+    /// @param max_chunk_size
+    ///   Maximum size of the chunk that will be given to Pack()
+    CNCChunkPacker(Uint4 max_chunk_size);
+    ~CNCChunkPacker(void);
+
+    /// Whether NetCache is built with compression support
+    static bool IsSupported(void);
+
+    /// Compress the chunk if the result is at least min_gain percent
+    /// smaller than the original. Returns pointer to the compressed data
+    /// (valid until next call to Pack()) or NULL if chunk should be
+    /// stored as is.
+    const char* Pack(const char* data, Uint4 size, int level, int min_gain,
+                     Uint4& packed_size);
+    /// Decompress the chunk into the buffer. Returns false and the reason
+    /// in error if data is damaged or doesn't fit into the buffer.
+    bool Unpack(const char* data, Uint4 data_size,
+                char* buffer, Uint4 buf_size,
+                Uint4& unpacked_size, string& error);
+    /// Size of the original data of compressed chunk or 0 if it's not
+    /// known.
+    static Uint8 GetUnpackedSize(const char* data, Uint4 data_size);
+
+private:
+    CNCChunkPacker(const CNCChunkPacker&);
+    CNCChunkPacker& operator= (const CNCChunkPacker&);
+
+    Uint4 m_MaxChunkSize;
+    char* m_Buf;
+#ifdef HAVE_LIBZSTD
+    ZSTD_CCtx* m_CCtx;
+    ZSTD_DCtx* m_DCtx;
+#endif
+};
+
+
+
+//////////////////////////////////////////////////////////////////////////
+// Inline functions
+//////////////////////////////////////////////////////////////////////////
+
+inline
+CNCChunkPacker::CNCChunkPacker(Uint4 max_chunk_size)
+    : m_MaxChunkSize(max_chunk_size),
+      m_Buf(NULL)
+#ifdef HAVE_LIBZSTD
+      , m_CCtx(NULL),
+      m_DCtx(NULL)
+#endif
+{}
+
+inline
+CNCChunkPacker::~CNCChunkPacker(void)
+{
+#ifdef HAVE_LIBZSTD
+    ZSTD_freeCCtx(m_CCtx);
+    ZSTD_freeDCtx(m_DCtx);
+#endif
+    free(m_Buf);
+}
+
+inline bool
+CNCChunkPacker::IsSupported(void)
+{
+#ifdef HAVE_LIBZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline const char*
+CNCChunkPacker::Pack(const char* data, Uint4 size, int level, int min_gain,
+                     Uint4& packed_size)
+{
+#ifdef HAVE_LIBZSTD
+    if (size < kNCMinPackSize  ||  size > m_MaxChunkSize)
+        return NULL;
+    if (!m_CCtx) {
+        m_CCtx = ZSTD_createCCtx();
+        if (!m_CCtx)
+            return NULL;
+    }
+    if (!m_Buf) {
+        m_Buf = (char*)malloc(m_MaxChunkSize);
+        if (!m_Buf)
+            return NULL;
+    }
+    // Output buffer is limited by minimum acceptable gain, so compression
+    // of data that doesn't compress well fails early.
+    size_t max_size = size - size_t(size) * min_gain / 100;
+    size_t res = ZSTD_compressCCtx(m_CCtx, m_Buf, max_size, data, size, level);
+    if (ZSTD_isError(res)  ||  res >= size)
+        return NULL;
+    packed_size = Uint4(res);
+    return m_Buf;
+#else
+    return NULL;
+#endif
+}
+
+inline bool
+CNCChunkPacker::Unpack(const char* data, Uint4 data_size,
+                       char* buffer, Uint4 buf_size,
+                       Uint4& unpacked_size, string& error)
+{
+#ifdef HAVE_LIBZSTD
+    if (!m_DCtx) {
+        m_DCtx = ZSTD_createDCtx();
+        if (!m_DCtx) {
+            error = "cannot create zstd decompression context";
+            return false;
+        }
+    }
+    size_t res = ZSTD_decompressDCtx(m_DCtx, buffer, buf_size, data, data_size);
+    if (ZSTD_isError(res)) {
+        error = ZSTD_getErrorName(res);
+        return false;
+    }
+    unpacked_size = Uint4(res);
+    return true;
+#else
+    error = "NetCache is built without zstd support";
+    return false;
+#endif
+}
+
+inline Uint8
+CNCChunkPacker::GetUnpackedSize(const char* data, Uint4 data_size)
+{
+#ifdef HAVE_LIBZSTD
+    unsigned long long res = ZSTD_getFrameContentSize(data, data_size);
+    if (res == ZSTD_CONTENTSIZE_UNKNOWN  ||  res == ZSTD_CONTENTSIZE_ERROR)
+        return 0;
+    return res;
+#else
+    return 0;
+#endif
+}
+
+END_NCBI_SCOPE
+
+#endif /* NETCACHE__NC_CHUNK_PACK__HPP */
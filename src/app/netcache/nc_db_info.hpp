@@ -56,6 +56,11 @@ static const Uint2  kNCMaxChunksInMap = 128;
 
 static const Uint1 kNCMaxBlobMapsDepth = 3;
 
+/// Number of leaves in the synchronization hash tree for each time bucket.
+/// Value is a part of the protocol between servers, so all servers in the
+/// cluster should use the same one.
+static const Uint4 kNCSyncTreeLeaves = 256;
+
 // 32740 * 128^3 - 32740 = 68'660'723'740
 const Uint8 kNCLargestBlobSize =
     Uint8(kNCMaxChunksInMap) * Uint8(kNCMaxChunksInMap) * Uint8(kNCMaxChunksInMap) * Uint8(kNCMaxBlobChunkSize) - Uint8(kNCMaxBlobChunkSize);
@@ -125,6 +130,9 @@ public:
     bool    need_stop_write;
     bool    need_mem_release;
     bool    delete_scheduled;
+    /// Blob data turned out to be incompressible, the rest of chunks is
+    /// written without compression.
+    bool    no_packing;
     Uint4   map_move_counter;
     int     last_access_time;
     int     need_write_time;
@@ -287,6 +295,10 @@ class CNCBlobVerManager;
 
 struct SNCBlobSummary;
 typedef map<string, SNCBlobSummary*>   TNCBlobSumList;
+/// Leaves of the synchronization hash tree of the slot
+typedef vector<Uint8>                  TNCSyncTree;
+/// Set of leaf numbers in the synchronization hash tree
+typedef set<Uint4>                     TNCSyncTreeLeaves;
 
 
 
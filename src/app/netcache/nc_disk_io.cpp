@@ -0,0 +1,625 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: asynchronous disk I/O engine for NetCache storage
+ */
+
+#include "nc_pch.hpp"
+
+#include <corelib/ncbireg.hpp>
+
+#include "nc_disk_io.hpp"
+#include "nc_stat.hpp"
+
+#ifdef NCBI_OS_LINUX
+# include <fcntl.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/mman.h>
+# ifdef HAVE_LIBURING
+#  include <liburing.h>
+# endif
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+static const char* kNCDiskIO_RegSection       = "storage";
+static const char* kNCDiskIO_EngineParam      = "disk_io_engine";
+static const char* kNCDiskIO_ThreadsParam     = "disk_io_threads";
+static const char* kNCDiskIO_DepthParam       = "disk_io_queue_depth";
+static const char* kNCDiskIO_ReadAheadParam   = "disk_io_read_ahead";
+static const char* kNCDiskIO_WriteBehindParam = "disk_io_write_behind";
+
+/// Size of memory page, granularity of all disk operations.
+static const size_t kNCPageSize = 4 * 1024;
+static const Uint8  kNCPageAlignMask = ~Uint8(kNCPageSize - 1);
+/// Size of the buffer all reads are made into. Data read is never looked at,
+/// reads are needed only to bring file pages into page cache. So one buffer
+/// shared by all operations is enough.
+static const Uint4 kNCDiskIOBufSize = 1024 * 1024;
+/// Maximum number of pages checked for residency in one call to mincore()
+static const Uint4 kNCDiskIOMaxCheckPages = kNCDiskIOBufSize / kNCPageSize;
+
+
+typedef deque< CSrvRef<SNCDiskIORequest> >  TNCDiskIOQueue;
+
+
+/// Task delivering completions of disk operations into TaskServer.
+/// All bookkeeping of finished requests (including release of references
+/// to SNCDBFileInfo, which can close and delete the file) is done here,
+/// on TaskServer's thread, and never on engine's threads.
+class CNCDiskIOReaper : public CSrvTask
+{
+public:
+    CNCDiskIOReaper(void);
+    virtual ~CNCDiskIOReaper(void);
+
+private:
+    virtual void ExecuteSlice(TSrvThreadNum thr_num);
+};
+
+
+static CNCDiskIO::EEngine s_Engine = CNCDiskIO::eEngineNone;
+static bool  s_WriteBehind = false;
+static Uint4 s_CntThreads = 4;
+static Uint4 s_QueueDepth = 128;
+static Uint4 s_ReadAhead = 256 * 1024;
+static bool  s_Stopping = false;
+static char* s_ReadBuf = NULL;
+static CNCDiskIOReaper* s_Reaper = NULL;
+#ifdef NCBI_OS_LINUX
+static pthread_mutex_t s_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_QueueCond = PTHREAD_COND_INITIALIZER;
+static vector<pthread_t> s_Threads;
+#endif
+/// Requests waiting to be executed
+static TNCDiskIOQueue s_Pending;
+/// Requests executed but not yet processed by CNCDiskIOReaper
+static TNCDiskIOQueue s_Completed;
+#ifdef HAVE_LIBURING
+static struct io_uring s_Ring;
+/// Requests currently submitted to the ring, index in this vector is
+/// user_data of the submission.
+static vector< CSrvRef<SNCDiskIORequest> > s_URingSlots;
+static vector<Uint4> s_URingFreeSlots;
+static const uintptr_t kNCURingStopData = uintptr_t(-1);
+#endif
+
+
+SNCDiskIORequest::SNCDiskIORequest(void)
+    : offset(0),
+      size(0),
+      is_read(true),
+      finished(false),
+      err_code(0),
+      waiter(NULL)
+{}
+
+SNCDiskIORequest::~SNCDiskIORequest(void)
+{}
+
+
+CNCDiskIOReaper::CNCDiskIOReaper(void)
+{
+#if __NC_TASKS_MONITOR
+    m_TaskName = "CNCDiskIOReaper";
+#endif
+}
+
+CNCDiskIOReaper::~CNCDiskIOReaper(void)
+{}
+
+void
+CNCDiskIOReaper::ExecuteSlice(TSrvThreadNum /* thr_num */)
+{
+    TNCDiskIOQueue completed;
+    vector<CSrvTask*> waiters;
+
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    completed.swap(s_Completed);
+    NON_CONST_ITERATE(TNCDiskIOQueue, it, completed) {
+        SNCDiskIORequest* req = *it;
+        req->finished = true;
+        if (req->waiter) {
+            waiters.push_back(req->waiter);
+            req->waiter = NULL;
+        }
+    }
+    pthread_mutex_unlock(&s_Lock);
+#endif
+
+    // Waiters can't be deleted until we return from this slice (see
+    // CSrvTaskTerminator), so it's safe to use them outside of the lock.
+    ITERATE(vector<CSrvTask*>, it, waiters) {
+        (*it)->SetRunnable(true);
+    }
+    NON_CONST_ITERATE(TNCDiskIOQueue, it, completed) {
+        SNCDiskIORequest* req = *it;
+        CSrvTime len = req->end_time;
+        len -= req->start_time;
+        CNCStat::DiskIOFinished(req->is_read, len.AsUSec());
+        if (req->err_code != 0) {
+            SRV_LOG(Error, "Disk " << (req->is_read? "read": "write-out")
+                           << " failed in file " << req->file->file_name
+                           << " at offset " << req->offset
+                           << ", size " << req->size
+                           << ", errno=" << req->err_code);
+        }
+    }
+}
+
+
+/// Record the result of the request and schedule its processing by
+/// CNCDiskIOReaper. Must be called under s_Lock.
+static void
+s_RequestExecuted(SNCDiskIORequest* req, int err_code)
+{
+    req->end_time = CSrvTime::Current();
+    req->err_code = err_code;
+    s_Completed.push_back(CSrvRef<SNCDiskIORequest>(req));
+}
+
+#ifdef NCBI_OS_LINUX
+static int
+s_ExecuteRequest(SNCDiskIORequest* req)
+{
+    int err_code = 0;
+    if (req->is_read) {
+        if (pread(req->file->fd, s_ReadBuf, req->size, off_t(req->offset)) < 0)
+            err_code = errno;
+    }
+    else if (sync_file_range(req->file->fd, off64_t(req->offset),
+                             off64_t(req->size), SYNC_FILE_RANGE_WRITE))
+    {
+        err_code = errno;
+    }
+    return err_code;
+}
+
+static void*
+s_PoolThreadMain(void* /* data */)
+{
+    pthread_mutex_lock(&s_Lock);
+    for (;;) {
+        while (s_Pending.empty()  &&  !s_Stopping)
+            pthread_cond_wait(&s_QueueCond, &s_Lock);
+        if (s_Pending.empty())
+            break;
+
+        CSrvRef<SNCDiskIORequest> req = s_Pending.front();
+        s_Pending.pop_front();
+        pthread_mutex_unlock(&s_Lock);
+
+        int err_code = s_ExecuteRequest(req);
+
+        pthread_mutex_lock(&s_Lock);
+        // Our reference is dropped while s_Completed still holds another
+        // one, so the request (and the file it references) is never
+        // destroyed on this thread.
+        s_RequestExecuted(req, err_code);
+        req.Reset();
+        pthread_mutex_unlock(&s_Lock);
+        s_Reaper->SetRunnable();
+        pthread_mutex_lock(&s_Lock);
+    }
+    pthread_mutex_unlock(&s_Lock);
+    return NULL;
+}
+#endif
+
+#ifdef HAVE_LIBURING
+/// Put request into the io_uring submission queue.
+/// Must be called under s_Lock.
+static bool
+s_URingSubmit(const CSrvRef<SNCDiskIORequest>& req)
+{
+    if (s_URingFreeSlots.empty())
+        return false;
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&s_Ring);
+    if (!sqe)
+        return false;
+
+    Uint4 slot = s_URingFreeSlots.back();
+    s_URingFreeSlots.pop_back();
+    s_URingSlots[slot] = req;
+    if (req->is_read) {
+        io_uring_prep_read(sqe, req->file->fd, s_ReadBuf, req->size, req->offset);
+    }
+    else {
+        io_uring_prep_sync_file_range(sqe, req->file->fd, req->size,
+                                      req->offset, SYNC_FILE_RANGE_WRITE);
+    }
+    io_uring_sqe_set_data(sqe, (void*)uintptr_t(slot));
+    io_uring_submit(&s_Ring);
+    return true;
+}
+
+static void*
+s_URingThreadMain(void* /* data */)
+{
+    for (;;) {
+        struct io_uring_cqe* cqe = NULL;
+        int res = io_uring_wait_cqe(&s_Ring, &cqe);
+        if (res == -EINTR)
+            continue;
+        if (res < 0)
+            break;
+
+        uintptr_t slot = uintptr_t(io_uring_cqe_get_data(cqe));
+        int cqe_res = cqe->res;
+        io_uring_cqe_seen(&s_Ring, cqe);
+        if (slot == kNCURingStopData)
+            break;
+
+        pthread_mutex_lock(&s_Lock);
+        s_RequestExecuted(s_URingSlots[slot], cqe_res < 0? -cqe_res: 0);
+        s_URingSlots[slot] = NULL;
+        s_URingFreeSlots.push_back(Uint4(slot));
+        // Requests that didn't fit into the ring earlier.
+        while (!s_Pending.empty()  &&  s_URingSubmit(s_Pending.front()))
+            s_Pending.pop_front();
+        pthread_mutex_unlock(&s_Lock);
+        s_Reaper->SetRunnable();
+    }
+    return NULL;
+}
+
+static bool
+s_URingInitialize(void)
+{
+    int res = io_uring_queue_init(s_QueueDepth, &s_Ring, 0);
+    if (res < 0) {
+        SRV_LOG(Warning, "Cannot initialize io_uring, errno=" << -res
+                         << ". Falling back to pool of threads.");
+        return false;
+    }
+    s_URingSlots.resize(s_QueueDepth);
+    for (Uint4 i = s_QueueDepth; i > 0; --i)
+        s_URingFreeSlots.push_back(i - 1);
+    return true;
+}
+#endif
+
+/// Add request to the engine's queue. Must be called under s_Lock.
+static void
+s_QueueRequest(const CSrvRef<SNCDiskIORequest>& req)
+{
+#ifdef HAVE_LIBURING
+    if (s_Engine == CNCDiskIO::eEngineURing) {
+        if (!s_URingSubmit(req))
+            s_Pending.push_back(req);
+        return;
+    }
+#endif
+    s_Pending.push_back(req);
+#ifdef NCBI_OS_LINUX
+    pthread_cond_signal(&s_QueueCond);
+#endif
+}
+
+
+bool
+CNCDiskIO::Initialize(const CNcbiRegistry& reg)
+{
+    string engine = reg.GetString(kNCDiskIO_RegSection, kNCDiskIO_EngineParam, "none");
+    s_CntThreads = Uint4(reg.GetInt(kNCDiskIO_RegSection, kNCDiskIO_ThreadsParam, 4));
+    s_QueueDepth = Uint4(reg.GetInt(kNCDiskIO_RegSection, kNCDiskIO_DepthParam, 128));
+    try {
+        s_ReadAhead = Uint4(NStr::StringToUInt8_DataSize(reg.GetString(
+                      kNCDiskIO_RegSection, kNCDiskIO_ReadAheadParam, "256 KB")));
+    }
+    catch (CStringException& ex) {
+        SRV_LOG(Critical, "Bad configuration: " << ex);
+        return false;
+    }
+    s_WriteBehind = reg.GetBool(kNCDiskIO_RegSection, kNCDiskIO_WriteBehindParam, false);
+
+    if (NStr::EqualNocase(engine, "none")) {
+        s_Engine = eEngineNone;
+    }
+    else if (NStr::EqualNocase(engine, "threads")) {
+        s_Engine = eEngineThreads;
+    }
+    else if (NStr::EqualNocase(engine, "uring")) {
+        s_Engine = eEngineURing;
+    }
+    else {
+        SRV_LOG(Critical, "Incorrect value of parameter " << kNCDiskIO_EngineParam
+                          << ": '" << engine << "'. Allowed values are"
+                             " 'none', 'threads' and 'uring'.");
+        return false;
+    }
+    if (s_CntThreads == 0)
+        s_CntThreads = 1;
+    if (s_QueueDepth < 8)
+        s_QueueDepth = 8;
+    if (s_ReadAhead > kNCDiskIOBufSize / 2)
+        s_ReadAhead = kNCDiskIOBufSize / 2;
+    s_ReadAhead = Uint4(s_ReadAhead & kNCPageAlignMask);
+
+#ifndef NCBI_OS_LINUX
+    s_Engine = eEngineNone;
+#else
+    if (s_Engine == eEngineNone)
+        return true;
+
+    if (s_Engine == eEngineURing) {
+# ifdef HAVE_LIBURING
+        if (!s_URingInitialize())
+            s_Engine = eEngineThreads;
+# else
+        SRV_LOG(Warning, "NetCache is built without io_uring support."
+                         " Falling back to pool of threads.");
+        s_Engine = eEngineThreads;
+# endif
+    }
+
+    s_ReadBuf = (char*)mmap(NULL, kNCDiskIOBufSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (s_ReadBuf == MAP_FAILED) {
+        SRV_LOG(Critical, "Cannot allocate disk I/O buffer, errno=" << errno);
+        s_ReadBuf = NULL;
+        s_Engine = eEngineNone;
+        return false;
+    }
+    s_Reaper = new CNCDiskIOReaper();
+
+    Uint4 cnt_threads = s_Engine == eEngineURing? 1: s_CntThreads;
+    void* (*thr_func)(void*) = &s_PoolThreadMain;
+# ifdef HAVE_LIBURING
+    if (s_Engine == eEngineURing)
+        thr_func = &s_URingThreadMain;
+# endif
+    for (Uint4 i = 0; i < cnt_threads; ++i) {
+        pthread_t thr;
+        int res = pthread_create(&thr, NULL, thr_func, NULL);
+        if (res != 0) {
+            SRV_LOG(Critical, "Unable to create disk I/O thread, result=" << res);
+            Finalize();
+            return false;
+        }
+        s_Threads.push_back(thr);
+    }
+#endif
+    return true;
+}
+
+void
+CNCDiskIO::Finalize(void)
+{
+#ifdef NCBI_OS_LINUX
+    if (s_Engine == eEngineNone)
+        return;
+
+    pthread_mutex_lock(&s_Lock);
+    s_Stopping = true;
+# ifdef HAVE_LIBURING
+    if (s_Engine == eEngineURing  &&  !s_Threads.empty()) {
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&s_Ring);
+        while (!sqe) {
+            io_uring_submit(&s_Ring);
+            sqe = io_uring_get_sqe(&s_Ring);
+        }
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, (void*)kNCURingStopData);
+        io_uring_submit(&s_Ring);
+    }
+# endif
+    pthread_cond_broadcast(&s_QueueCond);
+    pthread_mutex_unlock(&s_Lock);
+
+    ITERATE(vector<pthread_t>, it, s_Threads) {
+        int res = pthread_join(*it, NULL);
+        if (res != 0) {
+            SRV_LOG(Critical, "Cannot join disk I/O thread, res=" << res);
+        }
+    }
+    s_Threads.clear();
+# ifdef HAVE_LIBURING
+    if (s_Engine == eEngineURing)
+        io_uring_queue_exit(&s_Ring);
+# endif
+    s_Engine = eEngineNone;
+#endif
+}
+
+bool
+CNCDiskIO::IsEnabled(void)
+{
+    return s_Engine != eEngineNone  &&  !s_Stopping;
+}
+
+CNCDiskIO::EEngine
+CNCDiskIO::GetEngine(void)
+{
+    return s_Engine;
+}
+
+const char*
+CNCDiskIO::GetEngineName(void)
+{
+    switch (s_Engine) {
+    case eEngineThreads:
+        return "threads";
+    case eEngineURing:
+        return "uring";
+    default:
+        return "none";
+    }
+}
+
+bool
+CNCDiskIO::IsWriteBehind(void)
+{
+    return s_WriteBehind  &&  IsEnabled();
+}
+
+/// Check if all memory pages in the given range are in page cache
+static bool
+s_IsResident(char* mem_ptr, Uint4 size)
+{
+#ifdef NCBI_OS_LINUX
+    unsigned char vec[kNCDiskIOMaxCheckPages];
+    Uint4 cnt_pages = size / kNCPageSize;
+    if (cnt_pages > kNCDiskIOMaxCheckPages)
+        cnt_pages = kNCDiskIOMaxCheckPages;
+    if (mincore(mem_ptr, size_t(cnt_pages) * kNCPageSize, vec) != 0)
+        return true;
+    for (Uint4 i = 0; i < cnt_pages; ++i) {
+        if (!(vec[i] & 1))
+            return false;
+    }
+#endif
+    return true;
+}
+
+CSrvRef<SNCDiskIORequest>
+CNCDiskIO::StartRead(SNCDBFileInfo* file,
+                     const char* mem_ptr,
+                     Uint4 size,
+                     CSrvTask* waiter)
+{
+    CSrvRef<SNCDiskIORequest> req;
+    if (!IsEnabled()  ||  !file->file_map)
+        return req;
+
+    Uint8 offset = Uint8(mem_ptr - file->file_map);
+    Uint8 start = offset & kNCPageAlignMask;
+    Uint8 end = (offset + size + kNCPageSize - 1) & kNCPageAlignMask;
+    if (end > file->file_size)
+        end = file->file_size;
+    if (end <= start)
+        return req;
+    if (end - start > kNCDiskIOBufSize)
+        end = start + kNCDiskIOBufSize;
+    if (s_IsResident(file->file_map + start, Uint4(end - start)))
+        return req;
+
+    // Chunks of one blob are usually written one after another, so it's
+    // worth bringing in a few of the following ones at the same time.
+    end += s_ReadAhead;
+    if (end > file->file_size)
+        end = file->file_size;
+    if (end - start > kNCDiskIOBufSize)
+        end = start + kNCDiskIOBufSize;
+
+    req = new SNCDiskIORequest();
+    req->file = file;
+    req->offset = start;
+    req->size = Uint4(end - start);
+    req->is_read = true;
+    req->waiter = waiter;
+    req->start_time = CSrvTime::Current();
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    s_QueueRequest(req);
+    pthread_mutex_unlock(&s_Lock);
+#endif
+    return req;
+}
+
+void
+CNCDiskIO::StartWrite(SNCDBFileInfo* file, const char* mem_ptr, Uint4 size)
+{
+    if (!IsWriteBehind()  ||  !file->file_map)
+        return;
+
+    Uint8 offset = Uint8(mem_ptr - file->file_map);
+    Uint8 start = offset & kNCPageAlignMask;
+    Uint8 end = offset + size;
+    if (end > file->file_size)
+        end = file->file_size;
+    if (end <= start)
+        return;
+
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    // Chunks are written sequentially, so most of the time the new range
+    // just continues the one that is still waiting in the queue.
+    if (!s_Pending.empty()) {
+        SNCDiskIORequest* last = s_Pending.back();
+        if (!last->is_read  &&  last->file.GetPointer() == file
+            &&  start <= last->offset + last->size  &&  start >= last->offset
+            &&  end - last->offset <= kNCDiskIOBufSize)
+        {
+            if (end > last->offset + last->size)
+                last->size = Uint4(end - last->offset);
+            pthread_mutex_unlock(&s_Lock);
+            return;
+        }
+    }
+    pthread_mutex_unlock(&s_Lock);
+#endif
+
+    CSrvRef<SNCDiskIORequest> req(new SNCDiskIORequest());
+    req->file = file;
+    req->offset = start;
+    req->size = Uint4(end - start);
+    req->is_read = false;
+    req->start_time = CSrvTime::Current();
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    s_QueueRequest(req);
+    pthread_mutex_unlock(&s_Lock);
+#endif
+}
+
+bool
+CNCDiskIO::IsFinished(SNCDiskIORequest* req)
+{
+    bool result = true;
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    result = req->finished;
+    pthread_mutex_unlock(&s_Lock);
+#endif
+    return result;
+}
+
+void
+CNCDiskIO::CancelWait(SNCDiskIORequest* req)
+{
+#ifdef NCBI_OS_LINUX
+    pthread_mutex_lock(&s_Lock);
+    req->waiter = NULL;
+    pthread_mutex_unlock(&s_Lock);
+#endif
+}
+
+void
+CNCDiskIO::WriteSetup(CSrvSocketTask& task)
+{
+    string is("\": "),iss("\": \""), eol(",\n\""), eos("\"");
+    task.WriteText(eol).WriteText(kNCDiskIO_EngineParam     ).WriteText(iss).WriteText(GetEngineName()).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCDiskIO_ThreadsParam    ).WriteText(is ).WriteNumber(s_CntThreads);
+    task.WriteText(eol).WriteText(kNCDiskIO_DepthParam      ).WriteText(is ).WriteNumber(s_QueueDepth);
+    task.WriteText(eol).WriteText(kNCDiskIO_ReadAheadParam  ).WriteText(is ).WriteNumber(s_ReadAhead);
+    task.WriteText(eol).WriteText(kNCDiskIO_WriteBehindParam).WriteText(is ).WriteBool(s_WriteBehind);
+}
+
+END_NCBI_SCOPE
@@ -0,0 +1,118 @@
+#ifndef NETCACHE__NC_DISK_IO__HPP
+#define NETCACHE__NC_DISK_IO__HPP
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: asynchronous disk I/O engine for NetCache storage
+ *
+ * Database files are still accessed through memory mappings, but reads of
+ * chunks that are not in page cache and write-out of freshly written chunks
+ * are handed over to the engine. Engine executes them either via io_uring
+ * (if NetCache is built with liburing) or via pool of threads doing
+ * pread()/sync_file_range(). Completions are delivered back to the
+ * TaskServer scheduler which makes waiting tasks runnable, so that worker
+ * threads never block on major page faults for cold blobs.
+ */
+
+#include "nc_db_info.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// One asynchronous disk operation
+struct SNCDiskIORequest : public CObject
+{
+    /// File the operation is made on. Holding reference guarantees that file
+    /// descriptor won't be closed before operation finishes.
+    CSrvRef<SNCDBFileInfo> file;
+    /// Page-aligned offset inside the file
+    Uint8       offset;
+    /// Size of the range (multiple of page size)
+    Uint4       size;
+    bool        is_read;
+    /// Set when operation is finished (successfully or not)
+    bool        finished;
+    /// errno if operation failed, 0 otherwise
+    int         err_code;
+    /// Task to make runnable when operation finishes. Access to it is
+    /// protected by engine's lock, see CNCDiskIO::CancelWait().
+    CSrvTask*   waiter;
+    CSrvTime    start_time;
+    CSrvTime    end_time;
+
+    SNCDiskIORequest(void);
+    virtual ~SNCDiskIORequest(void);
+};
+
+
+/// Asynchronous disk I/O engine
+class CNCDiskIO
+{
+public:
+    enum EEngine {
+        eEngineNone,    ///< All I/O is done through page faults
+        eEngineThreads, ///< pread()/sync_file_range() in pool of threads
+        eEngineURing    ///< io_uring
+    };
+
+    /// Read engine parameters from registry and start the engine
+    static bool Initialize(const CNcbiRegistry& reg);
+    /// Stop the engine and wait for all its threads to finish
+    static void Finalize(void);
+
+    static bool IsEnabled(void);
+    static EEngine GetEngine(void);
+    static const char* GetEngineName(void);
+    /// Whether write-out of written chunks is started right away
+    static bool IsWriteBehind(void);
+
+    /// Start reading into page cache the part of the file mapped at
+    /// [mem_ptr, mem_ptr + size). If all memory pages of this range are
+    /// already resident then NULL is returned and caller can access memory
+    /// right away. Otherwise caller should wait for the task waiter to be
+    /// made runnable and then check IsFinished() on the returned request.
+    static CSrvRef<SNCDiskIORequest> StartRead(SNCDBFileInfo* file,
+                                               const char* mem_ptr,
+                                               Uint4 size,
+                                               CSrvTask* waiter);
+    /// Start write-out of the part of the file mapped at
+    /// [mem_ptr, mem_ptr + size). Nobody waits for such operation, it's
+    /// needed only to smooth out the kernel writeback.
+    static void StartWrite(SNCDBFileInfo* file, const char* mem_ptr, Uint4 size);
+
+    static bool IsFinished(SNCDiskIORequest* req);
+    /// Make sure that waiter of the request won't be touched anymore. Should
+    /// be called if waiter can be destroyed before the request is finished.
+    static void CancelWait(SNCDiskIORequest* req);
+
+    /// Write engine configuration into the socket
+    static void WriteSetup(CSrvSocketTask& task);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETCACHE__NC_DISK_IO__HPP */
@@ -165,6 +165,25 @@ s_SizeIndex(Uint8 size)
     return g_GetLogBase2(size);
 }
 
+/// Estimate percentile pct of values collected into histogram by
+/// s_SizeIndex(). Values are assumed to be spread evenly inside each bucket.
+static Uint8
+s_CalcPercentile(const vector<Uint8>& by_index, Uint8 cnt_values, Uint1 pct)
+{
+    Uint8 target = (cnt_values * pct + 99) / 100;
+    Uint8 cnt_seen = 0;
+    for (size_t i = 0; i < by_index.size(); ++i) {
+        if (cnt_seen + by_index[i] < target) {
+            cnt_seen += by_index[i];
+            continue;
+        }
+        Uint8 low = (i == 0? 0: Uint8(1) << i);
+        Uint8 high = Uint8(2) << i;
+        return low + (high - low) * (target - cnt_seen) / by_index[i];
+    }
+    return 0;
+}
+
 void
 CNCStat::AddSyncServer(Uint8 srv_id)
 {
@@ -247,10 +266,17 @@ CNCStat::x_ClearStats(void)
     m_DiskWrBlobSize = 0;
     m_DiskWrBySize.resize(0);
     m_DiskWrBySize.resize(40, 0);
+    m_DiskRdIOLens.Initialize();
+    m_DiskRdIOByLen.resize(0);
+    m_DiskRdIOByLen.resize(40, 0);
+    m_DiskWrIOLens.Initialize();
+    m_DiskWrIOByLen.resize(0);
+    m_DiskWrIOByLen.resize(40, 0);
     m_PeerSyncs = 0;
     m_PeerSynOps = 0;
     m_CntCleanedFiles = 0;
     m_CntFailedFiles = 0;
+    m_ReclaimedSize = 0;
     m_CmdLens.Initialize();
     m_CmdsByName.clear();
     m_LensByStatus.clear();
@@ -349,7 +375,11 @@ CNCStat::x_AddStats(CNCStat* src_stat)
         m_ClWrLenBySize[i].AddValues(src_stat->m_ClWrLenBySize[i]);
         m_ClRdLenBySize[i].AddValues(src_stat->m_ClRdLenBySize[i]);
         m_DiskWrBySize[i] += src_stat->m_DiskWrBySize[i];
+        m_DiskRdIOByLen[i] += src_stat->m_DiskRdIOByLen[i];
+        m_DiskWrIOByLen[i] += src_stat->m_DiskWrIOByLen[i];
     }
+    m_DiskRdIOLens.AddValues(src_stat->m_DiskRdIOLens);
+    m_DiskWrIOLens.AddValues(src_stat->m_DiskWrIOLens);
     m_ClRbackBlobs += src_stat->m_ClRbackBlobs;
     m_ClRbackSize += src_stat->m_ClRbackSize;
     m_ClRdBlobs += src_stat->m_ClRdBlobs;
@@ -360,6 +390,7 @@ CNCStat::x_AddStats(CNCStat* src_stat)
     m_PeerSynOps += src_stat->m_PeerSynOps;
     m_CntCleanedFiles += src_stat->m_CntCleanedFiles;
     m_CntFailedFiles += src_stat->m_CntFailedFiles;
+    m_ReclaimedSize += src_stat->m_ReclaimedSize;
     m_CheckedRecs.AddValues(src_stat->m_CheckedRecs);
     m_MovedRecs.AddValues(src_stat->m_MovedRecs);
     m_MovedSize.AddValues(src_stat->m_MovedSize);
@@ -590,6 +621,22 @@ CNCStat::DiskBlobWrite(Uint8 blob_size)
     stat->m_StatLock.Unlock();
 }
 
+void
+CNCStat::DiskIOFinished(bool is_read, Uint8 len_usec)
+{
+    CNCStat* stat = s_Stat();
+    stat->m_StatLock.Lock();
+    if (is_read) {
+        stat->m_DiskRdIOLens.AddValue(len_usec);
+        ++stat->m_DiskRdIOByLen[s_SizeIndex(len_usec)];
+    }
+    else {
+        stat->m_DiskWrIOLens.AddValue(len_usec);
+        ++stat->m_DiskWrIOByLen[s_SizeIndex(len_usec)];
+    }
+    stat->m_StatLock.Unlock();
+}
+
 void
 CNCStat::DBFileCleaned(bool success, Uint4 seen_recs,
                        Uint4 moved_recs, Uint4 moved_size)
@@ -606,6 +653,15 @@ CNCStat::DBFileCleaned(bool success, Uint4 seen_recs,
     stat->m_StatLock.Unlock();
 }
 
+void
+CNCStat::DBSpaceReclaimed(Uint8 size)
+{
+    CNCStat* stat = s_Stat();
+    stat->m_StatLock.Lock();
+    stat->m_ReclaimedSize += size;
+    stat->m_StatLock.Unlock();
+}
+
 void
 CNCStat::SaveCurStateStat(const SNCStateStat& state)
 {
@@ -807,6 +863,18 @@ CNCStat::PrintToLogs(CTempString stat_name)
         .PrintParam("disk_wr_blobs", m_DiskWrBlobs)
         .PrintParam("disk_wr_avg_blobs", m_DiskWrBlobs / time_secs)
         .PrintParam("disk_wr_size", m_DiskWrBlobSize);
+    if (m_DiskRdIOLens.GetCount() != 0) {
+        diag.PrintParam("disk_io_reads", m_DiskRdIOLens.GetCount())
+            .PrintParam("disk_io_rd_p50", s_CalcPercentile(m_DiskRdIOByLen, m_DiskRdIOLens.GetCount(), 50))
+            .PrintParam("disk_io_rd_p99", s_CalcPercentile(m_DiskRdIOByLen, m_DiskRdIOLens.GetCount(), 99))
+            .PrintParam("disk_io_rd_max", m_DiskRdIOLens.GetMaximum());
+    }
+    if (m_DiskWrIOLens.GetCount() != 0) {
+        diag.PrintParam("disk_io_writes", m_DiskWrIOLens.GetCount())
+            .PrintParam("disk_io_wr_p50", s_CalcPercentile(m_DiskWrIOByLen, m_DiskWrIOLens.GetCount(), 50))
+            .PrintParam("disk_io_wr_p99", s_CalcPercentile(m_DiskWrIOByLen, m_DiskWrIOLens.GetCount(), 99))
+            .PrintParam("disk_io_wr_max", m_DiskWrIOLens.GetMaximum());
+    }
     diag.PrintParam("peer_syncs", m_PeerSyncs)
         .PrintParam("peer_syn_ops", m_PeerSynOps)
         .PrintParam("cleaned_files", m_CntCleanedFiles)
@@ -816,7 +884,9 @@ CNCStat::PrintToLogs(CTempString stat_name)
         .PrintParam("moved_recs", m_MovedRecs.GetSum())
         .PrintParam("avg_moved_recs", m_MovedRecs.GetAverage())
         .PrintParam("moved_size", m_MovedSize.GetSum())
-        .PrintParam("avg_moved_size", m_MovedSize.GetAverage());
+        .PrintParam("avg_moved_size", m_MovedSize.GetAverage())
+        .PrintParam("reclaimed_size", m_ReclaimedSize)
+        .PrintParam("reclaimed_per_sec", m_ReclaimedSize / time_secs);
     diag.Flush();
 
     CSrvPrintProxy proxy(ctx);
@@ -1086,6 +1156,20 @@ CNCStat::PrintToSocket(CSrvSocketTask* sock)
     proxy << "Disk reads - "
                     << g_ToSizeStr(m_DiskDataRead) << ", "
                     << g_ToSizeStr(m_DiskDataRead / time_secs) << "/s" << endl;
+    if (m_DiskRdIOLens.GetCount() != 0) {
+        proxy << "Disk I/O reads - "
+                    << g_ToSmartStr(m_DiskRdIOLens.GetCount()) << " (cnt), "
+                    << g_AsMSecStat(s_CalcPercentile(m_DiskRdIOByLen, m_DiskRdIOLens.GetCount(), 50)) << " (p50 msec), "
+                    << g_AsMSecStat(s_CalcPercentile(m_DiskRdIOByLen, m_DiskRdIOLens.GetCount(), 99)) << " (p99 msec), "
+                    << g_AsMSecStat(m_DiskRdIOLens.GetMaximum()) << " (max msec)" << endl;
+    }
+    if (m_DiskWrIOLens.GetCount() != 0) {
+        proxy << "Disk I/O writes - "
+                    << g_ToSmartStr(m_DiskWrIOLens.GetCount()) << " (cnt), "
+                    << g_AsMSecStat(s_CalcPercentile(m_DiskWrIOByLen, m_DiskWrIOLens.GetCount(), 50)) << " (p50 msec), "
+                    << g_AsMSecStat(s_CalcPercentile(m_DiskWrIOByLen, m_DiskWrIOLens.GetCount(), 99)) << " (p99 msec), "
+                    << g_AsMSecStat(m_DiskWrIOLens.GetMaximum()) << " (max msec)" << endl;
+    }
     proxy << "Shrink check - "
                     << g_ToSmartStr(m_CntCleanedFiles) << " files ("
                     << g_ToSmartStr(m_CntFailedFiles) << " failed), "
@@ -1096,6 +1180,9 @@ CNCStat::PrintToSocket(CSrvSocketTask* sock)
                     << g_ToSizeStr(m_MovedSize.GetSum()) << " (per file "
                     << g_ToSmartStr(m_MovedRecs.GetAverage()) << " recs, "
                     << g_ToSizeStr(m_MovedSize.GetAverage()) << ")" << endl;
+    proxy << "Shrink reclaimed - "
+                    << g_ToSizeStr(m_ReclaimedSize) << " ("
+                    << g_ToSizeStr(m_ReclaimedSize / time_secs) << "/sec)" << endl;
     proxy << endl;
 
     m_SrvStat->PrintToSocket(proxy);
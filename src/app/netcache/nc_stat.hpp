@@ -101,8 +101,10 @@ public:
     static void DiskDataWrite(size_t data_size);
     static void DiskDataRead(size_t data_size);
     static void DiskBlobWrite(Uint8 blob_size);
+    static void DiskIOFinished(bool is_read, Uint8 len_usec);
     static void DBFileCleaned(bool success, Uint4 seen_recs,
                               Uint4 moved_recs, Uint4 moved_size);
+    static void DBSpaceReclaimed(Uint8 size);
     static void SaveCurStateStat(const SNCStateStat& state);
 
 public:
@@ -153,10 +155,15 @@ private:
     Uint8 m_DiskWrBlobs;
     Uint8 m_DiskWrBlobSize;
     vector<Uint8> m_DiskWrBySize;
+    TSrvTimeTerm m_DiskRdIOLens;
+    vector<Uint8> m_DiskRdIOByLen;
+    TSrvTimeTerm m_DiskWrIOLens;
+    vector<Uint8> m_DiskWrIOByLen;
     Uint8 m_PeerSyncs;
     Uint8 m_PeerSynOps;
     Uint8 m_CntCleanedFiles;
     Uint8 m_CntFailedFiles;
+    Uint8 m_ReclaimedSize;
     TSrvTimeTerm m_CmdLens;
     TCmdCountsMap m_CmdsByName;
     TStatusCmdLens m_LensByStatus;
@@ -43,6 +43,8 @@
 #include "nc_stat.hpp"
 #include "logging.hpp"
 #include "peer_control.hpp"
+#include "nc_disk_io.hpp"
+#include "nc_chunk_pack.hpp"
 
 
 #ifdef NCBI_OS_LINUX
@@ -90,6 +92,13 @@ static const char* kNCStorage_DiskCriticalParam = "critical_disk_free_limit";
 static const char* kNCStorage_MinRecNoSaveParam = "min_rec_no_save_period";
 static const char* kNCStorage_FailedWriteSize   = "failed_write_blob_key_count";
 static const char* kNCStorage_MaxBlobSizeStore  = "max_blob_size_store";
+static const char* kNCStorage_SendFileMinSize   = "sendfile_min_blob_size";
+static const char* kNCStorage_CompressionParam  = "blob_compression";
+static const char* kNCStorage_CompressLevelParam = "blob_compression_level";
+static const char* kNCStorage_CompressGainParam = "blob_compression_min_gain";
+static const char* kNCStorage_CompactMaxRate    = "compaction_max_rate";
+static const char* kNCStorage_CompactMinRate    = "compaction_min_rate";
+static const char* kNCStorage_CompactBatchSize  = "compaction_batch_size";
 static const char* kNCStorage_WbMemRelease      = "task_priority_wb_memrelease";
 
 
@@ -174,6 +183,13 @@ struct SBucketCache
 {
     CMiniMutex   lock;
     TKeyMap      key_map;
+    /// Leaves of the synchronization hash tree for blobs in this bucket
+    Uint8        sync_tree[kNCSyncTreeLeaves];
+
+    SBucketCache(void)
+    {
+        memset(sync_tree, 0, sizeof(sync_tree));
+    }
 };
 typedef map<Uint2, SBucketCache*> TBucketCacheMap;
 
@@ -285,6 +301,19 @@ static Int8 s_StopWriteOffSize = 0;
 static Int8 s_DiskFreeLimit = 0;
 static Int8 s_DiskCritical = 0;
 static Uint8 s_MaxBlobSizeStore = 0;
+static Uint8 s_SendFileMinSize = 0;
+static bool s_PackChunks = false;
+static int s_PackLevel = 3;
+static int s_PackMinGain = 10;
+/// Logical and stored sizes of all compressed chunks in the database
+static Int8 s_PackedDataSize = 0;
+static Int8 s_PackedStoredSize = 0;
+/// Limits of disk bandwidth used for moving records out of sparse files
+static Int8 s_CompactMaxRate = 0;
+static Int8 s_CompactMinRate = 0;
+static Uint4 s_CompactBatchSize = 0;
+/// Amount of blob data read from and written to disk for clients and peers
+static Uint8 s_ClientDiskBytes = 0;
 static CNewFileCreator* s_NewFileCreator = nullptr;
 static CDiskFlusher* s_DiskFlusher = nullptr;
 static CRecNoSaver* s_RecNoSaver = nullptr;
@@ -501,6 +530,20 @@ s_UnmapFile(char* mem_ptr, size_t file_size)
 #endif
 }
 
+/// Ask kernel to read ahead given range of the database file
+static void
+s_PrefetchFileRange(SNCDBFileInfo* file_info, Uint4 offset, Uint4 size)
+{
+#ifdef NCBI_OS_LINUX
+    if (offset >= file_info->file_size)
+        return;
+    size = min(size, file_info->file_size - offset);
+    char* start_ptr = (char*)(size_t(file_info->file_map + offset) & kMemPageAlignMask);
+    char* end_ptr = file_info->file_map + offset + size;
+    madvise(start_ptr, end_ptr - start_ptr, MADV_WILLNEED);
+#endif
+}
+
 static inline void
 s_LockFileMem(const void* mem_ptr, size_t mem_size)
 {
@@ -563,6 +606,43 @@ s_ReadVariableParams(const CNcbiRegistry& reg)
                        << " Changing it to " << kNCLargestBlobSize);
         s_MaxBlobSizeStore = kNCLargestBlobSize;
     }
+    s_SendFileMinSize = NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_SendFileMinSize, "0"));
+
+    string compression = reg.GetString(kNCStorage_RegSection,
+                                       kNCStorage_CompressionParam, "none");
+    if (NStr::CompareNocase(compression, "zstd") == 0) {
+#ifdef HAVE_LIBZSTD
+        s_PackChunks = true;
+#else
+        SRV_LOG(Error, "NetCache is built without zstd support, parameter "
+                       << kNCStorage_CompressionParam << " is ignored.");
+        s_PackChunks = false;
+#endif
+    }
+    else {
+        if (NStr::CompareNocase(compression, "none") != 0) {
+            SRV_LOG(Error, "Parameter " << kNCStorage_CompressionParam
+                           << " has wrong value '" << compression
+                           << "'. Assuming 'none'.");
+        }
+        s_PackChunks = false;
+    }
+    s_CompactMaxRate = NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_CompactMaxRate, "0"));
+    s_CompactMinRate = NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_CompactMinRate, "1 MB"));
+    s_CompactBatchSize = Uint4(NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_CompactBatchSize, "4 MB")));
+
+    s_PackLevel = reg.GetInt(kNCStorage_RegSection, kNCStorage_CompressLevelParam, 3);
+    s_PackMinGain = reg.GetInt(kNCStorage_RegSection, kNCStorage_CompressGainParam, 10);
+    if (s_PackMinGain < 0  ||  s_PackMinGain >= 100) {
+        SRV_LOG(Error, "Parameter " << kNCStorage_CompressGainParam
+                       << " has wrong value " << s_PackMinGain
+                       << ". Assuming it's 10.");
+        s_PackMinGain = 10;
+    }
 
     int warn_pct = reg.GetInt(kNCStorage_RegSection, "db_limit_percentage_alert", 65);
     if (warn_pct <= 0  ||  warn_pct >= 100) {
@@ -1133,6 +1213,73 @@ s_CalcChunkAddress(SNCDBFileInfo* file_info, SFileIndexRec* ind_rec)
     return (SFileChunkDataRec*)rec_ptr;
 }
 
+
+/// Maximum number of records the space shrinker processes without yielding
+/// execution to other tasks
+static const Uint4 kNCMaxCompactBatchRecs = 100;
+
+/// Chunk packers of all TaskServer threads
+static CNCChunkPacker** s_Packers = nullptr;
+
+static void
+s_InitPackers(void)
+{
+    TSrvThreadNum cnt_threads = CTaskServer::GetMaxRunningThreads();
+    s_Packers = new CNCChunkPacker*[cnt_threads];
+    for (TSrvThreadNum i = 0; i < cnt_threads; ++i)
+        s_Packers[i] = new CNCChunkPacker(kNCMaxBlobChunkSize);
+}
+
+static void
+s_FreePackers(void)
+{
+    if (!s_Packers)
+        return;
+    TSrvThreadNum cnt_threads = CTaskServer::GetMaxRunningThreads();
+    for (TSrvThreadNum i = 0; i < cnt_threads; ++i)
+        delete s_Packers[i];
+    delete[] s_Packers;
+    s_Packers = nullptr;
+}
+
+static inline CNCChunkPacker*
+s_GetPacker(void)
+{
+    return s_Packers[CTaskServer::GetCurThreadNum()];
+}
+
+/// Compress data of the chunk if it's worth it. Returns pointer to the
+/// compressed data (valid until next call in the same thread) or NULL if
+/// chunk should be stored as is.
+static const char*
+s_PackChunk(SNCBlobVerData* ver_data, const char* data, Uint4 size,
+            Uint4& packed_size)
+{
+    if (!s_PackChunks  ||  ver_data->no_packing  ||  size < kNCMinPackSize)
+        return NULL;
+
+    const char* res = s_GetPacker()->Pack(data, size, s_PackLevel,
+                                          s_PackMinGain, packed_size);
+    if (!res) {
+        // Chunks of one blob usually have similar contents, so no need to
+        // waste time on compression of the rest of them.
+        ver_data->no_packing = true;
+    }
+    return res;
+}
+
+/// Exclude compressed chunk being deleted from the statistics
+static void
+s_SubPackedChunk(SFileChunkDataRec* data_rec, Uint4 stored_size)
+{
+    Uint8 data_size = CNCChunkPacker::GetUnpackedSize(
+                                    (const char*)data_rec->chunk_data, stored_size);
+    if (data_size == 0)
+        data_size = stored_size;
+    AtomicSub(s_PackedDataSize, Int8(data_size));
+    AtomicSub(s_PackedStoredSize, Int8(stored_size));
+}
+
 /// Do set of procedures creating and initializing new database part and
 /// switching storage to using new database part as current one.
 static bool
@@ -1294,6 +1441,9 @@ CNCBlobStorage::Initialize(bool do_reinit)
 
     if (!s_ReadStorageParams())
         return false;
+    if (!CNCDiskIO::Initialize(CTaskServer::GetConfRegistry()))
+        return false;
+    s_InitPackers();
 
     if (!s_LockInstanceGuard())
         return false;
@@ -1342,6 +1492,8 @@ CNCBlobStorage::Initialize(bool do_reinit)
 void
 CNCBlobStorage::Finalize(void)
 {
+    CNCDiskIO::Finalize();
+    s_FreePackers();
     s_IndexDB.reset();
 
     s_UnlockInstanceGuard();
@@ -1383,6 +1535,22 @@ void CNCBlobStorage::WriteSetup(CSrvSocketTask& task)
     task.WriteText(eol).WriteText(kNCStorage_MaxBlobSizeStore).WriteText(str).WriteText(iss)
                                                    .WriteText(NStr::UInt8ToString_DataSize( s_MaxBlobSizeStore)).WriteText(eos);
     task.WriteText(eol).WriteText(kNCStorage_MaxBlobSizeStore).WriteText(is ).WriteNumber( s_MaxBlobSizeStore);
+    task.WriteText(eol).WriteText(kNCStorage_SendFileMinSize).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( s_SendFileMinSize)).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_SendFileMinSize).WriteText(is ).WriteNumber( s_SendFileMinSize);
+    task.WriteText(eol).WriteText(kNCStorage_CompressionParam).WriteText(iss)
+                                                   .WriteText(s_PackChunks ? "zstd" : "none").WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_CompressLevelParam).WriteText(is ).WriteNumber( s_PackLevel);
+    task.WriteText(eol).WriteText(kNCStorage_CompressGainParam).WriteText(is ).WriteNumber( s_PackMinGain);
+    task.WriteText(eol).WriteText(kNCStorage_CompactMaxRate).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( s_CompactMaxRate)).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_CompactMaxRate).WriteText(is ).WriteNumber( s_CompactMaxRate);
+    task.WriteText(eol).WriteText(kNCStorage_CompactMinRate).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( s_CompactMinRate)).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_CompactMinRate).WriteText(is ).WriteNumber( s_CompactMinRate);
+    task.WriteText(eol).WriteText(kNCStorage_CompactBatchSize).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( s_CompactBatchSize)).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_CompactBatchSize).WriteText(is ).WriteNumber( s_CompactBatchSize);
     task.WriteText(eol).WriteText("db_limit_percentage_alert" ).WriteText(is ).WriteNumber( s_WarnLimitOnPct);
     task.WriteText(eol).WriteText("db_limit_percentage_alert_delta").WriteText(is).WriteNumber(s_WarnLimitOffPct);
     task.WriteText(eol).WriteText("write_back_soft_size_limit").WriteText(str).WriteText(iss)
@@ -1395,6 +1563,7 @@ void CNCBlobStorage::WriteSetup(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("write_back_failed_delay"   ).WriteText(is ).WriteNumber( GetWBFailedWriteDelay());
     task.WriteText(eol).WriteText(kNCStorage_WbMemRelease).WriteText(is).WriteNumber(s_TaskPriorityWbMemRelease);
     task.WriteText(eol).WriteText(kNCStorage_FailedWriteSize  ).WriteText(is ).WriteNumber( CNCBlobAccessor::GetFailedWriteCount());
+    CNCDiskIO::WriteSetup(task);
 }
 
 void CNCBlobStorage::WriteEnvInfo(CSrvSocketTask& task)
@@ -1405,6 +1574,9 @@ void CNCBlobStorage::WriteEnvInfo(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("DBindex"  ).WriteText(iss).WriteText(   s_GetIndexFileName()).WriteText(eos);
     task.WriteText(eol).WriteText("DBfiles_count").WriteText( is).WriteNumber( CNCBlobStorage::GetNDBFiles());
     task.WriteText(eol).WriteText("DBsize"       ).WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(s_CurDBSize)).WriteText(eos);
+    task.WriteText(eol).WriteText("DBlogical_size").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(GetDBLogicalSize())).WriteText(eos);
+    task.WriteText(eol).WriteText("DBpacked_data").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(s_PackedDataSize)).WriteText(eos);
+    task.WriteText(eol).WriteText("DBpacked_stored").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(s_PackedStoredSize)).WriteText(eos);
     task.WriteText(eol).WriteText("DBgarbage"    ).WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(s_GarbageSize)).WriteText(eos);
     task.WriteText(eol).WriteText("diskfreespace").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(GetDiskFree())).WriteText(eos);
     task.WriteText(eol).WriteText("IsStopWrite").WriteText( is).WriteNumber( (int)s_IsStopWrite);
@@ -1771,6 +1943,81 @@ s_GetBucketCache(Uint2 bucket)
     return it->second;
 }
 
+/// Hash of the blob key. Used in the synchronization hash tree, so it must
+/// be the same on all servers in the cluster (FNV-1a).
+static inline Uint8
+s_HashSyncKey(const string& key)
+{
+    Uint8 hash = NCBI_CONST_UINT8(14695981039346656037);
+    for (size_t i = 0; i < key.size(); ++i) {
+        hash ^= Uint1(key[i]);
+        hash *= NCBI_CONST_UINT8(1099511628211);
+    }
+    return hash;
+}
+
+static inline Uint8
+s_MixSyncDigest(Uint8 hash, Uint8 value)
+{
+    hash ^= value;
+    hash ^= hash >> 33;
+    hash *= NCBI_CONST_UINT8(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= NCBI_CONST_UINT8(0xc4ceb9fe1a85ec53);
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static inline Uint4
+s_GetSyncTreeLeaf(const string& key)
+{
+    return Uint4((s_HashSyncKey(key) >> 32) % kNCSyncTreeLeaves);
+}
+
+/// Whether blob is included into the lists of blobs for synchronization.
+/// Filter by CNCPeerControl::AcceptsBlobKey() is not checked because it
+/// excludes blobs only for peers too old to support the hash tree.
+static inline bool
+s_IsBlobListedForSync(const string& key, Uint8 size)
+{
+    return size <= CNCDistributionConf::GetMaxBlobSizeSync()
+           ||  !CNCDistributionConf::IsThisServerKey(key);
+}
+
+/// Calculate digest of everything that synchronization by blob lists
+/// compares (see SNCBlobSummary::isEqual()).
+static Uint8
+s_CalcSyncDigest(const SNCCacheData* data)
+{
+    // Deleted blobs are not accounted in the tree, nor are the blobs too
+    // big to be synced. The lists skip those only on the server owning the
+    // key, but the tree should be the same on all servers, or their leaves
+    // would differ on every sync.
+    if (data->dead_time == 0  ||  data->size > CNCDistributionConf::GetMaxBlobSizeSync())
+        return 0;
+
+    Uint8 digest = s_HashSyncKey(data->key);
+    digest = s_MixSyncDigest(digest, data->create_time);
+    digest = s_MixSyncDigest(digest, data->create_server);
+    digest = s_MixSyncDigest(digest, data->create_id);
+    digest = s_MixSyncDigest(digest, Uint4(data->dead_time));
+    digest = s_MixSyncDigest(digest, Uint4(data->expire));
+    digest = s_MixSyncDigest(digest, Uint4(data->ver_expire));
+    return digest == 0? 1: digest;
+}
+
+/// Change digest of the blob accounted in the tree. Bucket's lock should be
+/// held by caller.
+static inline void
+s_SetSyncDigest(SBucketCache* cache, SNCCacheData* data, Uint8 digest)
+{
+    if (data->sync_digest != digest) {
+        cache->sync_tree[s_GetSyncTreeLeaf(data->key)]
+                                        ^= data->sync_digest ^ digest;
+        data->sync_digest = digest;
+    }
+}
+
 static SNCCacheData*
 s_GetKeyCacheData(Uint2 time_bucket, const string& key, bool need_create)
 {
@@ -1886,6 +2133,7 @@ CNCAlerts::Register(CNCAlerts::eDebugReleaseCacheData1, "ref_cnt is 0");
         cache->lock.Unlock();
         return;
     }
+    s_SetSyncDigest(cache, data, 0);
 #if __NC_CACHEDATA_INTR_SET
     size_t n = cache->key_map.erase(*data);
 #else
@@ -1998,6 +2246,7 @@ s_GetNextWriteCoord(EDBFileIndex file_index,
     ind_rec->offset = w_info.next_offset;
     ind_rec->rec_size = rec_size;
     ind_rec->rec_type = eFileRecNone;
+    ind_rec->rec_packed = 0;
     ind_rec->cache_data = NULL;
     ind_rec->chain_coord.clear();
 
@@ -2359,7 +2608,9 @@ s_MoveDataToGarbage(SNCDataCoord coord, Uint1 map_depth, SNCDataCoord up_coord,
                      << " when should be " << up_coord << ".");
     }
     if (ind_rec->rec_type == eFileRecChunkData) {
-        s_CalcChunkAddress(file_info, ind_rec);
+        SFileChunkDataRec* data_rec = s_CalcChunkAddress(file_info, ind_rec);
+        if (ind_rec->rec_packed)
+            s_SubPackedChunk(data_rec, s_CalcChunkDataSize(ind_rec->rec_size));
         s_MoveRecToGarbage(file_info, ind_rec);
     }
     else if (ind_rec->rec_type == eFileRecChunkMap) {
@@ -2453,12 +2704,15 @@ CNCAlerts::Register(CNCAlerts::eDebugReadMapInfo2, "ReadMapInfo: map_inf");
     return true;
 }
 
-bool
-CNCBlobStorage::ReadChunkData(SNCBlobVerData* ver_data,
-                              SNCChunkMaps* maps,
-                              Uint8 chunk_num,
-                              char*& buffer,
-                              Uint4& buf_size)
+/// Find index record of the data chunk number chunk_num, reading all
+/// necessary chunk maps on the way.
+static bool
+s_FindChunkData(SNCBlobVerData* ver_data,
+                SNCChunkMaps* maps,
+                Uint8 chunk_num,
+                Uint2& chunk_idx,
+                CSrvRef<SNCDBFileInfo>& data_file,
+                SFileIndexRec*& data_ind)
 {
     Uint2 map_idx[kNCMaxBlobMapsDepth] = {0};
     Uint1 cur_index = 0;
@@ -2537,20 +2791,21 @@ CNCAlerts::Register(CNCAlerts::eDebugReadChunkData2, "ReadChunkData: ReadMapInfo
         chunk_coord = maps->maps[0]->coords[map_idx[0]];
     }
 
-    CSrvRef<SNCDBFileInfo> data_file = s_GetDBFileTry(chunk_coord.file_id);
+    data_file = s_GetDBFileTry(chunk_coord.file_id);
     if (data_file.IsNull()) {
 #ifdef _DEBUG
 CNCAlerts::Register(CNCAlerts::eDebugReadChunkData3, "ReadChunkData: data_file");
 #endif
         return false;
     }
-    SFileIndexRec* data_ind = s_GetIndexRecTry(data_file, chunk_coord.rec_num);
+    data_ind = s_GetIndexRecTry(data_file, chunk_coord.rec_num);
     if (!data_ind) {
 #ifdef _DEBUG
 CNCAlerts::Register(CNCAlerts::eDebugReadChunkData4, "ReadChunkData: data_inf");
 #endif
         return false;
     }
+    chunk_idx = map_idx[0];
     /*
     This is an incorrect check because it can race with
     CNCBlobVerManager::x_UpdateVersion
@@ -2562,11 +2817,28 @@ CNCAlerts::Register(CNCAlerts::eDebugReadChunkData4, "ReadChunkData: data_inf");
                      << " when should be " << up_coord << ".");
     }
     */
+    return true;
+}
+
+bool
+CNCBlobStorage::ReadChunkData(SNCBlobVerData* ver_data,
+                              SNCChunkMaps* maps,
+                              Uint8 chunk_num,
+                              char*& buffer,
+                              Uint4& buf_size,
+                              bool& packed)
+{
+    Uint2 chunk_idx = 0;
+    CSrvRef<SNCDBFileInfo> data_file;
+    SFileIndexRec* data_ind = NULL;
+    if (!s_FindChunkData(ver_data, maps, chunk_num, chunk_idx, data_file, data_ind))
+        return false;
+
     SFileChunkDataRec* data_rec = s_CalcChunkAddress(data_file, data_ind);
-    if (data_rec->chunk_num != chunk_num  ||  data_rec->chunk_idx != map_idx[0])
+    if (data_rec->chunk_num != chunk_num  ||  data_rec->chunk_idx != chunk_idx)
     {
         SRV_LOG(Critical, "File " << data_file->file_name
-                          << " in chunk record " << chunk_coord.rec_num
+                          << " in chunk record " << (data_file->index_head - data_ind)
                           << " has wrong chunk number " << data_rec->chunk_num
                           << " and/or chunk index " << data_rec->chunk_idx
                           << ". Deleting blob.");
@@ -2575,17 +2847,85 @@ CNCAlerts::Register(CNCAlerts::eDebugReadChunkData4, "ReadChunkData: data_inf");
 
     buf_size = s_CalcChunkDataSize(data_ind->rec_size);
     buffer = (char*)data_rec->chunk_data;
+    packed = data_ind->rec_packed;
+    // Compressed chunk is read entirely right away. Data of uncompressed
+    // one is read via the file mapping or sendfile() later, possibly
+    // several times, so it's accounted in AddClientDiskBytes().
+    if (packed)
+        AtomicAdd(s_ClientDiskBytes, buf_size);
 
     return true;
 }
 
+void
+CNCBlobStorage::AddClientDiskBytes(Uint4 size)
+{
+    AtomicAdd(s_ClientDiskBytes, size);
+}
+
+bool
+CNCBlobStorage::UnpackChunkData(const char* data,
+                                Uint4 data_size,
+                                char* buffer,
+                                Uint4 buf_size,
+                                Uint4& unpacked_size)
+{
+    string error;
+    if (!s_GetPacker()->Unpack(data, data_size, buffer, buf_size,
+                               unpacked_size, error))
+    {
+        SRV_LOG(Critical, "Cannot decompress chunk data: " << error
+                          << ". Deleting blob.");
+        return false;
+    }
+    return true;
+}
+
+CSrvRef<SNCDiskIORequest>
+CNCBlobStorage::PrefetchChunkData(SNCBlobVerData* ver_data,
+                                  SNCChunkMaps* maps,
+                                  Uint8 chunk_num,
+                                  CSrvTask* waiter)
+{
+    Uint2 chunk_idx = 0;
+    CSrvRef<SNCDBFileInfo> data_file;
+    SFileIndexRec* data_ind = NULL;
+    if (!s_FindChunkData(ver_data, maps, chunk_num, chunk_idx, data_file, data_ind)
+        ||  data_ind->rec_type != eFileRecChunkData)
+    {
+        // Let ReadChunkData() deal with the problem.
+        return CSrvRef<SNCDiskIORequest>();
+    }
+    return CNCDiskIO::StartRead(data_file,
+                                s_CalcRecordAddress(data_file, data_ind),
+                                data_ind->rec_size, waiter);
+}
+
+const char*
+CNCBlobStorage::GetChunkDataFile(SNCBlobVerData* ver_data,
+                                 SNCChunkMaps* maps,
+                                 Uint8 chunk_num,
+                                 CSrvRef<SNCDBFileInfo>& data_file)
+{
+    Uint2 chunk_idx = 0;
+    SFileIndexRec* data_ind = NULL;
+    if (!s_FindChunkData(ver_data, maps, chunk_num, chunk_idx, data_file, data_ind)
+        ||  data_ind->rec_type != eFileRecChunkData  ||  data_ind->rec_packed)
+    {
+        data_file.Reset();
+        return NULL;
+    }
+    return (const char*)s_CalcChunkAddress(data_file, data_ind)->chunk_data;
+}
+
 char*
 CNCBlobStorage::WriteChunkData(SNCBlobVerData* ver_data,
                                SNCChunkMaps* maps,
                                SNCCacheData* cache_data,
                                Uint8 chunk_num,
                                char* buffer,
-                               Uint4 buf_size)
+                               Uint4 buf_size,
+                               bool& packed)
 {
     Uint2 map_idx[kNCMaxBlobMapsDepth] = {0};
     Uint1 cur_index = 0;
@@ -2613,10 +2953,16 @@ CNCAlerts::Register(CNCAlerts::eDebugWriteChunkData1,"chunk number");
             maps->maps[i]->map_idx = map_idx[i + 1];
     }
 
+    Uint4 packed_size = 0;
+    const char* packed_data = s_PackChunk(ver_data, buffer, buf_size, packed_size);
+    packed = packed_data != NULL;
+    const char* rec_data = packed ? packed_data : buffer;
+    Uint4 data_size = packed ? packed_size : buf_size;
+
     SNCDataCoord data_coord;
     CSrvRef<SNCDBFileInfo> data_file;
     SFileIndexRec* data_ind;
-    Uint4 rec_size = s_CalcChunkRecSize(buf_size);
+    Uint4 rec_size = s_CalcChunkRecSize(data_size);
     if (!s_GetNextWriteCoord(eFileIndexData, rec_size, data_coord, data_file, data_ind)) {
 #ifdef _DEBUG
 CNCAlerts::Register(CNCAlerts::eDebugWriteChunkData2,"s_GetNextWriteCoord");
@@ -2625,11 +2971,18 @@ CNCAlerts::Register(CNCAlerts::eDebugWriteChunkData2,"s_GetNextWriteCoord");
     }
 
     data_ind->rec_type = eFileRecChunkData;
+    data_ind->rec_packed = packed;
     data_ind->cache_data = cache_data;
     SFileChunkDataRec* data_rec = s_CalcChunkAddress(data_file, data_ind);
     data_rec->chunk_num = chunk_num;
     data_rec->chunk_idx = map_idx[0];
-    memcpy(data_rec->chunk_data, buffer, buf_size);
+    memcpy(data_rec->chunk_data, rec_data, data_size);
+    AtomicAdd(s_ClientDiskBytes, data_size);
+    if (packed) {
+        AtomicAdd(s_PackedDataSize, buf_size);
+        AtomicAdd(s_PackedStoredSize, packed_size);
+    }
+    CNCDiskIO::StartWrite(data_file, (char*)data_rec, rec_size);
 
     maps->maps[0]->coords[map_idx[0]] = data_coord;
 
@@ -2666,6 +3019,15 @@ CNCBlobStorage::ChangeCacheDeadTime(SNCCacheData* cache_data)
     table->lock.Unlock();
 }
 
+void
+CNCBlobStorage::UpdateSyncDigest(SNCCacheData* cache_data)
+{
+    SBucketCache* cache = s_GetBucketCache(cache_data->time_bucket);
+    cache->lock.Lock();
+    s_SetSyncDigest(cache, cache_data, s_CalcSyncDigest(cache_data));
+    cache->lock.Unlock();
+}
+
 Uint8
 CNCBlobStorage::GetMaxSyncLogRecNo(void)
 {
@@ -2713,6 +3075,18 @@ CNCBlobStorage::GetMaxBlobSizeStore(void)
     return s_MaxBlobSizeStore;
 }
 
+Uint8
+CNCBlobStorage::GetSendFileMinSize(void)
+{
+    return s_SendFileMinSize;
+}
+
+Int8
+CNCBlobStorage::GetDBLogicalSize(void)
+{
+    return s_CurDBSize + s_PackedDataSize - s_PackedStoredSize;
+}
+
 Int8
 CNCBlobStorage::GetDiskFree(void)
 {
@@ -2834,12 +3208,36 @@ CNCBlobStorage::GetLatestBlobExpire(void)
 }
 
 void
-CNCBlobStorage::GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst, const CNCPeerControl* peer)
+CNCBlobStorage::GetSyncTree(Uint2 slot, TNCSyncTree& tree)
+{
+    Uint2 slot_buckets = CNCDistributionConf::GetCntSlotBuckets();
+    Uint2 bucket_num = (slot - 1) * slot_buckets + 1;
+    tree.resize(size_t(slot_buckets) * kNCSyncTreeLeaves);
+    Uint8* leaf = tree.data();
+    for (Uint2 i = 0; i < slot_buckets; ++i, ++bucket_num) {
+        SBucketCache* cache = s_GetBucketCache(bucket_num);
+        cache->lock.Lock();
+        memcpy(leaf, cache->sync_tree, sizeof(cache->sync_tree));
+        cache->lock.Unlock();
+        leaf += kNCSyncTreeLeaves;
+    }
+}
+
+void
+CNCBlobStorage::GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst,
+                                 const CNCPeerControl* peer,
+                                 const TNCSyncTreeLeaves* leaves)
 {
     blobs_lst.clear();
     Uint2 slot_buckets = CNCDistributionConf::GetCntSlotBuckets();
     Uint2 bucket_num = (slot - 1) * slot_buckets + 1;
     for (Uint2 i = 0; i < slot_buckets; ++i, ++bucket_num) {
+        Uint4 first_leaf = Uint4(i) * kNCSyncTreeLeaves;
+        if (leaves) {
+            TNCSyncTreeLeaves::const_iterator it_leaf = leaves->lower_bound(first_leaf);
+            if (it_leaf == leaves->end()  ||  *it_leaf >= first_leaf + kNCSyncTreeLeaves)
+                continue;
+        }
         SBucketCache* cache = s_GetBucketCache(bucket_num);
 
         cache->lock.Lock();
@@ -2853,16 +3251,23 @@ CNCBlobStorage::GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst, const CN
 
         ITERATE(TKeyMap, it, cache->key_map) {
 #if __NC_CACHEDATA_INTR_SET
-            new (info_ptr) SNCTempBlobInfo(*it);
+            const SNCCacheData& cache_data = *it;
 #else
-            new (info_ptr) SNCTempBlobInfo(**it);
+            const SNCCacheData& cache_data = **it;
 #endif
+            if (leaves  &&  leaves->find(first_leaf + s_GetSyncTreeLeaf(cache_data.key))
+                                                            == leaves->end())
+            {
+                continue;
+            }
+            new (info_ptr) SNCTempBlobInfo(cache_data);
             ++info_ptr;
         }
         cache->lock.Unlock();
+        cnt_blobs = info_ptr - (SNCTempBlobInfo*)big_block;
 
         info_ptr = (SNCTempBlobInfo*)big_block;
-        for (Uint8 i = 0; i < cnt_blobs; ++i) {
+        for (Uint8 i = 0; i < cnt_blobs; ++i, ++info_ptr) {
             Uint2 key_slot = 0, key_bucket = 0;
             if (!CNCDistributionConf::GetSlotByKey(info_ptr->key, key_slot, key_bucket) ||
                 key_slot != slot /*|| key_bucket != bucket_num*/) {
@@ -2875,27 +3280,21 @@ CNCBlobStorage::GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst, const CN
                           ", expected bucket: " << bucket_num << ", calculated bucket: " << key_bucket);
             }
 
-            if (info_ptr->size > CNCDistributionConf::GetMaxBlobSizeSync()) {
-                if (CNCDistributionConf::IsThisServerKey(info_ptr->key)) {
-                    continue;
-                }
-            }
-
-            if (peer && !peer->AcceptsBlobKey(info_ptr->key)) {
-                continue;
+            if (s_IsBlobListedForSync(info_ptr->key, info_ptr->size)
+                &&  (!peer  ||  peer->AcceptsBlobKey(info_ptr->key)))
+            {
+                SNCBlobSummary* blob_sum = new SNCBlobSummary();
+                blob_sum->size           = info_ptr->size;
+                blob_sum->create_id      = info_ptr->create_id;
+                blob_sum->create_server  = info_ptr->create_server;
+                blob_sum->create_time    = info_ptr->create_time;
+                blob_sum->dead_time      = info_ptr->dead_time;
+                blob_sum->expire         = info_ptr->expire;
+                blob_sum->ver_expire     = info_ptr->ver_expire;
+                blobs_lst[info_ptr->key] = blob_sum;
             }
-            SNCBlobSummary* blob_sum = new SNCBlobSummary();
-            blob_sum->size           = info_ptr->size;
-            blob_sum->create_id      = info_ptr->create_id;
-            blob_sum->create_server  = info_ptr->create_server;
-            blob_sum->create_time    = info_ptr->create_time;
-            blob_sum->dead_time      = info_ptr->dead_time;
-            blob_sum->expire         = info_ptr->expire;
-            blob_sum->ver_expire     = info_ptr->ver_expire;
-            blobs_lst[info_ptr->key] = blob_sum;
-
+            // Skipped blobs must be destroyed too
             info_ptr->~SNCTempBlobInfo();
-            ++info_ptr;
         }
 
         free(big_block);
@@ -3013,7 +3412,11 @@ CBlobCacher::x_CacheMapRecs(SNCDataCoord map_coord,
             need_size = cache_data->chunk_size;
         else
             need_size = (cache_data->size - 1) % cache_data->chunk_size + 1;
-        if (data_size != need_size) {
+        if (map_ind->rec_packed  &&  data_size < need_size) {
+            m_PackedDataSize += need_size;
+            m_PackedStoredSize += data_size;
+        }
+        else if (data_size != need_size) {
             SRV_LOG(Critical, "Blob " << cache_data->key
                               << " with size " << cache_data->size
                               << " references data record with coord " << map_coord
@@ -3166,12 +3569,15 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
         Uint8 chunk_num = 0;
         typedef map<Uint4, Uint4> TSizesMap;
         TSizesMap sizes_map;
+        m_PackedDataSize = m_PackedStoredSize = 0;
         if (!x_CacheMapRecs(ind_rec->chain_coord, map_depth, coord, 0, cache_data,
                             cnt_chunks, chunk_num, sizes_map))
         {
             delete cache_data;
             return false;
         }
+        AtomicAdd(s_PackedDataSize, m_PackedDataSize);
+        AtomicAdd(s_PackedStoredSize, m_PackedStoredSize);
         ITERATE(TSizesMap, it, sizes_map) {
             CSrvRef<SNCDBFileInfo> info = s_GetDBFileNoLock(it->first);
             info->used_size += it->second;
@@ -3256,8 +3662,10 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
             s_MoveRecToGarbage(old_file, old_ind);
             old_data->coord.clear();
         }
+        s_SetSyncDigest(bucket_cache, old_data, 0);
         delete old_data;
     }
+    s_SetSyncDigest(bucket_cache, cache_data, s_CalcSyncDigest(cache_data));
 #if __NC_CACHEDATA_INTR_SET
     time_table->time_map.insert_equal(*cache_data);
 #else
@@ -3613,6 +4021,8 @@ CBlobCacher::x_CleanOrphanRecs(void)
 }
 
 CBlobCacher::CBlobCacher(void)
+    : m_PackedDataSize(0),
+      m_PackedStoredSize(0)
 {
 #if __NC_TASKS_MONITOR
     m_TaskName = "CBlobCacher";
@@ -3731,6 +4141,7 @@ CExpiredCleaner::x_DeleteNextData(void)
     Uint2 map_size = cache_data->map_size;
     cache_data->coord.clear();
     cache_data->dead_time = 0;
+    CNCBlobStorage::UpdateSyncDigest(cache_data);
     CNCBlobVerManager* mgr = cache_data->Get_ver_mgr();
     if (mgr) {
         mgr->ObtainReference();
@@ -3973,6 +4384,7 @@ CNCAlerts::Register(CNCAlerts::eDebugMoveRecord0,"s_GetNextWriteCoord");
 
     new_ind->cache_data = m_CacheData;
     new_ind->rec_type = m_IndRec->rec_type;
+    new_ind->rec_packed = m_IndRec->rec_packed;
     SNCDataCoord chain_coord = m_IndRec->chain_coord;
     new_ind->chain_coord = chain_coord;
 
@@ -4111,7 +4523,9 @@ CNCAlerts::Register(CNCAlerts::eDebugMoveRecord2,"eFileRecChunkMap");
 #ifdef _DEBUG
 CNCAlerts::Register(CNCAlerts::eDebugMoveRecord3,"eFileRecChunkData");
 #endif
-        if (m_CurVer) {
+        // Compressed chunks are never referenced from version's chunks,
+        // readers always decompress them from the database.
+        if (m_CurVer  &&  !new_ind->rec_packed) {
             SFileChunkDataRec* new_data = s_CalcChunkAddress(new_file, new_ind);
             m_CurVer->chunks[new_data->chunk_num] = (char*)new_data->chunk_data;
         }
@@ -4144,6 +4558,8 @@ CNCAlerts::Register(CNCAlerts::eDebugMoveRecord3,"eFileRecChunkData");
 
     ++m_CntMoved;
     m_SizeMoved += m_IndRec->rec_size + sizeof(SFileIndexRec);
+    m_BatchSize += m_IndRec->rec_size + sizeof(SFileIndexRec);
+    m_Budget -= m_IndRec->rec_size + sizeof(SFileIndexRec);
 
     return &CSpaceShrinker::x_FinishMoveRecord;
 
@@ -4252,6 +4668,7 @@ CSpaceShrinker::x_DeleteNextFile(void)
 #ifdef _DEBUG
 CNCAlerts::Register(CNCAlerts::eDebugDeleteFile,"x_DeleteNextFile");
 #endif
+    CNCStat::DBSpaceReclaimed((*m_CurDelFile)->file_size);
     s_DeleteDBFile(*m_CurDelFile, true);
     m_CurDelFile->Reset();
     ++m_CurDelFile;
@@ -4281,15 +4698,57 @@ CSpaceShrinker::x_StartMoves(void)
     m_CntProcessed = 0;
     m_CntMoved = 0;
     m_SizeMoved = 0;
+    m_PrefetchedTo = 0;
+    m_BatchSize = 0;
+    m_BatchRecs = 0;
+    m_CntThrottled = 0;
 
     return &CSpaceShrinker::x_MoveNextRecord;
 }
 
+/// Whether compaction should go at full speed regardless of client load
+static bool
+s_IsCompactionUrgent(void)
+{
+    return s_IsStopWrite != eNoStop
+           ||  s_GarbageSize * 100 > s_CurDBSize * 2 * s_MaxGarbagePct;
+}
+
+bool
+CSpaceShrinker::x_HasBudget(void)
+{
+    if (s_CompactMaxRate == 0  ||  s_IsCompactionUrgent())
+        return true;
+
+    int cur_time = CSrvTime::CurSecs();
+    if (cur_time != m_BudgetTime) {
+        // Bandwidth left from clients during the last period is given to
+        // compaction, but it's never starved completely.
+        Uint8 client_bytes = ACCESS_ONCE(s_ClientDiskBytes);
+        // Client I/O before the first call is not in any period
+        if (m_BudgetTime == 0)
+            m_LastClientBytes = client_bytes;
+        Int8 client_rate = Int8(client_bytes - m_LastClientBytes);
+        if (m_BudgetTime != 0  &&  cur_time > m_BudgetTime + 1)
+            client_rate /= cur_time - m_BudgetTime;
+        m_LastClientBytes = client_bytes;
+        m_BudgetTime = cur_time;
+        m_Budget = max(s_CompactMinRate, s_CompactMaxRate - client_rate);
+    }
+    return m_Budget > 0;
+}
+
 CSpaceShrinker::State
 CSpaceShrinker::x_MoveNextRecord(void)
 {
     if (CTaskServer::IsInShutdown())
         return &CSpaceShrinker::x_FinishMoves;
+    if (!x_HasBudget()) {
+        ++m_CntThrottled;
+        m_BatchSize = m_BatchRecs = 0;
+        RunAfter(1);
+        return NULL;
+    }
 
     int cur_time = CSrvTime::CurSecs();
     m_MaxFile->info_lock.Lock();
@@ -4324,6 +4783,16 @@ CSpaceShrinker::x_MoveNextRecord(void)
     if (s_IsIndexDeleted(m_MaxFile, m_IndRec))
         return &CSpaceShrinker::x_FinishMoveRecord;
 
+    // Records are placed in the file in the order of their numbers, so
+    // reading the file ahead by large pieces makes moves sequential reads
+    // instead of random page faults.
+    if (s_CompactBatchSize != 0
+        &&  m_IndRec->offset + m_IndRec->rec_size > m_PrefetchedTo)
+    {
+        s_PrefetchFileRange(m_MaxFile, m_IndRec->offset, s_CompactBatchSize);
+        m_PrefetchedTo = m_IndRec->offset + s_CompactBatchSize;
+    }
+
     m_CacheData = m_IndRec->cache_data;
 
 #if __NC_CACHEDATA_ALL_MONITOR
@@ -4503,10 +4972,19 @@ CSpaceShrinker::x_FinishMoveRecord(void)
     ++m_CntProcessed;
     m_PrevRecNum = m_RecNum;
 
-    if (m_Failed || CTaskServer::IsInShutdown())
+    if (m_Failed || CTaskServer::IsInShutdown()) {
         SetState(&CSpaceShrinker::x_FinishMoves);
-    else
+    }
+    else {
+        // Continue without yielding execution until the batch is full.
+        if (++m_BatchRecs < kNCMaxCompactBatchRecs
+            &&  m_BatchSize < s_CompactBatchSize)
+        {
+            return &CSpaceShrinker::x_MoveNextRecord;
+        }
         SetState(&CSpaceShrinker::x_MoveNextRecord);
+    }
+    m_BatchSize = m_BatchRecs = 0;
     SetRunnable();
     return NULL;
 }
@@ -4516,8 +4994,10 @@ CSpaceShrinker::x_FinishMoves(void)
 {
     if (!m_Failed) {
         m_MaxFile->is_releasing = true;
-        if (m_MaxFile->used_size == 0)
+        if (m_MaxFile->used_size == 0) {
+            CNCStat::DBSpaceReclaimed(m_MaxFile->file_size);
             s_DeleteDBFile(m_MaxFile, true);
+        }
         else if (m_CntProcessed == 0) {
             SRV_LOG(Warning, "Didn't find anything to process in the file");
             m_MaxFile->next_shrink_time = CSrvTime::CurSecs() + max(s_MinMoveLife, 300);
@@ -4531,10 +5011,14 @@ CSpaceShrinker::x_FinishMoves(void)
     }
     m_MaxFile.Reset();
 
+    int move_time = CSrvTime::CurSecs() - m_StartTime;
     CSrvDiagMsg().PrintExtra()
                  .PrintParam("cnt_processed", m_CntProcessed)
                  .PrintParam("cnt_moved", m_CntMoved)
-                 .PrintParam("size_moved", m_SizeMoved);
+                 .PrintParam("size_moved", m_SizeMoved)
+                 .PrintParam("move_time", move_time)
+                 .PrintParam("move_rate", m_SizeMoved / Uint4(max(move_time, 1)))
+                 .PrintParam("cnt_throttled", m_CntThrottled);
     CSrvDiagMsg().StopRequest();
     ReleaseDiagCtx();
     CNCStat::DBFileCleaned(!m_Failed, m_CntProcessed, m_CntMoved, m_SizeMoved);
@@ -4556,6 +5040,13 @@ CSpaceShrinker::x_FinishSession(void)
 }
 
 CSpaceShrinker::CSpaceShrinker(void)
+    : m_Budget(0),
+      m_BudgetTime(0),
+      m_LastClientBytes(0),
+      m_PrefetchedTo(0),
+      m_BatchSize(0),
+      m_BatchRecs(0),
+      m_CntThrottled(0)
 {
 #if __NC_TASKS_MONITOR
     m_TaskName = "CSpaceShrinker";
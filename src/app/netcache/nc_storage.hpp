@@ -42,6 +42,7 @@ BEGIN_NCBI_SCOPE
 class CNCBlobAccessor;
 struct SNCStateStat;
 class CNCPeerControl;
+struct SNCDiskIORequest;
 
 
 struct STimeTable_tag;
@@ -63,6 +64,9 @@ public:
     SNCDataCoord coord;
     string key;
     int saved_dead_time;
+    /// Digest of blob's summary as it's accounted in the synchronization
+    /// hash tree (0 if blob is not accounted there)
+    Uint8 sync_digest;
     Uint2 time_bucket;
     Uint2 map_size;
     Uint4 chunk_size;
@@ -130,6 +134,8 @@ public:
     static size_t GetNDBFiles(void);
     /// Get total size of database for the storage
     static Int8 GetDBSize(void);
+    /// Size the database would have if no blob data were compressed
+    static Int8 GetDBLogicalSize(void);
     static Int8 GetDiskFree(void);
     static Int8 GetAllowedDBSize(Int8 free_space);
     static bool IsDBSizeAlert(void);
@@ -137,7 +143,16 @@ public:
     static void MeasureDB(SNCStateStat& state);
 
     static int GetLatestBlobExpire(void);
-    static void GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst, const CNCPeerControl* peer);
+    /// Get list of blobs in the slot. If leaves is not NULL then only blobs
+    /// falling into given leaves of the synchronization hash tree are listed.
+    static void GetFullBlobsList(Uint2 slot, TNCBlobSumList& blobs_lst,
+                                 const CNCPeerControl* peer,
+                                 const TNCSyncTreeLeaves* leaves = NULL);
+    /// Get leaves of the synchronization hash tree of the slot. Each leaf is
+    /// XOR of digests of all blobs falling into it, leaves are maintained
+    /// incrementally on each change of the blobs, so equal leaves on two
+    /// servers mean (with very high probability) equal sets of blobs.
+    static void GetSyncTree(Uint2 slot, TNCSyncTree& tree);
     static Uint8 GetMaxSyncLogRecNo(void);
     static void SaveMaxSyncLogRecNo(void);
 
@@ -145,6 +160,9 @@ public:
     static void SavePurgeData(void);
 
     static Uint8 GetMaxBlobSizeStore(void);
+    /// Minimum size of blob which data is sent to clients directly from
+    /// database files with sendfile(). 0 means it's never done.
+    static Uint8 GetSendFileMinSize(void);
 public:
     // For internal use only
 
@@ -168,17 +186,51 @@ public:
                               SNCChunkMaps* maps,
                               Uint8 chunk_num,
                               char*& buffer,
-                              Uint4& buf_size);
+                              Uint4& buf_size,
+                              bool& packed);
+    /// Decompress data of the chunk read by ReadChunkData() with packed set
+    /// to TRUE. buf_size is the size of buffer which should be enough for
+    /// the whole chunk.
+    static bool UnpackChunkData(const char* data,
+                                Uint4 data_size,
+                                char* buffer,
+                                Uint4 buf_size,
+                                Uint4& unpacked_size);
+    /// Make sure that data of chunk number chunk_num is in memory. If it's
+    /// not there yet then disk read is started and returned, waiter will be
+    /// made runnable when it finishes. NULL is returned if data can be
+    /// accessed right away (or if disk I/O engine is not active).
+    static CSrvRef<SNCDiskIORequest> PrefetchChunkData(SNCBlobVerData* ver_data,
+                                                       SNCChunkMaps* maps,
+                                                       Uint8 chunk_num,
+                                                       CSrvTask* waiter);
+    /// Find database file containing data of chunk number chunk_num.
+    /// Returns address of chunk's data in the file's memory mapping or NULL
+    /// if data cannot be found.
+    static const char* GetChunkDataFile(SNCBlobVerData* ver_data,
+                                        SNCChunkMaps* maps,
+                                        Uint8 chunk_num,
+                                        CSrvRef<SNCDBFileInfo>& data_file);
+    /// Account data of uncompressed chunk sent to client or peer right
+    /// from the database file (through memory mapping or with sendfile())
+    /// in disk bandwidth used for clients.
+    static void AddClientDiskBytes(Uint4 size);
+    /// Write data of chunk number chunk_num into the database. If data was
+    /// compressed on the way then packed is set to TRUE and the returned
+    /// pointer cannot be used to read chunk's data.
     static char* WriteChunkData(SNCBlobVerData* ver_data,
                                 SNCChunkMaps* maps,
                                 SNCCacheData* cache_data,
                                 Uint8 chunk_num,
                                 char* buffer,
-                                Uint4 buf_size);
+                                Uint4 buf_size,
+                                bool& packed);
 
     static void ReferenceCacheData(SNCCacheData* cache_data);
     static void ReleaseCacheData(SNCCacheData* cache_data);
     static void ChangeCacheDeadTime(SNCCacheData* cache_data);
+    /// Account changed summary of the blob in the synchronization hash tree
+    static void UpdateSyncDigest(SNCCacheData* cache_data);
 
 private:
     CNCBlobStorage(void);
@@ -192,6 +244,7 @@ private:
 inline
 SNCCacheData::SNCCacheData(void)
     : saved_dead_time(0),
+      sync_digest(0),
       time_bucket(0),
       map_size(0),
       chunk_size(0),
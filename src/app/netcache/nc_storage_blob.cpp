@@ -607,6 +607,7 @@ CNCBlobVerManager::x_DeleteCurVersion(void)
     m_CacheData->dead_time = 0;
     CNCBlobStorage::ChangeCacheDeadTime(m_CacheData);
     m_CacheData->expire = 0;
+    CNCBlobStorage::UpdateSyncDigest(m_CacheData);
     if (m_CurVersion) {
         m_CurVersion->SetNotCurrent();
         m_CurVersion.Reset();
@@ -941,6 +942,7 @@ CNCBlobVerManager::FinalizeWriting(SNCBlobVerData* ver_data)
         m_CacheData->size = m_CurVersion->size;
         m_CacheData->chunk_size = m_CurVersion->chunk_size;
         m_CacheData->map_size = m_CurVersion->map_size;
+        CNCBlobStorage::UpdateSyncDigest(m_CacheData);
 
         m_CurVersion->meta_has_changed = true;
         m_CurVersion->last_access_time = CSrvTime::CurSecs();
@@ -965,6 +967,7 @@ CNCBlobVerManager::DeadTimeChanged(SNCBlobVerData* ver_data)
         m_CacheData->dead_time = ver_data->dead_time;
         m_CacheData->expire = ver_data->expire;
         m_CacheData->ver_expire = ver_data->ver_expire;
+        CNCBlobStorage::UpdateSyncDigest(m_CacheData);
         m_CurVersion->last_access_time = CSrvTime::CurSecs();
         m_CurVersion->need_write_time = m_CurVersion->last_access_time
                                         + s_WBWriteTimeout;
@@ -1090,6 +1093,7 @@ SNCBlobVerData::SNCBlobVerData(CNCBlobVerManager* mgr)
         need_stop_write(false),
         need_mem_release(false),
         delete_scheduled(false),
+        no_packing(false),
         map_move_counter(0),
         last_access_time(0),
         need_write_time(0),
@@ -1303,9 +1307,11 @@ SNCBlobVerData::x_WriteCurChunk(char* write_mem, Uint4 write_size)
         need_stop_write = true;
         return true;
     }
+    bool packed = false;
     char* new_mem = CNCBlobStorage::WriteChunkData(
                                         this, chunk_maps, mgr->GetCacheData(),
-                                        cur_chunk_num, write_mem, write_size);
+                                        cur_chunk_num, write_mem, write_size,
+                                        packed);
     if (!new_mem) {
         RunAfter(s_WBFailedWriteDelay);
         return false;
@@ -1313,7 +1319,8 @@ SNCBlobVerData::x_WriteCurChunk(char* write_mem, Uint4 write_size)
     CNCStat::DiskDataWrite(write_size);
 
     wb_mem_lock.Lock();
-    chunks[cur_chunk_num] = new_mem;
+    // Readers will decompress chunk from disk if it was written compressed.
+    chunks[cur_chunk_num] = packed ? NULL : new_mem;
     ++cur_chunk_num;
     if (data_mem < write_size) {
         SRV_FATAL("blob ver data broken");
@@ -1474,9 +1481,12 @@ SNCBlobVerData::AddChunkMem(char* mem, Uint4 mem_size)
 
 CNCBlobAccessor::CNCBlobAccessor(void)
     : m_ChunkMaps(NULL),
+      m_ChunkFileData(NULL),
+      m_FileChunk(0),
       m_MetaInfoReady(false),
       m_WriteMemRequested(false),
-      m_Buffer(NULL)
+      m_Buffer(NULL),
+      m_UnpackBuf(NULL)
 {
 #if __NC_TASKS_MONITOR
     m_TaskName = "CNCBlobAccessor";
@@ -1526,6 +1536,19 @@ CNCBlobAccessor::Initialize(SNCCacheData* cache_data)
 void
 CNCBlobAccessor::Deinitialize(void)
 {
+    if (m_DiskIOReq.NotNull()) {
+        CNCDiskIO::CancelWait(m_DiskIOReq);
+        m_DiskIOReq.Reset();
+    }
+    m_ChunkFile.Reset();
+    m_ChunkFileData = NULL;
+    if (m_UnpackBuf) {
+        if (m_Buffer == m_UnpackBuf)
+            m_Buffer = NULL;
+        delete[] m_UnpackBuf;
+        s_SubCurrentMem(m_CurData->chunk_size);
+        m_UnpackBuf = NULL;
+    }
     switch (m_AccessType) {
     case eNCReadData:
         if (m_ChunkMaps) {
@@ -1618,11 +1641,20 @@ CNCBlobAccessor::GetReadMemSize(void)
     }
     if (m_Buffer) {
         if (m_ChunkPos < m_ChunkSize) {
-            m_Buffer = m_CurData->chunks[m_CurChunk];
-            return m_ChunkSize - m_ChunkPos;
+            if (m_Buffer == m_UnpackBuf)
+                return m_ChunkSize - m_ChunkPos;
+            char* cur_buf = ACCESS_ONCE(m_CurData->chunks[m_CurChunk]);
+            if (cur_buf) {
+                m_Buffer = cur_buf;
+                return m_ChunkSize - m_ChunkPos;
+            }
+            // Chunk was just written to disk compressed, it has to be read
+            // from there.
+        }
+        else {
+            ++m_CurChunk;
+            m_ChunkPos = 0;
         }
-        ++m_CurChunk;
-        m_ChunkPos = 0;
     }
 
     Uint8 need_size = m_CurData->size - GetPosition() + m_ChunkPos;
@@ -1639,16 +1671,50 @@ CNCBlobAccessor::GetReadMemSize(void)
         m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
         s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
     }
+    if (m_DiskIOReq.NotNull()) {
+        // Wait for the disk read started earlier. Owner will be made
+        // runnable when it's finished.
+        if (!CNCDiskIO::IsFinished(m_DiskIOReq))
+            return 0;
+        m_DiskIOReq.Reset();
+    }
+    else if (CNCDiskIO::IsEnabled()) {
+        m_DiskIOReq = CNCBlobStorage::PrefetchChunkData(m_CurData, m_ChunkMaps,
+                                                        m_CurChunk, m_Owner);
+        if (m_DiskIOReq.NotNull())
+            return 0;
+    }
+    bool packed = false;
     if (!CNCBlobStorage::ReadChunkData(m_CurData, m_ChunkMaps, m_CurChunk,
-                                       m_Buffer, m_ChunkSize))
+                                       m_Buffer, m_ChunkSize, packed))
     {
         x_DelCorruptedVersion();
         return 0;
     }
+    if (packed) {
+        if (!m_UnpackBuf) {
+            m_UnpackBuf = new char[m_CurData->chunk_size];
+            s_AddCurrentMem(m_CurData->chunk_size);
+        }
+        CNCStat::DiskDataRead(m_ChunkSize);
+        if (!CNCBlobStorage::UnpackChunkData(m_Buffer, m_ChunkSize, m_UnpackBuf,
+                                             Uint4(need_size), m_ChunkSize))
+        {
+            m_Buffer = NULL;
+            x_DelCorruptedVersion();
+            return 0;
+        }
+        m_Buffer = m_UnpackBuf;
+    }
     if (m_ChunkSize != need_size) {
+        m_Buffer = NULL;
         x_DelCorruptedVersion();
         return 0;
     }
+    if (packed) {
+        // Decompressed data is private to this accessor.
+        return m_ChunkSize - m_ChunkPos;
+    }
 
     ACCESS_ONCE(m_CurData->chunks[m_CurChunk]) = m_Buffer;
     return m_ChunkSize - m_ChunkPos;
@@ -1663,7 +1729,45 @@ CNCBlobAccessor::MoveReadPos(Uint4 move_size)
         &&  m_Buffer == m_CurData->chunks[m_CurChunk])
     {
         CNCStat::DiskDataRead(move_size);
+        CNCBlobStorage::AddClientDiskBytes(move_size);
+    }
+}
+
+bool
+CNCBlobAccessor::GetReadFileRange(int& file_fd, Uint8& offset)
+{
+#ifdef NCBI_OS_MSWIN
+    return false;
+#else
+    if (m_CurData->cur_chunk_num <= m_CurChunk
+        ||  m_Buffer != m_CurData->chunks[m_CurChunk])
+    {
+        // Chunk is still in write-back memory.
+        return false;
+    }
+    if (m_ChunkFile.IsNull()  ||  m_FileChunk != m_CurChunk
+        ||  m_ChunkFileData != m_Buffer)
+    {
+        if (!m_ChunkMaps) {
+            m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
+            s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
+        }
+        m_FileChunk = m_CurChunk;
+        m_ChunkFileData = CNCBlobStorage::GetChunkDataFile(m_CurData, m_ChunkMaps,
+                                                           m_CurChunk, m_ChunkFile);
+        if (m_ChunkFileData != m_Buffer) {
+            // Chunk was moved to another place by the space shrinker (old
+            // place is still mapped and valid) or database is corrupted.
+            // Anyway data will be read from memory.
+            m_ChunkFile.Reset();
+            m_ChunkFileData = NULL;
+            return false;
+        }
     }
+    file_fd = m_ChunkFile->fd;
+    offset = Uint8(m_Buffer - m_ChunkFile->file_map) + m_ChunkPos;
+    return true;
+#endif
 }
 
 void
@@ -30,6 +30,7 @@
 
 
 #include "nc_db_info.hpp"
+#include "nc_disk_io.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -135,6 +136,11 @@ public:
     Uint4 GetReadMemSize(void);
     const void* GetReadMemPtr(void);
     void MoveReadPos(Uint4 move_size);
+    /// Get database file and offset in it where the data returned by
+    /// GetReadMemPtr() is located. Can be called only after GetReadMemSize()
+    /// returned non-zero. Returns FALSE if data is not written to disk yet
+    /// and thus can be read only from memory.
+    bool GetReadFileRange(int& file_fd, Uint8& offset);
     unsigned int GetCurBlobTTL(void) const;
     unsigned int GetNewBlobTTL(void) const;
     /// Set blob's timeout after last access before it will be deleted.
@@ -238,6 +244,13 @@ private:
     CSrvRef<SNCBlobVerData> m_CurData;
     CSrvRef<SNCBlobVerData> m_NewData;
     SNCChunkMaps*           m_ChunkMaps;
+    /// Disk read of current chunk in progress
+    CSrvRef<SNCDiskIORequest> m_DiskIOReq;
+    /// Database file containing data of chunk m_FileChunk, used when data
+    /// is sent to client directly from the file.
+    CSrvRef<SNCDBFileInfo> m_ChunkFile;
+    const char* m_ChunkFileData;
+    Uint8       m_FileChunk;
     bool        m_HasError;
     bool        m_MetaInfoReady;
     bool        m_WriteMemRequested;
@@ -248,6 +261,8 @@ private:
     Uint4       m_ChunkSize;
     Uint8       m_SizeRead;
     char*       m_Buffer;
+    /// Buffer for decompressed data of current chunk
+    char*       m_UnpackBuf;
     CSrvTask*   m_Owner;
 };
 
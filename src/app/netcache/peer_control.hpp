@@ -181,6 +181,7 @@ public:
     bool AcceptsBList2(void) const;
     bool AcceptsUserFlags(void) const;
     bool AcceptsPurge2(void) const;
+    bool AcceptsSyncTree(void) const;
 
 private:
     CNCPeerControl(Uint8 srv_id);
@@ -330,6 +331,12 @@ CNCPeerControl::AcceptsPurge2(void) const
     return m_HostProtocol >= 61107;
 }
 
+inline bool
+CNCPeerControl::AcceptsSyncTree(void) const
+{
+    return m_HostProtocol >= 61108;
+}
+
 inline void
 CNCPeerControl::ConnOk(void)
 {
@@ -60,6 +60,10 @@ static CNCLogCleaner* s_LogCleaner;
 
 static FILE* s_LogFile = NULL;
 
+/// Maximum number of hash tree leaves requested in one SYNC_BLIST command.
+/// The whole command must fit into socket's read buffer on the other side.
+static const size_t kNCMaxSyncTreeReqLeaves = 100;
+
 
 template <typename Type> void
 s_ShuffleList( vector<Type>& lst)
@@ -787,6 +791,9 @@ CNCActiveSyncControl::x_DoPeriodicSync(void)
     m_Hint = NC_SYNC_HINT;
     m_Progress = 0;
     m_SlotSrv->is_by_blobs = false;
+    m_ByTree = false;
+    m_RemoteTree.clear();
+    m_DiffLeaves.clear();
     m_StartedCmds = 0;
     m_FinishSyncCalled = false;
     m_NextTask = eSynNoTask;
@@ -839,8 +846,15 @@ CNCActiveSyncControl::x_WaitSyncStarted(void)
     m_NeedReply = true;
     m_LocalSyncedRecNo = 0;
     m_RemoteSyncedRecNo = 0;
+    if (m_SlotSrv->is_by_blobs) {
+        // Local changes made after that are not guaranteed to get into the
+        // tree or the blob lists, they will be synced by events next time.
+        m_LocalSyncedRecNo = CNCSyncLog::GetCurrentRecNo(m_Slot);
+    }
     m_SlotSrv->last_active_time = CSrvTime::CurSecs();
     // depending on the reply
+    if (m_SlotSrv->is_by_blobs  &&  !m_RemoteTree.empty())
+        return &CNCActiveSyncControl::x_PrepareSyncByTree;
     if (m_SlotSrv->is_by_blobs)
         return &CNCActiveSyncControl::x_PrepareSyncByBlobs;
     else
@@ -952,7 +966,8 @@ CNCActiveSyncControl::x_FinishSync(void)
     }
 
     CSrvDiagMsg().PrintExtra()
-                 .PrintParam("sync", (m_SlotSrv->is_by_blobs? "blobs": "events"))
+                 .PrintParam("sync", (m_SlotSrv->is_by_blobs? (m_ByTree? "tree": "blobs"): "events"))
+                 .PrintParam("diff_leaves", Uint8(m_DiffLeaves.size()))
                  .PrintParam("r_ok", m_ReadOK)
                  .PrintParam("r_err", m_ReadERR)
                  .PrintParam("w_ok", m_WriteOK)
@@ -1051,6 +1066,57 @@ CNCActiveSyncControl::x_PrepareSyncByEvents(void)
 #endif
 }
 
+CNCActiveSyncControl::State
+CNCActiveSyncControl::x_PrepareSyncByTree(void)
+{
+    TNCSyncTree local_tree;
+    CNCBlobStorage::GetSyncTree(m_Slot, local_tree);
+    m_DiffLeaves.clear();
+    // Trees can differ in size only if servers have different number of
+    // buckets per slot, then full lists of blobs are compared.
+    m_ByTree = local_tree.size() == m_RemoteTree.size();
+    if (m_ByTree) {
+        for (Uint4 i = 0; i < Uint4(local_tree.size()); ++i) {
+            if (local_tree[i] != m_RemoteTree[i])
+                m_DiffLeaves.insert(i);
+        }
+    }
+    m_RemoteTree.clear();
+    m_NextLeaf = m_DiffLeaves.begin();
+    m_SlotSrv->last_active_time = CSrvTime::CurSecs();
+    return &CNCActiveSyncControl::x_RequestBlobList;
+}
+
+CNCActiveSyncControl::State
+CNCActiveSyncControl::x_RequestBlobList(void)
+{
+    if (m_ByTree  &&  m_NextLeaf == m_DiffLeaves.end())
+        return &CNCActiveSyncControl::x_PrepareSyncByBlobs;
+
+    CNCActiveHandler* conn = m_SlotSrv->peer->GetBGConn();
+    if (!conn) {
+        m_Result = eSynNetworkError;
+        m_Hint = NC_SYNC_HINT;
+        return &CNCActiveSyncControl::x_FinishSync;
+    }
+
+    m_StartedCmds = 1;
+    if (m_ByTree) {
+        TNCSyncTreeLeaves leaves;
+        for (; m_NextLeaf != m_DiffLeaves.end()
+               &&  leaves.size() < kNCMaxSyncTreeReqLeaves; ++m_NextLeaf)
+        {
+            leaves.insert(*m_NextLeaf);
+        }
+        conn->SyncBlobsList(this, &leaves);
+    }
+    else {
+        conn->SyncBlobsList(this);
+    }
+    m_SlotSrv->last_active_time = CSrvTime::CurSecs();
+    return &CNCActiveSyncControl::x_WaitForBlobList;
+}
+
 CNCActiveSyncControl::State
 CNCActiveSyncControl::x_WaitForBlobList(void)
 {
@@ -1064,13 +1130,16 @@ CNCActiveSyncControl::x_WaitForBlobList(void)
     if (m_Result != eSynOK)
         return &CNCActiveSyncControl::x_FinishSync;
 
+    if (m_ByTree)
+        return &CNCActiveSyncControl::x_RequestBlobList;
     return &CNCActiveSyncControl::x_PrepareSyncByBlobs;
 }
 
 CNCActiveSyncControl::State
 CNCActiveSyncControl::x_PrepareSyncByBlobs(void)
 {
-    m_LocalSyncedRecNo = CNCSyncLog::GetCurrentRecNo(m_Slot);
+    // Both rec numbers were taken before the trees (or the first lists of
+    // blobs) were made, see x_WaitSyncStarted() and BlobsListResponse().
     m_RemoteSyncedRecNo = m_RemoteStartRecNo;
     m_SlotSrv->last_active_time = CSrvTime::CurSecs();
 
@@ -1078,7 +1147,8 @@ CNCActiveSyncControl::x_PrepareSyncByBlobs(void)
         delete it->second;
     }
     m_LocalBlobs.clear();
-    CNCBlobStorage::GetFullBlobsList(m_Slot, m_LocalBlobs, NULL);
+    CNCBlobStorage::GetFullBlobsList(m_Slot, m_LocalBlobs, NULL,
+                                     m_ByTree? &m_DiffLeaves: NULL);
 
     m_CurLocalBlob = m_LocalBlobs.begin();
     m_CurRemoteBlob = m_RemoteBlobs.begin();
@@ -1094,6 +1164,7 @@ CNCActiveSyncControl::x_CleanSyncObjects(void)
     }
     m_RemoteBlobs.clear();
     m_CurRemoteBlob = m_RemoteBlobs.begin();
+    m_RemoteTree.clear();
 
 #if 0
     ITERATE(TNCBlobSumList, it, m_LocalBlobs) {
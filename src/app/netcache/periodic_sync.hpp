@@ -218,7 +218,8 @@ struct SSyncTaskInfo
     -> x_WaitSyncStarted
             wait for sync started (check m_StartedCmds)
                 NCActiveHandler will report command result using  CmdFinished() method
-            depending on the reply, goto x_PrepareSyncByBlobs, or goto x_PrepareSyncByEvents
+            depending on the reply, goto x_PrepareSyncByTree, x_PrepareSyncByBlobs,
+            or x_PrepareSyncByEvents
 
     -> x_PrepareSyncByEvents
             another server has sent us list of events,
@@ -228,11 +229,24 @@ struct SSyncTaskInfo
             if CNCSyncLog cannot sync event lists (eg, some our info is lost), request blob list
                 goto x_WaitForBlobList
 
+    -> x_PrepareSyncByTree
+            another server has sent us leaves of its hash tree of blobs in the slot,
+            compare them with our tree and remember the leaves that differ
+            goto x_RequestBlobList
+
+    -> x_RequestBlobList
+            request list of blobs from the next portion of differing leaves
+            (or full list of blobs if trees cannot be compared)
+            when nothing left to request, goto x_PrepareSyncByBlobs
+            goto x_WaitForBlobList
+
     -> x_WaitForBlobList
-            once blob list received, goto x_PrepareSyncByBlobs
+            once blob list received, goto x_RequestBlobList if we sync by tree,
+            or x_PrepareSyncByBlobs otherwise
     
     -> x_PrepareSyncByBlobs
-            re-fill list of local blobs (in given slot)
+            re-fill list of local blobs (in given slot, only from differing
+            leaves if we sync by tree)
             goto x_ExecuteSyncCommands
     
     -> x_ExecuteSyncCommands
@@ -264,8 +278,11 @@ public:
 
     Uint2 GetSyncSlot(void);
     void StartResponse(Uint8 local_rec_no, Uint8 remote_rec_no, bool by_blobs);
+    /// Reply to SYNC_BLIST requested after SYNC_START
+    void BlobsListResponse(Uint8 remote_rec_no);
     bool AddStartEvent(SNCSyncEvent* evt);
     bool AddStartBlob(const string& key, SNCBlobSummary* blob_sum);
+    bool AddStartTreeLeaf(Uint8 leaf);
     bool GetNextTask(SSyncTaskInfo& task_info, bool* is_valid = nullptr);
     void ExecuteSyncTask(const SSyncTaskInfo& task_info, CNCActiveHandler* conn);
     void CmdFinished(ESyncResult res, ESynActionType action, CNCActiveHandler* conn, int hint);
@@ -285,6 +302,8 @@ private:
     State x_DoPeriodicSync(void);
     State x_WaitSyncStarted(void);
     State x_PrepareSyncByEvents(void);
+    State x_PrepareSyncByTree(void);
+    State x_RequestBlobList(void);
     State x_WaitForBlobList(void);
     State x_PrepareSyncByBlobs(void);
     State x_ExecuteSyncCommands(void);
@@ -327,6 +346,10 @@ private:
     TNCBlobSumList m_RemoteBlobs;
     TBlobsListIt   m_CurLocalBlob;
     TBlobsListIt   m_CurRemoteBlob;
+    TNCSyncTree    m_RemoteTree;
+    TNCSyncTreeLeaves m_DiffLeaves;
+    TNCSyncTreeLeaves::const_iterator m_NextLeaf;
+    bool           m_ByTree;
     Uint8   m_ReadOK;
     Uint8   m_ReadERR;
     Uint8   m_WriteOK;
@@ -388,6 +411,14 @@ CNCActiveSyncControl::StartResponse(Uint8 local_rec_no,
     m_SlotSrv->is_by_blobs = by_blobs;
 }
 
+inline void
+CNCActiveSyncControl::BlobsListResponse(Uint8 remote_rec_no)
+{
+    // Remote tree was made at SYNC_START, changes after that may be missing
+    // from the lists of blobs.
+    m_RemoteStartRecNo = min(m_RemoteStartRecNo, remote_rec_no);
+}
+
 inline bool
 CNCActiveSyncControl::AddStartEvent(SNCSyncEvent* evt)
 {
@@ -411,6 +442,16 @@ CNCActiveSyncControl::AddStartBlob(const string& key, SNCBlobSummary* blob_sum)
     return true;
 }
 
+inline bool
+CNCActiveSyncControl::AddStartTreeLeaf(Uint8 leaf)
+{
+    if (m_Result != eSynOK) {
+        return false;
+    }
+    m_RemoteTree.push_back(leaf);
+    return true;
+}
+
 END_NCBI_SCOPE
 
 
@@ -45,6 +45,7 @@
 # include <arpa/inet.h>
 # include <netdb.h>
 # include <sys/epoll.h>
+# include <sys/sendfile.h>
 # include <unistd.h>
 # include <fcntl.h>
 # include <errno.h>
@@ -915,6 +916,39 @@ retry:
     return size_t(n_written);
 }
 
+static size_t
+s_SendFileToSocket(CSrvSocketTask* task, int file_fd, Uint8 offset, size_t size)
+{
+    if (!task->m_SockCanWrite  &&  task->m_SeenWriteEvts == task->m_RegWriteEvts)
+        return 0;
+    if (size == 0)
+        return 0;
+
+    task->m_SeenWriteEvts = task->m_RegWriteEvts;
+    ssize_t n_written = 0;
+#ifdef NCBI_OS_LINUX
+    off_t file_pos = off_t(offset);
+retry:
+    n_written = sendfile(task->m_Fd, file_fd, &file_pos, size);
+    if (n_written == -1) {
+        int x_errno = errno;
+        if (x_errno == EINTR)
+            goto retry;
+        if (x_errno == EAGAIN  ||  x_errno == EWOULDBLOCK) {
+            // See comment in s_WriteToSocket().
+            return 0;
+        }
+        LOG_WITH_ERRNO(Warning, "Error sending file to socket", x_errno);
+        task->m_RegError = true;
+        n_written = 0;
+    }
+#endif
+    task->m_WrittenBytes += n_written;
+    task->m_SockCanWrite = size_t(n_written) == size;
+
+    return size_t(n_written);
+}
+
 static inline void
 s_CompactBuffer(char* buf, Uint2& size, Uint2& pos)
 {
@@ -1319,6 +1353,18 @@ CSrvSocketTask::Write(const void* buf, size_t size)
     }
 }
 
+size_t
+CSrvSocketTask::WriteFile(int file_fd, Uint8 offset, size_t size)
+{
+    if (IsWriteDataPending()) {
+        s_FlushData(this);
+        if (IsWriteDataPending())
+            return 0;
+    }
+    s_CompactWrBuffer(this);
+    return s_SendFileToSocket(this, file_fd, offset, size);
+}
+
 void
 CSrvSocketTask::WriteData(const void* buf, size_t size)
 {
@@ -184,6 +184,13 @@ public:
     /// amount of data written which can be 0 if socket is not writable at the
     /// moment.
     size_t Write(const void* buf, size_t size);
+    /// Write into the socket as much as immediately possible of the given
+    /// range of the file, passing data from the file to the socket inside
+    /// kernel (without copying it to user space). All data in internal write
+    /// buffers is sent before that to preserve the order of data. Method
+    /// returns amount of file data written which can be 0 if socket is not
+    /// writable at the moment.
+    size_t WriteFile(int file_fd, Uint8 offset, size_t size);
     /// Flush all data saved in internal write buffers to socket.
     /// Method must be called from inside of ExecuteSlice() of this task and
     /// no other writing methods should be called until FlushIsDone() returns
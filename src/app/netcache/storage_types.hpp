@@ -60,7 +60,8 @@ struct ATTR_PACKED SFileIndexRec
     Uint4   next_num;
     Uint4   offset;
     Uint4   rec_size:24;
-    Uint1   rec_type:8;
+    Uint1   rec_type:7;
+    Uint1   rec_packed:1;   // chunk data is compressed with zstd
     SNCDataCoord chain_coord;
     SNCCacheData* cache_data;
 };
@@ -221,6 +222,9 @@ private:
 
     TFileRecsMap m_RecsMap;
     TRecNumsSet m_NewFileIds;
+    /// Logical and stored sizes of compressed chunks of the blob being cached
+    Uint8 m_PackedDataSize;
+    Uint8 m_PackedStoredSize;
     TNCDBFilesMap::const_iterator m_CurFile;
     TRecNumsSet* m_CurRecsSet;
     TRecNumsSet::iterator m_CurRecIt;
@@ -277,7 +281,9 @@ private:
     -> x_DeleteNextFile: has smth to delete ? delete : x_StartMoves
     -> x_StartMoves: has smth to move ? x_MoveNextRecord : x_FinishSession
     -> x_MoveNextRecord:
-           find what to move;
+           if I/O budget for this second is exhausted, wait for the next one;
+           find what to move (reading ahead the file in large sequential
+           pieces);
            if not found, goto x_FinishMoves;
            if VerMgr for this key exists, goto x_CheckCurVersion;
            else x_MoveRecord;
@@ -293,6 +299,7 @@ private:
     -> x_MoveRecord: move, goto x_FinishMoveRecord
     -> x_FinishMoveRecord: release used resources;
         if move failed ? x_FinishMoves :  x_MoveNextRecord
+        (without yielding execution until the batch is full)
     -> x_FinishMoves: if the file from which we moved records is empty now, delete it;
         save some statistics
         goto x_FinishSession
@@ -319,6 +326,9 @@ private:
     State x_FinishSession(void);
 
     SNCDataCoord x_FindMetaCoord(SNCDataCoord coord, Uint1 max_map_depth);
+    /// Check if moves are allowed by the I/O budget, refilling the budget
+    /// at the start of each second.
+    bool x_HasBudget(void);
 
 
     typedef vector<CSrvRef<SNCDBFileInfo> > TFilesList;
@@ -340,6 +350,17 @@ private:
     bool m_Failed;
     bool m_MovingMeta;
     TFileRecsMap m_RecsMap;
+    /// Amount of data that can be moved until the end of current second
+    Int8 m_Budget;
+    int m_BudgetTime;
+    Uint8 m_LastClientBytes;
+    /// Offset in m_MaxFile up to which kernel was asked to read ahead
+    Uint4 m_PrefetchedTo;
+    /// Amount of data moved and number of records processed in the current
+    /// batch (in one execution slice)
+    Uint4 m_BatchSize;
+    Uint4 m_BatchRecs;
+    Uint4 m_CntThrottled;
 };
 
 
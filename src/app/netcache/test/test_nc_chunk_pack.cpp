@@ -0,0 +1,225 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: unit test for compression of NetCache blob chunks
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/test_boost.hpp>
+
+#include <random>
+#include <string>
+
+#include "../nc_chunk_pack.hpp"
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/// Same as kNCMaxBlobChunkSize of the server
+static const Uint4 kChunkSize = 32740;
+static const int   kLevel     = 3;
+static const int   kMinGain   = 10;
+
+
+// Text-like data that compresses well
+static string s_MakeCompressible(size_t size)
+{
+    static const char* const kWords[] = {
+        "chunk ", "blob ", "NetCache ", "storage ", "key ", "version "
+    };
+    mt19937 rng(12345);
+    string  res;
+    while (res.size() < size)
+        res += kWords[rng() % ArraySize(kWords)];
+    res.resize(size);
+    return res;
+}
+
+#ifdef HAVE_LIBZSTD
+
+// Random bytes that don't compress at all
+static string s_MakeIncompressible(size_t size)
+{
+    mt19937 rng(54321);
+    string  res(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+        res[i] = char(rng());
+    return res;
+}
+
+// Pack the chunk and unpack it back, checking that data is intact
+static void s_RoundTrip(CNCChunkPacker& packer, const string& data)
+{
+    Uint4 packed_size = 0;
+    const char* packed = packer.Pack(data.data(), Uint4(data.size()),
+                                     kLevel, kMinGain, packed_size);
+    BOOST_REQUIRE(packed != NULL);
+    BOOST_CHECK(packed_size < data.size() - data.size() * kMinGain / 100);
+    BOOST_CHECK_EQUAL(CNCChunkPacker::GetUnpackedSize(packed, packed_size),
+                      Uint8(data.size()));
+
+    // Packed data lives in the packer's buffer until next Pack()
+    string stored(packed, packed_size);
+    string buffer(kChunkSize, '\0');
+    Uint4  unpacked_size = 0;
+    string error;
+    BOOST_REQUIRE_MESSAGE(packer.Unpack(stored.data(), Uint4(stored.size()),
+                                        &buffer[0], kChunkSize,
+                                        unpacked_size, error),
+                          error);
+    BOOST_REQUIRE_EQUAL(unpacked_size, Uint4(data.size()));
+    BOOST_CHECK(buffer.compare(0, unpacked_size, data) == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(CompressibleChunk)
+{
+    CNCChunkPacker packer(kChunkSize);
+
+    s_RoundTrip(packer, s_MakeCompressible(kChunkSize / 2));
+    // Packer is reused for the next chunks as it is in the server
+    s_RoundTrip(packer, s_MakeCompressible(kChunkSize));
+    s_RoundTrip(packer, s_MakeCompressible(kNCMinPackSize));
+}
+
+
+BOOST_AUTO_TEST_CASE(IncompressibleChunk)
+{
+    CNCChunkPacker packer(kChunkSize);
+    string data = s_MakeIncompressible(kChunkSize);
+
+    Uint4 packed_size = 0;
+    BOOST_CHECK(packer.Pack(data.data(), Uint4(data.size()),
+                            kLevel, kMinGain, packed_size) == NULL);
+    // Gain requirement can't make the output bigger than the input either
+    BOOST_CHECK(packer.Pack(data.data(), Uint4(data.size()),
+                            kLevel, 0, packed_size) == NULL);
+
+    // Failure doesn't break the packer for the following chunks
+    s_RoundTrip(packer, s_MakeCompressible(kChunkSize));
+}
+
+
+BOOST_AUTO_TEST_CASE(TooSmallOrTooBigChunk)
+{
+    CNCChunkPacker packer(kChunkSize);
+    string data = s_MakeCompressible(kChunkSize + 1);
+
+    Uint4 packed_size = 0;
+    BOOST_CHECK(packer.Pack(data.data(), kNCMinPackSize - 1,
+                            kLevel, kMinGain, packed_size) == NULL);
+    BOOST_CHECK(packer.Pack(data.data(), kChunkSize + 1,
+                            kLevel, kMinGain, packed_size) == NULL);
+}
+
+
+BOOST_AUTO_TEST_CASE(ChunkBoundary)
+{
+    // Blob is split into full chunks and the tail regardless of its
+    // contents, so each chunk must be packed and unpacked on its own
+    CNCChunkPacker packer(kChunkSize);
+    string blob = s_MakeCompressible(kChunkSize * 2 + kChunkSize / 2);
+    string stored[3];
+
+    for (size_t i = 0, pos = 0;  pos < blob.size();  ++i, pos += kChunkSize) {
+        Uint4 size = Uint4(min(size_t(kChunkSize), blob.size() - pos));
+        Uint4 packed_size = 0;
+        const char* packed = packer.Pack(blob.data() + pos, size,
+                                         kLevel, kMinGain, packed_size);
+        BOOST_REQUIRE(packed != NULL);
+        stored[i].assign(packed, packed_size);
+    }
+
+    string result;
+    string buffer(kChunkSize, '\0');
+    string error;
+    for (const string& chunk : stored) {
+        Uint4 unpacked_size = 0;
+        BOOST_REQUIRE_MESSAGE(packer.Unpack(chunk.data(), Uint4(chunk.size()),
+                                            &buffer[0], kChunkSize,
+                                            unpacked_size, error),
+                              error);
+        BOOST_CHECK(unpacked_size <= kChunkSize);
+        result.append(buffer, 0, unpacked_size);
+    }
+    BOOST_CHECK_EQUAL(result.size(), blob.size());
+    BOOST_CHECK(result == blob);
+
+    // Unpacked chunk doesn't fit into the buffer one byte short of it
+    Uint4 unpacked_size = 0;
+    BOOST_CHECK(!packer.Unpack(stored[0].data(), Uint4(stored[0].size()),
+                               &buffer[0], kChunkSize - 1,
+                               unpacked_size, error));
+    BOOST_CHECK(!error.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(DamagedChunk)
+{
+    CNCChunkPacker packer(kChunkSize);
+    string data = s_MakeCompressible(kChunkSize);
+
+    Uint4 packed_size = 0;
+    const char* packed = packer.Pack(data.data(), Uint4(data.size()),
+                                     kLevel, kMinGain, packed_size);
+    BOOST_REQUIRE(packed != NULL);
+    // Chunk cut short, e.g. by the wrong record size
+    string stored(packed, packed_size / 2);
+
+    string buffer(kChunkSize, '\0');
+    Uint4  unpacked_size = 0;
+    string error;
+    BOOST_CHECK(!packer.Unpack(stored.data(), Uint4(stored.size()),
+                               &buffer[0], kChunkSize,
+                               unpacked_size, error));
+    BOOST_CHECK(!error.empty());
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(NoCompression)
+{
+    CNCChunkPacker packer(kChunkSize);
+    string data = s_MakeCompressible(kChunkSize);
+
+    BOOST_CHECK(!CNCChunkPacker::IsSupported());
+    Uint4 packed_size = 0;
+    BOOST_CHECK(packer.Pack(data.data(), Uint4(data.size()),
+                            kLevel, kMinGain, packed_size) == NULL);
+
+    string buffer(kChunkSize, '\0');
+    Uint4  unpacked_size = 0;
+    string error;
+    BOOST_CHECK(!packer.Unpack(data.data(), Uint4(data.size()),
+                               &buffer[0], kChunkSize,
+                               unpacked_size, error));
+    BOOST_CHECK(!error.empty());
+}
+
+#endif
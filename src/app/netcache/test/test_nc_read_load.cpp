@@ -0,0 +1,289 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  NetCache read load test
+ *
+ * Stores a set of large blobs and then reads them back in several threads
+ * for the given time, checking their contents. Reports amount of data served, throughput and (when
+ * NetCache runs on the same host and its pid is given) CPU time spent by the
+ * server per GB of data served. Running it against a server with
+ * sendfile_min_blob_size = 0 and then with sendfile_min_blob_size set below
+ * the blob size shows the gain from the zero-copy read path.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/ncbithr.hpp>
+
+#include <connect/services/netcache_api.hpp>
+
+#include <atomic>
+#include <unistd.h>
+#include <sys/resource.h>
+
+
+USING_NCBI_SCOPE;
+
+///////////////////////////////////////////////////////////////////////
+
+
+static atomic<Uint8> s_BytesRead(0);
+static atomic<Uint8> s_BlobsRead(0);
+static atomic<Uint8> s_Errors(0);
+
+
+/// Get CPU time (user + system) consumed by the process, in seconds.
+/// Returns negative value if it cannot be obtained.
+static double s_GetProcessCPU(int pid)
+{
+    CNcbiIfstream in(("/proc/" + NStr::IntToString(pid) + "/stat").c_str());
+    string stat_line;
+    if (!getline(in, stat_line))
+        return -1;
+    // Skip "pid (comm)" part -- comm can contain spaces.
+    SIZE_TYPE pos = stat_line.rfind(')');
+    if (pos == NPOS)
+        return -1;
+    vector<string> fields;
+    NStr::Split(stat_line.substr(pos + 2), " ", fields,
+                NStr::fSplit_Tokenize);
+    // utime and stime are fields 14 and 15 of the whole line.
+    if (fields.size() < 13)
+        return -1;
+    Uint8 ticks = NStr::StringToUInt8(fields[11])
+                  + NStr::StringToUInt8(fields[12]);
+    return double(ticks) / sysconf(_SC_CLK_TCK);
+}
+
+static double s_GetSelfCPU(void)
+{
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0)
+        return -1;
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+           + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+
+class CTestNCReadLoadThread : public CThread
+{
+public:
+    CTestNCReadLoadThread(CNetCacheAPI::TInstance api,
+                          const vector<string>& keys,
+                          const vector<char>& data,
+                          const CDeadline& deadline,
+                          int num)
+        : m_API(api),
+          m_Keys(keys),
+          m_Data(data),
+          m_Deadline(deadline),
+          m_Num(num)
+    {}
+
+    virtual void* Main(void)
+    {
+        vector<char> buf(m_Data.size());
+        size_t idx = m_Num;
+        while (!m_Deadline.IsExpired()) {
+            const string& key = m_Keys[idx++ % m_Keys.size()];
+            try {
+                size_t n_read = 0, blob_size = 0;
+                CNetCacheAPI::EReadResult res =
+                    m_API.GetData(key, buf.data(), buf.size(),
+                                  &n_read, &blob_size);
+                if (res != CNetCacheAPI::eReadComplete
+                    ||  n_read != m_Data.size())
+                {
+                    ERR_POST("Blob " << key << " was read incompletely: "
+                             << n_read << " bytes of " << blob_size);
+                    ++s_Errors;
+                    continue;
+                }
+                if (memcmp(buf.data(), m_Data.data(), n_read) != 0) {
+                    ERR_POST("Blob " << key << " was read corrupted");
+                    ++s_Errors;
+                    continue;
+                }
+                s_BytesRead += n_read;
+                ++s_BlobsRead;
+            }
+            catch (CException& ex) {
+                ERR_POST("Error reading blob " << key << ": " << ex);
+                ++s_Errors;
+            }
+        }
+        return NULL;
+    }
+
+private:
+    CNetCacheAPI   m_API;
+    const vector<string>& m_Keys;
+    const vector<char>&   m_Data;
+    CDeadline      m_Deadline;
+    int            m_Num;
+};
+
+
+class CTestNCReadLoadApp : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+};
+
+
+void CTestNCReadLoadApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "NetCache read load test");
+
+    arg_desc->AddPositional("service",
+        "NetCache service name or host:port",
+        CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("count",
+                            "count",
+                            "Number of blobs to read",
+                            CArgDescriptions::eInteger,
+                            "50");
+
+    arg_desc->AddDefaultKey("size",
+                            "size",
+                            "Size of each blob",
+                            CArgDescriptions::eDataSize,
+                            "16 MB");
+
+    arg_desc->AddDefaultKey("threads",
+                            "threads",
+                            "Number of reading threads",
+                            CArgDescriptions::eInteger,
+                            "8");
+
+    arg_desc->AddDefaultKey("duration",
+                            "duration",
+                            "Duration of reading phase in seconds",
+                            CArgDescriptions::eInteger,
+                            "60");
+
+    arg_desc->AddOptionalKey("server_pid",
+                             "pid",
+                             "Pid of NetCache server running on this host "
+                             "(to measure its CPU consumption)",
+                             CArgDescriptions::eInteger);
+
+    arg_desc->AddDefaultKey("timeout",
+                            "timeout",
+                            "Communication timeout in msec",
+                            CArgDescriptions::eInteger,
+                            "30000");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CTestNCReadLoadApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    int    count     = args["count"].AsInteger();
+    size_t blob_size = size_t(args["size"].AsInt8());
+    int    threads   = args["threads"].AsInteger();
+    int    duration  = args["duration"].AsInteger();
+    int    server_pid = args["server_pid"] ? args["server_pid"].AsInteger() : 0;
+    unsigned timeout = (unsigned) args["timeout"].AsInteger();
+
+    if (count <= 0  ||  threads <= 0  ||  blob_size == 0) {
+        ERR_POST("Parameters count, size and threads must be positive");
+        return 1;
+    }
+
+    CNetCacheAPI nc(args["service"].AsString(), "test_nc_read_load");
+    STimeout to = {timeout / 1000, (timeout % 1000) * 1000};
+    nc.SetCommunicationTimeout(to);
+
+    cout << "Storing " << count << " blobs of "
+         << NStr::UInt8ToString_DataSize(blob_size) << "..." << endl;
+    vector<char> data(blob_size);
+    for (size_t i = 0; i < blob_size; ++i)
+        data[i] = char(i * 31 + i / 4096);
+    vector<string> keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
+        keys.push_back(nc.PutData(data.data(), data.size()));
+
+    double server_cpu = server_pid ? s_GetProcessCPU(server_pid) : -1;
+    double client_cpu = s_GetSelfCPU();
+    CStopWatch sw(CStopWatch::eStart);
+
+    cout << "Reading with " << threads << " threads for "
+         << duration << " seconds..." << endl;
+    CDeadline deadline(duration);
+    vector<CRef<CThread> > thread_list;
+    thread_list.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+        CRef<CThread> thread(
+            new CTestNCReadLoadThread(nc, keys, data, deadline, i));
+        thread_list.push_back(thread);
+        thread->Run();
+    }
+    NON_CONST_ITERATE(vector<CRef<CThread> >, it, thread_list) {
+        (*it)->Join();
+    }
+
+    double elapsed = sw.Elapsed();
+    if (server_cpu >= 0)
+        server_cpu = s_GetProcessCPU(server_pid) - server_cpu;
+    client_cpu = s_GetSelfCPU() - client_cpu;
+
+    double gbytes = double(s_BytesRead) / (1024.0 * 1024 * 1024);
+    cout << "Blobs read:        " << s_BlobsRead << endl
+         << "Errors:            " << s_Errors << endl
+         << "Data served:       " << gbytes << " GB in "
+                                  << elapsed << " sec" << endl
+         << "Throughput:        " << (elapsed > 0 ? gbytes / elapsed : 0)
+                                  << " GB/sec" << endl
+         << "Client CPU per GB: " << (gbytes > 0 ? client_cpu / gbytes : 0)
+                                  << " sec" << endl;
+    if (server_cpu >= 0) {
+        cout << "Server CPU:        " << server_cpu << " sec" << endl
+             << "Server CPU per GB: " << (gbytes > 0 ? server_cpu / gbytes : 0)
+                                      << " sec" << endl;
+    }
+    else if (server_pid) {
+        ERR_POST("Cannot read CPU usage of process " << server_pid);
+    }
+
+    return s_Errors == 0 ? 0 : 1;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestNCReadLoadApp().AppMain(argc, argv);
+}
@@ -89,11 +89,11 @@ string CJobEvent::EventToString(EJobEvent  event)
 
 
 CJobEvent::CJobEvent() :
-    m_Status(CNetScheduleAPI::eJobNotFound),
-    m_Event(eUnknown),
     m_Timestamp(0, 0),
     m_NodeAddr(0),
-    m_RetCode(0)
+    m_RetCode(0),
+    m_Status(CNetScheduleAPI::eJobNotFound),
+    m_Event(eUnknown)
 {}
 
 
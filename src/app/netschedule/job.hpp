@@ -39,6 +39,7 @@
 #include "job_status.hpp"
 #include "ns_command_arguments.hpp"
 #include "ns_precise_time.hpp"
+#include "ns_interned_string.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -107,9 +108,9 @@ public:
 
     // setters/getters
     TJobStatus GetStatus() const
-    { return m_Status; }
+    { return TJobStatus(m_Status); }
     EJobEvent GetEvent() const
-    { return m_Event; }
+    { return EJobEvent(m_Event); }
     CNSPreciseTime GetTimestamp() const
     { return m_Timestamp; }
     unsigned GetNodeAddr() const
@@ -117,13 +118,13 @@ public:
     int      GetRetCode() const
     { return m_RetCode; }
     const string& GetClientNode() const
-    { return m_ClientNode; }
+    { return m_ClientNode.Get(); }
     const string& GetClientSession() const
-    { return m_ClientSession; }
+    { return m_ClientSession.Get(); }
     const string& GetErrorMsg() const
-    { return m_ErrorMsg; }
+    { return m_ErrorMsg.Get(); }
     const string GetQuotedErrorMsg() const
-    { return "'" + NStr::PrintableString(m_ErrorMsg) + "'"; }
+    { return "'" + NStr::PrintableString(m_ErrorMsg.Get()) + "'"; }
 
     void SetStatus(TJobStatus status)
     { m_Status = status; }
@@ -151,14 +152,19 @@ private:
 
     // SEventDB fields
     // id, event id - implicit
-    TJobStatus      m_Status;           // Job status after the event
-    EJobEvent       m_Event;            // Event
-    CNSPreciseTime  m_Timestamp;        // event timestamp
-    unsigned        m_NodeAddr;         // IP of a client (typically, worker node)
-    int             m_RetCode;          // Return code
-    string          m_ClientNode;       // Client node id
-    string          m_ClientSession;    // Client session
-    string          m_ErrorMsg;         // Error message (exception::what())
+    // Jobs may have many events so the fields are packed: the status and
+    // the event fit one byte each and the strings are shared between the
+    // events of all the jobs
+    CNSPreciseTime      m_Timestamp;        // event timestamp
+    unsigned            m_NodeAddr;         // IP of a client (typically,
+                                            // worker node)
+    int                 m_RetCode;          // Return code
+    Int1                m_Status;           // Job status after the event
+    Int1                m_Event;            // Event
+    CNSInternedString   m_ClientNode;       // Client node id
+    CNSInternedString   m_ClientSession;    // Client session
+    CNSInternedString   m_ErrorMsg;         // Error message
+                                            // (exception::what())
 };
 
 
@@ -213,6 +213,10 @@ void CJobStatusTracker::SetStatus(unsigned    job_id, TJobStatus  status)
                 bv.set_bit(job_id, true);
         }
     }
+
+    if (status == CNetScheduleAPI::ePending &&
+        old_status != CNetScheduleAPI::ePending)
+        m_NewPending.set_bit(job_id, true);
 }
 
 
@@ -220,6 +224,15 @@ void CJobStatusTracker::AddPendingJob(unsigned int  job_id)
 {
     CWriteLockGuard         guard(m_Lock);
     m_StatusStor[(int) CNetScheduleAPI::ePending]->set_bit(job_id, true);
+    m_NewPending.set_bit(job_id, true);
+}
+
+
+void CJobStatusTracker::TakeNewPendingJobs(TNSBitVector &  jobs)
+{
+    CWriteLockGuard         guard(m_Lock);
+    jobs.swap(m_NewPending);
+    m_NewPending.clear(true);
 }
 
 
@@ -239,6 +252,7 @@ void CJobStatusTracker::ClearAll(TNSBitVector *  bv)
         *bv |= bv1;
         bv1.clear(true);
     }
+    m_NewPending.clear(true);
 }
 
 
@@ -249,6 +263,7 @@ void CJobStatusTracker::ClearAll(void)
     for (size_t  k = 0; k < g_ValidJobStatusesSize; ++k) {
         m_StatusStor[g_ValidJobStatuses[k]]->clear(true);
     }
+    m_NewPending.clear(true);
 }
 
 
@@ -270,6 +285,8 @@ void CJobStatusTracker::SetExactStatusNoLock(unsigned   job_id,
 {
     TNSBitVector &      bv = *m_StatusStor[(int)status];
     bv.set(job_id, set_clear);
+    if (status == CNetScheduleAPI::ePending && set_clear)
+        m_NewPending.set_bit(job_id, true);
 }
 
 
@@ -279,6 +296,7 @@ void CJobStatusTracker::AddPendingBatch(unsigned  job_id_from,
     CWriteLockGuard     guard(m_Lock);
     m_StatusStor[(int) CNetScheduleAPI::ePending]->set_range(job_id_from,
                                                              job_id_to);
+    m_NewPending.set_range(job_id_from, job_id_to);
 }
 
 
@@ -118,6 +118,10 @@ public:
 
     void AddPendingJob(unsigned int  job_id);
 
+    // Provides the jobs which became pending since the previous call.
+    // The per affinity pending index is fed with them.
+    void TakeNewPendingJobs(TNSBitVector &  jobs);
+
     // Erase the job
     void Erase(unsigned job_id);
 
@@ -160,6 +164,9 @@ private:
     TStatusStorage          m_StatusStor;
     mutable CRWLock         m_Lock;
 
+    // Jobs which became pending since the last TakeNewPendingJobs() call
+    TNSBitVector            m_NewPending;
+
     // Done jobs counter
     unsigned                m_DoneCnt;
 };
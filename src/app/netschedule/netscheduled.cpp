@@ -193,6 +193,7 @@ int CNetScheduleDApp::Run(void)
                                                          params.path,
                                                          params.max_queues,
                                                          params.diskless,
+                                                         params.journal,
                                                          m_Reinit));
 
     if (!args[kNodaemonArgName]) {
@@ -41,6 +41,7 @@
 #include "queue_database.hpp"
 #include "ns_application.hpp"
 #include "ns_restore_state.hpp"
+#include "ns_journal.hpp"
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -919,6 +920,10 @@ CNetScheduleHandler::x_PrepareWriteBuffer(const string &  msg,
 
 EIO_Status CNetScheduleHandler::x_WriteMessage(const string &  msg)
 {
+    // The reply must not be seen before the job changes it reports are
+    // on disk
+    CNSJournal::WaitForCommit();
+
     size_t  msg_size = msg.size();
     bool    has_eom = false;
 
@@ -98,6 +98,12 @@ const unsigned int      default_reserve_dump_space = 1024 * 1024 * 1024; // 1GB
 const unsigned int      default_max_queues = 1000;
 const bool              default_diskless = false;
 
+const bool              default_journal = false;
+const bool              default_journal_sync_replies = true;
+const unsigned int      default_journal_commit_delay = 0;           // mks
+const unsigned int      default_journal_snapshot_interval = 600;    // sec
+const unsigned int      default_journal_snapshot_size = 1024 * 1024 * 1024;
+
 
 // Queue section values
 const CNSPreciseTime    default_timeout(3600, 0);
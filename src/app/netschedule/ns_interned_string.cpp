@@ -0,0 +1,120 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule interned strings
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbimtx.hpp>
+
+#include <string_view>
+#include <unordered_map>
+
+#include "ns_interned_string.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+// The keys point to the values stored in the entries
+typedef unordered_map<string_view, void *>      TInternedPool;
+
+// The pool is split into shards by the string hash, each with its own lock,
+// so the queues which intern strings concurrently rarely contend
+struct SInternedPoolShard
+{
+    CFastMutex          m_Lock;
+    TInternedPool       m_Pool;
+};
+
+static const size_t     kPoolShards = 32;
+
+
+static SInternedPoolShard *  s_GetShards(void)
+{
+    // The pool is never destroyed: the jobs may outlive the static objects
+    // destruction at exit
+    static SInternedPoolShard *     s_Shards =
+                                        new SInternedPoolShard[kPoolShards];
+    return s_Shards;
+}
+
+
+CNSInternedString::SEntry *
+CNSInternedString::x_Intern(const string &  value)
+{
+    if (value.empty())
+        return NULL;
+
+    size_t                  shard_index = hash<string_view>()(value) %
+                                          kPoolShards;
+    SInternedPoolShard &    shard = s_GetShards()[shard_index];
+    CFastMutexGuard         guard(shard.m_Lock);
+
+    TInternedPool::iterator     found = shard.m_Pool.find(string_view(value));
+    if (found != shard.m_Pool.end()) {
+        SEntry *    entry = static_cast<SEntry *>(found->second);
+        entry->m_Refs.fetch_add(1, memory_order_relaxed);
+        return entry;
+    }
+
+    SEntry *    entry = new SEntry;
+    entry->m_Refs.store(1, memory_order_relaxed);
+    entry->m_Shard = static_cast<unsigned int>(shard_index);
+    entry->m_Value = value;
+    shard.m_Pool[string_view(entry->m_Value)] = entry;
+    return entry;
+}
+
+
+void CNSInternedString::x_ReleaseLast(SEntry *  entry)
+{
+    SInternedPoolShard &    shard = s_GetShards()[entry->m_Shard];
+    CFastMutexGuard         guard(shard.m_Lock);
+
+    if (entry->m_Refs.fetch_sub(1, memory_order_acq_rel) != 1)
+        return;     // Referenced again from the pool meanwhile
+
+    shard.m_Pool.erase(string_view(entry->m_Value));
+    delete entry;
+}
+
+
+size_t CNSInternedString::GetPoolSize(void)
+{
+    size_t                  size = 0;
+    SInternedPoolShard *    shards = s_GetShards();
+    for (size_t  k = 0; k < kPoolShards; ++k) {
+        CFastMutexGuard     guard(shards[k].m_Lock);
+        size += shards[k].m_Pool.size();
+    }
+    return size;
+}
+
+
+END_NCBI_SCOPE
+
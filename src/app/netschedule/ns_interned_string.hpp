@@ -0,0 +1,146 @@
+#ifndef NETSCHEDULE_NS_INTERNED_STRING__HPP
+#define NETSCHEDULE_NS_INTERNED_STRING__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule interned strings
+ *
+ *   The job events store the client node and session which are the same for
+ *   all the events of a client. An interned string keeps a single reference
+ *   counted copy of each distinct value so an event holds a pointer instead
+ *   of its own string.
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+
+#include <atomic>
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CNSInternedString
+{
+    public:
+        CNSInternedString() :
+            m_Entry(NULL)
+        {}
+        CNSInternedString(const string &  value) :
+            m_Entry(x_Intern(value))
+        {}
+        CNSInternedString(const CNSInternedString &  other) :
+            m_Entry(other.m_Entry)
+        {
+            // The other instance holds a reference so the entry cannot
+            // disappear while the counter is incremented
+            if (m_Entry != NULL)
+                m_Entry->m_Refs.fetch_add(1, memory_order_relaxed);
+        }
+        CNSInternedString(CNSInternedString &&  other) :
+            m_Entry(other.m_Entry)
+        {
+            other.m_Entry = NULL;
+        }
+        ~CNSInternedString()
+        {
+            x_Release();
+        }
+
+        CNSInternedString &  operator=(const CNSInternedString &  other)
+        {
+            CNSInternedString   tmp(other);
+            swap(m_Entry, tmp.m_Entry);
+            return *this;
+        }
+        CNSInternedString &  operator=(CNSInternedString &&  other)
+        {
+            swap(m_Entry, other.m_Entry);
+            return *this;
+        }
+        CNSInternedString &  operator=(const string &  value)
+        {
+            CNSInternedString   tmp(value);
+            swap(m_Entry, tmp.m_Entry);
+            return *this;
+        }
+
+        const string &  Get(void) const
+        { return m_Entry == NULL ? kEmptyStr : m_Entry->m_Value; }
+        size_t size(void) const
+        { return m_Entry == NULL ? 0 : m_Entry->m_Value.size(); }
+        const char *  data(void) const
+        { return Get().data(); }
+        bool empty(void) const
+        { return m_Entry == NULL; }
+        void clear(void)
+        { x_Release(); }
+
+        // Number of distinct strings in the pool
+        static size_t GetPoolSize(void);
+
+    private:
+        struct SEntry
+        {
+            atomic<unsigned int>    m_Refs;
+            unsigned int            m_Shard;    // pool shard index
+            string                  m_Value;
+        };
+
+        static SEntry *  x_Intern(const string &  value);
+        static void x_ReleaseLast(SEntry *  entry);
+
+        void x_Release(void)
+        {
+            if (m_Entry == NULL)
+                return;
+
+            // Only the last reference is released under the pool shard
+            // lock, so the entry could be found and referenced again
+            // concurrently
+            unsigned int    refs = m_Entry->m_Refs.load(memory_order_relaxed);
+            while (refs > 1) {
+                if (m_Entry->m_Refs.compare_exchange_weak(
+                                            refs, refs - 1,
+                                            memory_order_acq_rel)) {
+                    m_Entry = NULL;
+                    return;
+                }
+            }
+            x_ReleaseLast(m_Entry);
+            m_Entry = NULL;
+        }
+
+    private:
+        SEntry *    m_Entry;        // NULL for an empty string
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_NS_INTERNED_STRING__HPP */
+
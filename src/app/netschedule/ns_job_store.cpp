@@ -0,0 +1,140 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule in-memory job storage
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include "ns_job_store.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+CNSJobStore::SChunk::SChunk() :
+    m_Count(0)
+{
+    memset(m_Present, 0, sizeof(m_Present));
+}
+
+
+CNSJobStore::SChunk::~SChunk()
+{
+    for (size_t  index = 0; m_Count > 0 && index < kChunkSize; ++index) {
+        if (Has(index)) {
+            Slot(index)->~value_type();
+            --m_Count;
+        }
+    }
+}
+
+
+CNSJobStore::CNSJobStore() :
+    m_Size(0)
+{}
+
+
+CNSJobStore::~CNSJobStore()
+{
+    clear();
+}
+
+
+CJob &  CNSJobStore::operator[](unsigned int  job_id)
+{
+    value_type *    found = x_Find(job_id);
+    if (found != NULL)
+        return found->second;
+
+    SChunk *        chunk = x_GetChunk(job_id);
+    size_t          index = job_id & kChunkMask;
+    value_type *    slot = new (chunk->Slot(index)) value_type(job_id, CJob());
+
+    chunk->m_Present[index / 64] |= Uint8(1) << (index % 64);
+    ++chunk->m_Count;
+    ++m_Size;
+    return slot->second;
+}
+
+
+size_t CNSJobStore::erase(unsigned int  job_id)
+{
+    value_type *    found = x_Find(job_id);
+    if (found == NULL)
+        return 0;
+
+    TChunks::iterator   chunk_it = m_Chunks.find(job_id >> kChunkBits);
+    SChunk *            chunk = chunk_it->second;
+    size_t              index = job_id & kChunkMask;
+
+    found->~value_type();
+    chunk->m_Present[index / 64] &= ~(Uint8(1) << (index % 64));
+    --m_Size;
+
+    if (--chunk->m_Count == 0) {
+        delete chunk;
+        m_Chunks.erase(chunk_it);
+    }
+    return 1;
+}
+
+
+void CNSJobStore::clear(void)
+{
+    for (TChunks::iterator  k = m_Chunks.begin(); k != m_Chunks.end(); ++k)
+        delete k->second;
+    m_Chunks.clear();
+    m_Size = 0;
+}
+
+
+size_t CNSJobStore::GetAllocatedSize(void) const
+{
+    // The hash table node is a value and a next pointer; a bucket is a
+    // pointer
+    return m_Chunks.size() * (sizeof(SChunk) +
+                              sizeof(TChunks::value_type) + sizeof(void *)) +
+           m_Chunks.bucket_count() * sizeof(void *);
+}
+
+
+CNSJobStore::SChunk *  CNSJobStore::x_GetChunk(unsigned int  job_id)
+{
+    unsigned int        chunk_no = job_id >> kChunkBits;
+    TChunks::iterator   found = m_Chunks.find(chunk_no);
+    if (found != m_Chunks.end())
+        return found->second;
+
+    unique_ptr<SChunk>  chunk(new SChunk);
+    m_Chunks[chunk_no] = chunk.get();
+    return chunk.release();
+}
+
+
+END_NCBI_SCOPE
+
@@ -0,0 +1,139 @@
+#ifndef NETSCHEDULE_NS_JOB_STORE__HPP
+#define NETSCHEDULE_NS_JOB_STORE__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule in-memory job storage
+ *
+ *   The job ids in a queue are dense and grow monotonically, so the jobs are
+ *   stored in fixed size chunks addressed by the job id rather than in a
+ *   tree. A lookup is a hash table lookup of the chunk and an array access,
+ *   there is no per job node overhead and the jobs submitted together are
+ *   close to each other in memory. A chunk is freed when its last job is
+ *   erased; the jobs expire roughly in the order of their ids so the chunks
+ *   are freed as well. The chunks are keyed by their number rather than
+ *   indexed from the lowest one so a job id wraparound, when the old jobs
+ *   with large ids live together with the new ones, costs nothing.
+ *
+ *   The interface is a subset of the map<unsigned int, CJob> one which was
+ *   used before.
+ *
+ */
+
+#include <unordered_map>
+
+#include "job.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+class CNSJobStore
+{
+    public:
+        typedef pair<const unsigned int, CJob>  value_type;
+        typedef value_type *                    iterator;
+        typedef const value_type *              const_iterator;
+
+        CNSJobStore();
+        ~CNSJobStore();
+
+        iterator find(unsigned int  job_id)
+        { return x_Find(job_id); }
+        const_iterator find(unsigned int  job_id) const
+        { return x_Find(job_id); }
+        iterator end(void)
+        { return NULL; }
+        const_iterator end(void) const
+        { return NULL; }
+
+        // Creates an empty job if there is no job with this id
+        CJob &  operator[](unsigned int  job_id);
+        size_t erase(unsigned int  job_id);
+        void clear(void);
+        size_t size(void) const
+        { return m_Size; }
+
+        // Memory taken by the chunks, bytes
+        size_t GetAllocatedSize(void) const;
+
+    private:
+        enum {
+            kChunkBits = 8,
+            kChunkSize = 1 << kChunkBits,
+            kChunkMask = kChunkSize - 1
+        };
+
+        struct SChunk
+        {
+            size_t      m_Count;                        // # of stored jobs
+            Uint8       m_Present[kChunkSize / 64];     // Slots bitmap
+            alignas(value_type)
+            char        m_Slots[kChunkSize * sizeof(value_type)];
+
+            SChunk();
+            ~SChunk();
+
+            bool Has(size_t  index) const
+            { return (m_Present[index / 64] >> (index % 64)) & 1; }
+            value_type *  Slot(size_t  index)
+            { return reinterpret_cast<value_type *>(m_Slots) + index; }
+            const value_type *  Slot(size_t  index) const
+            { return reinterpret_cast<const value_type *>(m_Slots) + index; }
+        };
+
+        typedef unordered_map<unsigned int, SChunk *>   TChunks;
+
+        value_type *  x_Find(unsigned int  job_id) const
+        {
+            TChunks::const_iterator     found =
+                                    m_Chunks.find(job_id >> kChunkBits);
+            if (found == m_Chunks.end())
+                return NULL;
+
+            size_t      index = job_id & kChunkMask;
+            if (!found->second->Has(index))
+                return NULL;
+            return found->second->Slot(index);
+        }
+
+        SChunk *  x_GetChunk(unsigned int  job_id);
+
+    private:
+        TChunks             m_Chunks;       // chunk number -> chunk
+        size_t              m_Size;
+
+    private:
+        CNSJobStore(const CNSJobStore &);
+        CNSJobStore &  operator=(const CNSJobStore &);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_NS_JOB_STORE__HPP */
+
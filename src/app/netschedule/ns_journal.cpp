@@ -0,0 +1,618 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule job state journal (write ahead log)
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <util/checksum.hpp>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ns_journal.hpp"
+#include "ns_server_params.hpp"
+#include "ns_types.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+const Uint4     kJournalRecordMagic(0xF1F1F1F1);
+
+enum EJournalRecordType {
+    eJournalJobChanged = 1,
+    eJournalJobDeleted = 2
+};
+
+
+// Every record is followed by the queue name, the affinity token, the group
+// token and the job in the dump format
+#pragma pack(push, 1)
+struct SNSJournalRecordHeader
+{
+    Uint4       magic;
+    Uint4       crc;                // CRC32 of everything after this field
+    Uint1       type;
+    Uint4       job_id;
+    Uint2       qname_size;
+    Uint4       aff_token_size;
+    Uint4       group_token_size;
+    Uint4       job_size;
+};
+#pragma pack(pop)
+
+
+static Uint4 s_RecordCRC(const SNSJournalRecordHeader &  header,
+                         const char *  payload, size_t  payload_size)
+{
+    const size_t    crc_offset = offsetof(SNSJournalRecordHeader, type);
+    CChecksum       crc(CChecksum::eCRC32);
+
+    crc.AddChars(reinterpret_cast<const char *>(&header) + crc_offset,
+                 sizeof(header) - crc_offset);
+    crc.AddChars(payload, payload_size);
+    return crc.GetChecksum();
+}
+
+
+static string s_MakeRecord(EJournalRecordType  type,
+                           const string &  qname,
+                           unsigned int  job_id,
+                           const string &  aff_token,
+                           const string &  group_token,
+                           const char *  job_data,
+                           size_t  job_size)
+{
+    SNSJournalRecordHeader      header;
+    string                      payload;
+
+    payload.reserve(qname.size() + aff_token.size() +
+                    group_token.size() + job_size);
+    payload.append(qname);
+    payload.append(aff_token);
+    payload.append(group_token);
+    payload.append(job_data, job_size);
+
+    header.magic = kJournalRecordMagic;
+    header.type = type;
+    header.job_id = job_id;
+    header.qname_size = qname.size();
+    header.aff_token_size = aff_token.size();
+    header.group_token_size = group_token.size();
+    header.job_size = job_size;
+    header.crc = s_RecordCRC(header, payload.data(), payload.size());
+
+    string      record(reinterpret_cast<const char *>(&header),
+                       sizeof(header));
+    record.append(payload);
+    return record;
+}
+
+
+static bool s_WriteAll(int  fd, const char *  data, size_t  size)
+{
+    while (size > 0) {
+        ssize_t     written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+
+// The records appended by the current thread which it has not waited for
+static thread_local CNSJournal *    s_CommitJournal = NULL;
+static thread_local Uint8           s_CommitLSN = 0;
+
+
+
+class CNSJournalCommitThread : public CThread
+{
+public:
+    CNSJournalCommitThread(CNSJournal &  journal) :
+        m_Journal(journal)
+    {}
+
+protected:
+    virtual void *  Main(void)
+    {
+        SetCurrentThreadName("netscheduled_jl");
+        m_Journal.CommitLoop();
+        return NULL;
+    }
+
+private:
+    CNSJournal &    m_Journal;
+};
+
+
+
+CNSJournal::CNSJournal(const string &  data_path,
+                       const SNSJournalParameters &  params) :
+    m_SyncReplies(params.sync_replies),
+    m_CommitDelay(params.commit_delay),
+    m_SnapshotInterval(params.snapshot_interval),
+    m_SnapshotSize(params.snapshot_size),
+    m_AppendedLSN(0),
+    m_CommittedLSN(0),
+    m_Segment(0),
+    m_SwitchSegment(false),
+    m_BytesSinceSnapshot(0),
+    m_LastSnapshot(time(0)),
+    m_StopRequested(false),
+    m_Commits(0),
+    m_FD(-1)
+{
+    m_JournalPath = CDirEntry::AddTrailingPathSeparator(
+                        CDirEntry::AddTrailingPathSeparator(data_path) +
+                        kJournalSubdirName);
+}
+
+
+CNSJournal::~CNSJournal()
+{
+    try {
+        Stop();
+    } catch (...) {}
+}
+
+
+size_t CNSJournal::Replay(unsigned int  first_segment,
+                          TNSJournalQueues &  queues)
+{
+    size_t                  records = 0;
+    vector<unsigned int>    segments = x_GetSegments();
+
+    for (vector<unsigned int>::const_iterator  k = segments.begin();
+            k != segments.end(); ++k) {
+        if (*k < first_segment)
+            continue;
+        records += x_ReplaySegment(x_GetSegmentFileName(*k), queues);
+    }
+    return records;
+}
+
+
+size_t CNSJournal::x_ReplaySegment(const string &  file_name,
+                                   TNSJournalQueues &  queues)
+{
+    FILE *      f = fopen(file_name.c_str(), "rb");
+    if (f == NULL)
+        throw runtime_error("Cannot open journal file " + file_name);
+
+    size_t      records = 0;
+    try {
+        SJobDumpHeader      header;
+        if (header.Read(f) != 0) {
+            fclose(f);
+            return 0;       // The segment has been just created
+        }
+
+        AutoArray<char>     input_buf(new char[kNetScheduleMaxOverflowSize]);
+        AutoArray<char>     output_buf(new char[kNetScheduleMaxOverflowSize]);
+        string              payload;
+
+        for (;;) {
+            SNSJournalRecordHeader  rec;
+            size_t                  bytes = fread(&rec, 1, sizeof(rec), f);
+
+            if (bytes == 0)
+                break;      // Clean end of the segment
+
+            // A record may be partially written if the server was killed.
+            // It can be only the last record of the last segment, everything
+            // before it has been synced.
+            if (bytes != sizeof(rec) || rec.magic != kJournalRecordMagic) {
+                ERR_POST(Warning << "Incomplete record header in the journal "
+                                    "file " << file_name << ". The rest of "
+                                    "the file is ignored.");
+                break;
+            }
+
+            size_t      payload_size = rec.qname_size + rec.aff_token_size +
+                                       rec.group_token_size + rec.job_size;
+            payload.resize(payload_size);
+            if (fread(&payload[0], 1, payload_size, f) != payload_size ||
+                s_RecordCRC(rec, payload.data(), payload_size) != rec.crc) {
+                ERR_POST(Warning << "Incomplete record in the journal file "
+                                 << file_name << ". The rest of the file is "
+                                    "ignored.");
+                break;
+            }
+
+            const char *    data = payload.data();
+            string          qname(data, rec.qname_size);
+            data += rec.qname_size;
+
+            SNSJournalJob &     journal_job = queues[qname][rec.job_id];
+            if (rec.type == eJournalJobDeleted) {
+                journal_job = SNSJournalJob();
+                journal_job.deleted = true;
+                ++records;
+                continue;
+            }
+
+            journal_job.deleted = false;
+            journal_job.aff_token.assign(data, rec.aff_token_size);
+            data += rec.aff_token_size;
+            journal_job.group_token.assign(data, rec.group_token_size);
+            data += rec.group_token_size;
+
+            // The job is stored exactly as in the dump file
+            FILE *  job_file = fmemopen(const_cast<char *>(data),
+                                        rec.job_size, "rb");
+            if (job_file == NULL)
+                throw runtime_error("Cannot read a job from the journal");
+            bool    loaded = false;
+            try {
+                loaded = journal_job.job.LoadFromDump(job_file,
+                                                      input_buf.get(),
+                                                      output_buf.get(),
+                                                      header);
+            } catch (...) {
+                fclose(job_file);
+                throw;
+            }
+            fclose(job_file);
+
+            if (!loaded || journal_job.job.GetId() != rec.job_id)
+                throw runtime_error("Inconsistent job record in the journal");
+            ++records;
+        }
+    } catch (const exception &  ex) {
+        fclose(f);
+        throw runtime_error("Error replaying journal file " + file_name +
+                            ": " + ex.what());
+    }
+
+    fclose(f);
+    return records;
+}
+
+
+void CNSJournal::Start(void)
+{
+    CDir    journal_dir(m_JournalPath);
+    if (!journal_dir.Exists())
+        journal_dir.Create();
+
+    // Never overwrite the segments of the previous instance: they are
+    // needed till a new snapshot is taken
+    vector<unsigned int>    segments = x_GetSegments();
+    m_Segment = segments.empty() ? 1 : segments.back() + 1;
+    if (!x_OpenSegment(m_Segment))
+        NCBI_THROW(CNetScheduleException, eInternalError,
+                   "Cannot create journal file " +
+                   x_GetSegmentFileName(m_Segment));
+
+    m_StopRequested = false;
+    m_LastSnapshot = time(0);
+    m_CommitThread.Reset(new CNSJournalCommitThread(*this));
+    m_CommitThread->Run();
+}
+
+
+void CNSJournal::Stop(void)
+{
+    if (m_CommitThread.Empty())
+        return;
+
+    {{
+        CFastMutexGuard     guard(m_Lock);
+        m_StopRequested = true;
+        m_HaveRecords.SignalSome();
+    }}
+
+    // The thread writes out all the appended records before exiting
+    m_CommitThread->Join();
+    x_CloseSegment();
+
+    {{
+        CFastMutexGuard     guard(m_Lock);
+        m_CommitThread.Reset();
+        m_Committed.SignalAll();
+    }}
+
+    if (m_Commits > 0)
+        LOG_POST(Note << "Journal: " << m_CommittedLSN << " record(s) "
+                         "written in " << m_Commits << " group commit(s)");
+}
+
+
+void CNSJournal::Remove(void)
+{
+    CDir    journal_dir(m_JournalPath);
+    if (journal_dir.Exists())
+        journal_dir.Remove();
+}
+
+
+void CNSJournal::JobChanged(const string &  qname,
+                            const CJob &  job,
+                            const string &  aff_token,
+                            const string &  group_token)
+{
+    char *      job_data = NULL;
+    size_t      job_size = 0;
+    FILE *      job_file = open_memstream(&job_data, &job_size);
+
+    if (job_file == NULL) {
+        ERR_POST(Critical << "Cannot serialize job " << job.GetId() <<
+                 " for the journal: " << strerror(errno));
+        return;
+    }
+
+    try {
+        job.Dump(job_file);
+    } catch (const exception &  ex) {
+        fclose(job_file);
+        free(job_data);
+        ERR_POST(Critical << "Cannot serialize job " << job.GetId() <<
+                 " for the journal: " << ex.what());
+        return;
+    }
+    fclose(job_file);
+
+    string      record = s_MakeRecord(eJournalJobChanged, qname, job.GetId(),
+                                      aff_token, group_token,
+                                      job_data, job_size);
+    free(job_data);
+    x_Append(record);
+}
+
+
+void CNSJournal::JobDeleted(const string &  qname, unsigned int  job_id)
+{
+    x_Append(s_MakeRecord(eJournalJobDeleted, qname, job_id,
+                          kEmptyStr, kEmptyStr, NULL, 0));
+}
+
+
+void CNSJournal::x_Append(const string &  record)
+{
+    Uint8       lsn;
+
+    {{
+        CFastMutexGuard     guard(m_Lock);
+        bool                was_empty = m_Pending.empty();
+
+        m_Pending.append(record);
+        lsn = ++m_AppendedLSN;
+        m_BytesSinceSnapshot += record.size();
+        if (was_empty)
+            m_HaveRecords.SignalSome();
+    }}
+
+    if (m_SyncReplies) {
+        s_CommitJournal = this;
+        s_CommitLSN = lsn;
+    }
+}
+
+
+void CNSJournal::WaitForCommit(void)
+{
+    CNSJournal *    journal = s_CommitJournal;
+    if (journal == NULL)
+        return;
+
+    s_CommitJournal = NULL;
+    journal->x_WaitForCommit(s_CommitLSN);
+}
+
+
+void CNSJournal::x_WaitForCommit(Uint8  lsn)
+{
+    CFastMutexGuard     guard(m_Lock);
+    while (m_CommittedLSN < lsn && m_CommitThread.NotEmpty())
+        m_Committed.WaitForSignal(m_Lock);
+}
+
+
+void CNSJournal::CommitLoop(void)
+{
+    string      records;
+
+    for (;;) {
+        Uint8           lsn;
+        unsigned int    segment;
+        bool            switch_segment;
+
+        {{
+            CFastMutexGuard     guard(m_Lock);
+            while (m_Pending.empty() && !m_SwitchSegment && !m_StopRequested)
+                m_HaveRecords.WaitForSignal(m_Lock);
+            if (m_Pending.empty() && !m_SwitchSegment)
+                break;      // Stop requested and nothing left to write
+        }}
+
+        // Give the other threads a chance to join the group
+        if (m_CommitDelay > 0)
+            SleepMicroSec(m_CommitDelay);
+
+        {{
+            CFastMutexGuard     guard(m_Lock);
+            records.swap(m_Pending);
+            lsn = m_AppendedLSN;
+            segment = m_Segment;
+            switch_segment = m_SwitchSegment;
+            m_SwitchSegment = false;
+        }}
+
+        // The records which have been appended before the switch request
+        // may go to the new segment as well. It does not harm: replaying a
+        // record already reflected in the snapshot gives the same state.
+        if (switch_segment) {
+            x_CloseSegment();
+            if (!x_OpenSegment(segment))
+                ERR_POST(Critical << "Cannot create journal file " <<
+                         x_GetSegmentFileName(segment));
+        }
+
+        if (!records.empty()) {
+            if (m_FD == -1 ||
+                !s_WriteAll(m_FD, records.data(), records.size()) ||
+                fdatasync(m_FD) != 0)
+                ERR_POST(Critical << "Journal write error: " <<
+                         strerror(errno) << ". The last job changes may be "
+                         "lost if the server crashes.");
+            records.clear();
+            ++m_Commits;
+        }
+
+        {{
+            CFastMutexGuard     guard(m_Lock);
+            m_CommittedLSN = lsn;
+            m_Committed.SignalAll();
+        }}
+    }
+}
+
+
+bool CNSJournal::IsSnapshotDue(void) const
+{
+    CFastMutexGuard     guard(m_Lock);
+
+    if (m_SnapshotSize > 0 && m_BytesSinceSnapshot >= m_SnapshotSize)
+        return true;
+    return time(0) - m_LastSnapshot >= time_t(m_SnapshotInterval);
+}
+
+
+void CNSJournal::RequestSnapshot(void)
+{
+    CFastMutexGuard     guard(m_Lock);
+    m_LastSnapshot = 0;
+}
+
+
+unsigned int CNSJournal::StartSnapshot(void)
+{
+    CFastMutexGuard     guard(m_Lock);
+
+    ++m_Segment;
+    m_SwitchSegment = true;
+    m_BytesSinceSnapshot = 0;
+    m_LastSnapshot = time(0);
+    m_HaveRecords.SignalSome();
+    return m_Segment;
+}
+
+
+void CNSJournal::FinishSnapshot(unsigned int  first_segment)
+{
+    vector<unsigned int>    segments = x_GetSegments();
+
+    for (vector<unsigned int>::const_iterator  k = segments.begin();
+            k != segments.end(); ++k) {
+        if (*k >= first_segment)
+            break;
+        CFile(x_GetSegmentFileName(*k)).Remove();
+    }
+}
+
+
+bool CNSJournal::x_OpenSegment(unsigned int  segment)
+{
+    string      file_name = x_GetSegmentFileName(segment);
+
+    m_FD = open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                0644);
+    if (m_FD == -1)
+        return false;
+
+    // The segment header is the same as the jobs dump file header so that
+    // the job records could be read by the dump loading code
+    SJobDumpHeader      header;
+    if (!s_WriteAll(m_FD, reinterpret_cast<const char *>(&header),
+                    sizeof(header)) || fdatasync(m_FD) != 0) {
+        x_CloseSegment();
+        return false;
+    }
+
+    // Make the new directory entry durable as well
+    int     dir_fd = open(m_JournalPath.c_str(), O_RDONLY);
+    if (dir_fd != -1) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+    return true;
+}
+
+
+void CNSJournal::x_CloseSegment(void)
+{
+    if (m_FD != -1) {
+        close(m_FD);
+        m_FD = -1;
+    }
+}
+
+
+string CNSJournal::x_GetSegmentFileName(unsigned int  segment) const
+{
+    return m_JournalPath + kJournalFilePrefix + to_string(segment);
+}
+
+
+vector<unsigned int> CNSJournal::x_GetSegments(void) const
+{
+    vector<unsigned int>    segments;
+    CDir                    journal_dir(m_JournalPath);
+
+    if (!journal_dir.Exists())
+        return segments;
+
+    CDir::TEntries      entries = journal_dir.GetEntries(
+                                        kJournalFilePrefix + "*",
+                                        CDir::fIgnoreRecursive);
+    for (CDir::TEntries::const_iterator  k = entries.begin();
+            k != entries.end(); ++k) {
+        string          name = (*k)->GetName();
+        unsigned int    segment = NStr::StringToUInt(
+                                    name.substr(kJournalFilePrefix.size()),
+                                    NStr::fConvErr_NoThrow);
+        if (segment != 0)
+            segments.push_back(segment);
+    }
+    sort(segments.begin(), segments.end());
+    return segments;
+}
+
+
+END_NCBI_SCOPE
+
@@ -0,0 +1,167 @@
+#ifndef NETSCHEDULE_NS_JOURNAL__HPP
+#define NETSCHEDULE_NS_JOURNAL__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule job state journal (write ahead log)
+ *
+ *   Every job change is appended to the journal as the complete job record
+ *   in the dump format. A dedicated thread writes the appended records and
+ *   syncs them to disk in groups, so one fdatasync() covers all the changes
+ *   made by all the handler threads while the previous sync was in progress.
+ *   Periodically the queues are dumped into a snapshot directory and the
+ *   journal segments which precede the snapshot are removed. After a crash
+ *   the snapshot is loaded as a regular dump and the journal is replayed on
+ *   top of it.
+ *
+ */
+
+#include <corelib/ncbimtx.hpp>
+#include <corelib/ncbithr.hpp>
+
+#include "job.hpp"
+#include "ns_db_dump.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+struct SNSJournalParameters;
+
+
+// The last journaled state of a job
+struct SNSJournalJob
+{
+    bool        deleted;
+    CJob        job;
+    string      aff_token;
+    string      group_token;
+
+    SNSJournalJob() : deleted(false)
+    {}
+};
+
+// Job id -> the last journaled state
+typedef map<unsigned int, SNSJournalJob>                TNSJournalJobs;
+// Queue name -> the journaled jobs of the queue
+typedef map<string, TNSJournalJobs, PNocase>            TNSJournalQueues;
+
+
+class CNSJournalCommitThread;
+
+
+class CNSJournal
+{
+    public:
+        CNSJournal(const string &  data_path,
+                   const SNSJournalParameters &  params);
+        ~CNSJournal();
+
+        // Startup time only. Reads the segments starting from the given one
+        // and collects the last state of each job mentioned there.
+        // Returns the number of records read.
+        size_t Replay(unsigned int  first_segment,
+                      TNSJournalQueues &  queues);
+
+        // Starts a new segment and the group commit thread
+        void Start(void);
+        // Writes out all the appended records and stops the commit thread
+        void Stop(void);
+        // Removes all the journal segments. The journal must be stopped.
+        void Remove(void);
+
+        // Both must be called under the queue operation lock so that the
+        // journal order of the records of one job matches the changes order
+        void JobChanged(const string &  qname,
+                        const CJob &  job,
+                        const string &  aff_token,
+                        const string &  group_token);
+        void JobDeleted(const string &  qname, unsigned int  job_id);
+
+        // Blocks till the records appended by the calling thread are on
+        // disk. No-op if the calling thread has nothing to wait for.
+        static void WaitForCommit(void);
+
+        bool IsSnapshotDue(void) const;
+        // Makes the next IsSnapshotDue() call return true
+        void RequestSnapshot(void);
+        // Makes the following records go to a new segment and provides the
+        // segment number. The snapshot taken after that call is the base
+        // for replaying the journal from that segment.
+        unsigned int StartSnapshot(void);
+        // Removes the segments which precede the given one
+        void FinishSnapshot(unsigned int  first_segment);
+
+        // The commit thread body
+        void CommitLoop(void);
+
+    private:
+        void x_Append(const string &  record);
+        void x_WaitForCommit(Uint8  lsn);
+        bool x_OpenSegment(unsigned int  segment);
+        void x_CloseSegment(void);
+        string x_GetSegmentFileName(unsigned int  segment) const;
+        vector<unsigned int> x_GetSegments(void) const;
+        size_t x_ReplaySegment(const string &  file_name,
+                               TNSJournalQueues &  queues);
+
+    private:
+        string                  m_JournalPath;
+        bool                    m_SyncReplies;
+        unsigned int            m_CommitDelay;
+        unsigned int            m_SnapshotInterval;
+        Uint8                   m_SnapshotSize;
+
+        // Protects everything below
+        mutable CFastMutex      m_Lock;
+        CConditionVariable      m_HaveRecords;
+        CConditionVariable      m_Committed;
+        string                  m_Pending;          // Not written records
+        Uint8                   m_AppendedLSN;      // # of appended records
+        Uint8                   m_CommittedLSN;     // # of records on disk
+        unsigned int            m_Segment;          // Current segment
+        bool                    m_SwitchSegment;    // Next write goes to a
+                                                    // new segment
+        Uint8                   m_BytesSinceSnapshot;
+        time_t                  m_LastSnapshot;
+        bool                    m_StopRequested;
+
+        // Used by the commit thread only
+        Uint8                   m_Commits;
+        int                     m_FD;
+
+        CRef<CNSJournalCommitThread>    m_CommitThread;
+
+    private:
+        CNSJournal(const CNSJournal &);
+        CNSJournal &  operator=(const CNSJournal &);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_NS_JOURNAL__HPP */
+
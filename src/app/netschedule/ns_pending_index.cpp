@@ -0,0 +1,98 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule per affinity index of the pending jobs
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include "ns_pending_index.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+CNSPendingAffinityIndex::CNSPendingAffinityIndex()
+{}
+
+
+void CNSPendingAffinityIndex::AddJob(unsigned int  job_id,
+                                     unsigned int  aff_id)
+{
+    if (aff_id != 0)
+        m_Candidates[aff_id].set_bit(job_id, true);
+}
+
+
+void CNSPendingAffinityIndex::RemoveJob(unsigned int  job_id,
+                                        unsigned int  aff_id)
+{
+    TAffinityCandidates::iterator   found = m_Candidates.find(aff_id);
+    if (found == m_Candidates.end())
+        return;
+
+    found->second.set_bit(job_id, false);
+    if (!found->second.any())
+        m_Candidates.erase(found);
+}
+
+
+unsigned int CNSPendingAffinityIndex::GetNext(unsigned int  aff_id,
+                                              unsigned int  job_id) const
+{
+    TAffinityCandidates::const_iterator     found = m_Candidates.find(aff_id);
+    if (found == m_Candidates.end())
+        return 0;
+
+    if (job_id == 0)
+        return found->second.get_first();
+    return found->second.get_next(job_id);
+}
+
+
+void CNSPendingAffinityIndex::Purge(const TNSBitVector &  pending_jobs)
+{
+    TAffinityCandidates::iterator   k = m_Candidates.begin();
+    while (k != m_Candidates.end()) {
+        k->second &= pending_jobs;
+        if (k->second.any()) {
+            k->second.optimize(0, TNSBitVector::opt_free_0);
+            ++k;
+        } else
+            m_Candidates.erase(k++);
+    }
+}
+
+
+void CNSPendingAffinityIndex::Clear(void)
+{
+    m_Candidates.clear();
+}
+
+
+END_NCBI_SCOPE
+
@@ -0,0 +1,87 @@
+#ifndef NETSCHEDULE_NS_PENDING_INDEX__HPP
+#define NETSCHEDULE_NS_PENDING_INDEX__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule per affinity index of the pending jobs
+ *
+ *   A GET with explicit or preferred affinities needs the lowest id pending
+ *   job in a few affinities. The index keeps a bit vector of the candidate
+ *   jobs for each affinity so such a job is found by looking at the given
+ *   affinities only instead of scanning all the pending jobs.
+ *
+ *   The index is updated when a job becomes pending but it is not updated
+ *   when a job leaves the pending state. The stale candidates are removed
+ *   by the lookup code which checks each candidate against the status
+ *   tracker anyway, and periodically by Purge().
+ *
+ */
+
+#include <map>
+
+#include "ns_types.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+// Not thread safe: the queue uses it under its operation lock
+class CNSPendingAffinityIndex
+{
+    public:
+        CNSPendingAffinityIndex();
+
+        void AddJob(unsigned int  job_id, unsigned int  aff_id);
+        void RemoveJob(unsigned int  job_id, unsigned int  aff_id);
+
+        // Provides the lowest candidate id of the affinity which is greater
+        // than the given one (or the first one if job_id is 0).
+        // 0 if there are no more candidates.
+        unsigned int GetNext(unsigned int  aff_id, unsigned int  job_id) const;
+
+        // Drops all the candidates which are not in the given pending jobs
+        void Purge(const TNSBitVector &  pending_jobs);
+        void Clear(void);
+
+        size_t GetAffinityCount(void) const
+        { return m_Candidates.size(); }
+
+    private:
+        typedef map<unsigned int, TNSBitVector>     TAffinityCandidates;
+
+        TAffinityCandidates     m_Candidates;   // affinity id -> job ids
+
+    private:
+        CNSPendingAffinityIndex(const CNSPendingAffinityIndex &);
+        CNSPendingAffinityIndex &  operator=(const CNSPendingAffinityIndex &);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_NS_PENDING_INDEX__HPP */
+
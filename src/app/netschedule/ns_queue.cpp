@@ -69,6 +69,7 @@ CQueue::CQueue(const string &        queue_name,
                CQueueDataBase &      qdb) :
     m_Server(server),
     m_QueueDB(qdb),
+    m_Journal(qdb.GetJournal()),
     m_RunTimeLine(NULL),
     m_QueueName(queue_name),
     m_Kind(queue_kind),
@@ -502,6 +503,8 @@ unsigned int  CQueue::Submit(const CNSClientId &        client,
                                                        m_ReadTimeout,
                                                        m_PendingTimeout,
                                                        op_begin_time));
+
+        x_JournalJob(job);
     }}
 
     rollback_action = new CNSSubmitRollback(client, job_id,
@@ -634,6 +637,8 @@ CQueue::SubmitBatch(const CNSClientId &             client,
                                                          m_ReadTimeout,
                                                          m_PendingTimeout,
                                                          curr_time));
+
+            x_JournalJob(batch[k].first);
         }
     }}
 
@@ -1164,6 +1169,7 @@ TJobStatus  CQueue::JobDelayExpiration(unsigned int            job_id,
         exp_time = time_start + run_timeout;
 
     TimeLineMove(job_id, exp_time, curr + tm);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return CNetScheduleAPI::eRunning;
@@ -1212,6 +1218,7 @@ TJobStatus  CQueue::JobDelayReadExpiration(unsigned int            job_id,
         exp_time = time_start + read_timeout;
 
     TimeLineMove(job_id, exp_time, curr + tm);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return CNetScheduleAPI::eReading;
@@ -1327,6 +1334,7 @@ TJobStatus  CQueue::SetJobListener(unsigned int            job_id,
     job_iter->second.SetNeedLsnrProgressMsgNotif(need_progress_msg);
     job_iter->second.SetNeedStolenNotif(need_stolen);
     job_iter->second.SetLastTouch(curr);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return status;
@@ -1353,6 +1361,7 @@ bool CQueue::PutProgressMessage(unsigned int    job_id,
                                                    m_PendingTimeout, curr));
     x_NotifyJobChanges(job_iter->second, MakeJobKey(job_id),
                        eProgressMessageChanged, curr);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return true;
@@ -1455,6 +1464,7 @@ TJobStatus  CQueue::ReturnJob(const CNSClientId &     client,
                                                    current_time));
 
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     if (m_PauseStatus == eNoPause)
         m_NotificationsList.Notify(
@@ -1575,6 +1585,7 @@ TJobStatus  CQueue::RescheduleJob(const CNSClientId &     client,
                                                    current_time));
 
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     if (m_PauseStatus == eNoPause)
         m_NotificationsList.Notify(
@@ -1634,6 +1645,7 @@ TJobStatus  CQueue::RedoJob(const CNSClientId &     client,
                                                    current_time));
 
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     if (m_PauseStatus == eNoPause)
         m_NotificationsList.Notify(job_id,
@@ -1742,6 +1754,7 @@ TJobStatus  CQueue::Cancel(const CNSClientId &  client,
 
     x_NotifyJobChanges(job_iter->second, job_key,
                        eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     // Notify the readers if the job has not been given for reading yet
     // and it was not a rollback due to a socket write error
@@ -1841,6 +1854,7 @@ unsigned int CQueue::x_CancelJobs(const CNSClientId &   client,
 
         x_NotifyJobChanges(job_iter->second, MakeJobKey(job_id),
                            eStatusChanged, current_time);
+        x_JournalJob(job_iter->second);
 
         // Notify the readers if the job has not been given for reading yet
         if (!m_ReadJobs.get_bit(job_id)) {
@@ -2319,6 +2333,7 @@ TJobStatus  CQueue::RereadJob(const CNSClientId &     client,
                                                    current_time));
 
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     // Notify the readers
     m_NotificationsList.Notify(job_id, job_iter->second.GetAffinityId(),
@@ -2461,6 +2476,7 @@ TJobStatus  CQueue::x_ChangeReadingStatus(const CNSClientId &  client,
                                              path_option);
     g_DoPerfLogging(*this, job_iter->second, 200);
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return CNetScheduleAPI::eReading;
@@ -2503,6 +2519,101 @@ void CQueue::x_Erase(const TNSBitVector &  job_ids, TJobStatus  status)
 void CQueue::OptimizeMem()
 {
     m_StatusTracker.OptimizeMem();
+
+    // Drop the index candidates which are not pending anymore: some
+    // affinities are never requested explicitly so their candidates are
+    // not checked by GET
+    TNSBitVector        pending_jobs;
+    CFastMutexGuard     guard(m_OperationLock);
+
+    x_UpdatePendingIndex();
+    m_StatusTracker.GetJobs(CNetScheduleAPI::ePending, pending_jobs);
+    m_PendingIndex.Purge(pending_jobs);
+}
+
+
+// Must be called under the operation lock
+void CQueue::x_UpdatePendingIndex(void)
+{
+    TNSBitVector        new_pending;
+    m_StatusTracker.TakeNewPendingJobs(new_pending);
+
+    TNSBitVector::enumerator    en(new_pending.first());
+    for (; en.valid(); ++en)
+        m_PendingIndex.AddJob(*en, m_GCRegistry.GetAffinityID(*en));
+}
+
+
+void CQueue::x_BuildPendingJobFilter(const CNSClientId &    client,
+                                     const TNSBitVector &   group_ids,
+                                     bool                   has_groups,
+                                     const string &         scope,
+                                     x_SPendingJobFilter &  filter)
+{
+    // The same restrictions as for the vacant jobs in x_FindVacantJob()
+    if (scope.empty() || scope == kNoScopeOnly) {
+        filter.excluded = m_ScopeRegistry.GetAllJobsInScopes();
+        if (has_groups) {
+            filter.allowed = m_GroupRegistry.GetJobs(group_ids);
+            filter.restricted = true;
+        }
+    } else {
+        filter.allowed = m_ScopeRegistry.GetJobs(scope);
+        filter.restricted = true;
+        if (has_groups)
+            m_GroupRegistry.RestrictByGroup(group_ids, filter.allowed);
+    }
+    m_ClientsRegistry.AddBlacklistedJobs(client, eGet, filter.excluded);
+}
+
+
+// Provides the lowest id pending job of the affinity which suits the filter
+// and is less than the upper limit (if it is not 0). Removes the stale index
+// candidates on the way.
+unsigned int
+CQueue::x_FindPendingJobWithAffinity(
+                        unsigned int                 aff_id,
+                        unsigned int                 upper_limit,
+                        const x_SPendingJobFilter &  filter,
+                        const map<string, size_t> &  jobs_per_client_ip)
+{
+    unsigned int    job_id = m_PendingIndex.GetNext(aff_id, 0);
+
+    while (job_id != 0 && (upper_limit == 0 || job_id < upper_limit)) {
+        unsigned int    next_job_id = m_PendingIndex.GetNext(aff_id, job_id);
+
+        if (m_StatusTracker.GetStatus(job_id) != CNetScheduleAPI::ePending ||
+            m_GCRegistry.GetAffinityID(job_id) != aff_id) {
+            m_PendingIndex.RemoveJob(job_id, aff_id);
+        } else if (!filter.excluded.get_bit(job_id) &&
+                   (!filter.restricted || filter.allowed.get_bit(job_id)) &&
+                   x_ValidateMaxJobsPerClientIP(job_id, jobs_per_client_ip)) {
+            return job_id;
+        }
+        job_id = next_job_id;
+    }
+    return 0;
+}
+
+
+// Provides the lowest id pending job among the given affinities
+CQueue::x_SJobPick
+CQueue::x_FindPendingJobWithAffinities(
+                        const TNSBitVector &         aff_ids,
+                        const x_SPendingJobFilter &  filter,
+                        const map<string, size_t> &  jobs_per_client_ip)
+{
+    x_SJobPick                  job_pick;
+    TNSBitVector::enumerator    en(aff_ids.first());
+
+    for (; en.valid(); ++en) {
+        unsigned int    job_id = x_FindPendingJobWithAffinity(
+                                            *en, job_pick.job_id, filter,
+                                            jobs_per_client_ip);
+        if (job_id != 0)
+            job_pick = x_SJobPick(job_id, false, *en);
+    }
+    return job_pick;
 }
 
 
@@ -2572,7 +2683,57 @@ CQueue::x_FindVacantJob(const CNSClientId  &          client,
     if (use_pref_affinity)
         effective_use_pref_affinity = use_pref_affinity && pref_aff.any();
 
-    if (explicit_aff || effective_use_pref_affinity || exclusive_new_affinity) {
+    // GET uses the pending index for the explicit and preferred affinities
+    // so the cost depends on the number of the requested affinities rather
+    // than on the number of the pending jobs. The vacant jobs are scanned
+    // only for READ, for the exclusive new affinity and for the any affinity
+    // fallback of the prioritized affinities.
+    bool            indexed = (cmd_group == eGet);
+
+    if (indexed &&
+        (explicit_aff || effective_use_pref_affinity)) {
+        x_SPendingJobFilter     filter;
+
+        x_UpdatePendingIndex();
+        x_BuildPendingJobFilter(client, group_ids, has_groups, scope, filter);
+
+        if (prioritized_aff) {
+            for (vector<unsigned int>::const_iterator  k = aff_ids.begin();
+                    k != aff_ids.end(); ++k) {
+                unsigned int    job_id = x_FindPendingJobWithAffinity(
+                                                *k, 0, filter,
+                                                running_jobs_per_client);
+                if (job_id != 0)
+                    return x_SJobPick(job_id, false, *k);
+            }
+            if (!any_affinity)
+                return x_SJobPick();
+        } else {
+            if (explicit_aff) {
+                x_SJobPick  job_pick = x_FindPendingJobWithAffinities(
+                                                explicit_affs, filter,
+                                                running_jobs_per_client);
+                if (job_pick.job_id != 0)
+                    return job_pick;
+            }
+            if (effective_use_pref_affinity) {
+                x_SJobPick  job_pick = x_FindPendingJobWithAffinities(
+                                                pref_aff, filter,
+                                                running_jobs_per_client);
+                if (job_pick.job_id != 0) {
+                    // The preferred affinity is not reported if there were
+                    // explicit ones
+                    if (explicit_aff)
+                        job_pick.aff_id = 0;
+                    return job_pick;
+                }
+            }
+        }
+    }
+
+    if ((explicit_aff || effective_use_pref_affinity ||
+         exclusive_new_affinity) &&
+        (!indexed || prioritized_aff || exclusive_new_affinity)) {
         // Check all vacant jobs: pending jobs for eGet,
         //                        done/failed/cancel jobs for eRead
         TNSBitVector    vacant_jobs;
@@ -2602,9 +2763,10 @@ CQueue::x_FindVacantJob(const CNSClientId  &          client,
 
         if (prioritized_aff) {
             // The criteria here is a list of explicit affinities
-            // (respecting their order) which may be followed by any affinity
+            // (respecting their order) which may be followed by any affinity.
+            // The explicit ones have been checked already for GET.
             for (vector<unsigned int>::const_iterator  k = aff_ids.begin();
-                    k != aff_ids.end(); ++k) {
+                    !indexed && k != aff_ids.end(); ++k) {
                 TNSBitVector    aff_jobs = m_AffinityRegistry.
                                                     GetJobsWithAffinity(*k);
                 TNSBitVector    candidates = vacant_jobs & aff_jobs;
@@ -3142,6 +3304,7 @@ TJobStatus CQueue::FailJob(const CNSClientId &    client,
         }
 
     x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, curr);
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
     return old_status;
@@ -3342,7 +3505,7 @@ void CQueue::x_CheckExecutionTimeout(const CNSPreciseTime &  queue_run_timeout,
     TJobStatus                          status;
     TJobStatus                          new_status;
     CJobEvent::EJobEvent                event_type;
-    map<unsigned int, CJob>::iterator   job_iter;
+    CNSJobStore::iterator               job_iter;
 
     {{
         CFastMutexGuard         guard(m_OperationLock);
@@ -3475,6 +3638,7 @@ void CQueue::x_CheckExecutionTimeout(const CNSPreciseTime &  queue_run_timeout,
                     m_AffinityRegistry, m_GroupRegistry, m_ScopeRegistry,
                     m_NotifHifreqPeriod, m_HandicapTimeout, eRead);
             }
+        x_JournalJob(job_iter->second);
     }}
 
     x_NotifyJobChanges(job_iter->second, MakeJobKey(job_id),
@@ -3541,6 +3705,7 @@ CQueue::CheckJobsExpiry(const CNSPreciseTime &  current_time,
                 m_StatusTracker.Erase(job_id);
                 job_ids.set_bit(job_id);
                 ++result.deleted;
+                x_JournalJobDeleted(job_id);
 
                 // check if the affinity should also be updated
                 if (aff != 0)
@@ -4205,6 +4370,7 @@ TJobStatus  CQueue::x_ResetDueTo(const CNSClientId &     client,
 
     x_NotifyJobChanges(job_iter->second, MakeJobKey(job_id),
                        eStatusChanged, current_time);
+    x_JournalJob(job_iter->second);
     return new_status;
 }
 
@@ -4370,6 +4536,11 @@ void CQueue::PrintStatistics(size_t &  aff_count) const
          .Print("reading", CountStatus(CNetScheduleAPI::eReading))
          .Print("confirmed", CountStatus(CNetScheduleAPI::eConfirmed))
          .Print("readfailed", CountStatus(CNetScheduleAPI::eReadFailed));
+    {{
+        CFastMutexGuard     guard(m_OperationLock);
+        extra.Print("jobs_in_memory", m_Jobs.size())
+             .Print("jobs_memory", m_Jobs.GetAllocatedSize());
+    }}
     counters_copy.PrintTransitions(extra);
     counters_copy.PrintDelta(extra, m_StatisticsCountersLastPrinted);
     extra.Flush();
@@ -4595,6 +4766,8 @@ void CQueue::x_UpdateDB_PutResultNoLock(unsigned                job_id,
     job_iter->second.SetOutput(output);
     job_iter->second.SetLastTouch(curr);
 
+    x_JournalJob(job_iter->second);
+
     job = job_iter->second;
 }
 
@@ -4635,13 +4808,14 @@ void CQueue::x_UpdateDB_ProvideJobNoLock(const CNSClientId &     client,
         job_iter->second.SetReadTimeout(kTimeZero);
         job_iter->second.SetReadCount(job_iter->second.GetReadCount() + 1);
     }
+    x_JournalJob(job_iter->second);
 
     job = job_iter->second;
 }
 
 
-// Dumps all the jobs into a flat file at the time of shutdown
-void CQueue::Dump(const string &  dump_dname)
+// Provides the jobs which are saved in a dump or in a snapshot
+TNSBitVector CQueue::x_GetJobsToDump(void) const
 {
     // Form a bit vector of all jobs to dump
     vector<TJobStatus>      statuses;
@@ -4663,6 +4837,15 @@ void CQueue::Dump(const string &  dump_dname)
     // need to save them
     jobs_to_dump -= m_ScopeRegistry.GetAllJobsInScopes();
 
+    return jobs_to_dump;
+}
+
+
+// Dumps all the jobs into a flat file at the time of shutdown
+void CQueue::Dump(const string &  dump_dname)
+{
+    TNSBitVector            jobs_to_dump = x_GetJobsToDump();
+
     if (!jobs_to_dump.any())
         return;     // Nothing to dump
 
@@ -4732,75 +4915,73 @@ string CQueue::x_GetJobsDumpFileName(const string &  dump_dname) const
 }
 
 
-unsigned int  CQueue::LoadFromDump(const string &  dump_dname)
+unsigned int  CQueue::LoadFromDump(const string &  dump_dname,
+                                   const TNSJournalJobs *  journal_jobs)
 {
     unsigned int    recs = 0;
     string          jobs_file_name = x_GetJobsDumpFileName(dump_dname);
     FILE *          jobs_file = NULL;
+    bool            have_journal = journal_jobs != NULL &&
+                                   !journal_jobs->empty();
 
-    if (!CDir(dump_dname).Exists())
-        return 0;
-    if (!CFile(jobs_file_name).Exists())
-        return 0;
+    if (!have_journal) {
+        if (!CDir(dump_dname).Exists())
+            return 0;
+        if (!CFile(jobs_file_name).Exists())
+            return 0;
+    }
 
     try {
         m_AffinityRegistry.LoadFromDump(dump_dname, m_QueueName);
         m_GroupRegistry.LoadFromDump(dump_dname, m_QueueName);
 
-        jobs_file = fopen(jobs_file_name.c_str(), "rb");
-        if (jobs_file == NULL)
-            throw runtime_error("Cannot open file " + jobs_file_name +
-                                " to load dumped jobs");
-
-        SJobDumpHeader      header;
-        header.Read(jobs_file);
-
-        CJob                job;
         AutoArray<char>     input_buf(new char[kNetScheduleMaxOverflowSize]);
         AutoArray<char>     output_buf(new char[kNetScheduleMaxOverflowSize]);
-        while (job.LoadFromDump(jobs_file,
-                                input_buf.get(), output_buf.get(),
-                                header)) {
-            unsigned int    job_id = job.GetId();
-            unsigned int    group_id = job.GetGroupId();
-            unsigned int    aff_id = job.GetAffinityId();
-            TJobStatus      status = job.GetStatus();
-
-            m_Jobs[job_id] = job;
-            m_StatusTracker.SetExactStatusNoLock(job_id, status, true);
-
-            if ((status == CNetScheduleAPI::eRunning ||
-                 status == CNetScheduleAPI::eReading) &&
-                m_RunTimeLine) {
-                // Add object to the first available slot;
-                // it is going to be rescheduled or dropped
-                // in the background control thread
-                // We can use time line without lock here because
-                // the queue is still in single-use mode while
-                // being loaded.
-                m_RunTimeLine->AddObject(m_RunTimeLine->GetHead(), job_id);
+
+        if (CFile(jobs_file_name).Exists()) {
+            jobs_file = fopen(jobs_file_name.c_str(), "rb");
+            if (jobs_file == NULL)
+                throw runtime_error("Cannot open file " + jobs_file_name +
+                                    " to load dumped jobs");
+
+            SJobDumpHeader      header;
+            header.Read(jobs_file);
+
+            CJob                job;
+            while (job.LoadFromDump(jobs_file,
+                                    input_buf.get(), output_buf.get(),
+                                    header)) {
+                // The journal has a later state of the job
+                if (have_journal &&
+                    journal_jobs->find(job.GetId()) != journal_jobs->end())
+                    continue;
+
+                x_RegisterLoadedJob(job);
+                ++recs;
             }
 
-            // Register the job for the affinity if so
-            if (aff_id != 0)
-                m_AffinityRegistry.AddJobToAffinity(job_id, aff_id);
-
-            // Register the job in the group registry
-            if (group_id != 0)
-                m_GroupRegistry.AddJobToGroup(group_id, job_id);
-
-            // Register the loaded job with the garbage collector
-            CNSPreciseTime  submit_time = job.GetSubmitTime();
-            CNSPreciseTime  expiration =
-                    GetJobExpirationTime(job.GetLastTouch(), status,
-                                         submit_time, job.GetTimeout(),
-                                         job.GetRunTimeout(),
-                                         job.GetReadTimeout(),
-                                         m_Timeout, m_RunTimeout, m_ReadTimeout,
-                                         m_PendingTimeout, kTimeZero);
-            m_GCRegistry.RegisterJob(job_id, job.GetSubmitTime(),
-                                     aff_id, group_id, expiration);
-            ++recs;
+            fclose(jobs_file);
+            jobs_file = NULL;
+        }
+
+        if (have_journal) {
+            for (TNSJournalJobs::const_iterator  k = journal_jobs->begin();
+                    k != journal_jobs->end(); ++k) {
+                if (k->second.deleted)
+                    continue;
+
+                // The affinity and group IDs could be given after the
+                // snapshot was taken so they are resolved by the tokens
+                CJob        job = k->second.job;
+                job.SetAffinityId(k->second.aff_token.empty() ? 0 :
+                        m_AffinityRegistry.ResolveAffinity(
+                                                    k->second.aff_token));
+                job.SetGroupId(m_GroupRegistry.ResolveGroup(
+                                                    k->second.group_token));
+
+                x_RegisterLoadedJob(job);
+                ++recs;
+            }
         }
 
         // Make sure that there are no affinity IDs in the registry for which
@@ -4826,11 +5007,148 @@ unsigned int  CQueue::LoadFromDump(const string &  dump_dname)
                             " from its dump");
     }
 
-    fclose(jobs_file);
     return recs;
 }
 
 
+// Dumps the jobs at the time of taking a journal snapshot. The registries are
+// dumped and the jobs are copied under the operation lock so that they are
+// consistent; the jobs file is written after the lock is released so that
+// the handlers are not stalled by the disk.
+void CQueue::Snapshot(const string &  dump_dname)
+{
+    vector<CJob>        jobs;
+
+    {{
+        CFastMutexGuard     guard(m_OperationLock);
+        TNSBitVector        jobs_to_dump = x_GetJobsToDump();
+
+        if (!jobs_to_dump.any())
+            return;     // Nothing to dump
+
+        try {
+            m_AffinityRegistry.Dump(dump_dname, m_QueueName);
+            m_GroupRegistry.Dump(dump_dname, m_QueueName);
+        } catch (const exception &  ex) {
+            RemoveDump(dump_dname);
+            throw runtime_error("Error dumping queue " + m_QueueName +
+                                ": " + string(ex.what()));
+        }
+
+        jobs.reserve(jobs_to_dump.count());
+        TNSBitVector::enumerator    en(jobs_to_dump.first());
+        for ( ; en.valid(); ++en) {
+            auto        job_iter = m_Jobs.find(*en);
+            if (job_iter != m_Jobs.end())
+                jobs.push_back(job_iter->second);
+        }
+    }}
+
+    string      jobs_file_name = x_GetJobsDumpFileName(dump_dname);
+    FILE *      jobs_file = NULL;
+
+    try {
+        jobs_file = fopen(jobs_file_name.c_str(), "wb");
+        if (jobs_file == NULL)
+            throw runtime_error("Cannot open file " + jobs_file_name +
+                                " to dump jobs");
+
+        SJobDumpHeader      header;
+        header.Write(jobs_file);
+
+        for (vector<CJob>::const_iterator  k = jobs.begin();
+                k != jobs.end(); ++k)
+            k->Dump(jobs_file);
+
+        // The snapshot is used only after it is on disk
+        if (fflush(jobs_file) != 0 || fsync(fileno(jobs_file)) != 0)
+            throw runtime_error("Cannot write file " + jobs_file_name);
+    } catch (const exception &  ex) {
+        if (jobs_file != NULL)
+            fclose(jobs_file);
+        RemoveDump(dump_dname);
+        throw runtime_error("Error dumping queue " + m_QueueName +
+                            ": " + string(ex.what()));
+    }
+
+    fclose(jobs_file);
+}
+
+
+// Registers a job loaded from the dump or from the journal in all the
+// queue structures
+void CQueue::x_RegisterLoadedJob(const CJob &  job)
+{
+    unsigned int    job_id = job.GetId();
+    unsigned int    group_id = job.GetGroupId();
+    unsigned int    aff_id = job.GetAffinityId();
+    TJobStatus      status = job.GetStatus();
+
+    m_Jobs[job_id] = job;
+    m_StatusTracker.SetExactStatusNoLock(job_id, status, true);
+
+    if ((status == CNetScheduleAPI::eRunning ||
+         status == CNetScheduleAPI::eReading) &&
+        m_RunTimeLine) {
+        // Add object to the first available slot;
+        // it is going to be rescheduled or dropped
+        // in the background control thread
+        // We can use time line without lock here because
+        // the queue is still in single-use mode while
+        // being loaded.
+        m_RunTimeLine->AddObject(m_RunTimeLine->GetHead(), job_id);
+    }
+
+    // Register the job for the affinity if so
+    if (aff_id != 0)
+        m_AffinityRegistry.AddJobToAffinity(job_id, aff_id);
+
+    // Register the job in the group registry
+    if (group_id != 0)
+        m_GroupRegistry.AddJobToGroup(group_id, job_id);
+
+    // Register the loaded job with the garbage collector
+    CNSPreciseTime  submit_time = job.GetSubmitTime();
+    CNSPreciseTime  expiration =
+            GetJobExpirationTime(job.GetLastTouch(), status,
+                                 submit_time, job.GetTimeout(),
+                                 job.GetRunTimeout(),
+                                 job.GetReadTimeout(),
+                                 m_Timeout, m_RunTimeout, m_ReadTimeout,
+                                 m_PendingTimeout, kTimeZero);
+    m_GCRegistry.RegisterJob(job_id, job.GetSubmitTime(),
+                             aff_id, group_id, expiration);
+}
+
+
+// Must be called under the operation lock after the job is changed.
+// The scoped jobs are not dumped so they are not journaled either.
+void CQueue::x_JournalJob(const CJob &  job)
+{
+    if (m_Journal == NULL)
+        return;
+
+    unsigned int    job_id = job.GetId();
+    if (!m_ScopeRegistry.GetJobScope(job_id).empty())
+        return;
+
+    unsigned int    aff_id = job.GetAffinityId();
+    unsigned int    group_id = job.GetGroupId();
+    m_Journal->JobChanged(m_QueueName, job,
+                          aff_id == 0 ? kEmptyStr :
+                                m_AffinityRegistry.GetTokenByID(aff_id),
+                          group_id == 0 ? kEmptyStr :
+                                m_GroupRegistry.ResolveGroup(group_id));
+}
+
+
+void CQueue::x_JournalJobDeleted(unsigned int  job_id)
+{
+    if (m_Journal != NULL)
+        m_Journal->JobDeleted(m_QueueName, job_id);
+}
+
+
 // The member does not grab the operational lock.
 // The member is used at the time of loading jobs from dump and at that time
 // there is no concurrent access.
@@ -4842,6 +5160,7 @@ void CQueue::x_ClearQueue(void)
     m_ReadJobs.clear(true);
 
     m_AffinityRegistry.Clear();
+    m_PendingIndex.Clear();
     m_GroupRegistry.Clear();
     m_GCRegistry.Clear();
     m_ScopeRegistry.Clear();
@@ -59,6 +59,9 @@
 #include "ns_precise_time.hpp"
 #include "ns_scope.hpp"
 #include "ns_server_params.hpp"
+#include "ns_journal.hpp"
+#include "ns_job_store.hpp"
+#include "ns_pending_index.hpp"
 
 #include <map>
 
@@ -466,7 +469,11 @@ public:
 
     void Dump(const string &  dump_dir_name);
     void RemoveDump(const string &  dump_dir_name);
-    unsigned int LoadFromDump(const string &  dump_dir_name);
+    // The journal jobs (if given) override the dumped ones
+    unsigned int LoadFromDump(const string &  dump_dir_name,
+                              const TNSJournalJobs *  journal_jobs = NULL);
+    // Dumps the jobs while the server is running
+    void Snapshot(const string &  dump_dir_name);
     bool ShouldPerfLogTransitions(void) const
     { return m_ShouldPerfLogTransitions; }
     void UpdatePerfLoggingSettings(const string &  qclass);
@@ -519,6 +526,35 @@ private:
                     bool                          has_groups,
                     ECommandGroup                 cmd_group,
                     const string &                scope);
+
+    // The GET restrictions which are checked for each job taken from the
+    // pending affinity index
+    struct x_SPendingJobFilter
+    {
+        TNSBitVector    excluded;       // out of scope and blacklisted jobs
+        TNSBitVector    allowed;        // scope and group jobs
+        bool            restricted;     // true if 'allowed' is in effect
+
+        x_SPendingJobFilter() :
+            restricted(false)
+        {}
+    };
+
+    void x_UpdatePendingIndex(void);
+    void x_BuildPendingJobFilter(const CNSClientId &    client,
+                                 const TNSBitVector &   group_ids,
+                                 bool                   has_groups,
+                                 const string &         scope,
+                                 x_SPendingJobFilter &  filter);
+    unsigned int
+    x_FindPendingJobWithAffinity(unsigned int                 aff_id,
+                                 unsigned int                 upper_limit,
+                                 const x_SPendingJobFilter &  filter,
+                                 const map<string, size_t> &  jobs_per_client_ip);
+    x_SJobPick
+    x_FindPendingJobWithAffinities(const TNSBitVector &         aff_ids,
+                                   const x_SPendingJobFilter &  filter,
+                                   const map<string, size_t> &  jobs_per_client_ip);
     map<string, size_t> x_GetRunningJobsPerClientIP(void);
     bool x_ValidateMaxJobsPerClientIP(unsigned int  job_id,
                                       const map<string, size_t> &  jobs_per_client_ip) const;
@@ -620,8 +656,12 @@ private:
                           bool                  affinity_may_change,
                           bool                  group_may_change);
 
+    TNSBitVector x_GetJobsToDump(void) const;
     string x_GetJobsDumpFileName(const string &  dump_dname) const;
     void x_ClearQueue(void);
+    void x_RegisterLoadedJob(const CJob &  job);
+    void x_JournalJob(const CJob &  job);
+    void x_JournalJobDeleted(unsigned int  job_id);
     void x_NotifyJobChanges(const CJob &            job,
                             const string &          job_key,
                             ENotificationReason     reason,
@@ -634,8 +674,9 @@ private:
     CNetScheduleServer *        m_Server;
     CJobStatusTracker           m_StatusTracker;    // status FSA
     CQueueDataBase &            m_QueueDB;
+    CNSJournal *                m_Journal;          // NULL if disabled
 
-    map<unsigned int, CJob>     m_Jobs;             // in-memory jobs
+    CNSJobStore                 m_Jobs;             // in-memory jobs
 
     // Timeline object to control job execution timeout
     CJobTimeLine*               m_RunTimeLine;
@@ -652,6 +693,8 @@ private:
 
     // Registry of all the job affinities
     CNSAffinityRegistry         m_AffinityRegistry;
+    // Pending jobs per affinity for GET
+    CNSPendingAffinityIndex     m_PendingIndex;
 
     // Last valid id for queue
     unsigned int                m_LastId;      // Last used job ID
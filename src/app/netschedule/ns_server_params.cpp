@@ -262,6 +262,7 @@ void SNS_Parameters::Read(const IRegistry &  reg)
                             "state_transition_perf_log_classes", kEmptyStr);
 
     diskless = GetBoolNoErr("diskless", default_diskless);
+    journal.Read(reg, sname);
 
     #if defined(_DEBUG) && !defined(NDEBUG)
     ReadErrorEmulatorSection(reg);
@@ -332,6 +333,32 @@ void SNS_Parameters::x_CheckJobGarbageCollectorSettings(void)
 }
 
 
+void SNSJournalParameters::Read(const IRegistry &  reg,
+                                const string &  sname)
+{
+    enabled = GetBoolNoErr("journal", default_journal);
+    sync_replies = GetBoolNoErr("journal_sync_replies",
+                                default_journal_sync_replies);
+
+    int     val = GetIntNoErr("journal_commit_delay",
+                              default_journal_commit_delay);
+    if (val < 0)
+        commit_delay = default_journal_commit_delay;
+    else
+        commit_delay = val;
+
+    val = GetIntNoErr("journal_snapshot_interval",
+                      default_journal_snapshot_interval);
+    if (val <= 0)
+        snapshot_interval = default_journal_snapshot_interval;
+    else
+        snapshot_interval = val;
+
+    snapshot_size = NS_GetDataSize(reg, sname, "journal_snapshot_size",
+                                   default_journal_snapshot_size);
+}
+
+
 void SNSRegistryParameters::Read(const IRegistry &  reg,
                                  const string &  sname,
                                  const string &  name,
@@ -123,6 +123,23 @@ struct SNSRegistryParameters
 
 
 
+// Job state journal parameters
+struct SNSJournalParameters
+{
+    bool            enabled;
+    bool            sync_replies;       // Reply only when the change is
+                                        // on disk
+    unsigned int    commit_delay;       // mks to wait for more records
+                                        // before a group commit
+    unsigned int    snapshot_interval;  // Max seconds between snapshots
+    unsigned int    snapshot_size;      // Max journal bytes between
+                                        // snapshots
+
+    void Read(const IRegistry &  reg, const string &  sname);
+};
+
+
+
 // Parameters for server
 struct SNS_Parameters : SServer_Parameters
 {
@@ -164,6 +181,8 @@ struct SNS_Parameters : SServer_Parameters
     unsigned int    max_queues;
     bool            diskless;
 
+    SNSJournalParameters        journal;
+
     void Read(const IRegistry &  reg);
 
     #if defined(_DEBUG) && !defined(NDEBUG)
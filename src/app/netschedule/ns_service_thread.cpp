@@ -72,6 +72,10 @@ void  CServiceThread::DoJob(void)
         }
     }
 
+    // The snapshot is taken in this thread so that the handlers are not
+    // blocked for longer than a single queue dump
+    m_QueueDB.CheckJournalSnapshot();
+
     if (!m_StatisticsLogging)
         return;
 
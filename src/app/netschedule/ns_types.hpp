@@ -88,6 +88,11 @@ const string    kCrashFlagFileName("CRASH_FLAG");
 const string    kDumpErrorFlagFileName("DUMP_ERROR_FLAG");
 const string    kPausedQueuesFilesName("PAUSED_QUEUES");
 const string    kRefuseSubmitFileName("REFUSE_SUBMIT");
+const string    kJournalSubdirName("journal");
+const string    kSnapshotSubdirName("snapshot");
+const string    kSnapshotFileName("SNAPSHOT");
+const string    kJournalFilePrefix("journal.");
+const string    kJournalBaseFileName("JOURNAL_BASE");
 const size_t    kDumpReservedSpaceFileBuffer = 1024 * 1024;
 
 static string   kNewLine("\n");
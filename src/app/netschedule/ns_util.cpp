@@ -312,6 +312,8 @@ void NS_ValidateServerSection(const IRegistry &  reg,
     NS_ValidateBool(reg, section, "log_execution_watcher_thread", warnings);
     NS_ValidateBool(reg, section, "log_statistics_thread", warnings);
     NS_ValidateBool(reg, section, "diskless", warnings);
+    NS_ValidateBool(reg, section, "journal", warnings);
+    NS_ValidateBool(reg, section, "journal_sync_replies", warnings);
 
 
     ok = NS_ValidateInt(reg, section, "del_batch_size", warnings);
@@ -459,6 +461,26 @@ void NS_ValidateServerSection(const IRegistry &  reg,
     }
 
     NS_ValidateDataSize(reg, section, "reserve_dump_space", warnings);
+
+    ok = NS_ValidateInt(reg, section, "journal_commit_delay", warnings);
+    if (ok) {
+        int     val = reg.GetInt(section, "journal_commit_delay",
+                                 default_journal_commit_delay);
+        if (val < 0)
+            warnings.push_back(g_ValidPrefix + "value " +
+                     NS_RegValName(section, "journal_commit_delay") +
+                     " must be >= 0");
+    }
+    ok = NS_ValidateInt(reg, section, "journal_snapshot_interval", warnings);
+    if (ok) {
+        int     val = reg.GetInt(section, "journal_snapshot_interval",
+                                 default_journal_snapshot_interval);
+        if (val <= 0)
+            warnings.push_back(g_ValidPrefix + "value " +
+                     NS_RegValName(section, "journal_snapshot_interval") +
+                     " must be > 0");
+    }
+    NS_ValidateDataSize(reg, section, "journal_snapshot_size", warnings);
 }
 
 
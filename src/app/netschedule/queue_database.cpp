@@ -30,6 +30,7 @@
  */
 #include <ncbi_pch.hpp>
 #include <unistd.h>
+#include <fcntl.h>
 
 #include <corelib/ncbi_system.hpp>
 #include <corelib/ncbireg.hpp>
@@ -60,10 +61,12 @@ CQueueDataBase::CQueueDataBase(CNetScheduleServer *  server,
                                const string &  path,
                                unsigned int  max_queues,
                                bool  diskless,
+                               const SNSJournalParameters &  journal_params,
                                bool  reinit)
 : m_Host(server->GetBackgroundHost()),
   m_MaxQueues(max_queues),
   m_Diskless(diskless),
+  m_RecoverFromJournal(false),
   m_StopPurge(false),
   m_FreeStatusMemCnt(0),
   m_LastFreeMem(time(0)),
@@ -75,6 +78,11 @@ CQueueDataBase::CQueueDataBase(CNetScheduleServer *  server,
     m_DataPath = CDirEntry::AddTrailingPathSeparator(path);
     m_DumpPath = CDirEntry::AddTrailingPathSeparator(m_DataPath +
                                                      kDumpSubdirName);
+    m_SnapshotPath = x_ReadSnapshotPath();
+
+    // The journal must exist before the queues are created
+    if (!m_Diskless && journal_params.enabled)
+        m_Journal.reset(new CNSJournal(m_DataPath, journal_params));
 
     // First, load the previous session start job IDs if file existed
     // The diskless flag will be considered when IDs are loaded.
@@ -105,6 +113,13 @@ CQueueDataBase::CQueueDataBase(CNetScheduleServer *  server,
         SerializePauseState(m_DataPath, GetPauseQueues());
         SerializeRefuseSubmitState(m_DataPath, server->GetRefuseSubmits(),
                                    GetRefuseSubmitQueues());
+
+        if (m_Journal.get() != NULL) {
+            // The previous instance journal (if any) is needed only till
+            // the first snapshot is taken, so it is done right away
+            m_Journal->Start();
+            x_JournalSnapshot();
+        }
     }
 }
 
@@ -150,6 +165,22 @@ void  CQueueDataBase::x_Open(bool  reinit)
         data_dir.Create();
     }
 
+    if (!m_Diskless) {
+        // An interrupted snapshot is never used. The previous instance
+        // journal and snapshot are needed only to recover after a crash.
+        if (!m_RecoverFromJournal) {
+            CFile   snapshot_file(m_DataPath + kSnapshotFileName);
+            if (snapshot_file.Exists())
+                snapshot_file.Remove();
+            m_SnapshotPath.clear();
+            CDir    journal_dir(m_DataPath + kJournalSubdirName);
+            if (journal_dir.Exists() && !journal_dir.Remove())
+                ERR_POST(Warning << "Error removing directory "
+                                 << journal_dir.GetPath());
+        }
+        x_RemoveStaleSnapshots();
+    }
+
     // The initialization must be done before the queues are created but after
     // the directory is possibly re-created
     m_Server->InitNodeID(m_DataPath);
@@ -247,13 +278,38 @@ void  CQueueDataBase::x_Open(bool  reinit)
             x_CreateAndMountQueue(qname, params);
         }
 
+        // The jobs changed after the snapshot (which is loaded as a dump)
+        // was taken override the dumped ones
+        TNSJournalQueues    journal_queues;
+        if (m_RecoverFromJournal) {
+            try {
+                size_t      records = m_Journal->Replay(
+                                        x_ReadJournalBase(m_DumpPath),
+                                        journal_queues);
+                GetDiagContext().Extra()
+                    .Print("_type", "startup")
+                    .Print("info", "replay_journal")
+                    .Print("records", records);
+            } catch (const exception &  ex) {
+                ERR_POST(Warning << ex.what());
+                last_queue_load_error = ex.what();
+                ++queue_load_error_count;
+                journal_queues.clear();
+            }
+        }
+
         // All the structures are ready to upload the jobs from the dump
         if (!m_Diskless) {
             for (TQueueInfo::iterator  k = m_Queues.begin();
                     k != m_Queues.end(); ++k) {
                 try {
+                    TNSJournalQueues::const_iterator    journal_jobs =
+                                            journal_queues.find(k->first);
                     unsigned int   records =
-                                        k->second.second->LoadFromDump(m_DumpPath);
+                        k->second.second->LoadFromDump(
+                                m_DumpPath,
+                                journal_jobs == journal_queues.end() ?
+                                        NULL : &journal_jobs->second);
                     GetDiagContext().Extra()
                         .Print("_type", "startup")
                         .Print("_queue", k->first)
@@ -1103,6 +1159,10 @@ void CQueueDataBase::CreateDynamicQueue(const CNSClientId &  client,
     params.description = description;
 
     x_CreateAndMountQueue(qname, params);
+
+    // A queue is restored after a crash only if it is in the snapshot
+    if (m_Journal.get() != NULL)
+        m_Journal->RequestSnapshot();
 }
 
 
@@ -1227,6 +1287,18 @@ void CQueueDataBase::Close(void)
         m_Queues.clear();
     }
 
+    if (m_Journal.get() != NULL) {
+        // Everything is dumped so the journal is not needed anymore
+        m_Journal->Stop();
+        m_Journal->Remove();
+
+        CFile   snapshot_file(m_DataPath + kSnapshotFileName);
+        if (snapshot_file.Exists())
+            snapshot_file.Remove();
+        m_SnapshotPath.clear();
+        x_RemoveStaleSnapshots();
+    }
+
     if (!m_Diskless) {
         x_RemoveDataFiles();
         x_RemoveCrashFlagFile();
@@ -2156,6 +2228,25 @@ void CQueueDataBase::x_Dump()
         }
     }
 
+    if (!x_DumpQueueClasses(m_DumpPath, dumped_queues))
+        dump_error = true;
+
+    if (!dump_error)
+        x_RemoveDumpErrorFlagFile();
+
+    LOG_POST(Note << "Dumping jobs finished");
+}
+
+
+// Dumps the classes of the dumped dynamic queues and their linked sections.
+// Returns false if there was an error; the dynamic queue dumps are removed in
+// this case.
+bool CQueueDataBase::x_DumpQueueClasses(const string &  dump_path,
+                                        const set<string> &  dumped_queues)
+{
+    bool                dump_ok = true;
+    const string        lbsm_test_queue("LBSMDTestQueue");
+
     // Dump the required queue classes. The only classes required are those
     // which were used by dynamic queues. The dynamic queue classes may also
     // use linked sections
@@ -2182,9 +2273,9 @@ void CQueueDataBase::x_Dump()
 
     // Dump classes if so and linked sections if so
     if (!classes_to_dump.empty()) {
-        string      qclasses_dump_file_name = m_DumpPath +
+        string      qclasses_dump_file_name = dump_path +
                                             kQClassDescriptionFileName;
-        string      linked_sections_dump_file_name = m_DumpPath +
+        string      linked_sections_dump_file_name = dump_path +
                                             kLinkedSectionsFileName;
         FILE *      qclasses_dump_file = NULL;
         FILE *      linked_sections_dump_file = NULL;
@@ -2249,7 +2340,7 @@ void CQueueDataBase::x_Dump()
                 linked_sections_dump_file = NULL;
             }
         } catch (const exception &  ex) {
-            dump_error = true;
+            dump_ok = false;
             ERR_POST("Error dumping dynamic queue classes and "
                      "their linked sections. Dynamic queue dumps are lost.");
             if (qclasses_dump_file != NULL)
@@ -2267,15 +2358,186 @@ void CQueueDataBase::x_Dump()
             for (set<string>::const_iterator
                     k = dynamic_queues_to_dump.begin();
                     k != dynamic_queues_to_dump.end(); ++k) {
-                m_Queues[*k].second->RemoveDump(m_DumpPath);
+                m_Queues[*k].second->RemoveDump(dump_path);
             }
         }
     }
+    return dump_ok;
+}
 
-    if (!dump_error)
-        x_RemoveDumpErrorFlagFile();
 
-    LOG_POST(Note << "Dumping jobs finished");
+void CQueueDataBase::CheckJournalSnapshot(void)
+{
+    if (m_Journal.get() != NULL && m_Journal->IsSnapshotDue())
+        x_JournalSnapshot();
+}
+
+
+// Makes the directory entries (created, renamed or removed files) durable
+static void s_SyncDir(const string &  dir_name)
+{
+    int     dir_fd = open(dir_name.c_str(), O_RDONLY);
+    if (dir_fd == -1)
+        throw runtime_error("Cannot open directory " + dir_name);
+    int     ret = fsync(dir_fd);
+    close(dir_fd);
+    if (ret != 0)
+        throw runtime_error("Cannot sync directory " + dir_name);
+}
+
+
+// Dumps the queues into a new snapshot directory while the server is running.
+// Each snapshot has its own directory; the SNAPSHOT file in the data
+// directory names the complete one. The file is replaced atomically and only
+// after the new snapshot is on disk, so a crash at any point leaves either
+// the previous or the new snapshot in use. The journal segments which precede
+// the snapshot are removed only after the switch.
+void CQueueDataBase::x_JournalSnapshot(void)
+{
+    CNSPreciseTime      start = CNSPreciseTime::Current();
+    string              data_dir_name =
+                    CDirEntry::DeleteTrailingPathSeparator(m_DataPath);
+
+    // The changes made after this point go to a new journal segment.
+    // Some of them may be in the snapshot as well which does not harm:
+    // the journal records are complete job states.
+    unsigned int        base = m_Journal->StartSnapshot();
+    string              new_dir_name = kSnapshotSubdirName + "." +
+                                       NStr::NumericToString(base);
+    string              new_path = CDirEntry::AddTrailingPathSeparator(
+                                                m_DataPath + new_dir_name);
+    CDir                new_dir(m_DataPath + new_dir_name);
+
+    try {
+        if (new_path == m_SnapshotPath)
+            throw runtime_error("The snapshot " + new_dir_name +
+                                " is already in use");
+        if (new_dir.Exists())
+            new_dir.Remove();
+        if (!new_dir.Create())
+            throw runtime_error("Cannot create directory " + new_path);
+
+        vector< CRef<CQueue> >  queues;
+        {{
+            CFastMutexGuard     guard(m_ConfigureLock);
+            for (TQueueInfo::iterator  k = m_Queues.begin();
+                    k != m_Queues.end(); ++k)
+                if (NStr::CompareNocase(k->first, "LBSMDTestQueue") != 0)
+                    queues.push_back(k->second.second);
+        }}
+
+        set<string>     dumped_queues;
+        for (vector< CRef<CQueue> >::iterator  k = queues.begin();
+                k != queues.end(); ++k) {
+            (*k)->Snapshot(new_path);
+            dumped_queues.insert((*k)->GetQueueName());
+        }
+
+        {{
+            CFastMutexGuard     guard(m_ConfigureLock);
+            if (!x_DumpQueueClasses(new_path, dumped_queues))
+                throw runtime_error("Error dumping dynamic queue classes");
+        }}
+
+        string      base_file_name = new_path + kJournalBaseFileName;
+        FILE *      base_file = fopen(base_file_name.c_str(), "w");
+        if (base_file == NULL)
+            throw runtime_error("Cannot create file " + base_file_name);
+        fprintf(base_file, "%u\n", base);
+        if (fflush(base_file) != 0 || fsync(fileno(base_file)) != 0) {
+            fclose(base_file);
+            throw runtime_error("Cannot write file " + base_file_name);
+        }
+        fclose(base_file);
+
+        // The snapshot must be on disk before it is referred to
+        s_SyncDir(new_path);
+        s_SyncDir(data_dir_name);
+
+        // Switch to the new snapshot: temporary file, sync, rename over the
+        // old one, sync the directory
+        string      file_name = m_DataPath + kSnapshotFileName;
+        string      tmp_file_name = file_name + ".tmp";
+        FILE *      tmp_file = fopen(tmp_file_name.c_str(), "w");
+        if (tmp_file == NULL)
+            throw runtime_error("Cannot create file " + tmp_file_name);
+        fprintf(tmp_file, "%s\n", new_dir_name.c_str());
+        if (fflush(tmp_file) != 0 || fsync(fileno(tmp_file)) != 0) {
+            fclose(tmp_file);
+            remove(tmp_file_name.c_str());
+            throw runtime_error("Cannot write file " + tmp_file_name);
+        }
+        fclose(tmp_file);
+        if (rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+            remove(tmp_file_name.c_str());
+            throw runtime_error("Cannot rename " + tmp_file_name +
+                                " to " + file_name);
+        }
+        s_SyncDir(data_dir_name);
+    } catch (const exception &  ex) {
+        ERR_POST("Error taking the journal snapshot: " << ex.what() <<
+                 ". The previous snapshot and the journal are kept.");
+        try {
+            if (new_path != m_SnapshotPath && new_dir.Exists())
+                new_dir.Remove();
+        } catch (...) {}
+        return;
+    }
+
+    // The previous snapshot is not referred to anymore
+    string      prev_path = m_SnapshotPath;
+    m_SnapshotPath = new_path;
+    if (!prev_path.empty()) {
+        try {
+            CDir(prev_path).Remove();
+        } catch (...) {
+            ERR_POST(Warning << "Error removing the previous snapshot "
+                             << prev_path);
+        }
+    }
+
+    m_Journal->FinishSnapshot(base);
+
+    GetDiagContext().Extra()
+        .Print("_type", "journal")
+        .Print("info", "snapshot")
+        .Print("time", NS_FormatPreciseTime(CNSPreciseTime::Current() -
+                                            start));
+}
+
+
+// Provides the path of the complete snapshot named in the SNAPSHOT file or
+// an empty string if there is none
+string CQueueDataBase::x_ReadSnapshotPath(void) const
+{
+    CNcbiIfstream       snapshot_file((m_DataPath + kSnapshotFileName).c_str());
+    string              dir_name;
+
+    if (!getline(snapshot_file, dir_name))
+        return kEmptyStr;
+    dir_name = NStr::TruncateSpaces(dir_name);
+    if (!NStr::StartsWith(dir_name, kSnapshotSubdirName + ".") ||
+        dir_name.find_first_of("/\\") != NPOS)
+        return kEmptyStr;
+    return CDirEntry::AddTrailingPathSeparator(m_DataPath + dir_name);
+}
+
+
+// Provides the first journal segment to be replayed on top of the snapshot
+unsigned int CQueueDataBase::x_ReadJournalBase(const string &  dump_path) const
+{
+    string              file_name = dump_path + kJournalBaseFileName;
+    CNcbiIfstream       base_file(file_name.c_str());
+    string              line;
+
+    if (!getline(base_file, line))
+        throw runtime_error("Cannot read file " + file_name);
+
+    unsigned int        base = NStr::StringToUInt(line,
+                                                  NStr::fConvErr_NoThrow);
+    if (base == 0)
+        throw runtime_error("Invalid journal base in file " + file_name);
+    return base;
 }
 
 
@@ -2429,6 +2691,31 @@ void CQueueDataBase::x_RemoveDump(void)
 }
 
 
+// Removes the snapshot directories except the one in use (if any)
+void CQueueDataBase::x_RemoveStaleSnapshots(void)
+{
+    CDir        data_dir(m_DataPath);
+    if (!data_dir.Exists())
+        return;
+
+    CDir::TEntries      entries = data_dir.GetEntries(
+                                    kSnapshotSubdirName + ".*",
+                                    CDir::fIgnoreRecursive);
+    for (CDir::TEntries::const_iterator  k = entries.begin();
+            k != entries.end(); ++k) {
+        if (!(*k)->IsDir())
+            continue;
+        string      path = CDirEntry::AddTrailingPathSeparator(
+                                                m_DataPath + (*k)->GetName());
+        if (path == m_SnapshotPath)
+            continue;
+        CDir        stale_dir(path);
+        if (!stale_dir.Remove())
+            ERR_POST(Warning << "Error removing directory " << path);
+    }
+}
+
+
 // Removes unnecessary files in the data directory
 void CQueueDataBase::x_RemoveDataFiles(void)
 {
@@ -2451,7 +2738,8 @@ void CQueueDataBase::x_RemoveDataFiles(void)
             entryName == kCrashFlagFileName ||
             entryName == kDumpErrorFlagFileName ||
             entryName == kPausedQueuesFilesName ||
-            entryName == kRefuseSubmitFileName)
+            entryName == kRefuseSubmitFileName ||
+            entryName == kSnapshotFileName)
             continue;
 
         CFile   f(m_DataPath + entryName);
@@ -2466,6 +2754,36 @@ void CQueueDataBase::x_RemoveDataFiles(void)
 // status.
 bool CQueueDataBase::x_CheckOpenPreconditions(bool  reinit)
 {
+    if (x_DoesCrashFlagFileExist() && !reinit && m_Journal.get() != NULL &&
+        !m_SnapshotPath.empty() &&
+        CFile(m_SnapshotPath + kJournalBaseFileName).Exists()) {
+        // The last snapshot is loaded as a regular dump and then the journal
+        // is replayed on top of it. The snapshot itself is kept till the
+        // next one is taken in case the server crashes again at the startup.
+        try {
+            CDir    dump_dir(m_DumpPath);
+            if (dump_dir.Exists())
+                dump_dir.Remove();
+            if (!CDir(m_SnapshotPath).Copy(
+                        CDirEntry::DeleteTrailingPathSeparator(m_DumpPath),
+                        CDir::fCF_Recursive | CDir::fCF_Overwrite))
+                throw runtime_error("Cannot copy " + m_SnapshotPath +
+                                    " to " + m_DumpPath);
+
+            ERR_POST("The server did not stop gracefully last time. "
+                     "The jobs are recovered from the journal in "
+                     << m_DataPath);
+            m_Server->RegisterAlert(eStartAfterCrash, "The server did not "
+                                    "stop gracefully last time. The jobs have "
+                                    "been recovered from the last snapshot "
+                                    "and the journal");
+            m_RecoverFromJournal = true;
+            return false;
+        } catch (const exception &  ex) {
+            ERR_POST("Error preparing the journal recovery: " << ex.what());
+        }
+    }
+
     if (x_DoesCrashFlagFileExist()) {
         ERR_POST("Reinitialization due to the server "
                  "did not stop gracefully last time. "
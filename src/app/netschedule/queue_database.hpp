@@ -51,6 +51,7 @@
 #include "background_host.hpp"
 #include "ns_service_thread.hpp"
 #include "ns_precise_time.hpp"
+#include "ns_journal.hpp"
 
 BEGIN_NCBI_SCOPE
 
@@ -71,6 +72,7 @@ public:
                    const string &  path,
                    unsigned int  max_queues,
                    bool  diskless,
+                   const SNSJournalParameters &  journal_params,
                    bool  reinit);
     ~CQueueDataBase();
 
@@ -145,6 +147,12 @@ public:
     string GetDataPath(void) const
     { return m_DataPath; }
 
+    // NULL if the job journal is disabled
+    CNSJournal *  GetJournal(void)
+    { return m_Journal.get(); }
+    // Takes a new journal snapshot if it is time to do so
+    void CheckJournalSnapshot(void);
+
 private:
     // No copy
     CQueueDataBase(const CQueueDataBase&);
@@ -172,6 +180,11 @@ private:
     string               m_DumpPath;
     unsigned int         m_MaxQueues;
     bool                 m_Diskless;
+    string               m_SnapshotPath;
+
+    // Job journal; created if enabled in the configuration
+    unique_ptr<CNSJournal>  m_Journal;
+    bool                    m_RecoverFromJournal;
 
     mutable CFastMutex   m_ConfigureLock;
 
@@ -258,6 +271,12 @@ private:
     CRef<CQueue>  x_GetQueueAt(unsigned int  index);
 
     void x_Dump(void);
+    bool x_DumpQueueClasses(const string &  dump_path,
+                            const set<string> &  dumped_queues);
+    void x_JournalSnapshot(void);
+    string x_ReadSnapshotPath(void) const;
+    unsigned int x_ReadJournalBase(const string &  dump_path) const;
+    void x_RemoveStaleSnapshots(void);
     void x_DumpQueueOrClass(FILE *  f,
                             const string &  qname, const string &  qclass,
                             bool  is_queue,
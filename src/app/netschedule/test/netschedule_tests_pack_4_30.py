@@ -245,3 +245,82 @@ class Scenario2004(TestBase):
 
         return True
 
+
+
+class Scenario2005(TestBase):
+
+    """Scenario 2005"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Journal enabled; submit jobs, get one; kill -9; " \
+               "restart -> jobs restored from the journal"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(1300)
+        jobID1 = self.ns.submitJob('TEST1', 'blah1')
+        jobID2 = self.ns.submitJob('TEST1', 'blah2')
+
+        ns_client = self.getNetScheduleService('TEST1', 'scenario2005')
+        ns_client.set_client_identification('node', 'session')
+        output = execAny(ns_client, 'GET2 wnode_aff=0 any_aff=1')
+        values = parse_qs(output, True, True)
+        if values['job_key'][0] != jobID1:
+            raise Exception("Unexpected GET2 output; expected the first job")
+
+        # No graceful shutdown: the jobs are only in the journal
+        self.ns.kill("SIGKILL")
+        self.ns.start()
+
+        if self.ns.getFastJobStatus('TEST1', jobID1) != 'Running':
+            raise Exception("The running job has not been restored")
+        if self.ns.getFastJobStatus('TEST1', jobID2) != 'Pending':
+            raise Exception("The pending job has not been restored")
+        return True
+
+
+class Scenario2006(TestBase):
+
+    """Scenario 2006"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Journal enabled; submit a job; wait for a snapshot; " \
+               "cancel it and submit another one; kill -9; restart; " \
+               "kill -9 again; restart -> " \
+               "jobs restored from the snapshot and the journal"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(1300)
+        jobID1 = self.ns.submitJob('TEST1', 'blah1')
+
+        # Let the server take a snapshot with the first job and truncate
+        # the journal
+        time.sleep(3)
+
+        self.ns.cancelJob('TEST1', jobID1)
+        jobID2 = self.ns.submitJob('TEST1', 'blah2')
+
+        # The second crash makes the server recover from the snapshot taken
+        # at the first recovery
+        self.ns.kill("SIGKILL")
+        self.ns.start()
+        self.ns.kill("SIGKILL")
+        self.ns.start()
+
+        if self.ns.getFastJobStatus('TEST1', jobID1) != 'Canceled':
+            raise Exception("The journaled change of the snapshot job "
+                            "has not been replayed")
+        if self.ns.getFastJobStatus('TEST1', jobID2) != 'Pending':
+            raise Exception("The journaled job has not been restored")
+        return True
@@ -0,0 +1,242 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  NetSchedule affinity dispatch stress test.
+ *                    Submits jobs spread over many affinities and then
+ *                    measures the rate of GETs by a worker node which has a
+ *                    few preferred affinities or asks for explicit ones.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <connect/services/netschedule_api.hpp>
+#include <connect/ncbi_core_cxx.hpp>
+
+#include <unistd.h>
+
+
+USING_NCBI_SCOPE;
+
+
+/// Test application
+///
+/// @internal
+///
+class CNetScheduleAffinityStress : public CNcbiApplication
+{
+    public:
+        void Init(void);
+        int Run(void);
+
+    private:
+        CNetScheduleAPI  x_GetAPI(const string &  service,
+                                  const string &  qname);
+        string  x_GetAffinity(unsigned int  index);
+        void  x_Submit(CNetScheduleSubmitter &  submitter,
+                       unsigned int  jobs, unsigned int  affinities);
+        unsigned int  x_Get(CNetScheduleExecutor &  executor,
+                            unsigned int  gets, const string &  aff_list);
+};
+
+
+
+void CNetScheduleAffinityStress::Init(void)
+{
+    // Avoid sockets to stay in TIME_WAIT state
+    GetRWConfig().Set("netservice_api", "use_linger2", "true",
+                      IRegistry::fNoOverride);
+
+    CONNECT_Init(&GetConfig());
+    SetDiagPostLevel(eDiag_Info);
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "NetSchedule affinity dispatch stress test");
+
+    arg_desc->AddKey("service",
+                     "service_name",
+                     "NetSchedule service name "
+                                        "(format: host:port or service_name).",
+                     CArgDescriptions::eString);
+
+    arg_desc->AddKey("queue",
+                     "queue_name",
+                     "NetSchedule queue name (like: noname).",
+                     CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("affinities",
+                            "affinities",
+                            "Number of distinct affinities of the "
+                            "submitted jobs",
+                            CArgDescriptions::eInteger, "10000");
+
+    arg_desc->AddDefaultKey("jobs",
+                            "jobs",
+                            "Number of jobs to submit",
+                            CArgDescriptions::eInteger, "100000");
+
+    arg_desc->AddDefaultKey("gets",
+                            "gets",
+                            "Number of GETs to measure",
+                            CArgDescriptions::eInteger, "5000");
+
+    arg_desc->AddDefaultKey("preferred",
+                            "preferred",
+                            "Number of the worker node affinities",
+                            CArgDescriptions::eInteger, "10");
+
+    arg_desc->AddFlag("explicit",
+                      "Request the worker node affinities explicitly "
+                      "instead of registering them as preferred");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+CNetScheduleAPI
+CNetScheduleAffinityStress::x_GetAPI(const string &  service,
+                                     const string &  qname)
+{
+    CNetScheduleAPI     cl = CNetScheduleAPI(service, "aff_stress", qname);
+    cl.SetProgramVersion("ns_affinity_stress 1.0.0");
+    cl.SetClientNode("aff_stress_node_" + NStr::IntToString(getpid()));
+    cl.SetClientSession("aff_stress_session");
+    return cl;
+}
+
+
+string  CNetScheduleAffinityStress::x_GetAffinity(unsigned int  index)
+{
+    return "aff_stress_" + NStr::UIntToString(index);
+}
+
+
+void  CNetScheduleAffinityStress::x_Submit(CNetScheduleSubmitter &  submitter,
+                                           unsigned int  jobs,
+                                           unsigned int  affinities)
+{
+    CStopWatch          timer(CStopWatch::eStart);
+
+    for (unsigned int  k = 0; k < jobs; ++k) {
+        CNetScheduleJob     job("ns_affinity_stress input");
+
+        job.affinity = x_GetAffinity(k % affinities);
+        submitter.SubmitJob(job);
+    }
+
+    NcbiCout << "Submitted " << jobs << " jobs with " << affinities
+             << " affinities in " << timer.Elapsed() << " sec" << NcbiEndl;
+}
+
+
+// Provides the number of jobs received
+unsigned int
+CNetScheduleAffinityStress::x_Get(CNetScheduleExecutor &  executor,
+                                  unsigned int  gets,
+                                  const string &  aff_list)
+{
+    unsigned int        received = 0;
+    double              max_time = 0.0;
+    CStopWatch          timer(CStopWatch::eStart);
+
+    for (unsigned int  k = 0; k < gets; ++k) {
+        CNetScheduleJob     job;
+        CStopWatch          get_timer(CStopWatch::eStart);
+        bool                job_provided = executor.GetJob(job, aff_list);
+        double              get_time = get_timer.Elapsed();
+
+        if (get_time > max_time)
+            max_time = get_time;
+        if (!job_provided)
+            break;
+
+        ++received;
+        job.output = "JOB DONE";
+        executor.PutResult(job);
+    }
+
+    double      elapsed = timer.Elapsed();
+    NcbiCout << "Received " << received << " jobs in " << elapsed << " sec";
+    if (received > 0 && elapsed > 0.0)
+        NcbiCout << ", " << received / elapsed << " GET+PUT per sec, "
+                 << "max GET " << max_time * 1000000.0 << " us";
+    NcbiCout << NcbiEndl;
+    return received;
+}
+
+
+int CNetScheduleAffinityStress::Run(void)
+{
+    const CArgs &           args = GetArgs();
+    unsigned int            affinities = args["affinities"].AsInteger();
+    unsigned int            jobs = args["jobs"].AsInteger();
+    unsigned int            gets = args["gets"].AsInteger();
+    unsigned int            preferred = args["preferred"].AsInteger();
+
+    if (affinities == 0 || preferred == 0 || preferred > affinities)
+        throw runtime_error("Unexpected number of affinities");
+
+    CNetScheduleAPI         cl = x_GetAPI(args["service"].AsString(),
+                                          args["queue"].AsString());
+    CNetScheduleSubmitter   submitter = cl.GetSubmitter();
+    CNetScheduleExecutor    executor = cl.GetExecutor();
+
+    cl.GetAdmin().PrintServerVersion(NcbiCout);
+
+    // The worker node affinities are the last ones so that their jobs are
+    // spread over the whole range of the submitted jobs
+    vector<string>          worker_affs;
+    for (unsigned int  k = affinities - preferred; k < affinities; ++k)
+        worker_affs.push_back(x_GetAffinity(k));
+
+    x_Submit(submitter, jobs, affinities);
+
+    string                  aff_list;
+    if (args["explicit"]) {
+        executor.SetAffinityPreference(
+                            CNetScheduleExecutor::eExplicitAffinitiesOnly);
+        aff_list = NStr::Join(worker_affs, ",");
+    } else {
+        executor.SetAffinityPreference(
+                            CNetScheduleExecutor::ePreferredAffinities);
+        executor.AddPreferredAffinities(worker_affs);
+    }
+
+    x_Get(executor, gets, aff_list);
+
+    executor.ClearNode();
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CNetScheduleAffinityStress().AppMain(argc, argv, 0, eDS_Default);
+}
@@ -38,6 +38,7 @@
 #include <corelib/ncbireg.hpp>
 #include <corelib/ncbi_system.hpp>
 #include <corelib/ncbimisc.hpp>
+#include <corelib/ncbitime.hpp>
 
 #include <connect/services/netschedule_api.hpp>
 #include <connect/services/netschedule_key.hpp>
@@ -72,6 +73,9 @@ class CNetScheduleLoader : public CNcbiApplication
 
     private:
         unsigned int  x_GetTotalJobs(const CArgs &  args);
+        Uint8  x_GetServerRSS(const CArgs &  args);
+        void  x_Prefill(CNetScheduleSubmitter &  submitter,
+                        const CArgs &  args);
         CNetScheduleAPI  x_GetAPI(const string &  service,
                                   const string &  qname);
         string  x_GetAffinity(void);
@@ -117,6 +121,20 @@ void CNetScheduleLoader::Init(void)
                              "Number of jobs to submit",
                              CArgDescriptions::eInteger);
 
+    arg_desc->AddOptionalKey("prefill",
+                             "prefill",
+                             "Number of jobs to submit before the loop. "
+                             "The jobs are left pending so that the server "
+                             "keeps them in memory.",
+                             CArgDescriptions::eInteger);
+
+    arg_desc->AddOptionalKey("server_pid",
+                             "server_pid",
+                             "Local NetSchedule server pid. If given then "
+                             "the server RSS growth per prefilled job is "
+                             "reported.",
+                             CArgDescriptions::eInteger);
+
     // Setup arg.descriptions for this application
     SetupArgDescriptions(arg_desc.release());
 }
@@ -130,6 +148,56 @@ unsigned int  CNetScheduleLoader::x_GetTotalJobs(const CArgs &  args)
 }
 
 
+// Provides the resident set size of the server process in bytes or 0 if the
+// server pid is not given or the size cannot be read
+Uint8  CNetScheduleLoader::x_GetServerRSS(const CArgs &  args)
+{
+    if (!args["server_pid"])
+        return 0;
+
+    CNcbiIfstream   status("/proc/" +
+                           NStr::IntToString(args["server_pid"].AsInteger()) +
+                           "/status");
+    string          line;
+    while (getline(status, line)) {
+        if (NStr::StartsWith(line, "VmRSS:")) {
+            // The value is in kB
+            return NStr::StringToUInt8(
+                        NStr::TruncateSpaces(line.substr(6, line.size() - 9))) *
+                   1024;
+        }
+    }
+    return 0;
+}
+
+
+void  CNetScheduleLoader::x_Prefill(CNetScheduleSubmitter &  submitter,
+                                    const CArgs &  args)
+{
+    if (!args["prefill"])
+        return;
+
+    unsigned int    prefill = args["prefill"].AsInteger();
+    Uint8           rss_before = x_GetServerRSS(args);
+    CStopWatch      timer(CStopWatch::eStart);
+
+    // No affinity so that these jobs are never given to the loop executor
+    for (unsigned int  k = 0; k < prefill; ++k)
+        x_SubmitJob(submitter, kEmptyStr);
+
+    NcbiCout << "Prefilled " << prefill << " jobs in "
+             << timer.Elapsed() << " sec" << NcbiEndl;
+
+    Uint8           rss_after = x_GetServerRSS(args);
+    if (prefill > 0 && rss_before > 0 && rss_after > 0) {
+        NcbiCout << "Server RSS: " << rss_before << " -> " << rss_after
+                 << " bytes, "
+                 << double(rss_after - rss_before) / prefill
+                 << " bytes per job" << NcbiEndl;
+    }
+}
+
+
 CNetScheduleAPI  CNetScheduleLoader::x_GetAPI(const string &  service,
                                               const string &  qname)
 {
@@ -175,10 +243,14 @@ int CNetScheduleLoader::Run(void)
     CNetScheduleExecutor    executor = cl.GetExecutor();
 
     cl.GetAdmin().PrintServerVersion(NcbiCout);
+    x_Prefill(submitter, args);
 
 
     CNetScheduleJob                 job;
     CNetScheduleAPI::EJobStatus     status;
+    unsigned int                    loops = 0;
+    double                          get_total = 0.0;
+    double                          get_max = 0.0;
     while (total_jobs > 0) {
         // Submit
         job.Reset();
@@ -190,9 +262,14 @@ int CNetScheduleLoader::Run(void)
             throw runtime_error("Unexpected job status after SUBMIT");
 
         // GET2 - only the client unique affinity
-        bool    job_provided = executor.GetJob(job, aff);
+        CStopWatch  get_timer(CStopWatch::eStart);
+        bool        job_provided = executor.GetJob(job, aff);
+        double      get_time = get_timer.Elapsed();
         if (!job_provided)
             throw runtime_error("Expected a job for execution, received nothing");
+        get_total += get_time;
+        if (get_time > get_max)
+            get_max = get_time;
 
         // WST
         status = executor.GetJobStatus(job);
@@ -209,8 +286,12 @@ int CNetScheduleLoader::Run(void)
             throw runtime_error("Unexpected job status after PUT2");
 
         --total_jobs;
+        ++loops;
     }
 
+    if (loops > 0)
+        NcbiCout << "GET2 latency: avg " << get_total / loops * 1000000.0
+                 << " us, max " << get_max * 1000000.0 << " us" << NcbiEndl;
     return 0;
 }
 
@@ -32,6 +32,7 @@
 
 #include <array>
 #include <chrono>
+#include <map>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -76,6 +77,8 @@ struct SMetrics : string, private SMetricType
 
     ~SMetrics()
     {
+        if (!m_Output) return;
+
         ostringstream os;
         os << *this;
         cout << os.str() << flush;
@@ -90,12 +93,19 @@ struct SMetrics : string, private SMetricType
     using TItem = pair<CPSG_ReplyItem::EType, EPSG_Status>;
     void AddItem(TItem item) { m_Items.emplace_back(std::move(item)); }
 
+    // Raw metrics are not output if only the summary is requested
+    void SetOutput(bool output) { m_Output = output; }
+
+    duration::rep GetLatency() const { return duration(m_Data[eDone] - m_Data[eStart]).count(); }
+    bool Succeeded() const { return !m_Items.empty() && m_Items.back().second == EPSG_Status::eSuccess; }
+
 private:
     duration::rep Get(EType t) const { return duration(m_Data[t].time_since_epoch()).count(); }
     void OutputItems(ostream& os) const;
 
     array<time_point, eSize> m_Data;
     vector<TItem> m_Items;
+    bool m_Output = true;
 
     friend ostream& operator<<(ostream& os, const SMetrics& metrics)
     {
@@ -116,6 +126,24 @@ private:
     }
 };
 
+// Throughput and latency percentiles per request type
+struct SPerformanceSummary
+{
+    void Add(CPSG_Request::EType type, const SMetrics& metrics);
+    void Report(ostream& os, double elapsed) const;
+
+private:
+    struct SStats
+    {
+        vector<SMetrics::duration::rep> latencies;
+        size_t failed = 0;
+    };
+
+    static void Report(ostream& os, const char* name, SStats& stats, double elapsed);
+
+    map<CPSG_Request::EType, SStats> m_Stats;
+};
+
 struct SIoRedirector
 {
     SIoRedirector(ios& what, ios& to) :
@@ -29,6 +29,9 @@
 
 #include <ncbi_pch.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <numeric>
 #include <unordered_set>
 #include <unordered_map>
@@ -581,6 +584,64 @@ void SMetrics::OutputItems(ostream& os) const
     }
 }
 
+const char* s_GetRequestName(CPSG_Request::EType type)
+{
+    switch (type) {
+        case CPSG_Request::eBiodata:        return "biodata";
+        case CPSG_Request::eResolve:        return "resolve";
+        case CPSG_Request::eBlob:           return "blob";
+        case CPSG_Request::eNamedAnnotInfo: return "named_annot";
+        case CPSG_Request::eChunk:          return "chunk";
+        case CPSG_Request::eIpgResolve:     return "ipg_resolve";
+        case CPSG_Request::eAccVerHistory:  return "acc_ver_history";
+    }
+
+    _TROUBLE;
+    return "unknown";
+}
+
+void SPerformanceSummary::Add(CPSG_Request::EType type, const SMetrics& metrics)
+{
+    auto& stats = m_Stats[type];
+    stats.latencies.push_back(metrics.GetLatency());
+    if (!metrics.Succeeded()) ++stats.failed;
+}
+
+void SPerformanceSummary::Report(ostream& os, double elapsed) const
+{
+    os << "type\trequests\tfailed\trps\tavg_ms\tp50_ms\tp90_ms\tp99_ms\tp999_ms\tmax_ms\n";
+
+    SStats all;
+
+    for (auto stats : m_Stats) {
+        all.latencies.insert(all.latencies.end(), stats.second.latencies.begin(), stats.second.latencies.end());
+        all.failed += stats.second.failed;
+        Report(os, s_GetRequestName(stats.first), stats.second, elapsed);
+    }
+
+    if (m_Stats.size() > 1) Report(os, "all", all, elapsed);
+    os.flush();
+}
+
+void SPerformanceSummary::Report(ostream& os, const char* name, SStats& stats, double elapsed)
+{
+    auto& latencies = stats.latencies;
+    const auto n = latencies.size();
+
+    if (!n) return;
+
+    sort(latencies.begin(), latencies.end());
+
+    // Nearest-rank percentile
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(ceil(p * n)) - 1]; };
+    const auto avg = accumulate(latencies.begin(), latencies.end(), SMetrics::duration::rep()) / n;
+
+    os << fixed << setprecision(3) << name << '\t' << n << '\t' << stats.failed << '\t' <<
+        (elapsed > 0.0 ? n / elapsed : 0.0) << '\t' << avg << '\t' <<
+        percentile(0.5) << '\t' << percentile(0.9) << '\t' << percentile(0.99) << '\t' <<
+        percentile(0.999) << '\t' << latencies.back() << '\n';
+}
+
 struct SDataOnlyCopy
 {
     SDataOnlyCopy(const SDataOnly& params) :
@@ -1275,7 +1336,13 @@ int CProcessing::Performance(const SPerformanceParams& params)
     using TReplyStorage = deque<shared_ptr<CPSG_Reply>>;
 
     if (SParams::verbose) cerr << "Preparing requests: ";
-    auto requests = ReadCommands([](string id, CJson_ConstNode&){ return make_shared<SMetrics>(std::move(id)); }, SParams::verbose ? kReportProgressAfter : 0);
+    auto create_context = [&](string id, CJson_ConstNode&) {
+        auto metrics = make_shared<SMetrics>(std::move(id));
+        metrics->SetOutput(!params.summary);
+        return metrics;
+    };
+
+    auto requests = ReadCommands(create_context, SParams::verbose ? kReportProgressAfter : 0);
 
     if (requests.empty()) return -1;
 
@@ -1320,7 +1387,9 @@ int CProcessing::Performance(const SPerformanceParams& params)
             metrics->Set(SMetricType::eDone);
             metrics->AddItem({CPSG_ReplyItem::eEndOfReply, status});
 
-            if (params.report_immediately) {
+            if (params.summary) {
+                // Metrics are kept with the request till the summary is done
+            } else if (params.report_immediately) {
                 // Metrics are reported on destruction
                 metrics.reset();
                 request.reset();
@@ -1354,6 +1423,7 @@ int CProcessing::Performance(const SPerformanceParams& params)
     }
 
     wait();
+    const auto started = chrono::steady_clock::now();
 
     // Start processing replies
     if (SParams::verbose) {
@@ -1378,9 +1448,21 @@ int CProcessing::Performance(const SPerformanceParams& params)
         t.join();
     }
 
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - started;
+
     // Release all replies held in queues, if any
     queues.clear();
 
+    if (params.summary) {
+        SPerformanceSummary summary;
+
+        for (const auto& request : requests) {
+            summary.Add(request->GetType(), *request->GetUserContext<SMetrics>());
+        }
+
+        summary.Report(cout, elapsed.count());
+    }
+
     // Output metrics
     if (SParams::verbose) cerr << "Outputting metrics: ";
     requests.clear();
@@ -316,13 +316,15 @@ struct SPerformanceParams : SParams
     const double delay;
     const bool local_queue;
     const bool report_immediately;
+    const bool summary;
 
-    SPerformanceParams(string s, CPSG_Request::TFlags rf, SPSG_UserArgs ua, size_t ut, double d, bool lq, bool ri) :
+    SPerformanceParams(string s, CPSG_Request::TFlags rf, SPSG_UserArgs ua, size_t ut, double d, bool lq, bool ri, bool sm) :
         SParams(std::move(s), rf, std::move(ua)),
         user_threads(ut),
         delay(d),
         local_queue(lq),
-        report_immediately(ri)
+        report_immediately(ri),
+        summary(sm)
     {}
 };
 
@@ -325,7 +325,8 @@ void CPsgClientApp::s_InitRequest<SPerformance>(CArgDescriptions& arg_desc)
     arg_desc.AddDefaultKey("delay", "SECONDS", "Delay between consecutive requests (in seconds)", CArgDescriptions::eDouble, "0.0");
     arg_desc.AddFlag("local-queue", "Whether user threads to use separate queues");
     arg_desc.AddFlag("report-immediately", "Whether to report metrics immediately (or at the end)");
-    arg_desc.AddDefaultKey("output-file", "FILENAME", "Output file to contain raw performance metrics", CArgDescriptions::eOutputFile, "-");
+    arg_desc.AddFlag("summary", "Whether to output throughput and latency percentiles per request type (instead of raw metrics)");
+    arg_desc.AddDefaultKey("output-file", "FILENAME", "Output file to contain raw performance metrics (or summary)", CArgDescriptions::eOutputFile, "-");
 }
 
 template <>
@@ -528,6 +529,7 @@ struct SPerformance : SBase<SPerformanceParams>, SIoRedirector
             args["delay"].AsDouble(),
             args["local-queue"].AsBoolean(),
             args["report-immediately"].AsBoolean(),
+            args["summary"].AsBoolean(),
         },
         SIoRedirector(cout, args["output-file"].AsOutputFile())
     {
@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include "exclude_blob_cache.hpp"
+#include "pubseq_gateway.hpp"
 
 
 bool CUserExcludeBlobs::IsInCache(const SExcludeBlobId& blob_id,
@@ -133,6 +134,29 @@ void CUserExcludeBlobs::Clear(void)
 }
 
 
+CUserExcludeBlobs *
+CExcludeBlobCache::x_LockUserBlobs(const string &  user, bool  create)
+{
+    CUserExcludeBlobs *     user_blobs = nullptr;
+    auto                    lock_user_blobs =
+        [this, &user_blobs](CUserExcludeBlobs * &  item, bool  created)
+        {
+            if (created)
+                item = m_Pool.Get();    // Not found; create a new user info
+            user_blobs = item;
+            user_blobs->m_Lock.lock();  // acquire the user data lock
+        };
+
+    if (create)
+        m_UserBlobs.FindOrCreate(user, lock_user_blobs);
+    else
+        m_UserBlobs.Find(user,
+                         [&lock_user_blobs](CUserExcludeBlobs * &  item)
+                         { lock_user_blobs(item, false); });
+    return user_blobs;
+}
+
+
 EPSGS_CacheAddResult CExcludeBlobCache::AddBlobId(const string &  user,
                                                   const SExcludeBlobId& blob_id,
                                                   bool &  completed,
@@ -143,24 +167,15 @@ EPSGS_CacheAddResult CExcludeBlobCache::AddBlobId(const string &  user,
     if (user.empty())
         return ePSGS_Added;
 
-    m_Lock.lock();                                  // acquire top level lock
-
-    const auto user_item = m_UserBlobs.find(user);
-    CUserExcludeBlobs *  user_blobs;
-    if (user_item == m_UserBlobs.cend()) {
-        // Not found; create a new user info
-        user_blobs = m_Pool.Get();
-        m_UserBlobs[user] = user_blobs;
-    } else {
-        // Found
-        user_blobs = user_item->second;
-    }
-
-    user_blobs->m_Lock.lock();                      // acquire the user data lock
-    m_Lock.unlock();                                // release top level lock
+    CUserExcludeBlobs *     user_blobs = x_LockUserBlobs(user, true);
 
     auto ret = user_blobs->AddBlobId(blob_id, completed, completed_time);
     user_blobs->m_Lock.unlock();                    // release user data lock
+
+    CPubseqGatewayApp::GetInstance()->GetCounters().Increment(
+                nullptr, ret == ePSGS_AlreadyInCache ?
+                                CPSGSCounters::ePSGS_ExcludeBlobCacheHit :
+                                CPSGSCounters::ePSGS_ExcludeBlobCacheMiss);
     return ret;
 }
 
@@ -175,24 +190,16 @@ bool CExcludeBlobCache::IsInCache(const string &  user,
     if (user.empty())
         return false;
 
-    m_Lock.lock();                      // acquire top level lock
-
-    const auto user_item = m_UserBlobs.find(user);
-    CUserExcludeBlobs *  user_blobs;
-    if (user_item == m_UserBlobs.cend()) {
-        // Not found
-        m_Lock.unlock();                // release top level lock
-        return false;
+    bool                    ret = false;
+    CUserExcludeBlobs *     user_blobs = x_LockUserBlobs(user, false);
+    if (user_blobs != nullptr) {
+        ret = user_blobs->IsInCache(blob_id, completed, completed_time);
+        user_blobs->m_Lock.unlock();    // release user data lock
     }
 
-    // Found
-    user_blobs = user_item->second;
-
-    user_blobs->m_Lock.lock();          // acquire the user data lock
-    m_Lock.unlock();                    // release top level lock
-
-    auto ret = user_blobs->IsInCache(blob_id, completed, completed_time);
-    user_blobs->m_Lock.unlock();        // release user data lock
+    CPubseqGatewayApp::GetInstance()->GetCounters().Increment(
+                nullptr, ret ? CPSGSCounters::ePSGS_ExcludeBlobCacheHit :
+                               CPSGSCounters::ePSGS_ExcludeBlobCacheMiss);
     return ret;
 }
 
@@ -205,21 +212,9 @@ bool CExcludeBlobCache::SetCompleted(const string &  user,
     if (user.empty())
         return true;
 
-    m_Lock.lock();                      // acquire top level lock
-
-    const auto user_item = m_UserBlobs.find(user);
-    CUserExcludeBlobs *  user_blobs;
-    if (user_item == m_UserBlobs.cend()) {
-        // Not found
-        m_Lock.unlock();                // release top level lock
-        return false;
-    }
-
-    // Found
-    user_blobs = user_item->second;
-
-    user_blobs->m_Lock.lock();          // acquire the user data lock
-    m_Lock.unlock();                    // release top level lock
+    CUserExcludeBlobs *     user_blobs = x_LockUserBlobs(user, false);
+    if (user_blobs == nullptr)
+        return false;   // Not found
 
     auto ret = user_blobs->SetCompleted(blob_id, new_val);
     user_blobs->m_Lock.unlock();        // release user data lock
@@ -235,21 +230,9 @@ bool CExcludeBlobCache::Remove(const string &  user,
     if (user.empty())
         return true;
 
-    m_Lock.lock();                      // acquire top level lock
-
-    const auto user_item = m_UserBlobs.find(user);
-    CUserExcludeBlobs *  user_blobs;
-    if (user_item == m_UserBlobs.cend()) {
-        // Not found
-        m_Lock.unlock();                // release top level lock
-        return false;
-    }
-
-    // Found
-    user_blobs = user_item->second;
-
-    user_blobs->m_Lock.lock();          // acquire the user data lock
-    m_Lock.unlock();                    // release top level lock
+    CUserExcludeBlobs *     user_blobs = x_LockUserBlobs(user, false);
+    if (user_blobs == nullptr)
+        return false;   // Not found
 
     auto ret = user_blobs->Remove(blob_id);
     user_blobs->m_Lock.unlock();        // release user data lock
@@ -265,23 +248,18 @@ void CExcludeBlobCache::Purge(void)
 
     psg_time_point_t    limit = psg_clock_t::now() - m_InactivityTimeout;
 
-    m_Lock.lock();                          // acquire top level lock
-
     // Purge the users and their caches approprietly
-    for (auto it = m_UserBlobs.begin(); it != m_UserBlobs.end(); ) {
-        it->second->m_Lock.lock();          // acquire the user data lock
-        if (it->second->m_LastTouch < limit) {
-            m_ToDiscard.push_back(it->second);
-            it->second->m_Lock.unlock();    // release user data lock
-            it = m_UserBlobs.erase(it);
-        } else {
-            m_ToPurge.push_back(it->second);
-            it->second->m_Lock.unlock();    // release user data lock
-            ++it;
-        }
-    }
-
-    m_Lock.unlock();                        // release top level lock
+    size_t      discarded = m_UserBlobs.EraseAllIf(
+        [this, limit](const string &, CUserExcludeBlobs * &  user_blobs)
+        {
+            lock_guard<mutex>   guard(user_blobs->m_Lock);
+            if (user_blobs->m_LastTouch < limit) {
+                m_ToDiscard.push_back(user_blobs);
+                return true;
+            }
+            m_ToPurge.push_back(user_blobs);
+            return false;
+        });
 
     // Discard obsolete users
     for (auto user_data : m_ToDiscard) {
@@ -297,5 +275,9 @@ void CExcludeBlobCache::Purge(void)
         user_data->m_Lock.unlock();         // release the user data lock
     }
     m_ToPurge.clear();
-}
 
+    if (discarded > 0)
+        CPubseqGatewayApp::GetInstance()->GetCounters().Increment(
+                    nullptr, CPSGSCounters::ePSGS_ExcludeBlobCacheEvicted,
+                    discarded);
+}
@@ -38,13 +38,13 @@
 #include <list>
 #include <atomic>
 #include <mutex>
-#include <map>
 #include <vector>
 #include <optional>
 #include <corelib/ncbistr.hpp>
 using namespace std;
 
 #include "pubseq_gateway_types.hpp"
+#include "psgs_sharded_cache.hpp"
 
 
 enum EPSGS_CacheAddResult {
@@ -208,6 +208,7 @@ class CExcludeBlobCache
     public:
         CExcludeBlobCache(size_t  inactivity_timeout,
                           size_t  max_cache_size, size_t  purged_size) :
+            m_UserBlobs(0, 0),      // The users are purged by inactivity only
             m_InactivityTimeout(inactivity_timeout),
             m_MaxCacheSize(max_cache_size), m_PurgedSize(purged_size)
         {
@@ -217,8 +218,9 @@ class CExcludeBlobCache
 
         ~CExcludeBlobCache()
         {
-            for (auto &  item : m_UserBlobs)
-                delete item.second;
+            m_UserBlobs.ForEach(
+                [](const string &, CUserExcludeBlobs * &  user_blobs)
+                { delete user_blobs; });
         }
 
     public:
@@ -242,16 +244,19 @@ class CExcludeBlobCache
         void Purge(void);
 
         size_t Size(void) {
-            size_t size = 0;
-            lock_guard<mutex>   guard(m_Lock);
-
-            size = m_UserBlobs.size();
-            return size;
+            return m_UserBlobs.Size();
         }
 
     private:
-        map<string, CUserExcludeBlobs *>    m_UserBlobs;
-        mutex                               m_Lock;
+        // Locks the user data and provides it. The user data are created if
+        // requested and they do not exist. The user data lock is taken before
+        // the cache shard lock is released so that the data cannot be purged
+        // in between.
+        CUserExcludeBlobs *  x_LockUserBlobs(const string &  user,
+                                             bool  create);
+
+    private:
+        CPSGS_ShardedCache<string, CUserExcludeBlobs *>     m_UserBlobs;
         CUserExcludeBlobsPool               m_Pool;
 
         chrono::seconds                     m_InactivityTimeout;
@@ -0,0 +1,731 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: mock processor which serves data from local files
+ *                   with a simulated backend latency
+ *
+ */
+#include <ncbi_pch.hpp>
+
+#include <corelib/request_status.hpp>
+#include <corelib/ncbidiag.hpp>
+#include <corelib/ncbifile.hpp>
+#include <connect/services/json_over_uttp.hpp>
+
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "mock_processor.hpp"
+#include "pubseq_gateway.hpp"
+#include "pubseq_gateway_convert_utils.hpp"
+#include "pubseq_gateway_logging.hpp"
+#include "psgs_thread_pool.hpp"
+
+
+USING_NCBI_SCOPE;
+
+static const string     kMockProcessorName = "MOCK";
+static const string     kMockProcessorGroupName = "MOCK";
+
+
+// Holds the processors which wait for their simulated latency to pass.
+// When the time comes the processor callback is posted to the processor
+// libuv loop.
+class CPSGS_MockDelayQueue
+{
+public:
+    CPSGS_MockDelayQueue(const SPubseqGatewaySettings &  settings);
+    ~CPSGS_MockDelayQueue();
+
+    void Schedule(CPSGS_MockProcessor *  processor);
+
+    // Returns true if the processor was still waiting, i.e. its callback
+    // will not be called
+    bool Remove(CPSGS_MockProcessor *  processor);
+
+private:
+    enum EPSGS_Distribution {
+        ePSGS_Fixed,
+        ePSGS_Uniform,
+        ePSGS_Normal,
+        ePSGS_LogNormal,
+        ePSGS_Exponential
+    };
+
+    void x_Run(void);
+    psg_clock_t::duration x_GetLatency(void);
+
+private:
+    EPSGS_Distribution      m_Distribution;
+    double                  m_MeanMs;
+    double                  m_StdDevMs;
+
+    mutex                   m_Lock;
+    condition_variable      m_Wakeup;
+    mt19937_64              m_Generator;
+    multimap<psg_time_point_t, CPSGS_MockProcessor *>   m_Waiting;
+    bool                    m_Stop;
+    thread                  m_Thread;
+};
+
+
+static void s_OnDataReady(void *  data)
+{
+    static_cast<CPSGS_MockProcessor *>(data)->OnDataReady();
+}
+
+
+CPSGS_MockDelayQueue::CPSGS_MockDelayQueue(
+                            const SPubseqGatewaySettings &  settings) :
+    m_Distribution(ePSGS_Fixed),
+    m_MeanMs(settings.m_MockLatencyMeanMs),
+    m_StdDevMs(settings.m_MockLatencyStdDevMs),
+    m_Generator(random_device()()),
+    m_Stop(false)
+{
+    string      distribution = settings.m_MockLatencyDistribution;
+    NStr::ToLower(distribution);
+    if (distribution == "uniform")
+        m_Distribution = ePSGS_Uniform;
+    else if (distribution == "normal")
+        m_Distribution = ePSGS_Normal;
+    else if (distribution == "lognormal")
+        m_Distribution = ePSGS_LogNormal;
+    else if (distribution == "exponential")
+        m_Distribution = ePSGS_Exponential;
+
+    m_Thread = thread(&CPSGS_MockDelayQueue::x_Run, this);
+}
+
+
+CPSGS_MockDelayQueue::~CPSGS_MockDelayQueue()
+{
+    {
+        lock_guard<mutex>   guard(m_Lock);
+        m_Stop = true;
+    }
+    m_Wakeup.notify_one();
+    m_Thread.join();
+}
+
+
+void CPSGS_MockDelayQueue::Schedule(CPSGS_MockProcessor *  processor)
+{
+    bool    need_wakeup;
+    {
+        lock_guard<mutex>   guard(m_Lock);
+        auto    it = m_Waiting.emplace(psg_clock_t::now() + x_GetLatency(),
+                                       processor);
+        // The thread sleeps till the earliest deadline
+        need_wakeup = (it == m_Waiting.begin());
+    }
+
+    if (need_wakeup)
+        m_Wakeup.notify_one();
+}
+
+
+bool CPSGS_MockDelayQueue::Remove(CPSGS_MockProcessor *  processor)
+{
+    lock_guard<mutex>   guard(m_Lock);
+    for (auto  it = m_Waiting.begin(); it != m_Waiting.end(); ++it) {
+        if (it->second == processor) {
+            m_Waiting.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void CPSGS_MockDelayQueue::x_Run(void)
+{
+    unique_lock<mutex>      guard(m_Lock);
+
+    while (!m_Stop) {
+        if (m_Waiting.empty()) {
+            m_Wakeup.wait(guard);
+            continue;
+        }
+
+        auto    first = m_Waiting.begin();
+        if (first->first > psg_clock_t::now()) {
+            m_Wakeup.wait_until(guard, first->first);
+            continue;
+        }
+
+        CPSGS_MockProcessor *   processor = first->second;
+        m_Waiting.erase(first);
+
+        // The processor is not destroyed till it signals finish and that
+        // happens only in its own libuv loop after the callback
+        guard.unlock();
+        try {
+            processor->PostponeInvoke(s_OnDataReady, processor);
+        } catch (...) {
+            // Logged in PostponeInvoke()
+        }
+        guard.lock();
+    }
+}
+
+
+// Must be called under the lock
+psg_clock_t::duration CPSGS_MockDelayQueue::x_GetLatency(void)
+{
+    double      latency_ms = m_MeanMs;
+
+    switch (m_Distribution) {
+        case ePSGS_Fixed:
+            break;
+        case ePSGS_Uniform:
+            // The standard deviation is used as a half width of the range
+            latency_ms = uniform_real_distribution<double>(
+                                m_MeanMs - m_StdDevMs,
+                                m_MeanMs + m_StdDevMs)(m_Generator);
+            break;
+        case ePSGS_Normal:
+            if (m_StdDevMs > 0.0)
+                latency_ms = normal_distribution<double>(
+                                m_MeanMs, m_StdDevMs)(m_Generator);
+            break;
+        case ePSGS_LogNormal:
+            // The parameters are calculated so that the distribution has
+            // the configured mean and standard deviation
+            if (m_MeanMs > 0.0) {
+                double  sigma2 = log(1.0 + (m_StdDevMs * m_StdDevMs) /
+                                           (m_MeanMs * m_MeanMs));
+                latency_ms = lognormal_distribution<double>(
+                                log(m_MeanMs) - sigma2 / 2.0,
+                                sqrt(sigma2))(m_Generator);
+            }
+            break;
+        case ePSGS_Exponential:
+            if (m_MeanMs > 0.0)
+                latency_ms = exponential_distribution<double>(
+                                1.0 / m_MeanMs)(m_Generator);
+            break;
+    }
+
+    if (latency_ms < 0.0)
+        latency_ms = 0.0;
+    return chrono::duration_cast<psg_clock_t::duration>(
+                chrono::duration<double, milli>(latency_ms));
+}
+
+
+
+CPSGS_MockProcessor::CPSGS_MockProcessor() :
+    m_DelayQueue(make_shared<CPSGS_MockDelayQueue>(
+                    CPubseqGatewayApp::GetInstance()->Settings())),
+    m_Status(ePSGS_InProgress),
+    m_Canceled(false),
+    m_BioseqInfoFound(false),
+    m_BlobFound(false)
+{
+    unsigned int    max_threads = CPubseqGatewayApp::GetInstance()->
+                                            Settings().m_MockIOThreads;
+    m_ThreadPool.reset(new CThreadPool(kMax_UInt,
+                                       new CPSGS_ThreadPool_Controller(
+                                           min(3u, max_threads), max_threads)));
+}
+
+
+CPSGS_MockProcessor::CPSGS_MockProcessor(
+                            shared_ptr<CPSGS_Request> request,
+                            shared_ptr<CPSGS_Reply> reply,
+                            TProcessorPriority priority,
+                            shared_ptr<CPSGS_MockDelayQueue> delay_queue,
+                            shared_ptr<CThreadPool> thread_pool) :
+    m_DelayQueue(delay_queue),
+    m_ThreadPool(thread_pool),
+    m_Status(ePSGS_InProgress),
+    m_Canceled(false),
+    m_BioseqInfoFound(false),
+    m_BlobFound(false)
+{
+    IPSGS_Processor::m_Request = request;
+    IPSGS_Processor::m_Reply = reply;
+    IPSGS_Processor::m_Priority = priority;
+}
+
+
+CPSGS_MockProcessor::~CPSGS_MockProcessor()
+{}
+
+
+bool CPSGS_MockProcessor::x_IsEnabled(CPSGS_Request &  request) const
+{
+    // The processor is registered only if it is enabled in the settings so
+    // only the per request disabling is checked
+    for (const auto &  dis_processor :
+            request.GetRequest<SPSGS_RequestBase>().m_DisabledProcessors) {
+        if (NStr::CompareNocase(dis_processor, kMockProcessorName) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+vector<string>
+CPSGS_MockProcessor::WhatCanProcess(shared_ptr<CPSGS_Request> request,
+                                    shared_ptr<CPSGS_Reply> reply) const
+{
+    if (!x_IsEnabled(*request))
+        return vector<string>();
+    if (request->GetRequestType() != CPSGS_Request::ePSGS_AnnotationRequest)
+        return vector<string>();
+
+    // Whether the annotations exist is known only after reading the files
+    return request->GetRequest<SPSGS_AnnotRequest>().m_Names;
+}
+
+
+bool
+CPSGS_MockProcessor::CanProcess(shared_ptr<CPSGS_Request> request,
+                                shared_ptr<CPSGS_Reply> reply) const
+{
+    if (!x_IsEnabled(*request))
+        return false;
+
+    switch (request->GetRequestType()) {
+        case CPSGS_Request::ePSGS_ResolveRequest:
+        case CPSGS_Request::ePSGS_BlobBySeqIdRequest:
+        case CPSGS_Request::ePSGS_BlobBySatSatKeyRequest:
+        case CPSGS_Request::ePSGS_AnnotationRequest:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+
+IPSGS_Processor*
+CPSGS_MockProcessor::CreateProcessor(shared_ptr<CPSGS_Request> request,
+                                     shared_ptr<CPSGS_Reply> reply,
+                                     TProcessorPriority priority) const
+{
+    if (!CanProcess(request, reply))
+        return nullptr;
+
+    return new CPSGS_MockProcessor(request, reply, priority,
+                                   m_DelayQueue, m_ThreadPool);
+}
+
+
+void CPSGS_MockProcessor::Process(void)
+{
+    CRequestContextResetter     context_resetter;
+    IPSGS_Processor::m_Request->SetRequestContext();
+
+    if (m_Canceled) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    m_PoolTask.Reset(new psg::CPSGS_ThreadPoolTask<CPSGS_MockProcessor>(
+                            *this, &CPSGS_MockProcessor::LoadData));
+    m_ThreadPool->AddTask(m_PoolTask);
+}
+
+
+void CPSGS_MockProcessor::LoadData(void)
+{
+    CRequestContextResetter     context_resetter;
+    IPSGS_Processor::m_Request->SetRequestContext();
+
+    if (!m_Canceled) {
+        try {
+            switch (IPSGS_Processor::m_Request->GetRequestType()) {
+                case CPSGS_Request::ePSGS_ResolveRequest: {
+                    auto &  request = IPSGS_Processor::m_Request->
+                                            GetRequest<SPSGS_ResolveRequest>();
+                    m_BioseqInfoFound = x_ReadFile(
+                            x_GetFileName("bioseq", request.m_SeqId),
+                            m_BioseqInfo);
+                    break;
+                }
+                case CPSGS_Request::ePSGS_BlobBySeqIdRequest: {
+                    auto &  request = IPSGS_Processor::m_Request->
+                                            GetRequest<SPSGS_BlobBySeqIdRequest>();
+                    m_BioseqInfoFound = x_ReadFile(
+                            x_GetFileName("bioseq", request.m_SeqId),
+                            m_BioseqInfo);
+                    if (!m_BioseqInfoFound)
+                        break;
+
+                    CJsonNode   bioseq_info_node =
+                                        CJsonNode::ParseJSON(m_BioseqInfo);
+                    if (bioseq_info_node.IsObject() &&
+                        bioseq_info_node.HasKey("sat") &&
+                        bioseq_info_node.HasKey("sat_key")) {
+                        m_BlobId =
+                            to_string(bioseq_info_node.GetInteger("sat")) + "." +
+                            to_string(bioseq_info_node.GetInteger("sat_key"));
+                    }
+                    if (!m_BlobId.empty() &&
+                        find(request.m_ExcludeBlobs.begin(),
+                             request.m_ExcludeBlobs.end(),
+                             m_BlobId) == request.m_ExcludeBlobs.end())
+                        x_LoadBlob(m_BlobId);
+                    break;
+                }
+                case CPSGS_Request::ePSGS_BlobBySatSatKeyRequest:
+                    x_LoadBlob(IPSGS_Processor::m_Request->
+                                    GetRequest<SPSGS_BlobBySatSatKeyRequest>().
+                                        m_BlobId.GetId());
+                    break;
+                case CPSGS_Request::ePSGS_AnnotationRequest: {
+                    auto &  request = IPSGS_Processor::m_Request->
+                                            GetRequest<SPSGS_AnnotRequest>();
+                    string  annot_dir = x_GetFileName("na", request.m_SeqId);
+
+                    // Which names are still not processed is checked when
+                    // the reply is sent so all of them are read here
+                    for (const auto &  name : request.m_Names) {
+                        string  annot_info;
+                        if (x_ReadFile(CDirEntry::MakePath(
+                                            annot_dir,
+                                            NStr::Replace(name, "/", "_")),
+                                       annot_info))
+                            m_AnnotInfo[name] = std::move(annot_info);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        } catch (const exception &  exc) {
+            m_LoadError = exc.what();
+        }
+    }
+
+    // The simulated latency starts when the data are loaded. The processor
+    // may be destroyed as soon as it is scheduled.
+    m_DelayQueue->Schedule(this);
+}
+
+
+void CPSGS_MockProcessor::OnDataReady(void)
+{
+    CRequestContextResetter     context_resetter;
+    IPSGS_Processor::m_Request->SetRequestContext();
+
+    if (m_Canceled) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    if (!m_LoadError.empty()) {
+        IPSGS_Processor::m_Reply->PrepareProcessorMessage(
+            IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+            "Exception when reading the mock data: " + m_LoadError,
+            CRequestStatus::e500_InternalServerError, ePSGS_UnknownError,
+            eDiag_Error);
+        x_Finish(ePSGS_Error);
+        return;
+    }
+
+    try {
+        switch (IPSGS_Processor::m_Request->GetRequestType()) {
+            case CPSGS_Request::ePSGS_ResolveRequest:
+                x_ProcessResolveRequest();
+                break;
+            case CPSGS_Request::ePSGS_BlobBySeqIdRequest:
+                x_ProcessGetRequest();
+                break;
+            case CPSGS_Request::ePSGS_BlobBySatSatKeyRequest:
+                x_ProcessGetBlobRequest();
+                break;
+            case CPSGS_Request::ePSGS_AnnotationRequest:
+                x_ProcessAnnotRequest();
+                break;
+            default:
+                x_Finish(ePSGS_Error);
+                break;
+        }
+    } catch (const exception &  exc) {
+        IPSGS_Processor::m_Reply->PrepareProcessorMessage(
+            IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+            "Exception when handling a request: " + string(exc.what()),
+            CRequestStatus::e500_InternalServerError, ePSGS_UnknownError,
+            eDiag_Error);
+        x_Finish(ePSGS_Error);
+    }
+}
+
+
+void CPSGS_MockProcessor::x_ProcessResolveRequest(void)
+{
+    if (!m_BioseqInfoFound) {
+        x_Finish(ePSGS_NotFound);
+        return;
+    }
+
+    if (SignalStartProcessing() == ePSGS_Cancel) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    // The data are stored in JSON so they are sent as JSON regardless of
+    // the requested format
+    IPSGS_Processor::m_Reply->PrepareBioseqDataAndCompletion(
+            IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+            m_BioseqInfo, SPSGS_ResolveRequest::ePSGS_JsonFormat, 1);
+    x_Finish(ePSGS_Done);
+}
+
+
+void CPSGS_MockProcessor::x_ProcessGetRequest(void)
+{
+    auto &      request = IPSGS_Processor::m_Request->
+                                GetRequest<SPSGS_BlobBySeqIdRequest>();
+    const string &  blob_id = m_BlobId;
+
+    if (!m_BioseqInfoFound) {
+        x_Finish(ePSGS_NotFound);
+        return;
+    }
+
+    if (SignalStartProcessing() == ePSGS_Cancel) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    IPSGS_Processor::m_Reply->PrepareBioseqDataAndCompletion(
+            IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+            m_BioseqInfo, SPSGS_ResolveRequest::ePSGS_JsonFormat, 1);
+
+    if (blob_id.empty()) {
+        IPSGS_Processor::m_Reply->PrepareProcessorMessage(
+                IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+                "The mock bioseq info for " + request.m_SeqId +
+                " has no sat and sat_key",
+                CRequestStatus::e404_NotFound, ePSGS_NoBlobPropsError,
+                eDiag_Error);
+        x_Finish(ePSGS_NotFound);
+        return;
+    }
+
+    for (const auto &  excluded : request.m_ExcludeBlobs) {
+        if (excluded == blob_id) {
+            IPSGS_Processor::m_Reply->PrepareBlobExcluded(
+                    blob_id, kMockProcessorName, ePSGS_BlobExcluded);
+            x_Finish(ePSGS_Done);
+            return;
+        }
+    }
+
+    if (!m_BlobFound) {
+        x_SendBlobNotFound(blob_id);
+        x_Finish(ePSGS_NotFound);
+        return;
+    }
+
+    x_SendBlob(blob_id);
+    x_Finish(ePSGS_Done);
+}
+
+
+void CPSGS_MockProcessor::x_ProcessGetBlobRequest(void)
+{
+    auto &      request = IPSGS_Processor::m_Request->
+                                GetRequest<SPSGS_BlobBySatSatKeyRequest>();
+
+    // The existence is checked before the start is signalled so that the
+    // other processors could serve the blob
+    if (!m_BlobFound) {
+        x_Finish(ePSGS_NotFound);
+        return;
+    }
+
+    if (SignalStartProcessing() == ePSGS_Cancel) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    x_SendBlob(request.m_BlobId.GetId());
+    x_Finish(ePSGS_Done);
+}
+
+
+void CPSGS_MockProcessor::x_ProcessAnnotRequest(void)
+{
+    auto &      request = IPSGS_Processor::m_Request->
+                                GetRequest<SPSGS_AnnotRequest>();
+    bool        found = false;
+
+    for (const auto &  name : request.GetNotProcessedName(m_Priority)) {
+        auto    annot_info = m_AnnotInfo.find(name);
+        if (annot_info == m_AnnotInfo.end()) {
+            request.ReportResultStatus(name, SPSGS_AnnotRequest::ePSGS_RS_NotFound);
+            continue;
+        }
+
+        if (request.RegisterProcessedName(m_Priority, name) > m_Priority) {
+            // A higher priority processor has already sent it
+            continue;
+        }
+
+        IPSGS_Processor::m_Reply->PrepareNamedAnnotationData(
+                name, kMockProcessorName, annot_info->second);
+        found = true;
+    }
+
+    x_Finish(found ? ePSGS_Done : ePSGS_NotFound);
+}
+
+
+void CPSGS_MockProcessor::x_LoadBlob(const string &  blob_id)
+{
+    m_BlobFound = x_ReadFile(x_GetFileName("blob", blob_id), m_BlobData);
+}
+
+
+void CPSGS_MockProcessor::x_SendBlob(const string &  blob_id)
+{
+    const string &  blob_data = m_BlobData;
+    size_t      chunk_size = CPubseqGatewayApp::GetInstance()->
+                                    Settings().m_MockBlobChunkSize;
+    size_t      chunk_count = (blob_data.size() + chunk_size - 1) / chunk_size;
+
+    CBlobRecord     blob_props;
+    blob_props.SetSize(blob_data.size());
+    blob_props.SetNChunks(chunk_count);
+
+    size_t      item_id = IPSGS_Processor::m_Reply->GetItemId();
+    IPSGS_Processor::m_Reply->PrepareBlobPropData(
+            item_id, kMockProcessorName, blob_id, ToJsonString(blob_props));
+    IPSGS_Processor::m_Reply->PrepareBlobPropCompletion(
+            item_id, kMockProcessorName, 2);
+
+    item_id = IPSGS_Processor::m_Reply->GetItemId();
+    for (size_t  chunk_no = 0; chunk_no < chunk_count; ++chunk_no) {
+        size_t  offset = chunk_no * chunk_size;
+        IPSGS_Processor::m_Reply->PrepareBlobData(
+                item_id, kMockProcessorName, blob_id,
+                reinterpret_cast<const unsigned char *>(blob_data.data()) + offset,
+                min(chunk_size, blob_data.size() - offset), chunk_no);
+    }
+    IPSGS_Processor::m_Reply->PrepareBlobCompletion(
+            item_id, kMockProcessorName, chunk_count + 1);
+}
+
+
+void CPSGS_MockProcessor::x_SendBlobNotFound(const string &  blob_id)
+{
+    IPSGS_Processor::m_Reply->PrepareBlobMessage(
+            IPSGS_Processor::m_Reply->GetItemId(), kMockProcessorName,
+            blob_id, "Blob " + blob_id + " is not found in the mock data",
+            CRequestStatus::e404_NotFound, ePSGS_NoBlobPropsError,
+            eDiag_Error);
+}
+
+
+void CPSGS_MockProcessor::Cancel(void)
+{
+    m_Canceled = true;
+
+    if (!IsUVThreadAssigned()) {
+        x_Finish(ePSGS_Canceled);
+        return;
+    }
+
+    // If the files are not being read yet then there will be no callback
+    if (auto  task = m_PoolTask) {
+        m_ThreadPool->CancelTask(task);
+        m_PoolTask.Reset();
+        if (task->TryFinish()) {
+            x_Finish(ePSGS_Canceled);
+            return;
+        }
+    }
+
+    // If the processor is still waiting then there will be no callback
+    if (m_DelayQueue->Remove(this)) {
+        x_Finish(ePSGS_Canceled);
+    }
+}
+
+
+IPSGS_Processor::EPSGS_Status
+CPSGS_MockProcessor::GetStatus(void) const
+{
+    return m_Status;
+}
+
+
+string CPSGS_MockProcessor::GetName(void) const
+{
+    return kMockProcessorName;
+}
+
+
+string CPSGS_MockProcessor::GetGroupName(void) const
+{
+    return kMockProcessorGroupName;
+}
+
+
+void CPSGS_MockProcessor::x_Finish(EPSGS_Status  status)
+{
+    if (m_Status != ePSGS_InProgress)
+        return;     // E.g. canceled while the reply was being sent
+
+    m_Status = status;
+    SignalFinishProcessing();
+}
+
+
+string CPSGS_MockProcessor::x_GetFileName(const string &  subdir,
+                                          const string &  name)
+{
+    const string &  data_path = CPubseqGatewayApp::GetInstance()->
+                                        Settings().m_MockDataPath;
+    return CDirEntry::MakePath(CDirEntry::ConcatPath(data_path, subdir),
+                               NStr::Replace(name, "/", "_"));
+}
+
+
+bool CPSGS_MockProcessor::x_ReadFile(const string &  file_name,
+                                     string &  content)
+{
+    if (!CFile(file_name).IsFile())
+        return false;
+
+    ifstream    in(file_name, ios::in | ios::binary);
+    if (!in)
+        return false;
+
+    content.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return !in.bad();
+}
+
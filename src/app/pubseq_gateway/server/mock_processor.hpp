@@ -0,0 +1,134 @@
+#ifndef PSGS_MOCKPROCESSOR__HPP
+#define PSGS_MOCKPROCESSOR__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: mock processor which serves data from local files
+ *                   with a simulated backend latency
+ *
+ */
+
+#include "psgs_request.hpp"
+#include "psgs_reply.hpp"
+#include "ipsgs_processor.hpp"
+#include "psgs_thread_pool_task.hpp"
+#include <util/thread_pool.hpp>
+
+#include <map>
+
+
+USING_NCBI_SCOPE;
+
+
+// The processor is a stand-in for the Cassandra processors: it lets running
+// the server (and benchmarking it) without a Cassandra cluster. It is
+// registered only if the [MOCK_PROCESSOR]/enabled setting is true and it has
+// the highest priority. The Cassandra processors can be switched off with
+// [CASSANDRA_PROCESSOR]/enabled = false.
+//
+// The data directory layout is as follows:
+//   <data_path>/bioseq/<seq_id>            bioseq info JSON; used for
+//                                          ID/resolve and ID/get
+//   <data_path>/blob/<sat>.<sat_key>       blob data; used for ID/get and
+//                                          ID/getblob
+//   <data_path>/na/<seq_id>/<annot_name>   named annotation info JSON; used
+//                                          for ID/get_na
+// The '/' characters in the seq_id and other names are replaced with '_'.
+// The blob id for ID/get is taken from the bioseq info 'sat' and 'sat_key'
+// fields.
+//
+// The files are read on a thread pool. Then the reply is sent after a delay
+// drawn from the configured latency distribution. The delays are served by a
+// single timer thread. So neither the file I/O nor the delay blocks the
+// libuv loops, i.e. like with an asynchronous backend.
+
+class CPSGS_MockDelayQueue;
+
+class CPSGS_MockProcessor : public IPSGS_Processor
+{
+public:
+    CPSGS_MockProcessor();
+    virtual ~CPSGS_MockProcessor();
+
+    virtual vector<string> WhatCanProcess(shared_ptr<CPSGS_Request> request,
+                                          shared_ptr<CPSGS_Reply> reply) const override;
+    virtual bool CanProcess(shared_ptr<CPSGS_Request> request,
+                            shared_ptr<CPSGS_Reply> reply) const override;
+    virtual IPSGS_Processor* CreateProcessor(shared_ptr<CPSGS_Request> request,
+                                             shared_ptr<CPSGS_Reply> reply,
+                                             TProcessorPriority priority) const override;
+    virtual void Process(void) override;
+    virtual void Cancel(void) override;
+    virtual EPSGS_Status GetStatus(void) const override;
+    virtual string GetName(void) const override;
+    virtual string GetGroupName(void) const override;
+
+    // Called from a thread pool thread; reads the files the request needs
+    void LoadData(void);
+
+    // Called from the processor libuv loop when the simulated latency passed
+    void OnDataReady(void);
+
+private:
+    CPSGS_MockProcessor(shared_ptr<CPSGS_Request> request,
+                        shared_ptr<CPSGS_Reply> reply,
+                        TProcessorPriority priority,
+                        shared_ptr<CPSGS_MockDelayQueue> delay_queue,
+                        shared_ptr<CThreadPool> thread_pool);
+
+    bool x_IsEnabled(CPSGS_Request &  request) const;
+    void x_ProcessResolveRequest(void);
+    void x_ProcessGetRequest(void);
+    void x_ProcessGetBlobRequest(void);
+    void x_ProcessAnnotRequest(void);
+    void x_LoadBlob(const string &  blob_id);
+    void x_SendBlob(const string &  blob_id);
+    void x_SendBlobNotFound(const string &  blob_id);
+    void x_Finish(EPSGS_Status  status);
+
+    static string x_GetFileName(const string &  subdir,
+                                const string &  name);
+    static bool x_ReadFile(const string &  file_name, string &  content);
+
+private:
+    shared_ptr<CPSGS_MockDelayQueue>    m_DelayQueue;
+    shared_ptr<CThreadPool>             m_ThreadPool;
+    CRef<psg::CPSGS_ThreadPoolTask<CPSGS_MockProcessor>>    m_PoolTask;
+    EPSGS_Status                        m_Status;
+    bool                                m_Canceled;
+
+    // Filled by LoadData() and used in the libuv loop by OnDataReady()
+    string                              m_LoadError;
+    bool                                m_BioseqInfoFound;
+    string                              m_BioseqInfo;
+    string                              m_BlobId;
+    bool                                m_BlobFound;
+    string                              m_BlobData;
+    map<string, string>                 m_AnnotInfo;    // name -> info
+};
+
+#endif  // PSGS_MOCKPROCESSOR__HPP
+
@@ -31,7 +31,6 @@
 
 #include <ncbi_pch.hpp>
 
-#include <algorithm>
 #include "pubseq_gateway.hpp"
 #include "pubseq_gateway_utils.hpp"
 #include "my_ncbi_cache.hpp"
@@ -121,6 +120,7 @@ SMyNCBIOKCacheItem::x_OnSuccess(const string &  cookie,
         waiter.m_Processor->PostponeInvoke(my_ncbi_success_cb,
                                            (void*)(user_data));
     }
+    m_WaitList.clear();
 }
 
 
@@ -186,46 +186,44 @@ CMyNCBIOKCache::GetUserInfo(IPSGS_Processor *  processor,
     optional<SUserInfoItem>     ret;
     auto &                      counters = m_App->GetCounters();
 
-    lock_guard<mutex>   guard(m_Lock);
+    m_Cache.FindOrCreate(
+        cookie,
+        [&](SMyNCBIOKCacheItem &  item, bool  created)
+        {
+            if (created) {
+                counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheMiss);
+
+                // Created with the status InProgress;
+                // Return is not set i.e. the caller must initiate the my ncbi
+                // request
+                return;
+            }
+
+            SUserInfoItem       ret_item;
+
+            // Here: the item is found. It can be in InProgress or in Ready
+            // state
+            if (item.m_Status == SMyNCBIOKCacheItem::ePSGS_Ready) {
+                // The user info is at hand. Prepare the return value
+                // accordingly
+                ret_item.m_Status = SMyNCBIOKCacheItem::ePSGS_Ready;
+                ret_item.m_UserInfo = item.m_UserInfo;
+
+                counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheHit);
+            } else {
+                // Here: m_Status == SMyNCBIOKCacheItem::ePSGS_InProgress
+                // There is no user info. Add the requester to the wait list
+                // and set only the status for the return value.
+                ret_item.m_Status = SMyNCBIOKCacheItem::ePSGS_InProgress;
+                item.x_AddToWaitList(processor, data_cb, error_cb);
+
+                counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheWaitHit);
+            }
+
+            item.m_LastTouch = psg_clock_t::now();
+            ret = ret_item;
+        });
 
-    auto    it = m_Cache.find(cookie);
-    if (it == m_Cache.cend()) {
-        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheMiss);
-
-        // Created with the status InProgress;
-        // Return is not set i.e. the caller must initiate the my ncbi request
-        m_Cache[cookie] = SMyNCBIOKCacheItem();
-        return ret;
-    }
-
-    SUserInfoItem       ret_item;
-
-    // Here: the item is found. It can be in InProgress or in Ready state
-    if (it->second.m_Status == SMyNCBIOKCacheItem::ePSGS_Ready) {
-        // The user info is at hand. Prepare the return value accordingly
-        ret_item.m_Status = SMyNCBIOKCacheItem::ePSGS_Ready;
-        ret_item.m_UserInfo = it->second.m_UserInfo;
-
-        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheHit);
-    } else {
-        // Here: m_Status == SMyNCBIOKCacheItem::ePSGS_InProgress
-        // There is no user info. Add the requester to the wait list and set
-        // only the status for the return value.
-        ret_item.m_Status = SMyNCBIOKCacheItem::ePSGS_InProgress;
-        it->second.x_AddToWaitList(processor, data_cb, error_cb);
-
-        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIOKCacheWaitHit);
-    }
-
-    auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-    if (lru_it != m_LRU.begin()) {
-        m_LRU.erase(lru_it);
-        m_LRU.push_front(cookie);
-    }
-
-    it->second.m_LastTouch = psg_clock_t::now();
-
-    ret = ret_item;
     return ret;
 }
 
@@ -234,31 +232,16 @@ void
 CMyNCBIOKCache::AddUserInfo(const string &  cookie,
                             const CPSG_MyNCBIRequest_WhoAmI::SUserInfo &  user_info)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(cookie);
-    if (find_it == m_Cache.end()) {
-        // No cookie. It should not really happened because someone had to
-        // request it and thus the cookie record should be here.
-        // To be safe, create a new record here.
-        SMyNCBIOKCacheItem      item;
-        item.m_UserInfo = user_info;
-        item.m_Status = SMyNCBIOKCacheItem::ePSGS_Ready;
-        m_Cache[cookie] = item;
-        m_LRU.emplace_front(cookie);
-        return;
-    }
-
-    // It already exists. Update LRU
-    auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-    if (lru_it != m_LRU.begin()) {
-        m_LRU.erase(lru_it);
-        m_LRU.push_front(cookie);
-    }
-
+    // Normally the cookie record is here because someone had to request it.
+    // To be safe, it is created if it is not.
     // This will update last touch, status and data +
     // will schedule callbacks to the waiters and clear the wait list.
-    find_it->second.x_OnSuccess(cookie, user_info);
+    m_Cache.FindOrCreate(
+        cookie,
+        [&](SMyNCBIOKCacheItem &  item, bool  /* created */)
+        {
+            item.x_OnSuccess(cookie, user_info);
+        });
 }
 
 
@@ -268,115 +251,86 @@ void CMyNCBIOKCache::OnError(const string &  cookie,
                              EDiagSev  severity,
                              const string &  message)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(cookie);
-    if (find_it != m_Cache.end()) {
-        // Will schedule a notification for those who waits
-        find_it->second.x_OnError(cookie, status, code, severity, message);
-
-        // Remove it from cache because no activity is expected
-        m_Cache.erase(find_it);
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.end()) {
-            m_LRU.erase(lru_it);
-        }
-    }
+    // Will schedule a notification for those who waits and remove the
+    // record from cache because no activity is expected
+    m_Cache.EraseIf(
+        cookie,
+        [&](SMyNCBIOKCacheItem &  item)
+        {
+            item.x_OnError(cookie, status, code, severity, message);
+            return true;
+        });
 }
 
 
-void CMyNCBIOKCache::OnNotFound(const string &  cookie){
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(cookie);
-    if (find_it != m_Cache.end()) {
-        // Will schedule a notification for those who waits
-        find_it->second.x_OnNotFound(cookie);
-
-        // Remove it from cache because no activity is expected
-        m_Cache.erase(find_it);
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.end()) {
-            m_LRU.erase(lru_it);
-        }
-    }
+void CMyNCBIOKCache::OnNotFound(const string &  cookie)
+{
+    // Will schedule a notification for those who waits and remove the
+    // record from cache because no activity is expected
+    m_Cache.EraseIf(
+        cookie,
+        [&](SMyNCBIOKCacheItem &  item)
+        {
+            item.x_OnNotFound(cookie);
+            return true;
+        });
 }
 
 
 void CMyNCBIOKCache::ClearWaitingProcessor(const string &  cookie,
                                            IPSGS_Processor *  processor)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(cookie);
-    if (find_it != m_Cache.end()) {
-        if (find_it->second.m_Status == SMyNCBIOKCacheItem::ePSGS_InProgress) {
+    m_Cache.Find(
+        cookie,
+        [processor](SMyNCBIOKCacheItem &  item)
+        {
             // Only if the date are not delivered yet it makes sense to check
             // for the waiters
-            find_it->second.x_RemoveWaiter(processor);
-        }
-    }
+            if (item.m_Status == SMyNCBIOKCacheItem::ePSGS_InProgress)
+                item.x_RemoveWaiter(processor);
+        });
 }
 
 
 void CMyNCBIOKCache::ClearInitiatedRequest(const string &  cookie)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(cookie);
-    if (find_it != m_Cache.end()) {
-        // Notify those who are waiting that there is an error receiving a
-        // reply from my NCBI if the myNCBI reply is in progress
-        if (find_it->second.m_Status == SMyNCBIOKCacheItem::ePSGS_InProgress) {
-            find_it->second.x_OnError(cookie, CRequestStatus::e503_ServiceUnavailable,
-                                      ePSGS_MyNCBIRequestInitiatorDestroyed, eDiag_Error,
-                                      "The initiator of the myNCBI request for cookie " +
-                                      SanitizeInputValue(cookie) + " is destroyed. "
-                                      "So the myNCBI reply will not be delivered. "
-                                      "Please try again.");
-
-            // Remove it from cache because no activity is expected
-            m_Cache.erase(find_it);
-
-            m_LRU.erase(find(m_LRU.begin(), m_LRU.end(), cookie));
-        }
-    }
+    // Notify those who are waiting that there is an error receiving a
+    // reply from my NCBI if the myNCBI reply is in progress and remove the
+    // record from cache because no activity is expected
+    m_Cache.EraseIf(
+        cookie,
+        [&cookie](SMyNCBIOKCacheItem &  item)
+        {
+            if (item.m_Status != SMyNCBIOKCacheItem::ePSGS_InProgress)
+                return false;
+
+            item.x_OnError(cookie, CRequestStatus::e503_ServiceUnavailable,
+                           ePSGS_MyNCBIRequestInitiatorDestroyed, eDiag_Error,
+                           "The initiator of the myNCBI request for cookie " +
+                           SanitizeInputValue(cookie) + " is destroyed. "
+                           "So the myNCBI reply will not be delivered. "
+                           "Please try again.");
+            return true;
+        });
 }
 
 
 void CMyNCBIOKCache::Maintain(void)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    if (m_Cache.size() <= m_HighMark)
-        return;
-
     // Cannot remove records which have a non empty wait list or it is in
     // progress.
     // If to do so then those request will freeze forever-ish.
-    size_t          need_to_delete_cnt = m_Cache.size() - m_LowMark;
-    list<string>    to_be_deleted;
-
-    for (auto  it = m_LRU.rbegin(); it != m_LRU.rend(); ++it) {
-        auto    cache_it = m_Cache.find(*it);
-        if (cache_it->second.m_WaitList.empty() &&
-            cache_it->second.m_Status == SMyNCBIOKCacheItem::ePSGS_Ready) {
-            // Can remove - the wait list is empty and the request has been
-            // completed
-            to_be_deleted.push_back(*it);
-            --need_to_delete_cnt;
-            if (need_to_delete_cnt == 0)
-                break;
-        }
-    }
-
-    // Now the actual removal
-    for (const auto &  cookie_to_delete: to_be_deleted) {
-        m_Cache.erase(m_Cache.find(cookie_to_delete));
-        m_LRU.erase(find(m_LRU.begin(), m_LRU.end(), cookie_to_delete));
-    }
+    size_t      evicted = m_Cache.Maintain(
+        [](SMyNCBIOKCacheItem &  item)
+        {
+            return item.m_WaitList.empty() &&
+                   item.m_Status == SMyNCBIOKCacheItem::ePSGS_Ready;
+        });
+
+    if (evicted > 0)
+        m_App->GetCounters().Increment(nullptr,
+                                       CPSGSCounters::ePSGS_MyNCBIOKCacheEvicted,
+                                       evicted);
 }
 
 
@@ -385,36 +339,15 @@ bool CMyNCBINotFoundCache::IsNotFound(const string &  cookie)
     if (m_ExpirationMs > 0) {
         auto &              counters = m_App->GetCounters();
 
-        lock_guard<mutex>   guard(m_Lock);
-
-        auto    it = m_Cache.find(cookie);
-        if (it == m_Cache.cend()) {
-            counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBINotFoundCacheMiss);
-            return false;
+        // An item which is here for too long is treated as not found.
+        // The found item time is not updated. The time is the moment when
+        // an error was noticed.
+        if (m_Cache.Find(cookie, [](bool &) {})) {
+            counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBINotFoundCacheHit);
+            return true;
         }
 
-        if (GetTimespanToNowMs(it->second) > m_ExpirationMs) {
-            // Found but the item is here for too long
-            counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBINotFoundCacheMiss);
-            m_Cache.erase(it);
-
-            auto    lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-            if (lru_it != m_LRU.begin())
-                m_LRU.erase(lru_it);
-
-            return false;
-        }
-
-        // Found. Update LRU but do not update the time. The time is the
-        // moment when an error was noticed.
-        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBINotFoundCacheHit);
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.begin()) {
-            m_LRU.erase(lru_it);
-            m_LRU.push_front(cookie);
-        }
-        return true;
+        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBINotFoundCacheMiss);
     }
     return false;
 }
@@ -422,41 +355,19 @@ bool CMyNCBINotFoundCache::IsNotFound(const string &  cookie)
 
 void CMyNCBINotFoundCache::AddNotFound(const string &  cookie)
 {
-    if (m_ExpirationMs > 0) {
-        lock_guard<mutex>   guard(m_Lock);
-
-        auto  find_it = m_Cache.find(cookie);
-        if (find_it == m_Cache.end()) {
-            // No cookie, add a new one
-            m_Cache[cookie] = psg_clock_t::now();
-            m_LRU.push_front(cookie);
-            return;
-        }
-
-        // It already exists
-        find_it->second = psg_clock_t::now();
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.begin()) {
-            m_LRU.erase(lru_it);
-            m_LRU.push_front(cookie);
-        }
-    }
+    if (m_ExpirationMs > 0)
+        m_Cache.Put(cookie, true);
 }
 
 
 void CMyNCBINotFoundCache::Maintain(void)
 {
     if (m_ExpirationMs > 0) {
-        lock_guard<mutex>   guard(m_Lock);
-
-        if (m_Cache.size() <= m_HighMark)
-            return;
-
-        while (m_Cache.size() > m_LowMark) {
-            m_Cache.erase(m_Cache.find(m_LRU.back()));
-            m_LRU.pop_back();
-        }
+        size_t      evicted = m_Cache.Maintain();
+        if (evicted > 0)
+            m_App->GetCounters().Increment(nullptr,
+                                           CPSGSCounters::ePSGS_MyNCBINotFoundCacheEvicted,
+                                           evicted);
     }
 }
 
@@ -468,37 +379,16 @@ CMyNCBIErrorCache::GetError(const string &  cookie)
     if (m_BackOffMs > 0) {
         auto &              counters = m_App->GetCounters();
 
-        lock_guard<mutex>   guard(m_Lock);
-
-        auto    it = m_Cache.find(cookie);
-        if (it == m_Cache.cend()) {
-            counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIErrorCacheMiss);
-            return ret;
-        }
-
-        if (GetTimespanToNowMs(it->second.m_LastTouch) > m_BackOffMs) {
-            // Found but the item is here for too long
+        // An item which is here for too long is treated as not found.
+        // The found item time is not updated. The time is the moment when
+        // an error was noticed.
+        if (m_Cache.Find(cookie,
+                         [&ret](SMyNCBIErrorCacheItem &  item)
+                         { ret = item; })) {
+            counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIErrorCacheHit);
+        } else {
             counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIErrorCacheMiss);
-            m_Cache.erase(it);
-
-            auto    lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-            if (lru_it != m_LRU.begin())
-                m_LRU.erase(lru_it);
-
-            return ret;
-        }
-
-        // Found. Update LRU but do not update the time. The time is the
-        // moment when an error was noticed.
-        counters.Increment(nullptr, CPSGSCounters::ePSGS_MyNCBIErrorCacheHit);
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.begin()) {
-            m_LRU.erase(lru_it);
-            m_LRU.push_front(cookie);
         }
-        ret = it->second;
-        return ret;
     }
     return ret;
 }
@@ -510,41 +400,21 @@ void CMyNCBIErrorCache::AddError(const string &  cookie,
                                  EDiagSev  severity,
                                  const string &  message)
 {
-    if (m_BackOffMs > 0) {
-        lock_guard<mutex>   guard(m_Lock);
-
-        auto  find_it = m_Cache.find(cookie);
-        if (find_it == m_Cache.end()) {
-            // No cookie, add a new one
-            m_Cache[cookie] = SMyNCBIErrorCacheItem(status, code, severity, message);
-            m_LRU.push_front(cookie);
-            return;
-        }
-
-        // It already exists
-        find_it->second.m_LastTouch = psg_clock_t::now();
-
-        auto lru_it = find(m_LRU.begin(), m_LRU.end(), cookie);
-        if (lru_it != m_LRU.begin()) {
-            m_LRU.erase(lru_it);
-            m_LRU.push_front(cookie);
-        }
-    }
+    // The back off period starts from the last noticed error
+    if (m_BackOffMs > 0)
+        m_Cache.Put(cookie,
+                    SMyNCBIErrorCacheItem(status, code, severity, message));
 }
 
 
 void CMyNCBIErrorCache::Maintain(void)
 {
     if (m_BackOffMs > 0) {
-        lock_guard<mutex>   guard(m_Lock);
-
-        if (m_Cache.size() <= m_HighMark)
-            return;
-
-        while (m_Cache.size() > m_LowMark) {
-            m_Cache.erase(m_Cache.find(m_LRU.back()));
-            m_LRU.pop_back();
-        }
+        size_t      evicted = m_Cache.Maintain();
+        if (evicted > 0)
+            m_App->GetCounters().Increment(nullptr,
+                                           CPSGSCounters::ePSGS_MyNCBIErrorCacheEvicted,
+                                           evicted);
     }
 }
 
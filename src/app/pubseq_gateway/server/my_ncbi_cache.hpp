@@ -33,15 +33,14 @@
  */
 
 
-#include <mutex>
-#include <map>
-#include <list>
 #include <string>
+#include <list>
 #include <optional>
 using namespace std;
 
 #include "pubseq_gateway_types.hpp"
 #include "myncbi_callback.hpp"
+#include "psgs_sharded_cache.hpp"
 #include <objtools/pubseq_gateway/impl/myncbi/myncbi_request.hpp>
 
 USING_NCBI_SCOPE;
@@ -108,7 +107,7 @@ class CMyNCBIOKCache
 
     public:
         CMyNCBIOKCache(CPubseqGatewayApp *  app, size_t  high_mark, size_t  low_mark) :
-            m_App(app), m_HighMark(high_mark), m_LowMark(low_mark)
+            m_App(app), m_Cache(high_mark, low_mark)
         {}
 
         ~CMyNCBIOKCache()
@@ -131,24 +130,15 @@ class CMyNCBIOKCache
 
         size_t Size(void)
         {
-            size_t              size = 0;
-            lock_guard<mutex>   guard(m_Lock);
-
-            size = m_Cache.size();
-            return size;
+            return m_Cache.Size();
         }
 
         // Cleans up the cache if needed
         void Maintain(void);
 
     private:
-        CPubseqGatewayApp *                 m_App;
-
-        size_t                              m_HighMark;
-        size_t                              m_LowMark;
-        map<string, SMyNCBIOKCacheItem>     m_Cache;
-        list<string>                        m_LRU;
-        mutex                               m_Lock;
+        CPubseqGatewayApp *                             m_App;
+        CPSGS_ShardedCache<string, SMyNCBIOKCacheItem>  m_Cache;
 };
 
 
@@ -160,8 +150,8 @@ class CMyNCBINotFoundCache
         CMyNCBINotFoundCache(CPubseqGatewayApp *  app,
                              size_t  high_mark, size_t  low_mark,
                              size_t  expiration_sec) :
-            m_App(app), m_HighMark(high_mark), m_LowMark(low_mark),
-            m_ExpirationMs(expiration_sec * 1000)
+            m_App(app), m_ExpirationMs(expiration_sec * 1000),
+            m_Cache(high_mark, low_mark, m_ExpirationMs)
         {}
 
         ~CMyNCBINotFoundCache()
@@ -173,11 +163,7 @@ class CMyNCBINotFoundCache
 
         size_t Size(void)
         {
-            size_t              size = 0;
-            lock_guard<mutex>   guard(m_Lock);
-
-            size = m_Cache.size();
-            return size;
+            return m_Cache.Size();
         }
 
         // Cleans up the cache if needed
@@ -185,14 +171,10 @@ class CMyNCBINotFoundCache
 
     private:
         CPubseqGatewayApp *                 m_App;
-
-        size_t                              m_HighMark;
-        size_t                              m_LowMark;
         size_t                              m_ExpirationMs;
 
-        map<string, psg_time_point_t>       m_Cache;
-        list<string>                        m_LRU;
-        mutex                               m_Lock;
+        // The value is not used; the items expire after m_ExpirationMs
+        CPSGS_ShardedCache<string, bool>    m_Cache;
 };
 
 
@@ -229,8 +211,8 @@ class CMyNCBIErrorCache
         CMyNCBIErrorCache(CPubseqGatewayApp *  app,
                           size_t  high_mark, size_t  low_mark,
                           size_t  back_off_ms) :
-            m_App(app), m_HighMark(high_mark), m_LowMark(low_mark),
-            m_BackOffMs(back_off_ms)
+            m_App(app), m_BackOffMs(back_off_ms),
+            m_Cache(high_mark, low_mark, m_BackOffMs)
         {}
 
         ~CMyNCBIErrorCache()
@@ -243,26 +225,18 @@ class CMyNCBIErrorCache
 
         size_t Size(void)
         {
-            size_t              size = 0;
-            lock_guard<mutex>   guard(m_Lock);
-
-            size = m_Cache.size();
-            return size;
+            return m_Cache.Size();
         }
 
         // Cleans up the cache if needed
         void Maintain(void);
 
     private:
-        CPubseqGatewayApp *                 m_App;
-
-        size_t                              m_HighMark;
-        size_t                              m_LowMark;
-        size_t                              m_BackOffMs;
+        CPubseqGatewayApp *                                 m_App;
+        size_t                                              m_BackOffMs;
 
-        map<string, SMyNCBIErrorCacheItem>  m_Cache;
-        list<string>                        m_LRU;
-        mutex                               m_Lock;
+        // The items expire after m_BackOffMs
+        CPSGS_ShardedCache<string, SMyNCBIErrorCacheItem>   m_Cache;
 };
 
 
@@ -0,0 +1,358 @@
+#ifndef PSGS_SHARDED_CACHE__HPP
+#define PSGS_SHARDED_CACHE__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: generic sharded cache with approximate LRU eviction
+ *
+ */
+
+
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+#include <functional>
+using namespace std;
+
+#include "pubseq_gateway_types.hpp"
+
+
+// The cache is split into shards by the key hash; each shard has its own
+// lock so the uv loop threads which look up different keys do not contend.
+// The eviction is the CLOCK approximation of LRU: an access sets the item
+// 'referenced' bit and the eviction hand clears the bits giving such items
+// a second chance instead of moving them in an LRU list on each access.
+// The items may also expire after the configured time since they were put
+// into the cache.
+//
+// The item values are accessed via functors called under the shard lock,
+// so the functors must be short and must not access the same cache.
+template <typename TKey, typename TValue, typename THash = hash<TKey>>
+class CPSGS_ShardedCache
+{
+    public:
+        // high_mark == 0 means there is no size limit
+        // expiration_ms == 0 means the items do not expire
+        CPSGS_ShardedCache(size_t  high_mark, size_t  low_mark,
+                           size_t  expiration_ms = 0,
+                           size_t  shard_count = kDefaultShardCount) :
+            m_HighMark(high_mark), m_LowMark(low_mark),
+            m_Expiration(chrono::milliseconds(expiration_ms)),
+            m_Shards(shard_count == 0 ? 1 : shard_count)
+        {
+            for (auto &  shard : m_Shards)
+                shard.reset(new SShard());
+        }
+
+        // Non copyable
+        CPSGS_ShardedCache(const CPSGS_ShardedCache &) = delete;
+        CPSGS_ShardedCache &  operator=(const CPSGS_ShardedCache &) = delete;
+
+    public:
+        // Calls func(TValue &) if the key is in the cache and the item has
+        // not expired. An expired item is removed.
+        // Returns true if func was called.
+        template <typename TFunc>
+        bool Find(const TKey &  key, TFunc  func)
+        {
+            SShard &            shard = x_GetShard(key);
+            lock_guard<mutex>   guard(shard.m_Lock);
+
+            SSlot *     slot = x_FindSlot(shard, key);
+            if (slot == nullptr)
+                return false;
+
+            slot->m_Referenced = true;
+            func(slot->m_Value);
+            return true;
+        }
+
+        // Calls func(TValue &, bool  created). A default constructed value
+        // is inserted if the key is not in the cache or the item expired.
+        template <typename TFunc>
+        void FindOrCreate(const TKey &  key, TFunc  func)
+        {
+            SShard &            shard = x_GetShard(key);
+            lock_guard<mutex>   guard(shard.m_Lock);
+
+            bool        created = false;
+            SSlot *     slot = x_FindSlot(shard, key);
+            if (slot == nullptr) {
+                slot = x_Insert(shard, key);
+                created = true;
+            }
+
+            slot->m_Referenced = true;
+            func(slot->m_Value, created);
+        }
+
+        // Inserts the item or replaces the existing one. In both cases the
+        // expiration starts from now.
+        void Put(const TKey &  key, const TValue &  value)
+        {
+            SShard &            shard = x_GetShard(key);
+            lock_guard<mutex>   guard(shard.m_Lock);
+
+            SSlot *     slot = x_FindSlot(shard, key);
+            if (slot == nullptr)
+                slot = x_Insert(shard, key);
+
+            slot->m_Value = value;
+            slot->m_Created = psg_clock_t::now();
+            slot->m_Referenced = true;
+        }
+
+        // Calls pred(TValue &) if the key is in the cache and removes the
+        // item if pred returns true. Returns true if the item was removed.
+        template <typename TPred>
+        bool EraseIf(const TKey &  key, TPred  pred)
+        {
+            SShard &            shard = x_GetShard(key);
+            lock_guard<mutex>   guard(shard.m_Lock);
+
+            auto    it = shard.m_Index.find(key);
+            if (it == shard.m_Index.end())
+                return false;
+            if (!pred(shard.m_Slots[it->second].m_Value))
+                return false;
+
+            x_Erase(shard, it);
+            return true;
+        }
+
+        bool Erase(const TKey &  key)
+        {
+            return EraseIf(key, [](TValue &) { return true; });
+        }
+
+        // Calls pred(const TKey &, TValue &) for each item and removes those
+        // for which pred returns true. Returns the number of removed items.
+        template <typename TPred>
+        size_t EraseAllIf(TPred  pred)
+        {
+            size_t      erased = 0;
+            for (auto &  shard_ptr : m_Shards) {
+                SShard &            shard = *shard_ptr;
+                lock_guard<mutex>   guard(shard.m_Lock);
+
+                for (auto &  slot : shard.m_Slots) {
+                    if (slot.m_Used && pred(slot.m_Key, slot.m_Value)) {
+                        x_Erase(shard, shard.m_Index.find(slot.m_Key));
+                        ++erased;
+                    }
+                }
+            }
+            return erased;
+        }
+
+        // Calls func(const TKey &, TValue &) for each item
+        template <typename TFunc>
+        void ForEach(TFunc  func)
+        {
+            for (auto &  shard_ptr : m_Shards) {
+                SShard &            shard = *shard_ptr;
+                lock_guard<mutex>   guard(shard.m_Lock);
+
+                for (auto &  slot : shard.m_Slots) {
+                    if (slot.m_Used)
+                        func(slot.m_Key, slot.m_Value);
+                }
+            }
+        }
+
+        // If the cache size is above the high mark then the items are
+        // evicted till the size is at the low mark. The items for which
+        // can_evict(TValue &) returns false are kept.
+        // Returns the number of evicted items.
+        template <typename TPred>
+        size_t Maintain(TPred  can_evict)
+        {
+            if (m_HighMark == 0 || Size() <= m_HighMark)
+                return 0;
+
+            size_t      shard_low_mark = m_LowMark / m_Shards.size();
+            size_t      evicted = 0;
+            for (auto &  shard_ptr : m_Shards) {
+                SShard &            shard = *shard_ptr;
+                lock_guard<mutex>   guard(shard.m_Lock);
+
+                evicted += x_Evict(shard, shard_low_mark, can_evict);
+            }
+            return evicted;
+        }
+
+        size_t Maintain(void)
+        {
+            return Maintain([](TValue &) { return true; });
+        }
+
+        size_t Size(void) const
+        {
+            size_t      size = 0;
+            for (const auto &  shard : m_Shards)
+                size += shard->m_Size.load(memory_order_relaxed);
+            return size;
+        }
+
+    public:
+        static const size_t     kDefaultShardCount = 16;
+
+    private:
+        struct SSlot
+        {
+            TKey                m_Key;
+            TValue              m_Value;
+            psg_time_point_t    m_Created;
+            bool                m_Used;
+            bool                m_Referenced;
+
+            SSlot() :
+                m_Used(false), m_Referenced(false)
+            {}
+        };
+
+        typedef unordered_map<TKey, size_t, THash>  TIndex;
+
+        struct SShard
+        {
+            mutex               m_Lock;
+            TIndex              m_Index;        // key -> slot
+            vector<SSlot>       m_Slots;        // the clock
+            vector<size_t>      m_FreeSlots;
+            size_t              m_Hand;         // the clock hand
+            atomic<size_t>      m_Size;
+
+            SShard() :
+                m_Hand(0), m_Size(0)
+            {}
+        };
+
+        SShard &  x_GetShard(const TKey &  key)
+        {
+            return *m_Shards[THash()(key) % m_Shards.size()];
+        }
+
+        bool x_IsExpired(const SSlot &  slot) const
+        {
+            return m_Expiration.count() > 0 &&
+                   psg_clock_t::now() - slot.m_Created > m_Expiration;
+        }
+
+        // Must be called under the shard lock
+        SSlot *  x_FindSlot(SShard &  shard, const TKey &  key)
+        {
+            auto    it = shard.m_Index.find(key);
+            if (it == shard.m_Index.end())
+                return nullptr;
+
+            SSlot *     slot = &shard.m_Slots[it->second];
+            if (x_IsExpired(*slot)) {
+                x_Erase(shard, it);
+                return nullptr;
+            }
+            return slot;
+        }
+
+        // Must be called under the shard lock
+        SSlot *  x_Insert(SShard &  shard, const TKey &  key)
+        {
+            size_t      index;
+            if (shard.m_FreeSlots.empty()) {
+                index = shard.m_Slots.size();
+                shard.m_Slots.emplace_back();
+            } else {
+                index = shard.m_FreeSlots.back();
+                shard.m_FreeSlots.pop_back();
+            }
+
+            SSlot &     slot = shard.m_Slots[index];
+            slot.m_Key = key;
+            slot.m_Value = TValue();
+            slot.m_Created = psg_clock_t::now();
+            slot.m_Used = true;
+            slot.m_Referenced = false;
+
+            shard.m_Index[key] = index;
+            shard.m_Size.store(shard.m_Index.size(), memory_order_relaxed);
+            return &slot;
+        }
+
+        // Must be called under the shard lock
+        void x_Erase(SShard &  shard, typename TIndex::iterator  it)
+        {
+            SSlot &     slot = shard.m_Slots[it->second];
+
+            shard.m_FreeSlots.push_back(it->second);
+            shard.m_Index.erase(it);
+            shard.m_Size.store(shard.m_Index.size(), memory_order_relaxed);
+
+            // Release the resources held by the item right away
+            slot.m_Key = TKey();
+            slot.m_Value = TValue();
+            slot.m_Used = false;
+            slot.m_Referenced = false;
+        }
+
+        // Must be called under the shard lock.
+        // Two turns of the clock hand are enough: the first one clears the
+        // referenced bits, the second one evicts everything evictable.
+        template <typename TPred>
+        size_t x_Evict(SShard &  shard, size_t  low_mark, TPred &  can_evict)
+        {
+            size_t      evicted = 0;
+            size_t      steps = shard.m_Slots.size() * 2;
+
+            while (shard.m_Index.size() > low_mark && steps > 0) {
+                --steps;
+                if (shard.m_Hand >= shard.m_Slots.size())
+                    shard.m_Hand = 0;
+
+                SSlot &     slot = shard.m_Slots[shard.m_Hand++];
+                if (!slot.m_Used)
+                    continue;
+
+                if ((!slot.m_Referenced || x_IsExpired(slot)) &&
+                    can_evict(slot.m_Value)) {
+                    x_Erase(shard, shard.m_Index.find(slot.m_Key));
+                    ++evicted;
+                } else {
+                    slot.m_Referenced = false;
+                }
+            }
+            return evicted;
+        }
+
+    private:
+        size_t                          m_HighMark;
+        size_t                          m_LowMark;
+        chrono::milliseconds            m_Expiration;
+        vector<unique_ptr<SShard>>      m_Shards;
+};
+
+#endif
+
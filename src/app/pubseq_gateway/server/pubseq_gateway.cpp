@@ -62,6 +62,7 @@
 #include "wgs_processor.hpp"
 #include "snp_processor.hpp"
 #include "dummy_processor.hpp"
+#include "mock_processor.hpp"
 #include "favicon.hpp"
 
 
@@ -1237,6 +1238,12 @@ void CPubseqGatewayApp::x_RegisterProcessors(void)
 {
     // Note: the order of adding defines the priority.
     //       Earleir added - higher priority
+    if (m_Settings.m_MockProcessorsEnabled) {
+        // Serves the data from local files instead of the backends; used
+        // for benchmarking without a Cassandra cluster
+        m_RequestDispatcher->AddProcessor(
+            unique_ptr<IPSGS_Processor>(new CPSGS_MockProcessor()));
+    }
     m_RequestDispatcher->AddProcessor(
         unique_ptr<IPSGS_Processor>(new CPSGS_CassProcessorDispatcher()));
     m_RequestDispatcher->AddProcessor(
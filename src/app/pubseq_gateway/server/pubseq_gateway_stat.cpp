@@ -378,6 +378,42 @@ CPSGSCounters::CPSGSCounters(const map<string, size_t> &  proc_group_to_index) :
         new SCounterInfo(
             "MyNCBIOKCacheWaitHitCount", "My NCBI OK cache hit counter when resolution is in progress",
             "Number of times a lookup in the my NCBI user info OK cache found a record in an in progress state");
+    m_Counters[ePSGS_MyNCBIOKCacheEvicted] =
+        new SCounterInfo(
+            "MyNCBIOKCacheEvictedCount", "My NCBI user info OK cache eviction counter",
+            "Number of records evicted from the my NCBI user info OK cache due to its size limit");
+    m_Counters[ePSGS_MyNCBINotFoundCacheEvicted] =
+        new SCounterInfo(
+            "MyNCBINotFoundCacheEvictedCount", "My NCBI not found cache eviction counter",
+            "Number of records evicted from the my NCBI not found cache due to its size limit");
+    m_Counters[ePSGS_MyNCBIErrorCacheEvicted] =
+        new SCounterInfo(
+            "MyNCBIErrorCacheEvictedCount", "My NCBI error cache eviction counter",
+            "Number of records evicted from the my NCBI error cache due to its size limit");
+    m_Counters[ePSGS_SplitInfoCacheMiss] =
+        new SCounterInfo(
+            "SplitInfoCacheMissCount", "Split info cache miss counter",
+            "Number of times a lookup in the split info cache found no record");
+    m_Counters[ePSGS_SplitInfoCacheHit] =
+        new SCounterInfo(
+            "SplitInfoCacheHitCount", "Split info cache hit counter",
+            "Number of times a lookup in the split info cache found a record");
+    m_Counters[ePSGS_SplitInfoCacheEvicted] =
+        new SCounterInfo(
+            "SplitInfoCacheEvictedCount", "Split info cache eviction counter",
+            "Number of records evicted from the split info cache due to its size limit");
+    m_Counters[ePSGS_ExcludeBlobCacheMiss] =
+        new SCounterInfo(
+            "ExcludeBlobCacheMissCount", "Exclude blob cache miss counter",
+            "Number of times a blob was not found in the user exclude blob cache");
+    m_Counters[ePSGS_ExcludeBlobCacheHit] =
+        new SCounterInfo(
+            "ExcludeBlobCacheHitCount", "Exclude blob cache hit counter",
+            "Number of times a blob was found in the user exclude blob cache");
+    m_Counters[ePSGS_ExcludeBlobCacheEvicted] =
+        new SCounterInfo(
+            "ExcludeBlobCacheEvictedCount", "Exclude blob cache eviction counter",
+            "Number of inactive users removed from the exclude blob cache");
     m_Counters[ePSGS_IncludeHUPSetToNo] =
         new SCounterInfo(
             "IncludeHUPSetToNo", "Include HUP set to 'no' when a blob in a secure keyspace counter",
@@ -771,7 +807,8 @@ CPSGSCounters::~CPSGSCounters()
 
 
 void CPSGSCounters::Increment(IPSGS_Processor *  processor,
-                              EPSGS_CounterType  counter)
+                              EPSGS_CounterType  counter,
+                              uint64_t  value)
 {
     if (counter >= ePSGS_LastCounter) {
         PSG_ERROR("Invalid counter id " + to_string(counter) +
@@ -790,7 +827,7 @@ void CPSGSCounters::Increment(IPSGS_Processor *  processor,
                             static_cast<size_t>(ePSGS_MaxIndividualCounter) - 1;
         size_t  proc_index = m_ProcGroupToIndex[processor->GetGroupName()];
 
-        ++(m_PerProcessorCounters[cnt_index][proc_index]->m_Value);
+        m_PerProcessorCounters[cnt_index][proc_index]->m_Value += value;
         return;
     }
 
@@ -800,7 +837,7 @@ void CPSGSCounters::Increment(IPSGS_Processor *  processor,
         return;
     }
 
-    ++(m_Counters[counter]->m_Value);
+    m_Counters[counter]->m_Value += value;
 }
 
 
@@ -127,6 +127,15 @@ class CPSGSCounters
             ePSGS_MyNCBIErrorCacheMiss,
             ePSGS_MyNCBIErrorCacheHit,
             ePSGS_MyNCBIOKCacheWaitHit,
+            ePSGS_MyNCBIOKCacheEvicted,
+            ePSGS_MyNCBINotFoundCacheEvicted,
+            ePSGS_MyNCBIErrorCacheEvicted,
+            ePSGS_SplitInfoCacheMiss,
+            ePSGS_SplitInfoCacheHit,
+            ePSGS_SplitInfoCacheEvicted,
+            ePSGS_ExcludeBlobCacheMiss,
+            ePSGS_ExcludeBlobCacheHit,
+            ePSGS_ExcludeBlobCacheEvicted,
             ePSGS_IncludeHUPSetToNo,
             ePSGS_IncomingConnectionsCounter,
             ePSGS_NewConnThrottled,
@@ -223,7 +232,8 @@ class CPSGSCounters
     }
 
     void Increment(IPSGS_Processor *  processor,
-                   EPSGS_CounterType  counter);
+                   EPSGS_CounterType  counter,
+                   uint64_t  value = 1);
     uint64_t GetValue(EPSGS_CounterType  counter);
     uint64_t GetFinishedRequestsCounter(void);
     void IncrementRequestStopCounter(int  status);
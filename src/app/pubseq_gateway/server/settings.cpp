@@ -53,6 +53,7 @@ const string            kWGSProcessorSection = "WGS_PROCESSOR";
 const string            kSNPProcessorSection = "SNP_PROCESSOR";
 const string            kCassandraProcessorSection = "CASSANDRA_PROCESSOR";
 const string            kLMDBProcessorSection = "LMDB_PROCESSOR";
+const string            kMockProcessorSection = "MOCK_PROCESSOR";
 const string            kAdminSection = "ADMIN";
 const string            kMyNCBISection = "MY_NCBI";
 const string            kCountersSection = "COUNTERS";
@@ -145,6 +146,13 @@ const double            kDefaultWGSHealthTimeoutSec = 0.0;
 const bool              kDefaultSNPProcessorsEnabled = true;
 const string            kDefaultSNPProcessorHealthCommand = "/ID/get_na?seq_id_type=12&seq_id=568801899&seq_ids=ref|NT_187403.1&names=SNP";
 const double            kDefaultSNPHealthTimeoutSec = 0.0;
+const bool              kDefaultMockProcessorsEnabled = false;
+const string            kDefaultMockDataPath = "";
+const string            kDefaultMockLatencyDistribution = "fixed";
+const double            kDefaultMockLatencyMeanMs = 0.0;
+const double            kDefaultMockLatencyStdDevMs = 0.0;
+const size_t            kDefaultMockBlobChunkSize = 32768;
+const size_t            kDefaultMockIOThreads = 4;
 const size_t            kDefaultMyNCBIOKCacheSize = 10000;
 const size_t            kDefaultMyNCBINotFoundCacheSize = 10000;
 const size_t            kDefaultMyNCBINotFoundCacheExpirationSec = 3600;
@@ -241,6 +249,16 @@ SPubseqGatewaySettings::SPubseqGatewaySettings() :
     m_SNPProcessorThrottleThreshold(0),
     m_SNPProcessorThrottleByIp(0),
     m_SNPProcessorLogTimingThreshold(kDefaultLogTimingThreshold),
+    m_MockProcessorsEnabled(kDefaultMockProcessorsEnabled),
+    m_MockDataPath(kDefaultMockDataPath),
+    m_MockLatencyDistribution(kDefaultMockLatencyDistribution),
+    m_MockLatencyMeanMs(kDefaultMockLatencyMeanMs),
+    m_MockLatencyStdDevMs(kDefaultMockLatencyStdDevMs),
+    m_MockBlobChunkSize(kDefaultMockBlobChunkSize),
+    m_MockIOThreads(kDefaultMockIOThreads),
+    m_MockProcessorThrottleThreshold(0),
+    m_MockProcessorThrottleByIp(0),
+    m_MockProcessorLogTimingThreshold(kDefaultLogTimingThreshold),
     m_MyNCBIOKCacheSize(kDefaultMyNCBIOKCacheSize),
     m_MyNCBINotFoundCacheSize(kDefaultMyNCBINotFoundCacheSize),
     m_MyNCBINotFoundCacheExpirationSec(kDefaultMyNCBINotFoundCacheExpirationSec),
@@ -298,6 +316,7 @@ void SPubseqGatewaySettings::Read(const CNcbiRegistry &   registry)
     x_ReadCDDProcessorSection(registry);        // Must be after x_ReadHealthSection() and x_ReadServerSection()
     x_ReadWGSProcessorSection(registry);        // Must be after x_ReadHealthSection() and x_ReadServerSection()
     x_ReadSNPProcessorSection(registry);        // Must be after x_ReadHealthSection() and x_ReadServerSection()
+    x_ReadMockProcessorSection(registry);       // Must be after x_ReadServerSection()
 
     x_ReadMyNCBISection(registry);
     x_ReadCountersSection(registry);
@@ -829,6 +848,37 @@ void SPubseqGatewaySettings::x_ReadSNPProcessorSection(const CNcbiRegistry &   r
 }
 
 
+void SPubseqGatewaySettings::x_ReadMockProcessorSection(const CNcbiRegistry &   registry)
+{
+    m_MockProcessorsEnabled = registry.GetBool(kMockProcessorSection,
+                                               "enabled",
+                                               kDefaultMockProcessorsEnabled);
+    m_MockDataPath = registry.GetString(kMockProcessorSection, "data_path",
+                                        kDefaultMockDataPath);
+    m_MockLatencyDistribution =
+            registry.GetString(kMockProcessorSection, "latency_distribution",
+                               kDefaultMockLatencyDistribution);
+    m_MockLatencyMeanMs =
+            registry.GetDouble(kMockProcessorSection, "latency_mean_ms",
+                               kDefaultMockLatencyMeanMs);
+    m_MockLatencyStdDevMs =
+            registry.GetDouble(kMockProcessorSection, "latency_stddev_ms",
+                               kDefaultMockLatencyStdDevMs);
+    m_MockBlobChunkSize =
+            registry.GetInt(kMockProcessorSection, "blob_chunk_size",
+                            kDefaultMockBlobChunkSize);
+    m_MockIOThreads =
+            registry.GetInt(kMockProcessorSection, "io_threads",
+                            kDefaultMockIOThreads);
+
+    x_ReadProcessorThrottleSettings(registry, "MOCK",
+                                    m_MockProcessorThrottleThreshold,
+                                    m_MockProcessorThrottleByIp);
+    x_ReadProcessorLogTimingThreshold(registry, "MOCK",
+                                      m_MockProcessorLogTimingThreshold);
+}
+
+
 void SPubseqGatewaySettings::x_ReadMyNCBISection(const CNcbiRegistry &   registry)
 {
     m_MyNCBIOKCacheSize = registry.GetInt(kMyNCBISection,
@@ -974,6 +1024,7 @@ void SPubseqGatewaySettings::Validate(CPSGAlerts &  alerts)
     x_ValidateCDDProcessorSection();
     x_ValidateWGSProcessorSection();
     x_ValidateSNPProcessorSection();
+    x_ValidateMockProcessorSection();
     x_ValidateMyNCBISection();
     x_ValidateCountersSection();
     x_ValidateLogSection();
@@ -1505,6 +1556,63 @@ void SPubseqGatewaySettings::x_ValidateWGSProcessorSection(void)
 void SPubseqGatewaySettings::x_ValidateSNPProcessorSection(void)
 { /* Nothing to validate so far */ }
 
+void SPubseqGatewaySettings::x_ValidateMockProcessorSection(void)
+{
+    if (!m_MockProcessorsEnabled)
+        return;
+
+    if (m_MockDataPath.empty()) {
+        m_CriticalErrors.push_back(
+            "The [" + kMockProcessorSection + "]/data_path value must be "
+            "not empty when the mock processor is enabled. "
+            "Disabling the mock processor.");
+        m_MockProcessorsEnabled = false;
+    }
+
+    static const vector<string>     distributions =
+        { "fixed", "uniform", "normal", "lognormal", "exponential" };
+    NStr::ToLower(m_MockLatencyDistribution);
+    if (find(distributions.begin(), distributions.end(),
+             m_MockLatencyDistribution) == distributions.end()) {
+        m_CriticalErrors.push_back(
+            "Invalid [" + kMockProcessorSection + "]/latency_distribution "
+            "value (" + m_MockLatencyDistribution + "). Allowed values are: "
+            "fixed, uniform, normal, lognormal, exponential. "
+            "Resetting to " + kDefaultMockLatencyDistribution);
+        m_MockLatencyDistribution = kDefaultMockLatencyDistribution;
+    }
+
+    if (m_MockLatencyMeanMs < 0.0) {
+        m_CriticalErrors.push_back(
+            "The [" + kMockProcessorSection + "]/latency_mean_ms value must "
+            "be >= 0. Received: " + to_string(m_MockLatencyMeanMs) +
+            ". Resetting to " + to_string(kDefaultMockLatencyMeanMs));
+        m_MockLatencyMeanMs = kDefaultMockLatencyMeanMs;
+    }
+
+    if (m_MockLatencyStdDevMs < 0.0) {
+        m_CriticalErrors.push_back(
+            "The [" + kMockProcessorSection + "]/latency_stddev_ms value must "
+            "be >= 0. Received: " + to_string(m_MockLatencyStdDevMs) +
+            ". Resetting to " + to_string(kDefaultMockLatencyStdDevMs));
+        m_MockLatencyStdDevMs = kDefaultMockLatencyStdDevMs;
+    }
+
+    if (m_MockBlobChunkSize == 0) {
+        m_CriticalErrors.push_back(
+            "The [" + kMockProcessorSection + "]/blob_chunk_size value must "
+            "be > 0. Resetting to " + to_string(kDefaultMockBlobChunkSize));
+        m_MockBlobChunkSize = kDefaultMockBlobChunkSize;
+    }
+
+    if (m_MockIOThreads == 0) {
+        m_CriticalErrors.push_back(
+            "The [" + kMockProcessorSection + "]/io_threads value must "
+            "be > 0. Resetting to " + to_string(kDefaultMockIOThreads));
+        m_MockIOThreads = kDefaultMockIOThreads;
+    }
+}
+
 void SPubseqGatewaySettings::x_ValidateMyNCBISection(void)
 {
     if (m_MyNCBIURL.empty()) {
@@ -1687,6 +1795,7 @@ SPubseqGatewaySettings::GetProcessorIPThrottlingThreshold(const string &  proces
     if (processor_id == "WGS")          return m_WGSProcessorThrottleThreshold;
     if (processor_id == "CDD")          return m_CDDProcessorThrottleThreshold;
     if (processor_id == "SNP")          return m_SNPProcessorThrottleThreshold;
+    if (processor_id == "MOCK")         return m_MockProcessorThrottleThreshold;
 
     ERR_POST("Unknown processor group identifier " + processor_id + ". Exiting.");
     exit(0);
@@ -1700,6 +1809,7 @@ SPubseqGatewaySettings::GetProcessorIPThrottlingLimit(const string &  processor_
     if (processor_id == "WGS")          return m_WGSProcessorThrottleByIp;
     if (processor_id == "CDD")          return m_CDDProcessorThrottleByIp;
     if (processor_id == "SNP")          return m_SNPProcessorThrottleByIp;
+    if (processor_id == "MOCK")         return m_MockProcessorThrottleByIp;
 
     ERR_POST("Unknown processor group identifier " + processor_id + ". Exiting.");
     exit(0);
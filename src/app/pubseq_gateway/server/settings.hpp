@@ -172,6 +172,18 @@ struct SPubseqGatewaySettings
     size_t                              m_SNPProcessorThrottleByIp;
     size_t                              m_SNPProcessorLogTimingThreshold;
 
+    // [MOCK_PROCESSOR]
+    bool                                m_MockProcessorsEnabled;
+    string                              m_MockDataPath;
+    string                              m_MockLatencyDistribution;
+    double                              m_MockLatencyMeanMs;
+    double                              m_MockLatencyStdDevMs;
+    size_t                              m_MockBlobChunkSize;
+    size_t                              m_MockIOThreads;
+    size_t                              m_MockProcessorThrottleThreshold;
+    size_t                              m_MockProcessorThrottleByIp;
+    size_t                              m_MockProcessorLogTimingThreshold;
+
     // [COUNTERS]
     // Configured counter/statistics ID to name/description
     map<string, tuple<string, string>>  m_IdToNameAndDescription;
@@ -218,6 +230,7 @@ private:
     void x_ReadCDDProcessorSection(const CNcbiRegistry &   registry);
     void x_ReadWGSProcessorSection(const CNcbiRegistry &   registry);
     void x_ReadSNPProcessorSection(const CNcbiRegistry &   registry);
+    void x_ReadMockProcessorSection(const CNcbiRegistry &   registry);
     void x_ReadMyNCBISection(const CNcbiRegistry &   registry);
     void x_ReadCountersSection(const CNcbiRegistry &   registry);
     void x_ReadLogSection(const CNcbiRegistry &   registry);
@@ -247,6 +260,7 @@ private:
     void x_ValidateCDDProcessorSection(void);
     void x_ValidateWGSProcessorSection(void);
     void x_ValidateSNPProcessorSection(void);
+    void x_ValidateMockProcessorSection(void);
     void x_ValidateMyNCBISection(void);
     void x_ValidateCountersSection(void);
     void x_ValidateLogSection(void);
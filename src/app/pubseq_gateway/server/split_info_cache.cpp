@@ -31,8 +31,8 @@
 
 #include <ncbi_pch.hpp>
 
-#include <algorithm>
 #include "split_info_cache.hpp"
+#include "pubseq_gateway.hpp"
 
 
 
@@ -40,21 +40,16 @@ optional<CRef<CID2S_Split_Info>>
 CSplitInfoCache::GetBlob(const SCass_BlobId &  info_blob_id)
 {
     optional<CRef<CID2S_Split_Info>>    ret;
-    lock_guard<mutex>                   guard(m_Lock);
-
-    auto    it = m_Cache.find(info_blob_id);
-    if (it == m_Cache.cend()) {
-        return ret;
-    }
-
-    auto lru_it = find(m_LRU.begin(), m_LRU.end(), info_blob_id);
-    if (lru_it != m_LRU.begin()) {
-        m_LRU.erase(lru_it);
-        m_LRU.push_front(info_blob_id);
+    auto &                              counters =
+                                CPubseqGatewayApp::GetInstance()->GetCounters();
+
+    if (m_Cache.Find(info_blob_id,
+                     [&ret](CRef<CID2S_Split_Info> &  blob)
+                     { ret = blob; })) {
+        counters.Increment(nullptr, CPSGSCounters::ePSGS_SplitInfoCacheHit);
+    } else {
+        counters.Increment(nullptr, CPSGSCounters::ePSGS_SplitInfoCacheMiss);
     }
-
-    it->second.m_LastTouch = psg_clock_t::now();
-    ret = it->second.m_SplitInfoBlob;
     return ret;
 }
 
@@ -63,37 +58,22 @@ void
 CSplitInfoCache::AddBlob(const SCass_BlobId &  info_blob_id,
                          CRef<CID2S_Split_Info>  blob)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    auto  find_it = m_Cache.find(info_blob_id);
-    if (find_it == m_Cache.end()) {
-        // No blob, add a new one
-        m_Cache[info_blob_id] = SSplitInfoCacheItem(blob);
-        m_LRU.emplace_front(info_blob_id);
-        return;
-    }
-
-    // It already exists
-    find_it->second.m_LastTouch = psg_clock_t::now();
-
-    auto lru_it = find(m_LRU.begin(), m_LRU.end(), info_blob_id);
-    if (lru_it != m_LRU.begin()) {
-        m_LRU.erase(lru_it);
-        m_LRU.push_front(info_blob_id);
-    }
+    // If the blob is already there then it is only marked as recently used
+    m_Cache.FindOrCreate(info_blob_id,
+                         [&blob](CRef<CID2S_Split_Info> &  cached_blob,
+                                 bool  created)
+                         {
+                            if (created)
+                                cached_blob = blob;
+                         });
 }
 
 
 void CSplitInfoCache::Maintain(void)
 {
-    lock_guard<mutex>   guard(m_Lock);
-
-    if (m_Cache.size() <= m_HighMark)
-        return;
-
-    while (m_Cache.size() > m_LowMark) {
-        m_Cache.erase(m_Cache.find(m_LRU.back()));
-        m_LRU.pop_back();
-    }
+    size_t      evicted = m_Cache.Maintain();
+    if (evicted > 0)
+        CPubseqGatewayApp::GetInstance()->GetCounters().Increment(
+                    nullptr, CPSGSCounters::ePSGS_SplitInfoCacheEvicted,
+                    evicted);
 }
-
@@ -33,39 +33,28 @@
  */
 
 
-#include <mutex>
-#include <map>
-#include <list>
 #include <optional>
 using namespace std;
 
 #include "pubseq_gateway_types.hpp"
 #include "cass_blob_id.hpp"
 #include "split_info_utils.hpp"
+#include "psgs_sharded_cache.hpp"
 #include <objects/seqsplit/seqsplit__.hpp>
 
 USING_NCBI_SCOPE;
 
 using namespace ncbi::objects;
 
-struct SSplitInfoCacheItem
-{
-    public:
-        SSplitInfoCacheItem(CRef<CID2S_Split_Info> blob) :
-            m_LastTouch(psg_clock_t::now()),
-            m_SplitInfoBlob(blob)
-        {}
-
-        SSplitInfoCacheItem()
-        {}
 
-        ~SSplitInfoCacheItem()
-        {}
-
-    public:
-        // For the future - if the cache needs to be purged
-        psg_time_point_t            m_LastTouch;
-        CRef<CID2S_Split_Info>      m_SplitInfoBlob;
+struct SCass_BlobIdHash
+{
+    size_t operator()(const SCass_BlobId &  blob_id) const
+    {
+        return hash<uint64_t>()(
+                    (static_cast<uint64_t>(blob_id.m_Sat) << 32) ^
+                    static_cast<uint32_t>(blob_id.m_SatKey));
+    }
 };
 
 
@@ -74,7 +63,7 @@ class CSplitInfoCache
 {
     public:
         CSplitInfoCache(size_t  high_mark, size_t  low_mark) :
-            m_HighMark(high_mark), m_LowMark(low_mark)
+            m_Cache(high_mark, low_mark)
         {}
 
         ~CSplitInfoCache()
@@ -88,22 +77,16 @@ class CSplitInfoCache
 
         size_t Size(void)
         {
-            size_t              size = 0;
-            lock_guard<mutex>   guard(m_Lock);
-
-            size = m_Cache.size();
-            return size;
+            return m_Cache.Size();
         }
 
         // Cleans up the cache if needed
         void Maintain(void);
 
     private:
-        size_t                                      m_HighMark;
-        size_t                                      m_LowMark;
-        map<SCass_BlobId, SSplitInfoCacheItem>      m_Cache;
-        list<SCass_BlobId>                          m_LRU;
-        mutex                                       m_Lock;
+        CPSGS_ShardedCache<SCass_BlobId,
+                           CRef<CID2S_Split_Info>,
+                           SCass_BlobIdHash>        m_Cache;
 };
 
 
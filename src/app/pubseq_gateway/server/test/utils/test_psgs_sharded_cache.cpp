@@ -0,0 +1,208 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: unit test for the PSG sharded cache
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/test_boost.hpp>
+
+#include <thread>
+#include <string>
+
+#include "../../psgs_sharded_cache.hpp"
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+// Puts a key into the shard number key % shard_count so that the tests
+// control which items share a shard
+struct SIdentityHash
+{
+    size_t operator()(size_t  key) const
+    {
+        return key;
+    }
+};
+
+typedef CPSGS_ShardedCache<size_t, int, SIdentityHash>  TIdentityCache;
+
+
+template <typename TCache, typename TKey>
+static bool s_Contains(TCache &  cache, const TKey &  key)
+{
+    return cache.Find(key, [](int &) {});
+}
+
+
+BOOST_AUTO_TEST_CASE(ClockSecondChance)
+{
+    // One shard; the eviction starts above 3 items and stops at 3
+    TIdentityCache      cache(3, 3, 0, 1);
+
+    for (size_t  key = 1; key <= 4; ++key)
+        cache.Put(key, int(key));
+    BOOST_CHECK_EQUAL(cache.Size(), 4U);
+
+    // All the items are referenced: the first turn of the hand clears the
+    // bits and the second one evicts the oldest item
+    BOOST_CHECK_EQUAL(cache.Maintain(), 1U);
+    BOOST_CHECK(!s_Contains(cache, 1U));
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+
+    // The hand now points to 2. The access gives 2 a second chance so 3
+    // is evicted instead even though 2 is older
+    int     value = 0;
+    BOOST_CHECK(cache.Find(2U, [&](int &  v) { value = v; }));
+    BOOST_CHECK_EQUAL(value, 2);
+
+    cache.Put(5U, 5);
+    BOOST_CHECK_EQUAL(cache.Maintain(), 1U);
+    BOOST_CHECK(s_Contains(cache, 2U));
+    BOOST_CHECK(!s_Contains(cache, 3U));
+    BOOST_CHECK(s_Contains(cache, 4U));
+    BOOST_CHECK(s_Contains(cache, 5U));
+}
+
+
+BOOST_AUTO_TEST_CASE(ClockKeepsPinnedItems)
+{
+    TIdentityCache      cache(2, 1, 0, 1);
+
+    for (size_t  key = 1; key <= 4; ++key)
+        cache.Put(key, int(key));
+
+    // Only the odd values may be evicted
+    size_t  evicted = cache.Maintain([](int &  v) { return v % 2 != 0; });
+    BOOST_CHECK_EQUAL(evicted, 2U);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+    BOOST_CHECK(s_Contains(cache, 2U));
+    BOOST_CHECK(s_Contains(cache, 4U));
+
+    // Below the high mark nothing is evicted
+    BOOST_CHECK_EQUAL(cache.Maintain(), 0U);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+}
+
+
+BOOST_AUTO_TEST_CASE(Expiration)
+{
+    TIdentityCache      cache(0, 0, 50, 1);
+
+    cache.Put(1U, 1);
+    cache.FindOrCreate(2U, [](int &  v, bool  created) {
+                                BOOST_CHECK(created);
+                                v = 2;
+                           });
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+
+    this_thread::sleep_for(chrono::milliseconds(100));
+
+    // A lookup removes an expired item
+    BOOST_CHECK(!s_Contains(cache, 1U));
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+
+    // An expired item is replaced by a default constructed one
+    cache.FindOrCreate(2U, [](int &  v, bool  created) {
+                                BOOST_CHECK(created);
+                                BOOST_CHECK_EQUAL(v, 0);
+                           });
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+
+    // Put restarts the expiration of an existing item
+    cache.Put(2U, 20);
+    int     value = 0;
+    BOOST_CHECK(cache.Find(2U, [&](int &  v) { value = v; }));
+    BOOST_CHECK_EQUAL(value, 20);
+}
+
+
+BOOST_AUTO_TEST_CASE(ExpiredItemsAreEvictedFirst)
+{
+    TIdentityCache      cache(2, 2, 50, 1);
+
+    cache.Put(1U, 1);
+    cache.Put(2U, 2);
+    this_thread::sleep_for(chrono::milliseconds(100));
+    cache.Put(3U, 3);
+
+    // 1 and 2 are referenced but expired; 3 is referenced and fresh, so
+    // the first turn of the hand evicts 1 and stops
+    BOOST_CHECK_EQUAL(cache.Maintain(), 1U);
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+    BOOST_CHECK(s_Contains(cache, 3U));
+}
+
+
+BOOST_AUTO_TEST_CASE(ShardsAreEvictedIndependently)
+{
+    // 4 shards; each shard is evicted down to 8 / 4 = 2 items
+    TIdentityCache      cache(4, 8, 0, 4);
+
+    // Keys 0, 4, 8, ... go to shard 0; 1, 2 and 3 go to the other shards
+    for (size_t  k = 0; k < 8; ++k)
+        cache.Put(k * 4, int(k * 4));
+    for (size_t  key = 1; key <= 3; ++key)
+        cache.Put(key, int(key));
+    BOOST_CHECK_EQUAL(cache.Size(), 11U);
+
+    BOOST_CHECK_EQUAL(cache.Maintain(), 6U);
+    BOOST_CHECK_EQUAL(cache.Size(), 5U);
+    for (size_t  key = 1; key <= 3; ++key)
+        BOOST_CHECK(s_Contains(cache, key));
+}
+
+
+BOOST_AUTO_TEST_CASE(ShardDistribution)
+{
+    // The default hash must spread the keys over all the shards: each of
+    // the 16 shards is evicted down to 160 / 16 = 10 items, so the total
+    // is exactly the low mark only if every shard got at least 10 keys
+    CPSGS_ShardedCache<string, int>     cache(100, 160);
+
+    for (int  k = 0; k < 1600; ++k)
+        cache.Put("user" + to_string(k), k);
+    BOOST_CHECK_EQUAL(cache.Size(), 1600U);
+
+    BOOST_CHECK_EQUAL(cache.Maintain(), 1600U - 160U);
+    BOOST_CHECK_EQUAL(cache.Size(), 160U);
+
+    size_t  count = 0;
+    cache.ForEach([&](const string &, int &) { ++count; });
+    BOOST_CHECK_EQUAL(count, 160U);
+
+    // Erase from all the shards
+    size_t  erased = cache.EraseAllIf([](const string &, int &  v) {
+                                          return v % 2 == 0;
+                                      });
+    BOOST_CHECK_EQUAL(erased + cache.Size(), 160U);
+    cache.ForEach([](const string &, int &  v) {
+                      BOOST_CHECK(v % 2 != 0);
+                  });
+}
@@ -2073,6 +2073,7 @@ size_t COperationTiming::x_GetLogThreshold(const string &  proc_group_name)
     if (proc_group_name == "CDD")       return settings.m_CDDProcessorLogTimingThreshold * 1000;
     if (proc_group_name == "WGS")       return settings.m_WGSProcessorLogTimingThreshold * 1000;
     if (proc_group_name == "SNP")       return settings.m_SNPProcessorLogTimingThreshold * 1000;
+    if (proc_group_name == "MOCK")      return settings.m_MockProcessorLogTimingThreshold * 1000;
 
     PSG_WARNING("No individual timing log threshold found for " + proc_group_name +
                 " processor. Server wide will be used.");
@@ -33,13 +33,106 @@
 
 #include <ncbi_pch.hpp>
 #include "connection_pool.hpp"
+#include "ncbi_socketp.h"
 #include <connect/error_codes.hpp>
+#include <connect/ncbi_buffer.h>
+
+#ifdef NCBI_OS_LINUX
+#  include <sys/epoll.h>
+#  include <errno.h>
+#  include <unistd.h>
+#endif
 
 #define NCBI_USE_ERRCODE_X   Connect_ThrServer
 
 
 BEGIN_NCBI_SCOPE
 
+
+// Max number of events taken from epoll at once
+static const int            kReactorMaxEvents = 256;
+// How long the reactor waits at most; also, how soon a listener which
+// could not be registered with epoll is retried
+static const unsigned int   kReactorSweepPeriodSec = 1;
+
+
+struct CServer_ConnectionPool::SReactor
+{
+    SReactor() :
+        epoll_fd(-1), sweep_requested(true), rearm_requested(true),
+        next_sweep(CTime::eEmpty)
+    {}
+
+    // Must be called with the lock held
+    void AddExpiration(const CTime& expiration)
+    {
+        if (!expiration.IsEmpty()  &&
+            (next_sweep.IsEmpty()  ||  expiration < next_sweep))
+            next_sweep = expiration;
+    }
+
+    ~SReactor()
+    {
+#ifdef NCBI_OS_LINUX
+        if (epoll_fd >= 0)
+            close(epoll_fd);
+#endif
+    }
+
+    int                             epoll_fd;
+    CTrigger                        trigger;    // wakes up epoll_wait()
+
+    // Filled by the other threads; protected by the lock.
+    // The pending connections have been returned to the pool and need to
+    // be looked at by the reactor: they have an alarm, data in the socket
+    // buffer, a closed socket or they are deferred
+    CFastMutex                      lock;
+    vector<TConnBase*>              pending;
+    bool                            sweep_requested;
+    bool                            rearm_requested;
+    // When the earliest of the idle connections expires (empty if none
+    // does), so that they are only scanned when one of them can expire
+    CTime                           next_sweep;
+
+    // The connections of the reactor; protected by the pool's m_Mutex.
+    // Each reactor sweeps through its own connections only
+    set<TConnBase*>                 conns;
+
+    // Used by the reactor thread only.
+    // The connections here may be deleted already so they are checked
+    // against the pool data before use
+    vector<TConnBase*>              to_process;
+    vector<TConnBase*>              deferred;
+    multimap<CTime, TConnBase*>     alarms;
+    vector<TReactorEvent>           events;
+#ifdef NCBI_OS_LINUX
+    vector<struct epoll_event>      ready;
+#endif
+};
+
+
+// Tells if there are data already read into the socket buffer; epoll
+// knows nothing about them while Poll() reports such a socket as readable
+static bool s_HasBufferedData(IServer_ConnectionBase* conn, EIO_Event events)
+{
+    if ((events & eIO_Read) == 0)
+        return false;
+
+    CSocket*    socket = dynamic_cast<CSocket*>(conn);
+    SOCK        sock = socket ? socket->GetSOCK() : NULL;
+    return sock != NULL  &&  BUF_Size(sock->r_buf) != 0;
+}
+
+
+static bool s_IsSocketClosed(IServer_ConnectionBase* conn)
+{
+    int         fd;
+    CPollable*  pollable = dynamic_cast<CPollable*>(conn);
+    return pollable == NULL  ||
+           pollable->GetOSHandle(&fd, sizeof(fd)) != eIO_Success;
+}
+
+
 std::string g_ServerConnTypeToString(enum EServerConnType  conn_type)
 {
     switch (conn_type) {
@@ -56,7 +149,8 @@ std::string g_ServerConnTypeToString(enum EServerConnType  conn_type)
 
 
 CServer_ConnectionPool::CServer_ConnectionPool(unsigned max_connections) :
-    m_MaxConnections(max_connections), m_ListeningStarted(false)
+    m_MaxConnections(max_connections), m_ListeningStarted(false),
+    m_NextReactor(0)
 {}
 
 CServer_ConnectionPool::~CServer_ConnectionPool()
@@ -77,6 +171,7 @@ void CServer_ConnectionPool::Erase(void)
         delete *it;
     }
     m_Data.clear();
+    x_DeleteReactors();
 }
 
 void CServer_ConnectionPool::x_UpdateExpiration(TConnBase* conn)
@@ -111,6 +206,11 @@ bool CServer_ConnectionPool::Add(TConnBase* conn, EServerConnType type)
         if (m_Data.find(conn) != m_Data.end())
             abort();
         m_Data.insert(conn);
+        if (!m_Reactors.empty()) {
+            conn->reactor = m_NextReactor++ %
+                            static_cast<unsigned int>(m_Reactors.size());
+            m_Reactors[conn->reactor]->conns.insert(conn);
+        }
     }}
 
     if (type == eListener)
@@ -120,7 +220,16 @@ bool CServer_ConnectionPool::Add(TConnBase* conn, EServerConnType type)
             // (e.g. in CServer::Run())
             conn->Activate();
 
-    PingControlConnection();
+    if (m_Reactors.empty()) {
+        PingControlConnection();
+    } else if (type == eListener) {
+        // The listeners are registered by the reactor sweep
+        x_RequestSweep(false);
+    } else if (type == eInactiveSocket) {
+        conn->type_lock.Lock();
+        x_ArmConnection(conn);
+        conn->type_lock.Unlock();
+    }
     return true;
 }
 
@@ -128,6 +237,11 @@ void CServer_ConnectionPool::Remove(TConnBase* conn)
 {
     CMutexGuard guard(m_Mutex);
     m_Data.erase(conn);
+    if (!m_Reactors.empty()) {
+        SReactor &  reactor = *m_Reactors[conn->reactor];
+        reactor.conns.erase(conn);
+        x_EpollRemove(reactor, conn);
+    }
 }
 
 
@@ -167,9 +281,12 @@ bool CServer_ConnectionPool::RemoveListener(unsigned short  port)
         }
     }}
 
-    if (found)
-        PingControlConnection();
-    else
+    if (found) {
+        if (m_Reactors.empty())
+            PingControlConnection();
+        else
+            x_RequestSweep(false);
+    } else
         ERR_POST(Warning << "No listener on port " << port << " found");
     return found;
 }
@@ -189,17 +306,28 @@ void CServer_ConnectionPool::SetConnType(TConnBase* conn, EServerConnType type)
                 x_UpdateExpiration(conn);
         }
         conn->type = new_type;
+
+        // A reactor does not need the poll vector to be re-read: the
+        // connection is handed over to it right away
+        if (type == eInactiveSocket  &&  !m_Reactors.empty())
+            x_ArmConnection(conn);
     }
     conn->type_lock.Unlock();
 
     // Signal poll cycle to re-read poll vector by sending
     // byte to control socket
-    if (type == eInactiveSocket)
+    if (type == eInactiveSocket  &&  m_Reactors.empty())
         PingControlConnection();
 }
 
 void CServer_ConnectionPool::PingControlConnection(void)
 {
+    if (!m_Reactors.empty()) {
+        // The poll cycle re-queries the events of all the connections
+        x_RequestSweep(true);
+        return;
+    }
+
     EIO_Status status = m_ControlTrigger.Set();
     if (status != eIO_Success) {
         ERR_POST_X(4, Warning
@@ -438,4 +566,529 @@ vector<unsigned short>  CServer_ConnectionPool::GetListenerPorts(void)
     return ports;
 }
 
+
+/////////////////////////////////////////////////////////////////////////////
+// epoll reactors
+
+bool CServer_ConnectionPool::StartReactors(unsigned int count)
+{
+#ifdef NCBI_OS_LINUX
+    _ASSERT(m_Reactors.empty()  &&  count > 0);
+
+    for (unsigned int  index = 0; index < count; ++index) {
+        unique_ptr<SReactor>    reactor(new SReactor);
+        TRIGGER                 trigger = reactor->trigger.GetTRIGGER();
+
+        reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (reactor->epoll_fd < 0  ||  trigger == NULL) {
+            ERR_POST_X(11, Critical << "Cannot create epoll reactor: "
+                       << (trigger ? strerror(errno) : "no trigger"));
+            x_DeleteReactors();
+            return false;
+        }
+
+        // The trigger is told apart from the connections by the NULL data
+        struct epoll_event  evt;
+        evt.events = EPOLLIN;
+        evt.data.ptr = NULL;
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD,
+                      trigger->fd, &evt) != 0) {
+            ERR_POST_X(14, Critical << "Cannot add trigger to epoll: "
+                       << strerror(errno));
+            x_DeleteReactors();
+            return false;
+        }
+
+        reactor->ready.resize(kReactorMaxEvents);
+        m_Reactors.push_back(reactor.release());
+    }
+
+    // Spread the connections added so far (normally the listeners only);
+    // the first sweep of each reactor registers them with epoll
+    CMutexGuard     guard(m_Mutex);
+    ITERATE(TData, it, m_Data) {
+        (*it)->reactor = m_NextReactor++ % count;
+        m_Reactors[(*it)->reactor]->conns.insert(*it);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void CServer_ConnectionPool::x_DeleteReactors(void)
+{
+    NON_CONST_ITERATE(vector<SReactor*>, it, m_Reactors) {
+        delete *it;
+    }
+    m_Reactors.clear();
+}
+
+
+void CServer_ConnectionPool::WakeUpReactors(void)
+{
+    NON_CONST_ITERATE(vector<SReactor*>, it, m_Reactors) {
+        (*it)->trigger.Set();
+    }
+}
+
+
+void CServer_ConnectionPool::x_RequestSweep(bool rearm)
+{
+    NON_CONST_ITERATE(vector<SReactor*>, it, m_Reactors) {
+        SReactor &  reactor = **it;
+
+        {{
+            CFastMutexGuard     guard(reactor.lock);
+            reactor.sweep_requested = true;
+            if (rearm)
+                reactor.rearm_requested = true;
+        }}
+        reactor.trigger.Set();
+    }
+}
+
+
+// Must be called with conn->type_lock held
+void CServer_ConnectionPool::x_ArmConnection(TConnBase* conn)
+{
+    SReactor &  reactor = *m_Reactors[conn->reactor];
+    bool        need_look = true;
+
+    if (conn->type == eInactiveSocket  &&  conn->IsOpen()) {
+        const CTime *   alarm_time = NULL;
+        EIO_Event       events = conn->GetEventsToPollFor(&alarm_time);
+
+        if (alarm_time != NULL)
+            conn->alarm = *alarm_time;
+        else
+            conn->alarm.Clear();
+
+        // A socket which cannot be armed is closed; the reactor reports
+        // it the same way Poll() does
+        if (x_EpollArm(reactor, conn, events))
+            need_look = alarm_time != NULL  ||
+                        s_HasBufferedData(conn, events);
+    }
+
+    CFastMutexGuard     guard(reactor.lock);
+    if (conn->type == eInactiveSocket)
+        reactor.AddExpiration(conn->expiration);
+    if (need_look) {
+        reactor.pending.push_back(conn);
+        guard.Release();
+        reactor.trigger.Set();
+    }
+}
+
+
+bool CServer_ConnectionPool::x_EpollArm(SReactor& reactor, TConnBase* conn,
+                                        EIO_Event events)
+{
+#ifdef NCBI_OS_LINUX
+    int         fd;
+    CPollable*  pollable = dynamic_cast<CPollable*>(conn);
+
+    _ASSERT(pollable);
+    if (pollable->GetOSHandle(&fd, sizeof(fd)) != eIO_Success)
+        return false;
+
+    struct epoll_event  evt;
+    evt.events = 0;
+    if (events & eIO_Read)
+        evt.events |= EPOLLIN | EPOLLRDHUP;
+    if (events & eIO_Write)
+        evt.events |= EPOLLOUT;
+    // The listeners stay armed. The other sockets are armed for one event
+    // so that they are not reported while they are processed, the same
+    // way they are kept out of the poll vector in the poll() mode. The
+    // readiness is checked again when a socket is re-armed, so the data
+    // left unread by the handler are reported then.
+    if (conn->type != eListener)
+        evt.events |= EPOLLONESHOT;
+    evt.data.ptr = conn;
+
+    int     op = conn->reactor_events == eIO_Open ? EPOLL_CTL_ADD
+                                                  : EPOLL_CTL_MOD;
+    if (epoll_ctl(reactor.epoll_fd, op, fd, &evt) != 0) {
+        // The kernel drops the registration if the descriptor was closed
+        // and the socket got a new one since
+        if (op != EPOLL_CTL_MOD  ||  errno != ENOENT  ||
+            epoll_ctl(reactor.epoll_fd, EPOLL_CTL_ADD, fd, &evt) != 0) {
+            ERR_POST_X(12, Error << "Cannot arm socket " << fd
+                       << " in epoll: " << strerror(errno));
+            return false;
+        }
+    }
+    conn->reactor_events = events;
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+// Keeps the socket registered but not reported; used when a connection is
+// made active by something other than its socket event
+void CServer_ConnectionPool::x_EpollDisarm(SReactor& reactor, TConnBase* conn)
+{
+#ifdef NCBI_OS_LINUX
+    int         fd;
+    CPollable*  pollable = dynamic_cast<CPollable*>(conn);
+
+    if (conn->reactor_events == eIO_Open  ||  pollable == NULL  ||
+        pollable->GetOSHandle(&fd, sizeof(fd)) != eIO_Success)
+        return;
+
+    struct epoll_event  evt;
+    evt.events = EPOLLONESHOT;
+    evt.data.ptr = conn;
+    epoll_ctl(reactor.epoll_fd, EPOLL_CTL_MOD, fd, &evt);
+#endif
+}
+
+
+void CServer_ConnectionPool::x_EpollRemove(SReactor& reactor, TConnBase* conn)
+{
+#ifdef NCBI_OS_LINUX
+    if (conn->reactor_events == eIO_Open)
+        return;
+    conn->reactor_events = eIO_Open;
+
+    // A closed socket has been removed from epoll by the kernel; its
+    // descriptor must not be used since it may belong to another socket
+    int         fd;
+    CPollable*  pollable = dynamic_cast<CPollable*>(conn);
+
+    if (pollable != NULL  &&
+        pollable->GetOSHandle(&fd, sizeof(fd)) == eIO_Success) {
+        struct epoll_event  evt;    // Ignored, for old kernels only
+        epoll_ctl(reactor.epoll_fd, EPOLL_CTL_DEL, fd, &evt);
+    }
+#endif
+}
+
+
+void CServer_ConnectionPool::x_ProcessPending(unsigned int index,
+                                              SReactor& reactor)
+{
+    {{
+        CFastMutexGuard     guard(reactor.lock);
+        reactor.to_process.swap(reactor.pending);
+    }}
+    if (reactor.to_process.empty())
+        return;
+
+    bool            sweep = false;
+    CMutexGuard     guard(m_Mutex);
+
+    ITERATE(vector<TConnBase*>, it, reactor.to_process) {
+        TConnBase *     conn = *it;
+
+        // The connection could be deleted since it was queued
+        if (m_Data.find(conn) == m_Data.end())
+            continue;
+
+        conn->type_lock.Lock();
+        switch (conn->type) {
+        case eInactiveSocket:
+            if (!conn->IsOpen()) {
+                sweep = true;
+            } else if (s_IsSocketClosed(conn)) {
+                conn->type = eActiveSocket;
+                conn->reactor_events = eIO_Open;
+                reactor.events.push_back(
+                            TReactorEvent(conn, eServIO_ClientClose));
+            } else if (s_HasBufferedData(conn, conn->reactor_events)) {
+                conn->type = eActiveSocket;
+                x_EpollDisarm(reactor, conn);
+                reactor.events.push_back(TReactorEvent(conn, eServIO_Read));
+            } else if (!conn->alarm.IsEmpty()) {
+                reactor.alarms.insert(make_pair(conn->alarm, conn));
+            }
+            break;
+        case eDeferredSocket:
+            reactor.deferred.push_back(conn);
+            break;
+        case eClosedSocket:
+            sweep = true;
+            break;
+        default:
+            // Already made active by its socket event
+            break;
+        }
+        conn->type_lock.Unlock();
+    }
+    guard.Release();
+
+    reactor.to_process.clear();
+    if (sweep) {
+        CFastMutexGuard     reactor_guard(reactor.lock);
+        reactor.sweep_requested = true;
+    }
+}
+
+
+void CServer_ConnectionPool::x_ProcessDeferred(SReactor& reactor)
+{
+    if (reactor.deferred.empty())
+        return;
+
+    size_t          kept = 0;
+    CMutexGuard     guard(m_Mutex);
+
+    for (size_t  k = 0; k < reactor.deferred.size(); ++k) {
+        TConnBase *     conn = reactor.deferred[k];
+
+        if (m_Data.find(conn) == m_Data.end())
+            continue;
+
+        conn->type_lock.Lock();
+        if (conn->type == eDeferredSocket) {
+            if (conn->IsReadyToProcess()) {
+                conn->type = eActiveSocket;
+                reactor.events.push_back(
+                    TReactorEvent(conn, IOEventToServIOEvent(
+                                            conn->GetEventsToPollFor(NULL))));
+            } else {
+                reactor.deferred[kept++] = conn;
+            }
+        }
+        conn->type_lock.Unlock();
+    }
+    reactor.deferred.resize(kept);
+}
+
+
+void CServer_ConnectionPool::x_ProcessAlarms(SReactor& reactor)
+{
+    if (reactor.alarms.empty())
+        return;
+
+    CTime   now = GetFastLocalTime();
+    if (now < reactor.alarms.begin()->first)
+        return;
+
+    CMutexGuard     guard(m_Mutex);
+    while (!reactor.alarms.empty()  &&  reactor.alarms.begin()->first <= now) {
+        TConnBase *     conn = reactor.alarms.begin()->second;
+
+        reactor.alarms.erase(reactor.alarms.begin());
+        if (m_Data.find(conn) == m_Data.end())
+            continue;
+
+        // The entry is stale if the connection has been processed since
+        // it was added
+        conn->type_lock.Lock();
+        if (conn->type == eInactiveSocket  &&  !conn->alarm.IsEmpty()  &&
+            conn->alarm <= now) {
+            conn->type = eActiveSocket;
+            conn->alarm.Clear();
+            x_EpollDisarm(reactor, conn);
+            reactor.events.push_back(TReactorEvent(conn, eServIO_Alarm));
+        }
+        conn->type_lock.Unlock();
+    }
+}
+
+
+// The reactor counterpart of GetPollAndTimerVec() for the connections of
+// one reactor: registers the listeners, removes the closed and expired
+// connections and, if requested, re-arms the idle ones
+void CServer_ConnectionPool::x_Sweep(SReactor& reactor, bool rearm)
+{
+    CTime           now = GetFastLocalTime();
+    CTime           next_sweep(CTime::eEmpty);
+
+    // The connections armed while sweeping update it themselves
+    {{
+        CFastMutexGuard     reactor_guard(reactor.lock);
+        reactor.next_sweep.Clear();
+    }}
+
+    CMutexGuard     guard(m_Mutex);
+
+    ERASE_ITERATE(set<TConnBase*>, it, reactor.conns) {
+        TConnBase *     conn_base = *it;
+
+        conn_base->type_lock.Lock();
+        EServerConnType conn_type = conn_base->type;
+
+        if (conn_type == eListener) {
+            CServer_Listener *  listener = dynamic_cast<CServer_Listener *>(
+                                                                    conn_base);
+            if (listener) {
+                vector<unsigned short>::iterator    port_it =
+                        std::find(m_ListenerPortsToStop.begin(),
+                                  m_ListenerPortsToStop.end(),
+                                  listener->GetPort());
+                if (port_it != m_ListenerPortsToStop.end()) {
+                    x_EpollRemove(reactor, conn_base);
+                    conn_base->type_lock.Unlock();
+                    m_ListenerPortsToStop.erase(port_it);
+                    m_Data.erase(conn_base);
+                    reactor.conns.erase(it);
+                    delete conn_base;
+                    continue;
+                }
+            }
+
+            // Not listening yet if it fails; it is retried soon
+            if (conn_base->reactor_events == eIO_Open  &&
+                !x_EpollArm(reactor, conn_base, eIO_Read)) {
+                CTime   retry(now);
+                retry.AddSecond(kReactorSweepPeriodSec,
+                                CTime::eIgnoreDaylight);
+                if (next_sweep.IsEmpty()  ||  retry < next_sweep)
+                    next_sweep = retry;
+            }
+        }
+        else if (conn_type == eClosedSocket
+            ||  (conn_type == eInactiveSocket  &&  !conn_base->IsOpen()))
+        {
+            x_EpollRemove(reactor, conn_base);
+            reactor.events.push_back(TReactorEvent(conn_base, eServIO_Delete));
+            m_Data.erase(conn_base);
+            reactor.conns.erase(it);
+        }
+        else if (conn_type == eInactiveSocket  &&
+                 !conn_base->expiration.IsEmpty()  &&
+                 conn_base->expiration <= now)
+        {
+            x_EpollRemove(reactor, conn_base);
+            reactor.events.push_back(TReactorEvent(conn_base,
+                                                   eServIO_Inactivity));
+            m_Data.erase(conn_base);
+            reactor.conns.erase(it);
+        }
+        else if (conn_type == eInactiveSocket)
+        {
+            if (rearm) {
+                x_ArmConnection(conn_base);
+            } else if (!conn_base->expiration.IsEmpty()  &&
+                       (next_sweep.IsEmpty()  ||
+                        conn_base->expiration < next_sweep)) {
+                next_sweep = conn_base->expiration;
+            }
+        }
+        conn_base->type_lock.Unlock();
+    }
+    guard.Release();
+
+    CFastMutexGuard     reactor_guard(reactor.lock);
+    reactor.AddExpiration(next_sweep);
+}
+
+
+EIO_Status
+CServer_ConnectionPool::WaitReactorEvents(unsigned int reactor_index,
+                                          const STimeout* timeout,
+                                          const vector<TReactorEvent>** events)
+{
+#ifdef NCBI_OS_LINUX
+    SReactor &  reactor = *m_Reactors[reactor_index];
+    bool        sweep;
+    bool        rearm;
+    CTime       now = GetFastLocalTime();
+
+    reactor.events.clear();
+    *events = &reactor.events;
+
+    x_ProcessPending(reactor_index, reactor);
+
+    {{
+        CFastMutexGuard     guard(reactor.lock);
+        sweep = reactor.sweep_requested  ||
+                (!reactor.next_sweep.IsEmpty()  &&  reactor.next_sweep <= now);
+        rearm = reactor.rearm_requested;
+        reactor.sweep_requested = false;
+        reactor.rearm_requested = false;
+    }}
+    if (sweep)
+        x_Sweep(reactor, rearm);
+
+    x_ProcessDeferred(reactor);
+
+    // Wait till the next sweep at most
+    int     wait_ms = kReactorSweepPeriodSec * 1000;
+    if (!reactor.events.empty()) {
+        wait_ms = 0;
+    } else {
+        if (timeout != kDefaultTimeout  &&  timeout != kInfiniteTimeout) {
+            unsigned int    timeout_ms = timeout->sec * 1000 +
+                                         (timeout->usec + 999) / 1000;
+            if (timeout_ms < static_cast<unsigned int>(wait_ms))
+                wait_ms = static_cast<int>(timeout_ms);
+        }
+        if (!reactor.alarms.empty()) {
+            CTimeSpan   span(reactor.alarms.begin()->first.DiffTimeSpan(
+                                                        GetFastLocalTime()));
+            if (span.GetCompleteSeconds() < 0  ||
+                span.GetNanoSecondsAfterSecond() < 0) {
+                wait_ms = 0;
+            } else if (span.GetCompleteSeconds() < wait_ms / 1000 + 1) {
+                int     alarm_ms = static_cast<int>(
+                            span.GetCompleteSeconds() * 1000 +
+                            (span.GetNanoSecondsAfterSecond() + 999999) /
+                            1000000);
+                if (alarm_ms < wait_ms)
+                    wait_ms = alarm_ms;
+            }
+        }
+    }
+
+    int     count = epoll_wait(reactor.epoll_fd, &reactor.ready[0],
+                               static_cast<int>(reactor.ready.size()),
+                               wait_ms);
+    if (count < 0) {
+        if (errno != EINTR)
+            return eIO_Unknown;
+        count = 0;
+    }
+
+    for (int  k = 0; k < count; ++k) {
+        const struct epoll_event &  evt = reactor.ready[k];
+        TConnBase *                 conn = static_cast<TConnBase*>(
+                                                            evt.data.ptr);
+        if (conn == NULL) {
+            reactor.trigger.Reset();
+            continue;
+        }
+
+        conn->type_lock.Lock();
+        if (conn->type == eListener) {
+            reactor.events.push_back(TReactorEvent(conn, eServIO_Read));
+        } else if (conn->type == eInactiveSocket) {
+            // As with Poll(), an error or a hang up is reported as the
+            // events the socket waits for
+            int     revent = 0;
+            if (evt.events & (EPOLLIN | EPOLLRDHUP))
+                revent |= eIO_Read;
+            if (evt.events & EPOLLOUT)
+                revent |= eIO_Write;
+            if (evt.events & (EPOLLERR | EPOLLHUP))
+                revent |= conn->reactor_events;
+            revent &= conn->reactor_events;
+            if (revent == 0)
+                revent = conn->reactor_events;
+
+            conn->type = eActiveSocket;
+            reactor.events.push_back(
+                TReactorEvent(conn, IOEventToServIOEvent(
+                                            static_cast<EIO_Event>(revent))));
+        }
+        // Otherwise the connection has been made active by its alarm
+        conn->type_lock.Unlock();
+    }
+
+    x_ProcessAlarms(reactor);
+    return eIO_Success;
+#else
+    *events = NULL;
+    return eIO_NotSupported;
+#endif
+}
+
+
 END_NCBI_SCOPE
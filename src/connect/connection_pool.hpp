@@ -93,9 +93,54 @@ public:
     ///  currently listened ports
     vector<unsigned short>  GetListenerPorts(void);
 
+    /// Switch the pool to the epoll based reactors which replace
+    /// GetPollAndTimerVec() and CSocketAPI::Poll(). The connections are
+    /// spread between the reactors and stay registered with epoll while
+    /// they are in the pool. A connection socket is armed for one event
+    /// at a time and it is re-armed when the connection is returned to the
+    /// pool (SetConnType(eInactiveSocket)), so a reactor wakes up for the
+    /// ready sockets only. Each reactor scans its own idle connections
+    /// only when the earliest of their inactivity timeouts is due.
+    /// Must be called before the connections are polled.
+    /// @return
+    ///  false if epoll is not available
+    bool StartReactors(unsigned int count);
+    unsigned int GetReactorCount(void) const
+    { return static_cast<unsigned int>(m_Reactors.size()); }
+
+    typedef pair<TConnBase*, EServIO_Event> TReactorEvent;
+    /// Wait for the events on the connections of the reactor. The
+    /// connections for which an event is returned are made active. The
+    /// events include everything GetPollAndTimerVec() and Poll() provide
+    /// together: the socket events, the alarms, the revived deferred
+    /// connections and the expired or closed connections which are taken
+    /// out of the pool (eServIO_Inactivity and eServIO_Delete).
+    /// Must be called from one thread per reactor.
+    /// @return
+    ///  eIO_Unknown if epoll failed (errno is set), eIO_Success otherwise
+    EIO_Status WaitReactorEvents(unsigned int reactor,
+                                 const STimeout* timeout,
+                                 const vector<TReactorEvent>** events);
+
+    /// Wake up the reactors so that they return from WaitReactorEvents()
+    void WakeUpReactors(void);
+
 private:
+    struct SReactor;
+
     void x_UpdateExpiration(TConnBase* conn);
 
+    void x_RequestSweep(bool rearm);
+    void x_ArmConnection(TConnBase* conn);
+    bool x_EpollArm(SReactor& reactor, TConnBase* conn, EIO_Event events);
+    void x_EpollDisarm(SReactor& reactor, TConnBase* conn);
+    void x_EpollRemove(SReactor& reactor, TConnBase* conn);
+    void x_ProcessPending(unsigned int index, SReactor& reactor);
+    void x_ProcessDeferred(SReactor& reactor);
+    void x_ProcessAlarms(SReactor& reactor);
+    void x_Sweep(SReactor& reactor, bool rearm);
+    void x_DeleteReactors(void);
+
 
     typedef set<TConnBase*> TData;
 
@@ -112,6 +157,12 @@ private:
     // The access to the container is protected with m_Mutex
     vector<unsigned short>  m_ListenerPortsToStop;
     bool                    m_ListeningStarted;
+
+    // The epoll reactors; empty in the poll() mode.
+    // The reactor of a new connection is chosen in a round robin manner,
+    // m_NextReactor is protected with m_Mutex
+    vector<SReactor*>       m_Reactors;
+    unsigned int            m_NextReactor;
 };
 
 
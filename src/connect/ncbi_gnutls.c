@@ -53,6 +53,20 @@
 #  include <gnutls/gnutls.h>
 #  include <gnutls/x509.h>
 
+#  if defined(NCBI_OS_LINUX)  &&  LIBGNUTLS_VERSION_NUMBER >= 0x030700
+#    include <linux/tls.h>
+#    ifdef TLS_TX
+#      include <netinet/tcp.h>
+#      define NCBI_GNUTLS_KTLS  1
+#      ifndef SOL_TLS
+#        define SOL_TLS         282
+#      endif /*!SOL_TLS*/
+#      ifndef TCP_ULP
+#        define TCP_ULP         31
+#      endif /*!TCP_ULP*/
+#    endif /*TLS_TX*/
+#  endif /*NCBI_OS_LINUX && LIBGNUTLS_VERSION_NUMBER>=3.7.0*/
+
 #  if   defined(ENOTSUP)
 #    define NCBI_NOTSUPPORTED  ENOTSUP
 #  elif defined(ENOSYS)
@@ -201,6 +215,9 @@ static gnutls_anon_client_credentials_t s_GnuTlsCredAnon;
 static gnutls_certificate_credentials_t s_GnuTlsCredCert;
 static volatile FSSLPull                s_Pull;
 static volatile FSSLPush                s_Push;
+#  ifdef NCBI_GNUTLS_KTLS
+static volatile int/*bool*/             s_GnuTlsKTls;
+#  endif /*NCBI_GNUTLS_KTLS*/
 
 
 static void x_GnuTlsLogger(int level, const char* message)
@@ -361,6 +378,324 @@ static int x_StatusToError(EIO_Status status, EIO_Event direction)
 }
 
 
+#ifdef __GNUC__
+inline
+#endif /*__GNUC__*/
+static int/*bool*/ x_IfToLog(void)
+{
+    /* NB: See the LEVEL() macros in gnutls_errors.h */
+    return 13 < s_GnuTlsLogLevel ? 1/*T*/ : 0/*F*/;
+}
+
+
+#  ifdef NCBI_GNUTLS_KTLS
+
+/* SNcbiSSLctx::offload flags */
+#    define fGnuTls_KTlsRx  1
+#    define fGnuTls_KTlsTx  2
+
+/* TLS record content types */
+#    define GNUTLS_KTLS_ALERT      21
+#    define GNUTLS_KTLS_HANDSHAKE  22
+#    define GNUTLS_KTLS_DATA       23
+
+/* TLS 1.2 handshake message that a client can safely ignore */
+#    define GNUTLS_KTLS_HELLO_REQUEST  0
+
+
+typedef union {
+    struct tls_crypto_info                     info;
+    struct tls12_crypto_info_aes_gcm_128       aes_gcm_128;
+    struct tls12_crypto_info_aes_gcm_256       aes_gcm_256;
+#    ifdef TLS_CIPHER_CHACHA20_POLY1305
+    struct tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#    endif /*TLS_CIPHER_CHACHA20_POLY1305*/
+} UGnuTlsKTlsCryptoInfo;
+
+
+/* NB: TLS 1.2 uses the record sequence number as the explicit nonce */
+#    define GNUTLS_KTLS_GCM(ci, x, seq, iv, key)                            \
+    ((key).size == sizeof((ci).x.key)  &&  (iv).size >= sizeof((ci).x.salt) \
+     ? (memcpy((ci).x.key,     (key).data, sizeof((ci).x.key)),             \
+        memcpy((ci).x.salt,    (iv).data,  sizeof((ci).x.salt)),            \
+        memcpy((ci).x.iv,      (seq),      sizeof((ci).x.iv)),              \
+        memcpy((ci).x.rec_seq, (seq),      sizeof((ci).x.rec_seq)),         \
+        sizeof((ci).x))                                                     \
+     : 0)
+
+
+/* Return the size of the crypto info filled in for the kernel, or 0 if the
+ * session parameters are not supported.  TLS 1.3 is never offloaded:  the
+ * peer may update its traffic keys (KeyUpdate) at any time, and the new keys
+ * would have to be derived by GNUTLS, which no longer sees the records. */
+static socklen_t x_GnuTlsKTlsCryptoInfo(gnutls_session_t session,
+                                        int/*bool*/ read,
+                                        UGnuTlsKTlsCryptoInfo* ci)
+{
+    gnutls_datum_t mac_key, iv, key;
+    unsigned char seq[8];
+    socklen_t len;
+
+    if (gnutls_protocol_get_version(session) != GNUTLS_TLS1_2)
+        return 0;
+    if (gnutls_record_get_state(session, read,
+                                &mac_key, &iv, &key, seq) != 0) {
+        return 0;
+    }
+
+    memset(ci, 0, sizeof(*ci));
+    switch (gnutls_cipher_get(session)) {
+    case GNUTLS_CIPHER_AES_128_GCM:
+        ci->info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        len = GNUTLS_KTLS_GCM(*ci, aes_gcm_128, seq, iv, key);
+        break;
+    case GNUTLS_CIPHER_AES_256_GCM:
+        ci->info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        len = GNUTLS_KTLS_GCM(*ci, aes_gcm_256, seq, iv, key);
+        break;
+#    ifdef TLS_CIPHER_CHACHA20_POLY1305
+    case GNUTLS_CIPHER_CHACHA20_POLY1305:
+        ci->info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+        if (key.size != sizeof(ci->chacha20_poly1305.key)
+            ||  iv.size != sizeof(ci->chacha20_poly1305.iv)) {
+            len = 0;
+            break;
+        }
+        memcpy(ci->chacha20_poly1305.key,     key.data, key.size);
+        memcpy(ci->chacha20_poly1305.iv,      iv.data,  iv.size);
+        memcpy(ci->chacha20_poly1305.rec_seq, seq,      sizeof(seq));
+        len = sizeof(ci->chacha20_poly1305);
+        break;
+#    endif /*TLS_CIPHER_CHACHA20_POLY1305*/
+    default:
+        len = 0;
+        break;
+    }
+    ci->info.version = TLS_1_2_VERSION;
+    return len;
+}
+
+
+/* Hand the established session over to the kernel.  Receiving goes first:
+ * once it is offloaded, GNUTLS never sees any incoming records (including the
+ * ones it might want to respond to), so only then sending can be offloaded,
+ * too.  Records that GNUTLS has already taken off the socket would be lost
+ * to the kernel.  Over a stream, GNUTLS pulls exactly the record header and
+ * then exactly the rest of the record (see x_GnuTlsPull(), which never reads
+ * ahead), so after the handshake it can only hold decrypted data, which
+ * gnutls_record_check_pending() accounts for;  in that case, as well as when
+ * SOCK has anything buffered, the session stays in the user space entirely.
+ * Likewise, sending is not offloaded while GNUTLS holds corked data.  Any
+ * failure leaves the respective direction in the user space. */
+static void x_GnuTlsKTlsOffload(gnutls_session_t session)
+{
+    SNcbiSSLctx* ctx = (SNcbiSSLctx*) gnutls_transport_get_ptr(session);
+    UGnuTlsKTlsCryptoInfo ci;
+    socklen_t len;
+    int fd;
+
+    assert(ctx  &&  ctx->sock  &&  !ctx->offload);
+
+    if (gnutls_record_check_pending(session) != 0
+        ||  BUF_Size(ctx->sock->r_buf) != 0) {
+        CORE_DEBUG_ARG(if (s_GnuTlsLogLevel))
+            CORE_TRACEF(("GnuTlsKTls(%p): Data pending", session));
+        return;
+    }
+
+    fd = ctx->sock->sock;
+    if (!(len = x_GnuTlsKTlsCryptoInfo(session, 1/*read*/, &ci))
+        ||  setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0
+        ||  setsockopt(fd, SOL_TLS, TLS_RX, &ci, len) != 0) {
+        CORE_DEBUG_ARG(if (s_GnuTlsLogLevel))
+            CORE_TRACEF(("GnuTlsKTls(%p): Not available", session));
+        memset(&ci, 0, sizeof(ci));
+        return;
+    }
+    ctx->offload |= fGnuTls_KTlsRx;
+
+    if (gnutls_record_check_corked(session) == 0
+        &&  (len = x_GnuTlsKTlsCryptoInfo(session, 0/*write*/, &ci)) != 0
+        &&  setsockopt(fd, SOL_TLS, TLS_TX, &ci, len) == 0) {
+        ctx->offload |= fGnuTls_KTlsTx;
+    }
+    memset(&ci, 0, sizeof(ci));
+
+    CORE_LOGF_X(36, eLOG_Trace,
+                ("GNUTLS session %p offloaded to kernel TLS (%s)", session,
+                 ctx->offload & fGnuTls_KTlsTx ? "RX/TX" : "RX only"));
+}
+
+
+/* Check that the handshake record consists of HelloRequest's only, which
+ * may be ignored (RFC 5246, 7.4.1.1), as renegotiation is not possible */
+static int/*bool*/ x_GnuTlsKTlsHelloRequests(const unsigned char* data,
+                                             size_t size)
+{
+    if (!size  ||  size % 4)
+        return 0/*false*/;
+    do {
+        if (data[0] != GNUTLS_KTLS_HELLO_REQUEST
+            ||  data[1]  ||  data[2]  ||  data[3]) {
+            return 0/*false*/;
+        }
+        data += 4;
+        size -= 4;
+    } while (size);
+    return 1/*true*/;
+}
+
+
+/* The kernel returns decrypted data of as many records as fit in "buf",
+ * while any non-data record comes alone along with its type in a control
+ * message */
+static EIO_Status x_GnuTlsKTlsRead(SNcbiSSLctx* ctx, void* buf, size_t size,
+                                   size_t* done, int* error)
+{
+    SOCK sock = ctx->sock;
+    EIO_Status status;
+
+    for (;;) {
+        char cbuf[CMSG_SPACE(sizeof(unsigned char))];
+        const unsigned char* data = (const unsigned char*) buf;
+        unsigned char type = GNUTLS_KTLS_DATA;
+        struct cmsghdr* cmsg;
+        struct msghdr msg;
+        struct iovec iov;
+        ssize_t x_read;
+
+        iov.iov_base = buf;
+        iov.iov_len  = size;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+
+        if ((x_read = recvmsg(sock->sock, &msg, 0)) < 0) {
+            int x_error = errno;
+            if (x_error == SOCK_EINTR)
+                continue;
+            if (x_error == SOCK_EWOULDBLOCK  ||  x_error == SOCK_EAGAIN) {
+                /* SOCK takes care of the timeout and of interrupts */
+                status = SOCK_WaitInternal(sock, eIO_Read);
+                if (status == eIO_Success)
+                    continue;
+                *error = x_StatusToError(status, eIO_Read);
+                if (!*error)
+                    *error = EIO;
+            } else {
+                status = x_error == SOCK_ECONNRESET  ||  x_error == EPIPE
+                    ? eIO_Closed : eIO_Unknown;
+                *error = x_error;
+            }
+            break;
+        }
+        if ((cmsg = CMSG_FIRSTHDR(&msg)) != 0
+            &&  cmsg->cmsg_level == SOL_TLS
+            &&  cmsg->cmsg_type  == TLS_GET_RECORD_TYPE) {
+            type = *((unsigned char*) CMSG_DATA(cmsg));
+        }
+
+        if (type == GNUTLS_KTLS_DATA) {
+            /* NB: EOF without close_notify is not distinguished here */
+            if (!x_read) {
+                sock->eof = 1/*true*/;
+                *done = 0;
+                *error = GNUTLS_E_PREMATURE_TERMINATION;
+                status = eIO_Closed;
+                break;
+            }
+            sock->n_read += (TNCBI_BigCount) x_read;
+            *done = (size_t) x_read;
+            status = eIO_Success;
+            break;
+        }
+        if (type == GNUTLS_KTLS_HANDSHAKE
+            &&  x_GnuTlsKTlsHelloRequests(data, (size_t) x_read)) {
+            continue;
+        }
+        if (type == GNUTLS_KTLS_ALERT  &&  x_read == 2) {
+            gnutls_alert_description_t alert
+                = (gnutls_alert_description_t) data[1];
+            if (alert == GNUTLS_A_CLOSE_NOTIFY  &&  data[0] != GNUTLS_AL_FATAL) {
+                sock->eof = 1/*true*/;
+                *done = 0;
+                *error = GNUTLS_E_APPLICATION_ERROR_MAX - alert;
+                status = eIO_Closed;
+                break;
+            }
+            status = x_AlertToStatus(alert, data[0] == GNUTLS_AL_FATAL);
+            *error = GNUTLS_E_APPLICATION_ERROR_MAX - alert;
+            break;
+        }
+        /* e.g. a renegotiation attempt, which cannot be handled here */
+        *error = GNUTLS_E_UNEXPECTED_PACKET;
+        status = eIO_Unknown;
+        break;
+    }
+
+    /* NB: a clean EOF is not a read error (same as in the plain socket) */
+    sock->r_status = status != eIO_Closed  ||  !sock->eof
+        ? status : eIO_Success;
+    return status;
+}
+
+
+static EIO_Status x_GnuTlsKTlsWrite(SNcbiSSLctx* ctx, const void* data,
+                                    size_t size, size_t* done, int* error)
+{
+    FSSLPush push = s_Push;
+    EIO_Status status;
+
+    /* The kernel splits the data into records by itself */
+    if (push) {
+        status = push(ctx->sock, data, size, done, x_IfToLog());
+        if (status == eIO_Success)
+            return status;
+    } else
+        status = eIO_NotSupported;
+
+    if (!(*error = x_StatusToError(status, eIO_Write)))
+        *error = errno ? errno : EIO;
+    return status;
+}
+
+
+/* Return 0 on success, or errno */
+static int x_GnuTlsKTlsClose(SNcbiSSLctx* ctx)
+{
+    static const unsigned char kCloseNotify[] = {
+        GNUTLS_AL_WARNING, GNUTLS_A_CLOSE_NOTIFY
+    };
+    char cbuf[CMSG_SPACE(sizeof(unsigned char))];
+    struct cmsghdr* cmsg;
+    struct msghdr msg;
+    struct iovec iov;
+
+    iov.iov_base = (void*) kCloseNotify;
+    iov.iov_len  = sizeof(kCloseNotify);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type  = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(unsigned char));
+    *((unsigned char*) CMSG_DATA(cmsg)) = GNUTLS_KTLS_ALERT;
+
+    if (sendmsg(ctx->sock->sock, &msg, MSG_NOSIGNAL)
+        != (ssize_t) sizeof(kCloseNotify)) {
+        return errno ? errno : EIO;
+    }
+    return 0;
+}
+
+#  endif /*NCBI_GNUTLS_KTLS*/
+
+
 static void* s_GnuTlsCreate(ESOCK_Side side, SNcbiSSLctx* ctx, int* error)
 {
     gnutls_connection_end_t end = (side == eSOCK_Client
@@ -478,6 +813,10 @@ static EIO_Status s_GnuTlsOpen(void* session, int* error, char** desc)
             *desc = 0;
     } else {
         status = eIO_Success;
+#  ifdef NCBI_GNUTLS_KTLS
+        if (s_GnuTlsKTls)
+            x_GnuTlsKTlsOffload((gnutls_session_t) session);
+#  endif /*NCBI_GNUTLS_KTLS*/
         if (desc) {
 #  if LIBGNUTLS_VERSION_NUMBER >= 0x030110
             char* temp = gnutls_session_get_desc((gnutls_session_t) session);
@@ -513,16 +852,6 @@ static void x_set_errno(gnutls_session_t session, int error)
 }
 
 
-#ifdef __GNUC__
-inline
-#endif /*__GNUC__*/
-static int/*bool*/ x_IfToLog(void)
-{
-    /* NB: See the LEVEL() macros in gnutls_errors.h */
-    return 13 < s_GnuTlsLogLevel ? 1/*T*/ : 0/*F*/;
-}
-
-
 static ssize_t x_GnuTlsPull(gnutls_transport_ptr_t ptr, void* buf, size_t size)
 {
     SNcbiSSLctx* ctx = (SNcbiSSLctx*) ptr;
@@ -557,6 +886,16 @@ static EIO_Status s_GnuTlsRead(void* session, void* buf,
 
     assert(session  &&  buf  &&  n_todo > 0);
 
+#  ifdef NCBI_GNUTLS_KTLS
+    {{
+        SNcbiSSLctx* ctx
+            = (SNcbiSSLctx*) gnutls_transport_get_ptr((gnutls_session_t)
+                                                      session);
+        if (ctx->offload & fGnuTls_KTlsRx)
+            return x_GnuTlsKTlsRead(ctx, buf, n_todo, n_done, error);
+    }}
+#  endif /*NCBI_GNUTLS_KTLS*/
+
 again:
     x_read = gnutls_record_recv((gnutls_session_t) session, buf, n_todo);
     assert(x_read < 0  ||  (size_t) x_read <= n_todo);
@@ -654,6 +993,16 @@ static EIO_Status s_GnuTlsWrite(void* session, const void* x_data,
 
     *n_done = 0;
 
+#  ifdef NCBI_GNUTLS_KTLS
+    {{
+        SNcbiSSLctx* ctx
+            = (SNcbiSSLctx*) gnutls_transport_get_ptr((gnutls_session_t)
+                                                      session);
+        if (ctx->offload & fGnuTls_KTlsTx)
+            return x_GnuTlsKTlsWrite(ctx, data, n_todo, n_done, error);
+    }}
+#  endif /*NCBI_GNUTLS_KTLS*/
+
     for (;;) {
         size_t x_todo = n_todo > max_size ? max_size : n_todo;
         size_t x_done;
@@ -678,6 +1027,9 @@ static EIO_Status s_GnuTlsWrite(void* session, const void* x_data,
 
 static EIO_Status s_GnuTlsClose(void* session, int how, int* error)
 {
+#  ifdef NCBI_GNUTLS_KTLS
+    SNcbiSSLctx* ctx;
+#  endif /*NCBI_GNUTLS_KTLS*/
     EIO_Status status;
     int x_error;
 
@@ -686,6 +1038,15 @@ static EIO_Status s_GnuTlsClose(void* session, int how, int* error)
     CORE_DEBUG_ARG(if (s_GnuTlsLogLevel))
         CORE_TRACEF(("GnuTlsClose(%p): Enter", session));
 
+#  ifdef NCBI_GNUTLS_KTLS
+    ctx = (SNcbiSSLctx*) gnutls_transport_get_ptr((gnutls_session_t) session);
+    /* GNUTLS cannot wait for the peer's close_notify anymore */
+    if (ctx->offload & fGnuTls_KTlsRx)
+        how = SOCK_SHUTDOWN_WR;
+    if (ctx->offload & fGnuTls_KTlsTx)
+        x_error = x_GnuTlsKTlsClose(ctx);
+    else
+#  endif /*NCBI_GNUTLS_KTLS*/
     x_error = gnutls_bye((gnutls_session_t) session,
                          how == SOCK_SHUTDOWN_RDWR
                          ? GNUTLS_SHUT_RDWR
@@ -820,6 +1181,14 @@ static EIO_Status s_GnuTlsInit(FSSLPull pull, FSSLPush push)
                                 version, s_GnuTlsLogLevel));
     }
 
+#  ifdef NCBI_GNUTLS_KTLS
+    /* Check CONN_TLS_KTLS or [CONN]TLS_KTLS */
+    val = ConnNetInfo_GetValueInternal(0, REG_CONN_TLS_KTLS,
+                                       buf, sizeof(buf),
+                                       DEF_CONN_TLS_KTLS);
+    s_GnuTlsKTls = ConnNetInfo_Boolean(val);
+#  endif /*NCBI_GNUTLS_KTLS*/
+
     CORE_DEBUG_ARG(if (s_GnuTlsLogLevel))
         CORE_TRACE("GnuTlsInit(): Go-on");
 
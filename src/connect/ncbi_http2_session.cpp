@@ -55,7 +55,7 @@ SH2S_Event<TBase>::SH2S_Event(SH2S_Event&& other) :
         case eStart: new(&m_Start) TStart(std::move(other.m_Start)); break;
         case eData:  new(&m_Data) TH2S_Data(std::move(other.m_Data)); break;
         case eEof:   break;
-        case eError: break;
+        case eError: new(&m_Error) string(std::move(other.m_Error)); break;
     }
 }
 
@@ -67,7 +67,7 @@ SH2S_Event<TBase>::~SH2S_Event()
         case eStart: m_Start.~TStart(); break;
         case eData:  m_Data.~TH2S_Data(); break;
         case eEof:   break;
-        case eError: break;
+        case eError: m_Error.~string(); break;
     }
 }
 
@@ -430,7 +430,7 @@ int SH2S_Session::OnStreamClose(nghttp2_session*, int32_t stream_id, uint32_t er
         m_StreamsByQueues.erase(response_queue);
         m_StreamsByIds.erase(stream_id);
         m_Streams.erase(it);
-        Push(response_queue, TH2S_ResponseEvent::eError);
+        PushError(response_queue, string("stream closed with ") + SUvNgHttp2_Error::NgHttp2Str(error_code));
     }
 
     return 0;
@@ -460,12 +460,14 @@ int SH2S_Session::OnHeader(nghttp2_session*, const nghttp2_frame* frame, const u
     return 0;
 }
 
-void SH2S_Session::OnReset(SUvNgHttp2_Error)
+void SH2S_Session::OnReset(SUvNgHttp2_Error error)
 {
+    const string error_str(error);
+
     for (auto& stream : m_Streams) {
         auto& response_queue = stream.response_queue;
         m_SessionsByQueues.erase(response_queue);
-        Push(response_queue, TH2S_ResponseEvent::eError);
+        PushError(response_queue, error_str);
     }
 
     m_Streams.clear();
@@ -500,12 +502,19 @@ int SH2S_Session::OnFrameRecv(nghttp2_session*, const nghttp2_frame *frame)
 }
 
 SH2S_IoCoordinator::SH2S_IoCoordinator() :
+    m_Timer(this, s_OnTimer, 0, 0),
+    m_Waiting(false),
     m_Proxy(SSocketAddress::Parse(CNcbiEnvironment().Get("HTTP_PROXY"), SSocketAddress::SHost::EName::eOriginal))
 {
+    m_Wakeup.Init(this, &m_Loop, s_OnWakeup);
+    m_Timer.Init(&m_Loop);
 }
 
 SH2S_IoCoordinator::~SH2S_IoCoordinator()
 {
+    m_Wakeup.Close();
+    m_Timer.Close();
+
     for (auto& session : m_Sessions) {
         session.second.Shutdown();
     }
@@ -514,7 +523,7 @@ SH2S_IoCoordinator::~SH2S_IoCoordinator()
     m_Sessions.clear();
 }
 
-void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue)
+void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue, uint64_t wait_ms)
 {
     m_Loop.Run(UV_RUN_NOWAIT);
 
@@ -533,6 +542,7 @@ void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue)
         auto response_queue = outgoing.response_queue;
         auto session = m_SessionsByQueues.find(response_queue);
         const bool new_request = session == m_SessionsByQueues.end();
+        const char* error = "request is not in progress";
 
         switch (outgoing.GetType()) {
             case TH2S_RequestEvent::eStart:
@@ -545,6 +555,8 @@ void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue)
                             continue;
                         }
                     }
+
+                    error = "failed to start request";
                 } else {
                     H2S_IOC_TRACE(response_queue << " pop unexpected " << outgoing);
                 }
@@ -593,12 +605,27 @@ void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue)
         // We can only report error if we still have corresponding queue
         if (auto queue = response_queue.lock()) {
             TH2S_ResponseEvent event(TH2S_ResponseEvent::eError);
+            event.GetError() = error;
             H2S_IOC_TRACE(response_queue << " push " << event);
             queue->GetLock()->emplace(std::move(event));
         }
     }
 
-    m_Loop.Run(UV_RUN_NOWAIT);
+    if (!wait_ms) {
+        m_Loop.Run(UV_RUN_NOWAIT);
+        return;
+    }
+
+    // Requests pushed after this point signal wakeup, so they cannot be missed
+    m_Waiting = true;
+
+    if (request_queue.GetLock()->empty()) {
+        m_Timer.SetRepeat(wait_ms);
+        m_Loop.Run(UV_RUN_ONCE);
+        m_Timer.Stop();
+    }
+
+    m_Waiting = false;
 }
 
 SH2S_Session* SH2S_IoCoordinator::NewSession(const SH2S_Request::SStart& request)
@@ -633,6 +660,138 @@ SH2S_Session* SH2S_IoCoordinator::NewSession(const SH2S_Request::SStart& request
     return &it->second;
 }
 
+int s_GetStatusCode(CHttpHeaders::THeaders& headers)
+{
+    int status_code = 0;
+    auto status = headers.find(":status");
+
+    if (status != headers.end()) {
+        status_code = stoi(status->second.front());
+        headers.erase(status);
+    }
+
+    return status_code;
+}
+
+void SH2S_Async::Start(TH2S_RequestEvent request, shared_ptr<TH2S_ResponseQueue> response_queue, string body,
+        CHttp2Session::TAsyncCallback callback, CDeadline deadline)
+{
+    _ASSERT(callback);
+
+    H2S_RW_TRACE(response_queue.get() << " push " << request);
+    m_Io->Push(std::move(request));
+
+    if (!body.empty()) {
+        m_Io->Push(TH2S_RequestEvent(TH2S_Data(body.begin(), body.end()), response_queue));
+    }
+
+    m_Io->Push(TH2S_RequestEvent(TH2S_RequestEvent::eEof, response_queue));
+    m_Requests.push_back({ std::move(response_queue), std::move(callback), std::move(deadline), {} });
+}
+
+size_t SH2S_Async::Poll(const CDeadline& deadline)
+{
+    // A waiting poll holds the coordinator (shared by all requests of the process),
+    // so the time slices are short. They also bound how late requests expire.
+    const uint64_t kMaxWaitMs = 10;
+
+    for (uint64_t wait_ms = 0; ; ) {
+        m_Io->coordinator.GetLock()->Process(m_Io->request_queue, wait_ms);
+
+        if (Receive() || Expire() || m_Requests.empty()) {
+            break;
+        }
+
+        if (deadline.IsInfinite()) {
+            wait_ms = kMaxWaitMs;
+        } else {
+            auto remaining = deadline.GetRemainingTime();
+
+            if (remaining.IsZero()) {
+                break;
+            }
+
+            wait_ms = min(max<uint64_t>(remaining.GetAsMilliSeconds(), 1), kMaxWaitMs);
+        }
+    }
+
+    return m_Requests.size();
+}
+
+size_t SH2S_Async::Receive()
+{
+    size_t completed = 0;
+
+    for (auto it = m_Requests.begin(); it != m_Requests.end(); ) {
+        if (!it->Receive()) {
+            ++it;
+            continue;
+        }
+
+        // Callbacks are allowed to start new requests (they are appended)
+        auto request = std::move(*it);
+        it = m_Requests.erase(it);
+        request.callback(request.response);
+        ++completed;
+    }
+
+    return completed;
+}
+
+size_t SH2S_Async::Expire()
+{
+    size_t expired = 0;
+
+    for (auto it = m_Requests.begin(); it != m_Requests.end(); ) {
+        if (!it->deadline.IsExpired()) {
+            ++it;
+            continue;
+        }
+
+        // The stream is left to the coordinator, its events are dropped along with the queue
+        auto request = std::move(*it);
+        it = m_Requests.erase(it);
+        request.response = CHttp2Session::SAsyncResponse();
+        request.response.error = "request timed out";
+        request.callback(request.response);
+        ++expired;
+    }
+
+    return expired;
+}
+
+bool SH2S_Async::SRequest::Receive()
+{
+    auto queue_locked = response_queue->GetLock();
+
+    while (!queue_locked->empty()) {
+        TH2S_ResponseEvent incoming(std::move(queue_locked->front()));
+        queue_locked->pop();
+        H2S_RW_TRACE(response_queue.get() << " pop " << incoming);
+
+        switch (incoming.GetType()) {
+            case TH2S_ResponseEvent::eStart:
+                response.headers = std::move(incoming.GetStart());
+                response.status_code = s_GetStatusCode(response.headers);
+                break;
+
+            case TH2S_ResponseEvent::eData:
+                response.body.append(incoming.GetData().begin(), incoming.GetData().end());
+                break;
+
+            case TH2S_ResponseEvent::eEof:
+                return true;
+
+            case TH2S_ResponseEvent::eError:
+                response = CHttp2Session::SAsyncResponse();
+                response.error = std::move(incoming.GetError());
+                return true;
+        }
+    }
+
+    return false;
+}
+
 CHttp2Session::CHttp2Session() :
     CHttpSession_Base(CHttpSession_Base::eHTTP_2),
     m_ApiLock(GetApiLock())
@@ -646,14 +805,7 @@ CHttp2Session::TApiLock CHttp2Session::GetApiLock()
 
 void CHttp2Session::UpdateResponse(CHttpRequest& req, CHttpHeaders::THeaders headers)
 {
-    int status_code = 0;
-    auto status = headers.find(":status");
-
-    if (status != headers.end()) {
-        status_code = stoi(status->second.front());
-        headers.erase(status);
-    }
-
+    auto status_code = s_GetStatusCode(headers);
     req.x_UpdateResponse(std::move(headers), status_code, {});
 }
 
@@ -681,6 +833,39 @@ void CHttp2Session::x_StartRequest(CHttpSession_Base::EProtocol protocol, CHttpR
     req.x_InitConnection2(std::move(stream));
 }
 
+void CHttp2Session::StartAsync(CHttpRequest& req, TAsyncCallback callback, string body)
+{
+    _ASSERT(req.m_Session.GetPointerOrNull() == this);
+
+    if (!m_Async) {
+        m_Async = make_shared<SH2S_Async>();
+    }
+
+    req.x_AdjustHeaders(false);
+
+    auto response_queue = make_shared<TH2S_ResponseQueue>();
+
+    const auto& req_cred = req.m_Credentials;
+    SUvNgHttp2_Tls::TCred cred(req_cred ? req_cred->GetCert() : string(), req_cred ? req_cred->GetPKey() : string());
+
+    TH2S_RequestEvent request(SH2S_Request::SStart(req.m_Method, req.m_Url, std::move(cred), req.m_Headers->Get()), response_queue);
+
+    // Unlike for blocking requests (where it applies to each I/O operation),
+    // the timeout limits the entire request here
+    CDeadline deadline(req.m_Timeout.IsDefault() ? CTimeout(DEF_CONN_TIMEOUT) : req.m_Timeout);
+
+    if (!req.m_Deadline.IsDefault()) {
+        deadline = min(deadline, CDeadline(req.m_Deadline));
+    }
+
+    m_Async->Start(std::move(request), std::move(response_queue), std::move(body), std::move(callback), std::move(deadline));
+}
+
+size_t CHttp2Session::Poll(const CTimeout& timeout)
+{
+    return m_Async ? m_Async->Poll(CDeadline(timeout)) : 0;
+}
+
 bool CHttp2Session::x_Downgrade(CHttpResponse& resp, CHttpSession_Base::EProtocol& protocol) const
 {
     if (resp.GetStatusCode() || (protocol <= CHttpSession_Base::eHTTP_11)) {
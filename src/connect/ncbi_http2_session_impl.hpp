@@ -35,6 +35,8 @@
 
 #include <corelib/reader_writer.hpp>
 
+#include <atomic>
+#include <list>
 #include <map>
 #include <queue>
 #include <unordered_map>
@@ -65,7 +67,10 @@ struct SH2S_Event : TBase
     SH2S_Event(TH2S_Data data, TArgs&&... args) : TBase(std::forward<TArgs>(args)...), m_Type(eData) , m_Data(std::move(data)) {}
 
     template <class ...TArgs>
-    SH2S_Event(EType type, TArgs&&... args) : TBase(std::forward<TArgs>(args)...), m_Type(type) {}
+    SH2S_Event(EType type, TArgs&&... args) : TBase(std::forward<TArgs>(args)...), m_Type(type)
+    {
+        if (m_Type == eError) new(&m_Error) string();
+    }
 
     SH2S_Event(SH2S_Event&& other);
 
@@ -75,6 +80,7 @@ struct SH2S_Event : TBase
 
     TStart&    GetStart() { _ASSERT(m_Type == eStart); return m_Start; }
     TH2S_Data& GetData()  { _ASSERT(m_Type == eData);  return m_Data;  }
+    string&    GetError() { _ASSERT(m_Type == eError); return m_Error; }
 
 private:
     const char* GetTypeName() const;
@@ -84,6 +90,7 @@ private:
     union {
         TStart m_Start;
         TH2S_Data m_Data;
+        string m_Error;
     };
 
     friend ostream& operator<<(ostream& os, const SH2S_Event& e)
@@ -209,6 +216,13 @@ private:
         }
     }
 
+    void PushError(TH2S_WeakResponseQueue& response_queue, string error)
+    {
+        TH2S_ResponseEvent event(TH2S_ResponseEvent::eError);
+        event.GetError() = std::move(error);
+        Push(response_queue, std::move(event));
+    }
+
     static ssize_t s_DataSourceRead(nghttp2_session*, int32_t,
             uint8_t* buf, size_t length, uint32_t* data_flags, nghttp2_data_source* source, void* user_data)
     {
@@ -228,12 +242,28 @@ struct SH2S_IoCoordinator
     SH2S_IoCoordinator();
     ~SH2S_IoCoordinator();
 
-    void Process(TH2S_RequestQueue& request_queue);
+    void Process(TH2S_RequestQueue& request_queue, uint64_t wait_ms = 0);
+
+    // Interrupts waiting in Process(), can be called without holding the lock
+    void Wakeup() volatile
+    {
+        auto& that = const_cast<SH2S_IoCoordinator&>(*this);
+
+        if (that.m_Waiting) {
+            that.m_Wakeup.Signal();
+        }
+    }
 
 private:
     SH2S_Session* NewSession(const SH2S_Request::SStart& request);
 
+    static void s_OnWakeup(uv_async_t*) {}
+    static void s_OnTimer(uv_timer_t*) {}
+
     SUv_Loop m_Loop;
+    SUv_Async m_Wakeup;
+    SUv_Timer m_Timer;
+    atomic_bool m_Waiting;
     multimap<SH2S_Session::TAddrNCred, SUvNgHttp2_Session<SH2S_Session>> m_Sessions;
     TH2S_SessionsByQueues m_SessionsByQueues;
     SSocketAddress m_Proxy;
@@ -244,6 +274,12 @@ struct SH2S_Io
     TH2S_RequestQueue request_queue;
     SThreadSafe<SH2S_IoCoordinator> coordinator;
 
+    void Push(TH2S_RequestEvent event)
+    {
+        request_queue.GetLock()->emplace(std::move(event));
+        coordinator->Wakeup();
+    }
+
     static shared_ptr<SH2S_Io> GetInstance()
     {
         static pair<mutex, weak_ptr<SH2S_Io>> io;
@@ -293,10 +329,15 @@ private:
     void Push(TH2S_RequestEvent event)
     {
         H2S_RW_TRACE(m_ResponseQueue.get() << " push " << event);
-        m_Io->request_queue.GetLock()->emplace(std::move(event));
+        m_Io->Push(std::move(event));
     }
 
-    void Process() { m_Io->coordinator.GetLock()->Process(m_Io->request_queue); }
+    void Process()
+    {
+        // Asynchronous requests may be waiting in the coordinator, make them release it
+        m_Io->coordinator->Wakeup();
+        m_Io->coordinator.GetLock()->Process(m_Io->request_queue);
+    }
 
     shared_ptr<SH2S_Io> m_Io;
     TUpdateResponse m_UpdateResponse;
@@ -306,6 +347,32 @@ private:
     EState m_State = eWriting;
 };
 
+struct SH2S_Async
+{
+    SH2S_Async() : m_Io(SH2S_Io::GetInstance()) {}
+
+    void Start(TH2S_RequestEvent request, shared_ptr<TH2S_ResponseQueue> response_queue, string body,
+            CHttp2Session::TAsyncCallback callback, CDeadline deadline);
+    size_t Poll(const CDeadline& deadline);
+
+private:
+    struct SRequest
+    {
+        shared_ptr<TH2S_ResponseQueue> response_queue;
+        CHttp2Session::TAsyncCallback callback;
+        CDeadline deadline;
+        CHttp2Session::SAsyncResponse response;
+
+        bool Receive();
+    };
+
+    size_t Receive();
+    size_t Expire();
+
+    shared_ptr<SH2S_Io> m_Io;
+    list<SRequest> m_Requests;
+};
+
 
 END_NCBI_SCOPE
 
@@ -94,7 +94,7 @@ extern "C" {
  * C++ sources (in C++ Toolkit) see include/connect/error_codes.hpp.
  */
 NCBI_C_DEFINE_ERRCODE_X(Connect_Conn,          301,  37);
-NCBI_C_DEFINE_ERRCODE_X(Connect_Socket,        302, 166);
+NCBI_C_DEFINE_ERRCODE_X(Connect_Socket,        302, 171);
 NCBI_C_DEFINE_ERRCODE_X(Connect_Util,          303,  15);
 NCBI_C_DEFINE_ERRCODE_X(Connect_LBSM,          304,  96);
 NCBI_C_DEFINE_ERRCODE_X(Connect_FTP,           305,  14);
@@ -0,0 +1,518 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Process-wide cache of service resolutions.
+ *
+ *   Cached server lists are read-mostly:  once published, an entry does not
+ *   change (but for its "refreshing" mark), and it only gets replaced as a
+ *   whole (and freed) under the write lock.  So opening an iterator off the
+ *   cache only takes the (shared) read lock to copy the servers out, and it
+ *   never gets to the actual service mappers.  Entries get re-resolved ahead
+ *   of their expiration, by the first iterator that notices it is time to,
+ *   when that iterator is closed, so other iterators keep using the
+ *   current entry in the meantime.
+ *
+ */
+
+#include "ncbi_ansi_ext.h"
+#include "ncbi_lb.h"
+#include "ncbi_priv.h"
+#include "ncbi_servcache.h"
+#include "ncbi_socketp.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Statistics counters that are bumped outside the write lock */
+#ifdef __GNUC__
+#  define x_Inc(c)  ((void) __sync_fetch_and_add(&(c), 1))
+#else
+#  define x_Inc(c)  ((void) ++(c))  /* best effort */
+#endif /*__GNUC__*/
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+    static SSERV_Info* s_GetNextInfo(SERV_ITER, HOST_INFO*);
+    static void        s_Close      (SERV_ITER);
+
+    static const SSERV_VTable s_op = {
+        s_GetNextInfo, 0/*Feedback*/, 0/*Update*/, 0/*Reset*/, s_Close, 0
+    };
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /*__cplusplus*/
+
+
+struct SSERV_CacheEntry {
+    struct SSERV_CacheEntry* next;
+    const char*              key;
+    const SSERV_VTable*      op;        /* the actual mapper                 */
+    TNCBI_Time               expires;
+    TNCBI_Time               refresh;   /* time to start re-resolution       */
+    int/*bool*/           refreshing;   /* re-resolution is under way        */
+    size_t                   n_info;
+    SSERV_Info*              info[1];   /* NB: times are relative            */
+};
+
+
+struct SCACHE_Data {
+    SSERV_VTable       op;      /* "s_op" with the actual mapper name        */
+    char*              key;
+    SSERV_CacheQuery   query;   /* to re-resolve with, if "resolve" is set   */
+    FSERV_CacheResolve resolve;
+    TNCBI_Time         ttl;
+    SLB_Candidate*     cand;
+    size_t             n_cand;
+    size_t             n_info;
+    SSERV_Info*        info[1];
+};
+
+
+/* Protected by CORE_LOCK */
+static struct SSERV_CacheEntry* s_Cache = 0;
+static SSERV_CacheStats         s_Stats = { 0 };
+
+
+static void x_FreeEntry(struct SSERV_CacheEntry* entry)
+{
+    size_t n;
+    for (n = 0;  n < entry->n_info;  ++n)
+        free(entry->info[n]);
+    free(entry);
+}
+
+
+static struct SSERV_CacheEntry* x_FindEntry(const char* key)
+{
+    struct SSERV_CacheEntry* entry;
+    for (entry = s_Cache;  entry;  entry = entry->next) {
+        if (strcasecmp(entry->key, key) == 0)
+            break;
+    }
+    return entry;
+}
+
+
+/* Replace the entry with the same key (if any), and drop all expired ones */
+static void x_Publish(struct SSERV_CacheEntry* entry)
+{
+    struct SSERV_CacheEntry *temp, **prev, *drop = 0;
+    TNCBI_Time now = (TNCBI_Time) time(0);
+
+    CORE_LOCK_WRITE;
+    prev = &s_Cache;
+    while ((temp = *prev) != 0) {
+        if (temp->expires <= now  ||  strcasecmp(temp->key, entry->key) == 0) {
+            *prev = temp->next;
+            temp->next = drop;
+            drop = temp;
+        } else
+            prev = &temp->next;
+    }
+    entry->next = s_Cache;
+    s_Cache = entry;
+    CORE_UNLOCK;
+
+    /* nobody can get to these anymore */
+    while ((temp = drop) != 0) {
+        drop = temp->next;
+        x_FreeEntry(temp);
+    }
+}
+
+
+static struct SSERV_CacheEntry* x_Resolve(const char*             key,
+                                          TNCBI_Time              ttl,
+                                          const SSERV_CacheQuery* query,
+                                          FSERV_CacheResolve      resolve)
+{
+    size_t keylen = strlen(key) + 1, n_info = 0, n;
+    struct SSERV_CacheEntry* entry = 0;
+    struct timeval start, stop;
+    const SSERV_VTable* op;
+    SSERV_Info** info = 0;
+    TNCBI_Time now;
+    double latency;
+
+    gettimeofday(&start, 0);
+    op = resolve(query, &info, &n_info);
+    gettimeofday(&stop, 0);
+    now = (TNCBI_Time) stop.tv_sec;
+    latency = (double)(stop.tv_sec  - start.tv_sec)
+        +     (double)(stop.tv_usec - start.tv_usec) / 1000000.0;
+
+    if (op) {
+        n = n_info ? n_info : 1;
+        entry = (struct SSERV_CacheEntry*)
+            malloc(sizeof(*entry) + (n - 1) * sizeof(entry->info) + keylen);
+    }
+    if (entry) {
+        entry->next       = 0;
+        entry->key        = (const char*) memcpy(&entry->info[n], key, keylen);
+        entry->op         = op;
+        entry->expires    = now + ttl;
+        entry->refresh    = now + ttl - ttl / 4;
+        entry->refreshing = 0/*false*/;
+        entry->n_info     = n_info;
+        for (n = 0;  n < n_info;  ++n) {
+            SSERV_Info* temp = info[n];
+            if (temp->time  &&  temp->time != NCBI_TIME_INFINITE)
+                temp->time = temp->time > now ? temp->time - now : 1;
+            entry->info[n] = temp;
+        }
+    } else {
+        for (n = 0;  n < n_info;  ++n)
+            free(info[n]);
+    }
+    if (info)
+        free(info);
+
+    CORE_LOCK_WRITE;
+    s_Stats.resolutions++;
+    s_Stats.latency += latency;
+    if (s_Stats.max_latency < latency)
+        s_Stats.max_latency = latency;
+    CORE_UNLOCK;
+
+    CORE_TRACEF(("[%s]  Service %sresolved in %.6fs: %lu server(s) cached",
+                 query->service, entry ? "" : "not ", latency,
+                 (unsigned long) n_info));
+    return entry;
+}
+
+
+/* Copy the servers out of the entry (which may not change meanwhile) */
+static struct SCACHE_Data* x_NewData(const struct SSERV_CacheEntry* entry)
+{
+    size_t n = entry->n_info ? entry->n_info : 1;
+    struct SCACHE_Data* data = (struct SCACHE_Data*)
+        calloc(1, sizeof(*data) + (n - 1) * sizeof(data->info));
+    if (!data)
+        return 0;
+    if (!(data->cand = (SLB_Candidate*) malloc(n * sizeof(*data->cand)))) {
+        free(data);
+        return 0;
+    }
+    for (n = 0;  n < entry->n_info;  ++n) {
+        const SSERV_Info* temp = entry->info[n];
+        if (!(data->info[n] = SERV_CopyInfoEx(temp, SERV_NameOfInfo(temp))))
+            break;
+        data->n_info++;
+    }
+    if (n < entry->n_info) {
+        while (n)
+            free(data->info[--n]);
+        free(data->cand);
+        free(data);
+        return 0;
+    }
+    data->op        = s_op;
+    data->op.mapper = entry->op->mapper;
+    return data;
+}
+
+
+static void x_FreeData(struct SCACHE_Data* data)
+{
+    size_t n;
+    for (n = 0;  n < data->n_info;  ++n)
+        free(data->info[n]);
+    if (data->query.service)
+        free((void*) data->query.service);
+    if (data->query.net_info)
+        ConnNetInfo_Destroy((SConnNetInfo*) data->query.net_info);
+    if (data->key)
+        free(data->key);
+    free(data->cand);
+    free(data);
+}
+
+
+static char* x_Key(SERV_ITER iter)
+{
+    char   buf[40];
+    char*  key;
+    size_t len;
+
+    len = (size_t) sprintf(buf, "%04X/%X ", (unsigned int) iter->types,
+                           (iter->ok_down       << 0) |
+                           (iter->ok_standby    << 1) |
+                           (iter->ok_reserved   << 2) |
+                           (iter->ok_suppressed << 3) |
+                           (iter->ok_private    << 4) |
+                           (iter->external      << 5));
+    if (!(key = (char*) malloc(len + strlen(iter->name)
+                               + iter->arglen + iter->vallen + 3))) {
+        return 0;
+    }
+    sprintf(key, "%s%s %.*s=%.*s", buf, iter->name,
+            (int) iter->arglen, iter->arg ? iter->arg : "",
+            (int) iter->vallen, iter->val ? iter->val : "");
+    return key;
+}
+
+
+static int/*bool*/ x_Skip(SERV_ITER iter, const SSERV_Info* info)
+{
+    size_t n;
+    for (n = 0;  n < iter->n_skip;  ++n) {
+        if (SERV_EqualInfo(iter->skip[n], info))
+            return 1/*true*/;
+    }
+    return 0/*false*/;
+}
+
+
+/* Rank servers as the mappers return them:  active ones first, then
+ * standby, then those that are down (and only returned if asked for) */
+static int x_Rank(const SSERV_Info* info)
+{
+    return info->rate > 0.0 ? 2 : info->rate < 0.0 ? 1 : 0;
+}
+
+
+static SLB_Candidate* s_GetCandidate(void* user_data, size_t i)
+{
+    struct SCACHE_Data* data = (struct SCACHE_Data*) user_data;
+    return i < data->n_cand ? &data->cand[i] : 0;
+}
+
+
+static SSERV_Info* s_GetNextInfo(SERV_ITER iter, HOST_INFO* host_info)
+{
+    struct SCACHE_Data* data = (struct SCACHE_Data*) iter->data;
+    SSERV_Info* info;
+    int rank = -1;
+    size_t n;
+
+    assert(data);
+    data->n_cand = 0;
+    for (n = 0;  n < data->n_info;  ++n) {
+        const SSERV_Info* temp = data->info[n];
+        int x_rank;
+        if (x_Skip(iter, temp))
+            continue;
+        if ((x_rank = x_Rank(temp)) < rank)
+            continue;
+        if (x_rank > rank) {
+            data->n_cand = 0;
+            rank = x_rank;
+        }
+        data->cand[data->n_cand].info   = temp;
+        data->cand[data->n_cand].status = temp->rate < 0.0
+            ? -temp->rate : temp->rate;
+        data->n_cand++;
+    }
+    if (!data->n_cand)
+        return 0;
+
+    n = LB_Select(iter, data, s_GetCandidate, 1.0);
+    if ((info = SERV_CopyInfoEx(data->cand[n].info,
+                                SERV_NameOfInfo(data->cand[n].info))) != 0
+        &&  info->time  &&  info->time != NCBI_TIME_INFINITE) {
+        info->time += iter->time;
+    }
+    if (host_info)
+        *host_info = 0;
+    return info;
+}
+
+
+static void s_Close(SERV_ITER iter)
+{
+    struct SCACHE_Data* data = (struct SCACHE_Data*) iter->data;
+    assert(data);
+    iter->data = 0;
+    if (data->resolve) {
+        /* this iterator has taken it upon itself to refresh the entry */
+        struct SSERV_CacheEntry* entry
+            = x_Resolve(data->key, data->ttl, &data->query, data->resolve);
+        if (entry) {
+            x_Inc(s_Stats.refreshes);
+            x_Publish(entry);
+        } else {
+            /* let some other iterator try that again */
+            CORE_LOCK_WRITE;
+            if ((entry = x_FindEntry(data->key)) != 0)
+                entry->refreshing = 0/*false*/;
+            CORE_UNLOCK;
+        }
+    }
+    x_FreeData(data);
+}
+
+
+/* Elect the iterator to refresh the entry, unless someone else already is */
+static int/*bool*/ x_Elect(SERV_ITER               iter,
+                           const SSERV_CacheQuery* query,
+                           FSERV_CacheResolve      resolve)
+{
+    struct SCACHE_Data* data = (struct SCACHE_Data*) iter->data;
+    struct SSERV_CacheEntry* entry;
+    int/*bool*/ elected = 0/*false*/;
+
+    assert(!data->resolve);
+    if (!(data->query.service = strdup(query->service)))
+        return 0/*false*/;
+    if (query->net_info
+        &&  !(data->query.net_info = ConnNetInfo_Clone(query->net_info))) {
+        return 0/*false*/;
+    }
+    CORE_LOCK_WRITE;
+    if ((entry = x_FindEntry(data->key)) != 0
+        &&  !entry->refreshing  &&  entry->refresh <= iter->time) {
+        entry->refreshing = 1/*true*/;
+        elected = 1/*true*/;
+    }
+    CORE_UNLOCK;
+    if (elected) {
+        data->query.types    = query->types;
+        data->query.external = query->external;
+        data->query.arg      = query->arg;
+        data->query.val      = query->val;
+        data->resolve        = resolve;
+    }
+    return elected;
+}
+
+
+/***********************************************************************
+ *  INTERNAL
+ ***********************************************************************/
+
+TNCBI_Time SERV_CACHE_TTL(const char* svc)
+{
+    unsigned long ttl;
+    char val[40];
+    char* end;
+
+    if (!ConnNetInfo_GetValueInternal(svc, REG_CONN_SERVICE_CACHE,
+                                      val, sizeof(val), 0)  ||  !*val) {
+        return 0;
+    }
+    errno = 0;
+    ttl = strtoul(val, &end, 10);
+    if (errno  ||  *end  ||  ttl > 24 * 60 * 60) {
+        CORE_LOGF(eLOG_Warning,
+                  ("[%s]  Bad service cache time-to-live \"%s\" ignored",
+                   svc, val));
+        return 0;
+    }
+    return (TNCBI_Time) ttl;
+}
+
+
+const SSERV_VTable* SERV_CACHE_Open(SERV_ITER               iter,
+                                    TNCBI_Time              ttl,
+                                    const SSERV_CacheQuery* query,
+                                    FSERV_CacheResolve      resolve,
+                                    SSERV_Info**            info,
+                                    int/*bool*/*            failed)
+{
+    struct SSERV_CacheEntry* entry;
+    struct SCACHE_Data* data = 0;
+    int/*bool*/ refresh = 0/*false*/;
+    int/*bool*/ cached = 0/*false*/;
+    char* key;
+
+    assert(iter  &&  !iter->data  &&  !iter->op  &&  ttl);
+    *failed = 0/*false*/;
+    if (!(key = x_Key(iter)))
+        return 0;
+
+    CORE_LOCK_READ;
+    if ((entry = x_FindEntry(key)) != 0  &&  entry->expires > iter->time) {
+        cached = 1/*true*/;
+        if (!entry->op->Update) {
+            data = x_NewData(entry);
+            refresh = !entry->refreshing  &&  entry->refresh <= iter->time;
+        }
+    }
+    CORE_UNLOCK;
+
+    if (!cached) {
+        x_Inc(s_Stats.misses);
+        if (!(entry = x_Resolve(key, ttl, query, resolve))) {
+            *failed = 1/*true*/;
+            free(key);
+            return 0;
+        }
+        /* not published yet, so cannot change */
+        if (!entry->op->Update)
+            data = x_NewData(entry);
+        x_Publish(entry);
+    } else if (data)
+        x_Inc(s_Stats.hits);
+
+    if (!data) {
+        /* NB: mappers that need updates (DISPD) are not cacheable */
+        free(key);
+        return 0;
+    }
+    data->key = key;
+    iter->data = data;
+    if (refresh  &&  x_Elect(iter, query, resolve))
+        data->ttl = ttl;
+
+    /* call GetNextInfo() subsequently if info is actually needed */
+    if (info)
+        *info = 0;
+    return &data->op;
+}
+
+
+/***********************************************************************
+ *  EXTERNAL
+ ***********************************************************************/
+
+extern void SERV_GetCacheStats(SSERV_CacheStats* stats)
+{
+    if (!stats)
+        return;
+    CORE_LOCK_READ;
+    *stats = s_Stats;
+    CORE_UNLOCK;
+}
+
+
+extern void SERV_FlushCache(void)
+{
+    struct SSERV_CacheEntry* entry;
+
+    CORE_LOCK_WRITE;
+    entry = s_Cache;
+    s_Cache = 0;
+    memset(&s_Stats, 0, sizeof(s_Stats));
+    CORE_UNLOCK;
+
+    while (entry) {
+        struct SSERV_CacheEntry* next = entry->next;
+        x_FreeEntry(entry);
+        entry = next;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef CONNECT___NCBI_SERVCACHE__H
+#define CONNECT___NCBI_SERVCACHE__H
+
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Process-wide cache of service resolutions:  whole server lists, as
+ *   obtained from the actual service mappers, are kept for a configured
+ *   time-to-live, and the iterators are then served off the cached copies.
+ *
+ */
+
+#include "ncbi_servicep.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Parameters of the original SERV_Open*() call, needed to (re-)resolve
+ * the service through the actual mappers.
+ */
+typedef struct {
+    const char*         service;
+    TSERV_Type          types;
+    const SConnNetInfo* net_info;
+    int/*bool*/         external;
+    const char*         arg;
+    const char*         val;
+} SSERV_CacheQuery;
+
+
+/* Resolve the service bypassing the cache:  store all servers found in a
+ * malloc()'ed array of malloc()'ed infos ("*info", "*n_info"), and return
+ * the virtual table of the mapper that has found them (0 on error).
+ */
+typedef const SSERV_VTable* (*FSERV_CacheResolve)
+(const SSERV_CacheQuery* query,
+ SSERV_Info***           info,
+ size_t*                 n_info
+ );
+
+
+/* Return the time-to-live (seconds) of the cached resolutions of the
+ * service;  0 if the service is not to be cached.
+ */
+TNCBI_Time SERV_CACHE_TTL(const char* svc);
+
+
+/* Open the iterator off the cached server list (resolving the service
+ * with "resolve" if it has not been cached yet, or has expired).
+ * Return 0 if the service can not be served from the cache, and set
+ * "*failed" if that is because the service could not be resolved at all.
+ * NOTE:  The iterator reports the name of the actual mapper.
+ */
+const SSERV_VTable* SERV_CACHE_Open(SERV_ITER               iter,
+                                    TNCBI_Time              ttl,
+                                    const SSERV_CacheQuery* query,
+                                    FSERV_CacheResolve      resolve,
+                                    SSERV_Info**            info,
+                                    int/*bool*/*            failed);
+
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* CONNECT___NCBI_SERVCACHE__H */
@@ -33,6 +33,7 @@
 #include "ncbi_ansi_ext.h"
 #include "ncbi_dispd.h"
 #include "ncbi_local.h"
+#include "ncbi_servcache.h"
 #ifdef NCBI_OS_UNIX
 #  include "ncbi_lbsmd.h"
 #endif /*NCBI_OS_UNIX*/
@@ -1046,6 +1047,11 @@ int/*bool*/ SERV_IsMapperConfiguredInternal(const char* svc, const char* key)
 }
 
 
+static const SSERV_VTable* s_Resolve(const SSERV_CacheQuery* query,
+                                     SSERV_Info***           info,
+                                     size_t*                 n_info);
+
+
 static SERV_ITER x_Open(const char*         service,
                         int/*bool*/         ismask,
                         TSERV_Type          types,
@@ -1059,7 +1065,8 @@ static SERV_ITER x_Open(const char*         service,
                         const char*         arg,
                         const char*         val,
                         SSERV_Info**        info,
-                        HOST_INFO*          host_info)
+                        HOST_INFO*          host_info,
+                        int/*bool*/         cache)
 {
     int exact = s_Fast;
     int/*bool*/
@@ -1081,6 +1088,7 @@ static SERV_ITER x_Open(const char*         service,
     const SSERV_VTable* op;
     ESERV_Type type;
     SERV_ITER iter;
+    TNCBI_Time ttl;
     char* url;
 
     if ( host_info )
@@ -1350,6 +1358,28 @@ static SERV_ITER x_Open(const char*         service,
         svc = 0;
     }
 
+    /* Cached resolutions (whole server lists, not for reverse DNS lookups,
+     * and not when LBSMD host information is required) */
+    if (cache  &&  svc  &&  !s_Fast  &&  !iter->reverse_dns  &&  !host_info
+        &&  (ttl = SERV_CACHE_TTL(svc)) != 0) {
+        SSERV_CacheQuery query;
+        int/*bool*/ failed;
+        query.service  = service;
+        query.types    = types;
+        query.net_info = net_info;
+        query.external = external;
+        query.arg      = arg;
+        query.val      = val;
+        if ((op = SERV_CACHE_Open(iter, ttl, &query, s_Resolve,
+                                  info, &failed)) != 0) {
+            goto done;
+        }
+        if (failed) {
+            SERV_Close(iter);
+            return 0;
+        }
+    }
+
     /* Ugly optimization not to access the registry more than necessary */
     if ((!(do_local  = s_IsMapperConfigured(svc, REG_CONN_LOCAL_ENABLE))   ||
          !(op = SERV_LOCAL_Open(iter, info)))
@@ -1740,6 +1770,63 @@ static SSERV_Info* s_GetNextInfo(SERV_ITER   iter,
 }
 
 
+/* Resolve the service (bypassing the cache) into the full list of servers */
+static const SSERV_VTable* s_Resolve(const SSERV_CacheQuery* query,
+                                     SSERV_Info***           info,
+                                     size_t*                 n_info)
+{
+    const SSERV_VTable* op;
+    SSERV_InfoCPtr temp;
+    size_t n, a_info;
+    SERV_ITER iter;
+
+    *info = 0;
+    *n_info = 0;
+    iter = x_Open(query->service, 0/*not mask*/, query->types,
+                  0/*preferred_host*/, 0/*preferred_port*/, 0.0/*preference*/,
+                  query->net_info, 0/*skip*/, 0/*n_skip*/,
+                  query->external, query->arg, query->val,
+                  0/*info*/, 0/*host_info*/, 0/*no cache*/);
+    if (!iter)
+        return 0;
+    op = iter->op;
+    a_info = 0;
+    /* NB: mappers that need updates (DISPD) are not drained (nor cached) */
+    while (!op->Update  &&  (temp = s_GetNextInfo(iter, 0, 0)) != 0) {
+        SSERV_Info* copy;
+        if (*n_info == a_info) {
+            SSERV_Info** x_info;
+            n = a_info + 10;
+            x_info = (SSERV_Info**)
+                (*info
+                 ? realloc(*info, n * sizeof(**info))
+                 : malloc (       n * sizeof(**info)));
+            if (!x_info) {
+                op = 0;
+                break;
+            }
+            *info = x_info;
+            a_info = n;
+        }
+        if (!(copy = SERV_CopyInfoEx(temp, SERV_NameOfInfo(temp)))) {
+            op = 0;
+            break;
+        }
+        (*info)[(*n_info)++] = copy;
+    }
+    SERV_Close(iter);
+    if (!op) {
+        for (n = 0;  n < *n_info;  ++n)
+            free((*info)[n]);
+        if (*info)
+            free(*info);
+        *info = 0;
+        *n_info = 0;
+    }
+    return op;
+}
+
+
 static SERV_ITER s_Open(const char*         service,
                         int/*bool*/         ismask,
                         TSERV_Type          types,
@@ -1760,7 +1847,7 @@ static SERV_ITER s_Open(const char*         service,
                             preferred_host, preferred_port, preference,
                             net_info, skip, n_skip,
                             external, arg, val,
-                            &x_info, host_info);
+                            &x_info, host_info, 1/*cache*/);
     assert(!iter  ||  iter->op);
     if (!iter)
         x_info = 0;
@@ -132,12 +132,14 @@
 #    include <sys/resource.h>
 #  endif /*HAVE_SYS_RESOURCE_H*/
 #  include <sys/stat.h>
+#  include <sys/uio.h>
 #  include <sys/un.h>
 #endif /*NCBI_OS_UNIX*/
 
 /* Portable standard C headers
  */
 #include <ctype.h>
+#include <limits.h>
 #include <stdlib.h>
 
 #define NCBI_USE_ERRCODE_X   Connect_Socket
@@ -3846,6 +3848,34 @@ static EIO_Status s_Read_(SOCK    sock,
 }
 
 
+/* Report an I/O error to the error hook (if any is installed) */
+static void x_ErrorCallbackIO(SOCK       sock,
+                              EIO_Event  event,
+                              EIO_Status status)
+{
+    SSOCK_ErrInfo info;
+    char          addr[SOCK_ADDRSTRLEN];
+
+    assert(s_ErrHook  &&  status != eIO_Success);
+
+    memset(&info, 0, sizeof(info));
+    info.type = eSOCK_ErrIO;
+    info.sock = sock;
+    if (sock->port) {
+        s_AddrToString(addr, sizeof(addr), &sock->addr, s_IPVersion, 0);
+        info.host =       addr;
+        info.port = sock->port;
+    }
+#ifdef NCBI_OS_UNIX
+    else
+        info.host = sock->path;
+#endif /*NCBI_OS_UNIX*/
+    info.event = event;
+    info.status = status;
+    s_ErrorCallback(&info);
+}
+
+
 static EIO_Status s_Read(SOCK    sock,
                          void*   buf,
                          size_t  size,
@@ -3853,25 +3883,8 @@ static EIO_Status s_Read(SOCK    sock,
                          int     peek)
 {
     EIO_Status status = s_Read_(sock, buf, size, n_read, peek);
-    if (s_ErrHook  &&  status != eIO_Success  &&  status != eIO_Closed) {
-        SSOCK_ErrInfo info;
-        char          addr[SOCK_ADDRSTRLEN];
-        memset(&info, 0, sizeof(info));
-        info.type = eSOCK_ErrIO;
-        info.sock = sock;
-        if (sock->port) {
-            s_AddrToString(addr, sizeof(addr), &sock->addr, s_IPVersion, 0);
-            info.host =       addr;
-            info.port = sock->port;
-        }
-#ifdef NCBI_OS_UNIX
-        else
-            info.host = sock->path;
-#endif /*NCBI_OS_UNIX*/
-        info.event = eIO_Read;
-        info.status = status;
-        s_ErrorCallback(&info);
-    }
+    if (s_ErrHook  &&  status != eIO_Success  &&  status != eIO_Closed)
+        x_ErrorCallbackIO(sock, eIO_Read, status);
     assert(*n_read <= size);
     return status;
 }
@@ -4475,26 +4488,253 @@ static EIO_Status s_Write(SOCK        sock,
                           int/*bool*/ oob)
 {
     EIO_Status status = s_Write_(sock, data, size, n_written, oob);
-    if (s_ErrHook  &&  status != eIO_Success) {
-        SSOCK_ErrInfo info;
-        char          addr[SOCK_ADDRSTRLEN];
-        memset(&info, 0, sizeof(info));
-        info.type = eSOCK_ErrIO;
-        info.sock = sock;
-        if (sock->port) {
-            s_AddrToString(addr, sizeof(addr), &sock->addr, s_IPVersion, 0);
-            info.host =       addr;
-            info.port = sock->port;
+    if (s_ErrHook  &&  status != eIO_Success)
+        x_ErrorCallbackIO(sock, eIO_Write, status);
+    assert(*n_written <= size);
+    return status;
+}
+
+
+#if defined(NCBI_OS_UNIX)  &&  !defined(SOCK_SEND_SLICE)
+
+/* Max # of I/O vector segments to pass to a single sendmsg() */
+#  if defined(IOV_MAX)  &&  IOV_MAX < 64
+#    define SOCK_SENDV_MAX  IOV_MAX
+#  else
+#    define SOCK_SENDV_MAX  64
+#  endif
+
+/* Gathering version of s_Send():  write the I/O vector (less its first "skip"
+ * bytes) with a single sendmsg(), as many bytes at once as possible.
+ * Return eIO_Success iff at least some bytes have been written successfully.
+ * Otherwise (nothing written), return an error code to indicate the problem.
+ * NOTE: This call is for plain (not secure) stream sockets only.
+ */
+static EIO_Status s_SendV(SOCK               sock,
+                          const SSOCK_IOVec* iov,
+                          size_t             n_iov,
+                          size_t             skip,
+                          size_t*            n_written)
+{
+    struct iovec  vec[SOCK_SENDV_MAX];
+    struct msghdr msg;
+    int/*bool*/   writeable;
+    size_t        n;
+    char          _id[MAXIDLEN];
+
+    assert(sock->type == eSOCK_Socket  &&  !sock->sslctx  &&  !*n_written);
+    assert(n_iov  &&  skip < iov->size);
+
+    if (sock->w_status == eIO_Closed)
+        return eIO_Closed;
+
+    for (n = 0;  n < n_iov  &&  n < SOCK_SENDV_MAX;  ++n) {
+        vec[n].iov_base = (char*) iov[n].data + skip;
+        vec[n].iov_len  =         iov[n].size - skip;
+        skip = 0;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = vec;
+    msg.msg_iovlen = n;
+
+    /* write to the socket */
+    writeable = 0/*false*/;
+    for (;;) { /* optionally auto-resume if interrupted */
+        int error = 0;
+
+        ssize_t x_written = sendmsg(sock->sock, &msg, 0
+#ifdef MSG_NOSIGNAL
+                                    | (s_AllowSigPipe ? 0 : MSG_NOSIGNAL)
+#endif /*MSG_NOSIGNAL*/
+                                    );
+
+        if (x_written >= 0  ||
+            (x_written < 0  &&  ((error = SOCK_ERRNO) == SOCK_EPIPE         ||
+                                 error                == SOCK_ENOTCONN      ||
+                                 error                == SOCK_ETIMEDOUT     ||
+                                 error                == SOCK_ENETRESET     ||
+                                 error                == SOCK_ECONNRESET    ||
+                                 error                == SOCK_ECONNABORTED))) {
+            /* statistics & logging */
+            if (x_written <= 0) {
+                if (sock->log != eOff) {
+                    s_DoLog(sock->n_read  &&  sock->n_written
+                            ? eLOG_Error : eLOG_Trace, sock, eIO_Write,
+                            (void*) &error, 0, 0);
+                }
+            } else if (sock->log == eOn
+                       ||  (sock->log == eDefault  &&  s_Log == eOn)) {
+                size_t left = (size_t) x_written;
+                for (n = 0;  left;  ++n) {
+                    size_t len = vec[n].iov_len < left ? vec[n].iov_len : left;
+                    if (len) {
+                        s_DoLog(eLOG_Note, sock, eIO_Write,
+                                vec[n].iov_base, len, 0);
+                    }
+                    left -= len;
+                }
+            }
+
+            if (x_written > 0) {
+                sock->n_written += (TNCBI_BigCount) x_written;
+                *n_written       = (size_t)         x_written;
+                sock->w_status = eIO_Success;
+                break/*success*/;
+            }
+            if (x_written < 0) {
+                if (error != SOCK_EPIPE  &&  error != SOCK_ENOTCONN)
+                    sock->r_status = eIO_Closed;
+                sock->w_status = eIO_Closed;
+                break/*closed*/;
+            }
+        }
+
+        if (!x_written)
+            return eIO_Unknown;
+
+        /* blocked -- retry if unblocked before the timeout expires
+         * (use stall protection if specified) */
+        if (error == SOCK_EWOULDBLOCK  ||  error == SOCK_EAGAIN) {
+            SSOCK_Poll poll;
+            EIO_Status status;
+
+            if (sock->w_tv_set  &&  !(sock->w_tv.tv_sec | sock->w_tv.tv_usec)){
+                sock->w_status = eIO_Timeout;
+                break/*timeout*/;
+            }
+            if (writeable) {
+                CORE_TRACEF(("%s[SOCK::SendV] "
+                             " Spurious false indication of write-ready",
+                             s_ID(sock, _id)));
+            }
+            poll.sock   = sock;
+            poll.event  = eIO_Write;
+            poll.revent = eIO_Open;
+            /* stall protection:  try pulling incoming data from the socket */
+            status = s_SelectStallsafe(1, &poll, SOCK_GET_TIMEOUT(sock, w), 0);
+            assert(poll.event == eIO_Write);
+            if (status == eIO_Timeout) {
+                sock->w_status = eIO_Timeout;
+                break/*timeout*/;
+            }
+            if (status != eIO_Success)
+                return status;
+            if (poll.revent == eIO_Close)
+                return eIO_Unknown;
+            assert(poll.revent == eIO_Write);
+            writeable = 1/*true*/;
+            continue/*try to write again*/;
+        }
+
+        if (error != SOCK_EINTR) {
+            const char* strerr = SOCK_STRERROR(error);
+            CORE_LOGF_ERRNO_EXX(167, eLOG_Trace,
+                                error, strerr ? strerr : "",
+                                ("%s[SOCK::SendV] "
+                                 " Failed sendmsg()",
+                                 s_ID(sock, _id)));
+            UTIL_ReleaseBuffer(strerr);
+            /* don't want to handle all possible errors...
+               let them be "unknown" */
+            sock->w_status = eIO_Unknown;
+            break/*unknown*/;
+        }
+
+        if (x_IsInterruptibleSOCK(sock)) {
+            sock->w_status = eIO_Interrupt;
+            break/*interrupt*/;
         }
-#ifdef NCBI_OS_UNIX
-        else
-            info.host = sock->path;
-#endif /*NCBI_OS_UNIX*/
-        info.event = eIO_Write;
-        info.status = status;
-        s_ErrorCallback(&info);
     }
-    assert(*n_written <= size);
+
+    return (EIO_Status) sock->w_status;
+}
+
+#endif /*NCBI_OS_UNIX && !SOCK_SEND_SLICE*/
+
+
+/* Write the I/O vector (less its first "skip" bytes) to the socket.  Plain
+ * stream sockets get the entire vector in a single system call (whenever
+ * possible);  otherwise, the segments get written one after another, and only
+ * the first write may wait for the socket to become writable.  Return
+ * eIO_Success if some data have been written.  Return other (error) code only
+ * if nothing at all can be written.
+ */
+static EIO_Status s_WriteV_(SOCK               sock,
+                            const SSOCK_IOVec* iov,
+                            size_t             n_iov,
+                            size_t             skip,
+                            size_t*            n_written)
+{
+    unsigned int wtv_set;
+    struct timeval wtv;
+    EIO_Status status;
+
+    assert(sock->type & eSOCK_Socket);
+
+    /* skip the segments that have already been written */
+    while (n_iov  &&  skip >= iov->size) {
+        skip -= iov->size;
+        --n_iov;
+        ++iov;
+    }
+    assert(n_iov);
+
+    *n_written = 0;
+#if defined(NCBI_OS_UNIX)  &&  !defined(SOCK_SEND_SLICE)
+    if (sock->type == eSOCK_Socket  &&  !sock->sslctx) {
+        if (sock->w_status == eIO_Closed) {
+            char _id[MAXIDLEN];
+            CORE_TRACEF(("%s[SOCK::WriteV] "
+                         " Socket already shut down for writing",
+                         s_ID(sock, _id)));
+            return eIO_Closed;
+        }
+        status = s_WritePending(sock, SOCK_GET_TIMEOUT(sock, w), 0, 0);
+        if (status != eIO_Success)
+            return status;
+        assert(!sock->pending  &&  !sock->w_len);
+        /* pending connect() may have turned the socket secure */
+        if (!sock->sslctx)
+            return s_SendV(sock, iov, n_iov, skip, n_written);
+    }
+#endif /*NCBI_OS_UNIX && !SOCK_SEND_SLICE*/
+
+    status = eIO_Success;
+    wtv_set = 2;
+    for ( ;  n_iov;  --n_iov, ++iov, skip = 0) {
+        size_t x_written, x_size = iov->size - skip;
+        if (!x_size)
+            continue;
+        status = s_Write_(sock, (const char*) iov->data + skip, x_size,
+                          &x_written, 0);
+        *n_written += x_written;
+        if (status != eIO_Success  ||  x_written < x_size)
+            break;
+        if (sock->type == eSOCK_Datagram  ||  !(wtv_set & 2))
+            continue;
+        /* do not wait on the remaining segments */
+        if ((wtv_set = sock->w_tv_set) != 0)
+            wtv = sock->w_tv;
+        /*zero timeout*/
+        sock->w_tv_set = 1;
+        memset(&sock->w_tv, 0, sizeof(sock->w_tv));
+    }
+    if (!(wtv_set & 2)  &&  (sock->w_tv_set = wtv_set & 1) != 0)
+        x_tvcpy(&sock->w_tv, &wtv);
+
+    return *n_written ? eIO_Success : status;
+}
+
+
+static EIO_Status s_WriteV(SOCK               sock,
+                           const SSOCK_IOVec* iov,
+                           size_t             n_iov,
+                           size_t             skip,
+                           size_t*            n_written)
+{
+    EIO_Status status = s_WriteV_(sock, iov, n_iov, skip, n_written);
+    if (s_ErrHook  &&  status != eIO_Success)
+        x_ErrorCallbackIO(sock, eIO_Write, status);
     return status;
 }
 
@@ -8126,6 +8366,83 @@ extern EIO_Status SOCK_Read(SOCK           sock,
 }
 
 
+extern EIO_Status SOCK_ReadV(SOCK               sock,
+                             const SSOCK_IOVec* iov,
+                             size_t             n_iov,
+                             size_t*            n_read,
+                             EIO_ReadMethod     how)
+{
+    EIO_Status status;
+    size_t     x_read, size, i;
+    char       _id[MAXIDLEN];
+
+    for (size = i = 0;  i < n_iov;  ++i) {
+        if (iov[i].size  &&  !iov[i].data)
+            break;
+        size += iov[i].size;
+    }
+    if ((n_iov  &&  !iov)  ||  i < n_iov) {
+        if ( n_read )
+            *n_read = 0;
+        assert(0);
+        return eIO_InvalidArg;
+    }
+    x_read = 0;
+    if (sock->sock != SOCK_INVALID) {
+        switch (how) {
+        case eIO_ReadPlain:
+        case eIO_ReadPersist:
+            if (!size) {
+                status = s_Read(sock, 0, 0, &x_read, 0/*read*/);
+                break;
+            }
+            for (i = 0;  i < n_iov;  ++i) {
+                char*  x_buf  = (char*) iov[i].data;
+                size_t x_size = iov[i].size;
+                if (!x_size)
+                    continue;
+                /* plain read waits for the first segment only, and the
+                 * rest is filled from what has already been read ahead */
+                if (how == eIO_ReadPlain  &&  x_read
+                    &&  !BUF_Size(sock->r_buf)) {
+                    break;
+                }
+                do {
+                    size_t xx_read;
+                    status = s_Read(sock, x_buf,
+                                    x_size, &xx_read, 0/*read*/);
+                    x_read += xx_read;
+                    x_buf  += xx_read;
+                    x_size -= xx_read;
+                } while (how == eIO_ReadPersist
+                         &&  x_size  &&  status == eIO_Success);
+                if (x_size  ||  status != eIO_Success)
+                    break;
+            }
+            break;
+
+        default:
+            CORE_LOGF_X(170, eLOG_Error,
+                        ("%s[SOCK::ReadV] "
+                         " Unsupported read method #%u",
+                         s_ID(sock, _id), (unsigned int) how));
+            status = eIO_NotSupported;
+            break;
+        }
+    } else {
+        CORE_LOGF_X(171, eLOG_Error,
+                    ("%s[SOCK::ReadV] "
+                     " Invalid socket",
+                     s_ID(sock, _id)));
+        status = eIO_Unknown;
+    }
+
+    if ( n_read )
+        *n_read = x_read;
+    return status;
+}
+
+
 #define s_Pushback(s, d, n)  BUF_Pushback(&(s)->r_buf, d, n)
 
 
@@ -8361,6 +8678,69 @@ extern EIO_Status SOCK_Write(SOCK            sock,
 }
 
 
+extern EIO_Status SOCK_WriteV(SOCK               sock,
+                              const SSOCK_IOVec* iov,
+                              size_t             n_iov,
+                              size_t*            n_written,
+                              EIO_WriteMethod    how)
+{
+    EIO_Status status;
+    size_t     x_written, size, i;
+    char       _id[MAXIDLEN];
+
+    for (size = i = 0;  i < n_iov;  ++i) {
+        if (iov[i].size  &&  !iov[i].data)
+            break;
+        size += iov[i].size;
+    }
+    if ((n_iov  &&  !iov)  ||  i < n_iov) {
+        if ( n_written )
+            *n_written = 0;
+        assert(0);
+        return eIO_InvalidArg;
+    }
+    if (sock->sock != SOCK_INVALID) {
+        switch (how) {
+        case eIO_WritePlain:
+        case eIO_WritePersist:
+            if (!size) {
+                status = s_Write(sock, 0, 0, &x_written, 0);
+                break;
+            }
+            x_written = 0;
+            do {
+                size_t xx_written;
+                status = s_WriteV(sock, iov, n_iov, x_written, &xx_written);
+                x_written += xx_written;
+            } while (how == eIO_WritePersist
+                     &&  x_written < size  &&  status == eIO_Success);
+            break;
+
+        default:
+            /* NB: no OOB for I/O vectors */
+            CORE_LOGF_X(168, eLOG_Error,
+                        ("%s[SOCK::WriteV] "
+                         " Unsupported write method #%u",
+                         s_ID(sock, _id), (unsigned int) how));
+            status = eIO_NotSupported;
+            x_written = 0;
+            break;
+        }
+    } else {
+        CORE_LOGF_X(169, eLOG_Error,
+                    ("%s[SOCK::WriteV] "
+                     " Invalid socket",
+                     s_ID(sock, _id)));
+        status = eIO_Closed;
+        x_written = 0;
+    }
+
+    if ( n_written )
+        *n_written = x_written;
+    return status;
+}
+
+
 extern EIO_Status SOCK_Abort(SOCK sock)
 {
     char _id[MAXIDLEN];
@@ -9994,6 +10374,27 @@ extern EIO_Status SOCK_SetupSSLEx(FSSLSetup setup)
 }
 
 
+EIO_Status SOCK_WaitInternal(SOCK sock, EIO_Event event)
+{
+    SSOCK_Poll poll;
+    EIO_Status status;
+
+    assert(sock->type == eSOCK_Socket);
+    assert(event == eIO_Read  ||  event == eIO_Write);
+
+    poll.sock   = sock;
+    poll.event  = event;
+    poll.revent = eIO_Open;
+    status = s_Select(1, &poll, event == eIO_Read
+                      ? SOCK_GET_TIMEOUT(sock, r)
+                      : SOCK_GET_TIMEOUT(sock, w), 1/*asis*/);
+    assert(poll.event == event);
+    if (status == eIO_Success  &&  poll.revent == eIO_Close)
+        status  = eIO_Unknown;
+    return status;
+}
+
+
 extern const char* SOCK_SSLName(void)
 {
     return !s_SSLSetup ? 0 : !s_SSL ? "" : s_SSL->Name;
@@ -390,6 +390,19 @@ EIO_Status CSocket::Read(void*          buf,
 }
 
 
+EIO_Status CSocket::ReadV(const SSOCK_IOVec* iov,
+                          size_t             n_iov,
+                          size_t*            n_read,
+                          EIO_ReadMethod     how)
+{
+    if ( m_Socket )
+        return SOCK_ReadV(m_Socket, iov, n_iov, n_read, how);
+    if ( n_read )
+        *n_read = 0;
+    return eIO_Closed;
+}
+
+
 EIO_Status CSocket::ReadLine(string& str)
 {
     str.clear();
@@ -421,6 +434,19 @@ EIO_Status CSocket::Write(const void*     buf,
 }
 
 
+EIO_Status CSocket::WriteV(const SSOCK_IOVec* iov,
+                           size_t             n_iov,
+                           size_t*            n_written,
+                           EIO_WriteMethod    how)
+{
+    if ( m_Socket )
+        return SOCK_WriteV(m_Socket, iov, n_iov, n_written, how);
+    if ( n_written )
+        *n_written = 0;
+    return eIO_Closed;
+}
+
+
 void CSocket::GetPeerAddress(unsigned int*   host,
                              unsigned short* port,
                              ENH_ByteOrder   byte_order) const
@@ -149,6 +149,7 @@ typedef struct {
     SOCK        sock;           /* sock that the above session handle using  */
     NCBI_CRED   cred;           /* secure session credential(s), 0 if none   */
     const char* host;           /* hostname for named SSL extension (SNI)    */
+    unsigned    offload;        /* provider-specific offload flags (kTLS)    */
 } SNcbiSSLctx;
 
 
@@ -393,6 +394,13 @@ void SOCK_SetupSSLInternal(FSSLSetup setup, int/*bool*/ init);
 EIO_Status SOCK_SetupSSLInternalEx(FSSLSetup setup, int/*bool*/ init);
 
 
+/* Wait on the socket itself (for the SSL provider that does I/O directly):
+ * unlike SOCK_Wait(), data already buffered in SOCK are not considered, and
+ * the socket's own timeout for the direction gets used (as well as its
+ * interrupt-on-signal setting). */
+EIO_Status SOCK_WaitInternal(SOCK sock, EIO_Event event);
+
+
 #ifdef NCBI_OS_MSWIN
 /* Utility */
 
@@ -49,6 +49,11 @@ NCBI_PARAM_DEF_EX(bool, server, Catch_Unhandled_Exceptions, true, 0,
 typedef NCBI_PARAM_TYPE(server, Catch_Unhandled_Exceptions) TParamServerCatchExceptions;
 static CSafeStatic<TParamServerCatchExceptions> s_ServerCatchExceptions;
 
+NCBI_PARAM_DECL(unsigned int, server, Reactor_Threads);
+NCBI_PARAM_DEF_EX(unsigned int, server, Reactor_Threads, 0, 0,
+                  CSERVER_REACTOR_THREADS);
+typedef NCBI_PARAM_TYPE(server, Reactor_Threads) TParamServerReactorThreads;
+
 
 class ILogCandidate : public CStdRequest
 {
@@ -699,7 +704,8 @@ void CServer::SetParameters(const SServer_Parameters& new_params)
 {
     if (new_params.init_threads <= 0  ||
         new_params.max_threads  < new_params.init_threads  ||
-        new_params.max_threads > 1000) {
+        new_params.max_threads > 1000  ||
+        new_params.reactor_threads > 64) {
         NCBI_THROW(CServer_Exception, eBadParameters,
                    "CServer::SetParameters: Bad parameters");
     }
@@ -739,6 +745,15 @@ void CServer::x_DoRun(void)
 
     Init();
 
+    if (m_Parameters->reactor_threads > 0) {
+        if (m_ConnectionPool->StartReactors(m_Parameters->reactor_threads)) {
+            x_DoRunReactors();
+            return;
+        }
+        ERR_POST_X(15, Warning << "epoll reactors are not available, "
+                   "falling back to poll()");
+    }
+
     vector<CSocketAPI::SPoll> polls;
     size_t     count;
     typedef vector<IServer_ConnectionBase*> TConnsList;
@@ -849,6 +864,131 @@ void CServer::x_DoRun(void)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CServer_ReactorThread -- runs a reactor other than the first one which is
+// run by the thread that called CServer::Run()
+class CServer_ReactorThread : public CThread
+{
+public:
+    CServer_ReactorThread(CServer& server, unsigned int reactor)
+        : m_Server(server), m_Reactor(reactor), m_StopRequested(false)
+    { }
+
+    void RequestStop(void) { m_StopRequested = true; }
+
+protected:
+    virtual void* Main(void);
+
+private:
+    CServer&            m_Server;
+    unsigned int        m_Reactor;
+    atomic<bool>        m_StopRequested;
+};
+
+
+void* CServer_ReactorThread::Main(void)
+{
+    while (!m_StopRequested) {
+        try {
+            m_Server.x_ProcessReactorEvents(m_Reactor, kInfiniteTimeout);
+        } STD_CATCH_ALL_X(13, "CServer_ReactorThread::Main");
+    }
+    return NULL;
+}
+
+
+// Waits for the events of the reactor and submits the requests for them;
+// returns true if there was anything to do
+bool CServer::x_ProcessReactorEvents(unsigned int reactor,
+                                     const STimeout* timeout)
+{
+    typedef CServer_ConnectionPool::TReactorEvent   TReactorEvent;
+
+    const vector<TReactorEvent> *   events = NULL;
+    EIO_Status  status = m_ConnectionPool->WaitReactorEvents(reactor,
+                                                             timeout,
+                                                             &events);
+    if (status != eIO_Success) {
+        int     x_errno = errno;
+        ERR_POST_X(16, Critical << "Reactor " << reactor
+                   << " wait failed with status " << IO_StatusStr(status)
+                   << (x_errno ? ", {" + NStr::IntToString(x_errno) + '}'
+                               : kEmptyStr));
+        return false;
+    }
+
+    ITERATE(vector<TReactorEvent>, it, *events) {
+        CRef<CStdRequest> req(it->first->CreateRequest(
+                                            it->second, *m_ConnectionPool,
+                                            m_Parameters->idle_timeout));
+        m_ThreadPool->AcceptRequest(req);
+    }
+    return !events->empty();
+}
+
+
+void CServer::x_DoRunReactors(void)
+{
+    typedef vector< CRef<CServer_ReactorThread> >   TReactorThreads;
+    TReactorThreads     threads;
+
+    for (unsigned int  reactor = 1;
+         reactor < m_ConnectionPool->GetReactorCount(); ++reactor) {
+        threads.push_back(CRef<CServer_ReactorThread>(
+                                    new CServer_ReactorThread(*this, reactor)));
+        threads.back()->Run();
+    }
+
+    auto stop_threads = [&]() {
+        NON_CONST_ITERATE(TReactorThreads, it, threads) {
+            (*it)->RequestStop();
+        }
+        m_ConnectionPool->WakeUpReactors();
+        NON_CONST_ITERATE(TReactorThreads, it, threads) {
+            (*it)->Join();
+        }
+    };
+
+    // The first reactor runs here so that ShutdownRequested() and
+    // ProcessTimeout() are called from this thread as in the poll() mode
+    const STimeout *    accept_timeout = m_Parameters->accept_timeout;
+    bool                has_accept_timeout =
+                                accept_timeout != kDefaultTimeout  &&
+                                accept_timeout != kInfiniteTimeout;
+    double              idle_limit = has_accept_timeout
+                                ? accept_timeout->sec +
+                                  accept_timeout->usec / 1000000.0
+                                : 0.0;
+    CStopWatch          idle(CStopWatch::eStart);
+
+    try {
+        while (!ShutdownRequested()) {
+            const STimeout *    timeout = kInfiniteTimeout;
+            STimeout            left;
+
+            if (has_accept_timeout) {
+                double  elapsed = idle.Elapsed();
+                if (elapsed >= idle_limit) {
+                    ProcessTimeout();
+                    idle.Restart();
+                    elapsed = 0.0;
+                }
+                NcbiMsToTimeout(&left, static_cast<unsigned long>(
+                                        (idle_limit - elapsed) * 1000.0));
+                timeout = &left;
+            }
+
+            if (x_ProcessReactorEvents(0, timeout))
+                idle.Restart();
+        }
+    } catch (...) {
+        stop_threads();
+        throw;
+    }
+    stop_threads();
+}
+
+
 void CServer::Run(void)
 {
     StartListening(); // detect unavailable ports ASAP
@@ -943,7 +1083,8 @@ SServer_Parameters::SServer_Parameters() :
     idle_timeout(&k_DefaultIdleTimeout),
     init_threads(5),
     max_threads(10),
-    spawn_threshold(1)
+    spawn_threshold(1),
+    reactor_threads(TParamServerReactorThreads::GetDefault())
 { }
 
 
@@ -458,6 +458,35 @@ CNetServer::SExecResult SNetCacheAPIImpl::ExecMirrorAware(
     return primary_server.ExecWithRetry(cmd, multiline_output);
 }
 
+bool SNetCacheAPIImpl::GetDirectServer(const CNetCacheKey& key,
+        const CNetCacheAPIParameters* parameters, CNetServer& server)
+{
+    if (key.GetVersion() == 3)
+        return false;
+
+    const string& key_service_name = key.GetServiceName();
+
+    CNetService service(m_Service);
+
+    if (!key_service_name.empty() &&
+            key_service_name != service.GetServiceName()) {
+        if (!m_ServiceMap.IsAllowed(key_service_name))
+            return false;
+
+        service = m_ServiceMap.GetServiceByName(key_service_name, m_Service);
+    }
+
+    server = service.GetServer(key.GetHost(), key.GetPort());
+
+    ESwitch server_check = eDefault;
+    parameters->GetServerCheck(&server_check);
+    if (server_check == eDefault)
+        server_check = key.GetFlag(CNetCacheKey::fNCKey_NoServerCheck) ?
+                eOff : eOn;
+
+    return server_check == eOff || service->IsInService(server);
+}
+
 CNetCacheAPI::CNetCacheAPI(CNetCacheAPI::EAppRegistry /* use_app_reg */,
         const string& conf_section /* = kEmptyStr */,
         CNetScheduleAPI::TInstance ns_api) :
@@ -907,6 +936,236 @@ CNetCacheAPI::EReadResult CNetCacheAPI::GetData(
         (char*) buffer.data(), x_blob_size, NULL, x_blob_size);
 }
 
+// Reads the blobs of one server for CNetCacheAPI::GetBlobs() pipelining
+// the commands. The commands are sent in portions, so that no more than
+// kMaxDepth of them are unanswered at any time. As the server stops
+// reading commands while it is sending a reply, the unanswered commands
+// must fit into the socket buffers, otherwise both sides would block.
+class CNetCacheBatchReader : public INetServerExecHandler
+{
+public:
+    struct SItem {
+        size_t index;
+        string cmd;
+        bool mirrored;
+    };
+
+    CNetCacheBatchReader(const vector<string>& keys,
+            CNetCacheAPI::TBlobHandler& handler) :
+        m_Keys(keys),
+        m_Handler(handler)
+    {
+    }
+
+    virtual void Exec(CNetServerConnection::TInstance conn_impl,
+            const STimeout* timeout);
+
+    vector<SItem> m_Items;
+
+    // Indices of the keys to read one by one
+    vector<size_t> m_OneByOne;
+
+private:
+    enum { kMaxDepth = 64 };
+
+    bool x_ReadReply(SNetServerConnectionImpl* conn, const SItem& item,
+            CNetCacheAPI::EReadResult& result, string& data);
+
+    const vector<string>& m_Keys;
+    CNetCacheAPI::TBlobHandler& m_Handler;
+
+    // The number of items with the replies read; if a connection taken from
+    // the pool turns out to be closed, TryExec() calls Exec() again and the
+    // commands are resent starting from the first unanswered one
+    size_t m_Done = 0;
+};
+
+void CNetCacheBatchReader::Exec(CNetServerConnection::TInstance conn_impl,
+        const STimeout* timeout)
+{
+    CNetServerConnection conn(conn_impl);
+    CTimeoutKeeper timeout_keeper(&conn->m_Socket, timeout);
+
+    size_t sent = m_Done;
+
+    try {
+        while (m_Done < m_Items.size()) {
+            if (sent < m_Items.size() && sent - m_Done <= kMaxDepth / 2) {
+                string cmds;
+
+                for (; sent < m_Items.size() &&
+                        sent - m_Done < kMaxDepth; ++sent) {
+                    if (!cmds.empty())
+                        cmds += "\r\n";
+                    cmds += m_Items[sent].cmd;
+                }
+
+                // WriteLine() terminates the last command
+                conn->WriteLine(cmds);
+            }
+
+            const SItem& item = m_Items[m_Done];
+            CNetCacheAPI::EReadResult result = CNetCacheAPI::eNotFound;
+            string data;
+            bool replied = x_ReadReply(conn, item, result, data);
+
+            ++m_Done;
+
+            if (replied)
+                m_Handler(m_Keys[item.index], result, data);
+            else
+                m_OneByOne.push_back(item.index);
+        }
+    }
+    catch (...) {
+        // Do not let the connection with pending replies back to the pool
+        if (sent > m_Done)
+            conn->Abort();
+        throw;
+    }
+}
+
+bool CNetCacheBatchReader::x_ReadReply(SNetServerConnectionImpl* conn,
+        const SItem& item, CNetCacheAPI::EReadResult& result, string& data)
+{
+    string response;
+
+    // An error reply is read completely, so the pipeline is still in sync
+    try {
+        conn->ReadCmdOutputLine(response, false);
+    }
+    catch (CNetCacheBlobTooOldException&) {
+        return true;
+    }
+    catch (CNetCacheException& e) {
+        switch (e.GetErrCode()) {
+        case CNetCacheException::eBlobNotFound:
+            // The blob may still be found on a mirror
+            return !item.mirrored;
+        }
+        // Thrown as GetData() would do; the caller drops the connection
+        throw;
+    }
+
+    string::size_type pos = response.find("SIZE=");
+
+    if (pos == string::npos) {
+        conn->Abort();
+        CONNSERV_THROW_FMT(CNetCacheException, eInvalidServerResponse,
+            conn->m_Server,
+            "No SIZE field in reply to the blob reading command");
+    }
+
+    data.resize(CheckBlobSize(NStr::StringToUInt8(
+        response.c_str() + pos + sizeof("SIZE=") - 1,
+        NStr::fAllowTrailingSymbols)));
+
+    size_t bytes_read = 0;
+    EIO_Status status = data.empty() ? eIO_Success :
+        conn->m_Socket.Read(&data[0], data.size(), &bytes_read,
+                eIO_ReadPersist);
+
+    switch (status) {
+    case eIO_Success:
+        break;
+    case eIO_Timeout:
+        CONNSERV_THROW_FMT(CNetServiceException, eTimeout, conn->m_Server,
+            "Timeout while reading blob contents");
+
+    case eIO_Closed:
+        CONNSERV_THROW_FMT(CNetCacheException, eBlobClipped, conn->m_Server,
+            "Unexpected EOF while reading " << m_Keys[item.index] <<
+            " (blob size: " << data.size() <<
+            ", unread bytes: " << data.size() - bytes_read << ")");
+
+    default:
+        CONNSERV_THROW_FMT(CNetServiceException, eCommunicationError,
+            conn->m_Server,
+            "Error while reading blob: " << IO_StatusStr(status));
+    }
+
+    result = CNetCacheAPI::eReadComplete;
+    return true;
+}
+
+void CNetCacheAPI::GetBlobs(const vector<string>& keys, TBlobHandler handler,
+        const CNamedParameterList* optional)
+{
+    CNetCacheAPIParameters parameters(&m_Impl->m_DefaultParameters);
+
+    parameters.LoadNamedParameters(optional);
+
+    bool mirroring_enabled =
+        parameters.GetMirroringMode() != CNetCacheAPI::eMirroringDisabled;
+
+    // Group the keys by server; the keys of a group also share the server
+    // check flag, which GetDirectServer() takes from the first one of them
+    typedef map<string, vector<size_t> > TKeysByServer;
+    TKeysByServer keys_by_server;
+    vector<size_t> one_by_one;
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        CNetCacheKey key(keys[i], m_Impl->m_CompoundIDPool);
+
+        if (key.GetVersion() == 3)
+            one_by_one.push_back(i);
+        else
+            keys_by_server[key.GetServiceName() + '/' + key.GetHost() +
+                ':' + NStr::UIntToString(key.GetPort()) +
+                (key.GetFlag(CNetCacheKey::fNCKey_NoServerCheck) ?
+                    "/0" : "/1")].push_back(i);
+    }
+
+    ITERATE(TKeysByServer, it, keys_by_server) {
+        CNetCacheKey first_key(keys[it->second.front()],
+                m_Impl->m_CompoundIDPool);
+        CNetServer server;
+
+        if (!m_Impl->GetDirectServer(first_key, &parameters, server)) {
+            one_by_one.insert(one_by_one.end(),
+                    it->second.begin(), it->second.end());
+            continue;
+        }
+
+        CNetCacheBatchReader batch_reader(keys, handler);
+
+        ITERATE(vector<size_t>, index, it->second) {
+            CNetCacheKey key(keys[*index], m_Impl->m_CompoundIDPool);
+
+            CNetCacheBatchReader::SItem item;
+            item.index = *index;
+            item.cmd = m_Impl->MakeCmd("GET2 ", key, &parameters);
+            item.mirrored = mirroring_enabled &&
+                !key.GetServiceName().empty() &&
+                !key.GetFlag(CNetCacheKey::fNCKey_SingleServer);
+            batch_reader.m_Items.push_back(std::move(item));
+        }
+
+        server->TryExec(batch_reader);
+
+        one_by_one.insert(one_by_one.end(),
+                batch_reader.m_OneByOne.begin(), batch_reader.m_OneByOne.end());
+    }
+
+    ITERATE(vector<size_t>, index, one_by_one) {
+        const string& key = keys[*index];
+        size_t blob_size = 0;
+        string data;
+
+        unique_ptr<IReader> reader(GetData(key, &blob_size, optional));
+
+        if (reader.get() == NULL) {
+            handler(key, eNotFound, data);
+            continue;
+        }
+
+        data.resize(blob_size);
+        m_Impl->ReadBuffer(*reader, const_cast<char*>(data.data()),
+            blob_size, NULL, blob_size);
+        handler(key, eReadComplete, data);
+    }
+}
+
 CNcbiIstream* CNetCacheAPI::GetIStream(const string& key, size_t* blob_size,
         const CNamedParameterList* optional)
 {
@@ -120,6 +120,12 @@ struct NCBI_XCONNECT_EXPORT SNetCacheAPIImpl : public CObject
         SNetServiceImpl::EServerErrorHandling error_handling =
             SNetServiceImpl::eRethrowServerErrors);
 
+    // Return (in "server") the server the key points to if the blob can be
+    // read from that server directly, i.e. without going through mirrors
+    // or other servers of the service like ExecMirrorAware() does.
+    bool GetDirectServer(const CNetCacheKey& key,
+        const CNetCacheAPIParameters* parameters, CNetServer& server);
+
     void Init(CSynRegistry& registry, const SRegSynonyms& sections);
 
     CNetService m_Service;
@@ -260,24 +260,22 @@ SNetServerConnectionImpl::~SNetServerConnectionImpl()
 void SNetServerConnectionImpl::WriteLine(const string& line)
 {
     // TODO change to "\n" when no old NS/NC servers remain.
-    string str(line + "\r\n");
+    static const char kEOL[] = "\r\n";
 
-    const char* buf = str.data();
-    size_t len = str.size();
+    // Send the line and its terminator at once without concatenating them.
+    SSOCK_IOVec iov[2];
+    iov[0].data = const_cast<char*>(line.data());
+    iov[0].size = line.size();
+    iov[1].data = const_cast<char*>(kEOL);
+    iov[1].size = sizeof(kEOL) - 1;
 
-    while (len > 0) {
-        size_t n_written;
+    EIO_Status io_st = m_Socket.WriteV(iov, 2, NULL, eIO_WritePersist);
 
-        EIO_Status io_st = m_Socket.Write(buf, len, &n_written);
-
-        if (io_st != eIO_Success) {
-            Abort();
+    if (io_st != eIO_Success) {
+        Abort();
 
-            CONNSERV_THROW_FMT(CNetSrvConnException, eWriteFailure,
-                m_Server, "Failed to write: " << IO_StatusStr(io_st));
-        }
-        len -= n_written;
-        buf += n_written;
+        CONNSERV_THROW_FMT(CNetSrvConnException, eWriteFailure,
+            m_Server, "Failed to write: " << IO_StatusStr(io_st));
     }
 }
 
@@ -66,6 +66,10 @@ NCBI_PARAM_DECL(string, netcache, service_name);
 typedef NCBI_PARAM_TYPE(netcache, service_name) TNetCache_ServiceName;
 NCBI_PARAM_DEF(string, netcache, service_name, "NC_UnitTest");
 
+NCBI_PARAM_DECL(unsigned, netcache, get_blobs_count);
+typedef NCBI_PARAM_TYPE(netcache, get_blobs_count) TNetCache_GetBlobsCount;
+NCBI_PARAM_DEF(unsigned, netcache, get_blobs_count, 50);
+
 
 static const string s_ClientName("test_netcache_api");
 
@@ -880,6 +884,91 @@ static void s_SimpleTest(const CNamedParameterList* nc_params)
 
 #define OUTPUT_CTX(ctx) ctx << '[' << __LINE__ << "]: "
 
+// Compares reading many small blobs one by one with reading them by
+// GetBlobs(). Run against a local NetCache server to see the effect of
+// the pipelining alone, e.g.:
+// NETCACHE_SERVICE_NAME=localhost:9000 NETCACHE_GET_BLOBS_COUNT=10000
+static void s_GetBlobsTest(const CNamedParameterList* nc_params)
+{
+    const size_t kBlobSize = 1024;
+    const unsigned kBlobCount = TNetCache_GetBlobsCount::GetDefault();
+
+    CNetCacheAPI api(TNetCache_ServiceName::GetDefault(), s_ClientName);
+    api.SetDefaultParameters(nc_params);
+
+    vector<string> keys;
+    vector<string> blobs;
+    auto random_char = bind(uniform_int_distribution<int>(0, 255), mt19937());
+
+    for (unsigned i = 0; i < kBlobCount; ++i) {
+        string blob(kBlobSize, '\0');
+        generate_n(blob.begin(), blob.size(), random_char);
+
+        keys.push_back(api.PutData(blob.data(), blob.size(),
+                    nc_blob_ttl = 600));
+        blobs.push_back(std::move(blob));
+    }
+
+    // Not existing blob, to check that it is reported in place
+    api.Remove(keys.front());
+
+    CStopWatch sw(CStopWatch::eStart);
+
+    for (unsigned i = 1; i < kBlobCount; ++i) {
+        string data;
+        api.ReadData(keys[i], data);
+        BOOST_REQUIRE_MESSAGE(data == blobs[i],
+                "Blob contents mismatch (" << i << ")");
+    }
+
+    double one_by_one = sw.Restart();
+
+    // The keys come back in the order the servers reply, which is not
+    // necessarily the order of the request when there are several servers
+    typedef pair<CNetCacheAPI::EReadResult, string> TResult;
+    map<string, TResult> results;
+
+    api.GetBlobs(keys, [&](const string& key,
+                CNetCacheAPI::EReadResult result, string& data) {
+        BOOST_REQUIRE_MESSAGE(results.find(key) == results.end(),
+                "Key reported more than once " << key);
+        results[key] = TResult(result, std::move(data));
+    });
+
+    double pipelined = sw.Elapsed();
+
+    BOOST_REQUIRE_MESSAGE(results.size() == keys.size(),
+            "Reported " << results.size() << " keys of " << keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto it = results.find(keys[i]);
+        BOOST_REQUIRE_MESSAGE(it != results.end(),
+                "Key not reported (" << i << ")");
+
+        if (i == 0) {
+            BOOST_REQUIRE_MESSAGE(
+                    it->second.first != CNetCacheAPI::eReadComplete,
+                    "Removed blob found");
+        } else {
+            BOOST_REQUIRE_MESSAGE(
+                    it->second.first == CNetCacheAPI::eReadComplete,
+                    "Blob not found (" << i << ")");
+            BOOST_REQUIRE_MESSAGE(it->second.second == blobs[i],
+                    "Blob contents mismatch (" << i << ")");
+        }
+    }
+
+    NcbiCout << "Reading " << kBlobCount << " blobs of " << kBlobSize <<
+        " bytes:" << NcbiEndl <<
+        "  one by one: " << (kBlobCount - 1) / one_by_one << " blobs/s" <<
+        NcbiEndl <<
+        "  GetBlobs(): " << kBlobCount / pipelined << " blobs/s" << NcbiEndl;
+
+    ITERATE(vector<string>, key, keys) {
+        api.Remove(*key);
+    }
+}
+
 #define BOOST_ERROR_CTX(message, ctx) \
     BOOST_ERROR(OUTPUT_CTX(ctx) << message)
                     
@@ -1038,6 +1127,11 @@ BOOST_AUTO_TEST_CASE(SimpleTestMirroring)
     s_SimpleTest(nc_mirroring_mode = CNetCacheAPI::eMirroringEnabled);
 }
 
+BOOST_AUTO_TEST_CASE(GetBlobs)
+{
+    s_GetBlobsTest(nc_mirroring_mode = CNetCacheAPI::eMirroringDisabled);
+}
+
 BOOST_AUTO_TEST_CASE(AllowedServices)
 {
     s_AllowedServicesTest();
@@ -29,8 +29,9 @@
 
 #include <ncbi_pch.hpp>
 
-#include <corelib/ncbiapp.hpp>
+#include <corelib/test_boost.hpp>
 #include <corelib/request_status.hpp>
+#include <corelib/ncbitime.hpp>
 #include <connect/ncbi_http2_session.hpp>
 
 #include <atomic>
@@ -38,16 +39,40 @@
 #include <sstream>
 #include <thread>
 
-#include "test_assert.h"  // This header must go last
+#include <common/test_assert.h>  /* This header must go last */
 
 
 USING_NCBI_SCOPE;
 
 
-class CNCBITestHttp2SessionApp : public CNcbiApplication
+static const string kGoodUrl("https://www.ncbi.nlm.nih.gov/Service/dispd.cgi?service=test");
+static const string kBadUrl("https://www.ncbi.nlm.nih.gov/Service/404");
+
+
+NCBITEST_INIT_CMDLINE(arg_desc)
 {
-    int  Run (void);
-};
+    arg_desc->AddOptionalKey("benchmark", "URL",
+            "Compare asynchronous requests with thread-per-request ones "
+            "(use a local server, e.g. 'nghttpd --no-tls 8080')", CArgDescriptions::eString);
+    arg_desc->AddDefaultKey("requests", "NUMBER", "Number of requests to benchmark",
+            CArgDescriptions::eInteger, "1000");
+    arg_desc->AddDefaultKey("threads", "NUMBER", "Number of threads for thread-per-request benchmark "
+            "(zero means one thread per request)", CArgDescriptions::eInteger, "0");
+}
+
+
+NCBITEST_INIT_TREE()
+{
+    const CArgs& args = CNcbiApplication::Instance()->GetArgs();
+
+    if (args["benchmark"].HasValue()) {
+        NCBITEST_DISABLE(Blocking);
+        NCBITEST_DISABLE(Async);
+        NCBITEST_DISABLE(AsyncTimeout);
+    } else {
+        NCBITEST_DISABLE(Benchmark);
+    }
+}
 
 
 struct SOut
@@ -69,19 +94,23 @@ private:
     mutex m_Mutex;
 };
 
-int CNCBITestHttp2SessionApp::Run(void)
+
+BOOST_AUTO_TEST_CASE(Blocking)
 {
     const size_t kThreadNum = 4;
-    const string kGoodUrl("https://www.ncbi.nlm.nih.gov/Service/dispd.cgi?service=test");
-    const string kBadUrl("https://www.ncbi.nlm.nih.gov/Service/404");
     atomic_size_t wait(kThreadNum);
     SOut out;
 
+    // Boost.Test checks are not thread-safe, the status codes are checked afterwards
+    vector<pair<int, int>> status_codes(kThreadNum);
+
     auto f = [&]() {
         size_t n = kThreadNum;
 
         do {
-            this_thread::yield();
+            if (!n) {
+                return;
+            }
         }
         while (!wait.compare_exchange_weak(n, n - 1));
 
@@ -90,16 +119,17 @@ int CNCBITestHttp2SessionApp::Run(void)
         }
 
         CHttp2Session session;
+        auto& status_code = status_codes[n - 1];
 
         if (n % 2) {
             CHttpRequest request = session.NewRequest(kGoodUrl);
             CHttpResponse response = request.Execute();
-            _ASSERT(response.GetStatusCode() == CRequestStatus::e200_Ok);
+            status_code = { response.GetStatusCode(), CRequestStatus::e200_Ok };
             out << response.ContentStream();
         } else {
             CHttpRequest request = session.NewRequest(kBadUrl);
             CHttpResponse response = request.Execute();
-            _ASSERT(response.GetStatusCode() == CRequestStatus::e404_NotFound);
+            status_code = { response.GetStatusCode(), CRequestStatus::e404_NotFound };
             out << response.ErrorStream();
         }
     };
@@ -114,11 +144,124 @@ int CNCBITestHttp2SessionApp::Run(void)
         t.join();
     }
 
-    return 0;
+    for (const auto& status_code : status_codes) {
+        BOOST_CHECK_EQUAL(status_code.first, status_code.second);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Async)
+{
+    const size_t kRequestNum = 4;
+    CHttp2Session session;
+    size_t completed = 0;
+
+    for (auto i = kRequestNum; i > 0; --i) {
+        const bool good = i % 2;
+        CHttpRequest request = session.NewRequest(good ? kGoodUrl : kBadUrl);
+
+        session.StartAsync(request, [&, good](CHttp2Session::SAsyncResponse& response) {
+            BOOST_CHECK_EQUAL(response.status_code, good ? CRequestStatus::e200_Ok : CRequestStatus::e404_NotFound);
+            BOOST_CHECK_MESSAGE(response.error.empty(), response.error);
+            cout << response.body << '\n';
+            ++completed;
+        });
+    }
+
+    // Requests time out eventually, so this cannot hang
+    while (session.Poll(CTimeout::eInfinite));
+
+    BOOST_CHECK_EQUAL(completed, kRequestNum);
+}
+
+
+BOOST_AUTO_TEST_CASE(AsyncTimeout)
+{
+    CHttp2Session session;
+    size_t completed = 0;
+
+    CHttpRequest request = session.NewRequest(kGoodUrl);
+    request.SetTimeout(CTimeout(0.001));
+
+    session.StartAsync(request, [&](CHttp2Session::SAsyncResponse& response) {
+        BOOST_CHECK_EQUAL(response.status_code, 0);
+        BOOST_CHECK(!response.error.empty());
+        ++completed;
+    });
+
+    CStopWatch sw(CStopWatch::eStart);
+
+    while (session.Poll(CTimeout::eInfinite));
+
+    BOOST_CHECK_EQUAL(completed, 1u);
+    BOOST_CHECK_LT(sw.Elapsed(), 10.0);
 }
 
 
-int main(int argc, const char* argv[])
+BOOST_AUTO_TEST_CASE(Benchmark)
 {
-    return CNCBITestHttp2SessionApp().AppMain(argc, argv);
+    const CArgs& args = CNcbiApplication::Instance()->GetArgs();
+    const string url = args["benchmark"].AsString();
+    const auto requests = static_cast<size_t>(args["requests"].AsInteger());
+    const auto threads = static_cast<size_t>(args["threads"].AsInteger());
+
+    auto report = [&](const char* name, const CStopWatch& sw, size_t failed) {
+        const auto elapsed = sw.Elapsed();
+        cout << name << ": " << requests << " requests in " << elapsed << "s, "
+            << (elapsed > 0.0 ? requests / elapsed : 0.0) << " requests/s, " << failed << " failed" << endl;
+    };
+
+    // Keep the I/O (and connections) across both runs
+    auto api_lock = CHttp2Session::GetApiLock();
+
+    // Warm up (establish connection)
+    CHttp2Session().NewRequest(url).Execute().ContentStream().ignore(numeric_limits<streamsize>::max());
+
+    // All requests in flight at once, completed by the calling thread
+    {
+        CHttp2Session session;
+        size_t failed = 0;
+        CStopWatch sw(CStopWatch::eStart);
+
+        for (size_t i = 0; i < requests; ++i) {
+            CHttpRequest request = session.NewRequest(url);
+            session.StartAsync(request, [&](CHttp2Session::SAsyncResponse& response) {
+                if (response.status_code != CRequestStatus::e200_Ok) ++failed;
+            });
+        }
+
+        while (session.Poll(CTimeout::eInfinite));
+
+        report("Asynchronous", sw, failed);
+    }
+
+    // Blocking requests, one per thread
+    {
+        const size_t thread_num = threads ? min(threads, requests) : requests;
+        atomic_size_t next(0), failed(0);
+        vector<thread> pool;
+        CStopWatch sw(CStopWatch::eStart);
+
+        for (size_t i = 0; i < thread_num; ++i) {
+            pool.emplace_back([&]() {
+                CHttp2Session session;
+
+                while (next++ < requests) {
+                    CHttpResponse response = session.NewRequest(url).Execute();
+
+                    if (response.GetStatusCode() == CRequestStatus::e200_Ok) {
+                        response.ContentStream().ignore(numeric_limits<streamsize>::max());
+                    } else {
+                        ++failed;
+                    }
+                }
+            });
+        }
+
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        report("Thread-per-request", sw, failed);
+    }
 }
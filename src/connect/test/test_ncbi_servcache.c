@@ -0,0 +1,196 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Service resolution cache test (using the LOCAL service mapper)
+ *
+ */
+
+#include "../ncbi_ansi_ext.h"
+#include "../ncbi_priv.h"               /* CORE logging facilities */
+#include "../ncbi_servicep.h"          /* SERV_MapperName() */
+#include "../ncbi_socketp.h"            /* gettimeofday() */
+#include <connect/ncbi_service.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "test_assert.h"  /* This header must go last */
+
+#ifdef _MSC_VER
+#define setenv(n,v,w)   _putenv_s(n,v)
+#endif /*_MSC_VER*/
+
+
+#define CACHED    "TEST_SERVCACHE"
+#define UNCACHED  "TEST_SERVCACHE_OFF"
+
+#define NUM_OPENS 10000
+
+#define TTL       4   /* seconds */
+
+#define _STR(x)   #x
+#define  STR(x)  _STR(x)
+
+
+static void s_SetServer(const char* service, int n, const char* server)
+{
+    char name[80];
+    sprintf(name, "%s_CONN_LOCAL_SERVER_%d", service, n);
+    setenv(name, server, 1);
+}
+
+
+static unsigned int s_Resolve(const char* service, const char** mapper)
+{
+    unsigned int count = 0;
+    SERV_ITER    iter;
+
+    if (!(iter = SERV_OpenSimple(service)))
+        return 0;
+    if (mapper)
+        *mapper = SERV_MapperName(iter);
+    while (SERV_GetNextInfo(iter))
+        ++count;
+    SERV_Close(iter);
+    return count;
+}
+
+
+static double s_Time(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (double) tv.tv_sec + (double) tv.tv_usec / 1000000.0;
+}
+
+
+/* Average time of opening an iterator, and getting the first server */
+static double s_Profile(const char* service)
+{
+    double start = s_Time();
+    int n;
+    for (n = 0;  n < NUM_OPENS;  ++n) {
+        SERV_ITER iter = SERV_OpenSimple(service);
+        assert(iter);
+        assert(SERV_GetNextInfo(iter));
+        SERV_Close(iter);
+    }
+    return (s_Time() - start) / NUM_OPENS;
+}
+
+
+static void s_Stats(const char* what, SSERV_CacheStats* stats)
+{
+    SERV_GetCacheStats(stats);
+    CORE_LOGF(eLOG_Note,
+              ("%s: %lu hit(s), %lu miss(es), %lu refresh(es),"
+               " %lu resolution(s) in %.6fs (max %.6fs)", what,
+               stats->hits, stats->misses, stats->refreshes,
+               stats->resolutions, stats->latency, stats->max_latency));
+}
+
+
+int main(int argc, char* argv[])
+{
+    SSERV_CacheStats stats;
+    SSERV_Info* info;
+    const char* mapper;
+    double cached, uncached;
+    time_t deadline;
+    unsigned int count;
+    int n;
+
+    CORE_SetLOGFormatFlags(fLOG_None          | fLOG_Short   |
+                           fLOG_OmitNoteLevel | fLOG_DateTime);
+    CORE_SetLOGFILE_Ex(stderr, eLOG_Note, eLOG_Fatal, 0/*no auto-close*/);
+
+    /* Only the LOCAL mapper for the test services */
+    setenv("CONN_LOCAL_ENABLE",  "1", 1);
+    setenv("CONN_LBSMD_DISABLE", "1", 1);
+    setenv("CONN_DISPD_DISABLE", "1", 1);
+    s_SetServer(CACHED,   0, "STANDALONE 127.0.0.1:10001 R=1");
+    s_SetServer(CACHED,   1, "STANDALONE 127.0.0.1:10002 R=1");
+    s_SetServer(UNCACHED, 0, "STANDALONE 127.0.0.1:10001 R=1");
+    s_SetServer(UNCACHED, 1, "STANDALONE 127.0.0.1:10002 R=1");
+    setenv(CACHED "_CONN_SERVICE_CACHE", STR(TTL), 1);
+
+    SERV_FlushCache();
+
+    /* First use resolves, and reports the actual mapper */
+    assert(s_Resolve(CACHED, &mapper) == 2);
+    assert(strcasecmp(mapper, "LOCAL") == 0);
+    s_Stats("Initial", &stats);
+    assert(stats.misses == 1  &&  !stats.hits  &&  stats.resolutions == 1);
+
+    /* Next ones are served off the cache, even if the configuration changes */
+    s_SetServer(CACHED, 2, "STANDALONE 127.0.0.1:10003 R=1");
+    assert(s_Resolve(CACHED, &mapper) == 2);
+    assert(strcasecmp(mapper, "LOCAL") == 0);
+    assert((info = SERV_GetInfoSimple(CACHED)) != 0);
+    free(info);
+    s_Stats("Cached", &stats);
+    assert(stats.misses == 1  &&  stats.hits == 2  &&  stats.resolutions == 1);
+
+    /* Uncached services are not affected */
+    assert(s_Resolve(UNCACHED, 0) == 2);
+    s_Stats("Uncached", &stats);
+    assert(stats.misses == 1  &&  stats.hits == 2  &&  stats.resolutions == 1);
+
+    /* Flush takes the changes in */
+    SERV_FlushCache();
+    assert(s_Resolve(CACHED, 0) == 3);
+
+    /* Re-resolution ahead of expiration:  only the order of events is
+     * checked, not their timing (which depends on the host load) -- the
+     * cached list keeps being served until the new server shows up, and
+     * once it has shown up, the old list is never served again */
+    SERV_FlushCache();
+    assert(s_Resolve(CACHED, 0) == 3);
+    s_SetServer(CACHED, 3, "STANDALONE 127.0.0.1:10004 R=1");
+    deadline = time(0) + 3 * TTL;
+    while ((count = s_Resolve(CACHED, 0)) == 3) {
+        assert(time(0) < deadline);
+        CORE_Msdelay(100);
+    }
+    assert(count == 4);
+    for (n = 0;  n < 10;  ++n)
+        assert(s_Resolve(CACHED, 0) == 4);
+    s_Stats("Refreshed", &stats);
+    assert(stats.refreshes + stats.misses >= 2  &&  stats.resolutions >= 2);
+
+    /* Profile */
+    SERV_FlushCache();
+    uncached = s_Profile(UNCACHED);
+    cached   = s_Profile(CACHED);
+    s_Stats("Profile", &stats);
+    CORE_LOGF(eLOG_Note,
+              ("Open (per iterator): %.3fus uncached, %.3fus cached,"
+               " hit ratio %.2f%%", uncached * 1000000.0, cached * 1000000.0,
+               100.0 * stats.hits / (stats.hits + stats.misses)));
+
+    CORE_LOG(eLOG_Note, "TEST completed successfully");
+    CORE_SetLOG(0);
+    return 0;
+}
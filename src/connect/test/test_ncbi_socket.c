@@ -167,6 +167,53 @@ static void TEST__client_1(SOCK sock)
         free(blob);
     }}
 
+    /* Send a very big binary blob gathered from pieces of varying sizes,
+     * and receive it back (bounced by the server) scattered to pieces of
+     * other sizes */
+    {{
+        SSOCK_IOVec    iov[N_SUB_BLOB + 1];
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        size_t         k, pos;
+        if (!blob) {
+            CORE_LOG(eLOG_Fatal, "TC1::out of memory");
+            assert(0);
+            return;
+        }
+
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n)
+            blob[n] = (unsigned char)(n * 7);
+        for (pos = k = 0;  k < N_SUB_BLOB;  ++k) {
+            /* the first piece is empty, the last one takes the remainder */
+            n = k < N_SUB_BLOB - 1 ? k * (2 * SUB_BLOB_SIZE / N_SUB_BLOB)
+                : BIG_BLOB_SIZE - pos;
+            iov[k].data = blob + pos;
+            iov[k].size = n;
+            pos += n;
+        }
+        assert(pos == BIG_BLOB_SIZE);
+        status = SOCK_WriteV(sock, iov, N_SUB_BLOB,
+                             &n_io_done, eIO_WritePersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+
+        memset(blob, 0, BIG_BLOB_SIZE);
+        for (pos = k = 0;  k <= N_SUB_BLOB;  ++k) {
+            n = k < N_SUB_BLOB ? SUB_BLOB_SIZE - 1 : BIG_BLOB_SIZE - pos;
+            iov[k].data = blob + pos;
+            iov[k].size = n;
+            pos += n;
+        }
+        assert(pos == BIG_BLOB_SIZE);
+        status = SOCK_ReadV(sock, iov, N_SUB_BLOB + 1,
+                            &n_io_done, eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n) {
+            x_check = blob[n] - (unsigned char)(n * 7);
+            assert(x_check == 0);
+        }
+
+        free(blob);
+    }}
+
     /* Try to read more data (must hit EOF as the peer is shut down) */
     assert(SOCK_Read(sock, buf, 1, &n_io_done, eIO_ReadPeek)
            == eIO_Closed);
@@ -285,6 +332,30 @@ static void TEST__server_1(SOCK sock)
         free(blob);
     }}
 
+    /* Receive a very big binary blob (sent by the client gathered from its
+     * pieces), and write it back in one piece */
+    {{
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        if (!blob) {
+            CORE_LOG(eLOG_Fatal, "TS1::out of memory");
+            assert(0);
+            return;
+        }
+
+        status = SOCK_Read(sock, blob, BIG_BLOB_SIZE,
+                           &n_io_done, eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n) {
+            x_check = blob[n] - (unsigned char)(n * 7);
+            assert(x_check == 0);
+        }
+        status = SOCK_Write(sock, blob, BIG_BLOB_SIZE,
+                            &n_io_done, eIO_WritePersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+
+        free(blob);
+    }}
+
     /* Shutdown on write */
 #ifdef NCBI_OS_MSWIN
     verify(SOCK_Shutdown(sock, eIO_ReadWrite) == eIO_Success);
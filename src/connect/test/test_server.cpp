@@ -33,6 +33,7 @@
 #include <ncbi_pch.hpp>
 #include <corelib/ncbiapp.hpp>
 #include <corelib/ncbicntr.hpp>
+#include <corelib/ncbi_process.hpp>
 #include <corelib/ncbi_system.hpp>
 #include <corelib/request_control.hpp>
 #include <connect/ncbi_util.h>
@@ -245,6 +246,69 @@ private:
 };
 
 
+/// SIdleConnections --
+///
+/// Connections which stay idle till the end of the test.  They let
+/// see how the server scales with the number of (mostly idle)
+/// connections: the CPU time taken while the regular clients are
+/// processed should not grow much with their number.
+
+struct SIdleConnections
+{
+    SIdleConnections(int count) : m_Count(count), m_Ready(0, kMax_Int) { }
+
+    int                         m_Count;      ///< Number to open
+    vector< AutoPtr<CSocket> >  m_Sockets;    ///< The open ones
+    CSemaphore                  m_Ready;      ///< Posted once all are open
+    CStopWatch                  m_Watch;      ///< Started once all are open
+    double                      m_UserTime;   ///< CPU times at that point
+    double                      m_SystemTime;
+};
+
+
+/// CIdleConnectionsRequest --
+///
+/// Opens the idle connections; the other client requests wait for it.
+
+class CIdleConnectionsRequest : public CStdRequest
+{
+public:
+    CIdleConnectionsRequest(unsigned short port, int n_waiting,
+                            SIdleConnections& idle)
+        : m_Port(port), m_Waiting(n_waiting), m_Idle(idle)
+    {
+    }
+
+protected:
+    virtual void Process(void);
+
+private:
+    unsigned short    m_Port;
+    int               m_Waiting;  ///< Number of requests waiting for it
+    SIdleConnections& m_Idle;
+};
+
+void CIdleConnectionsRequest::Process(void)
+{
+    for (int i = 0;  i < m_Idle.m_Count;  ++i) {
+        AutoPtr<CSocket> socket(new CSocket("localhost", m_Port));
+        if (socket->GetStatus(eIO_Open) != eIO_Success) {
+            ERR_POST(Warning << "Could open only " << i << " of "
+                     << m_Idle.m_Count << " idle connections"
+                     " (check the open files limit)");
+            break;
+        }
+        m_Idle.m_Sockets.push_back(socket);
+    }
+    ERR_POST(Info << "Idle connections: " << m_Idle.m_Sockets.size());
+
+    CCurrentProcess::GetTimes(NULL, &m_Idle.m_UserTime,
+                              &m_Idle.m_SystemTime);
+    m_Idle.m_Watch.Start();
+    m_Idle.m_Ready.Post(m_Waiting);
+}
+
+
 /// CConnectionRequest --
 ///
 /// Simple built-in client code to ease testing.
@@ -254,10 +318,12 @@ class CConnectionRequest : public CStdRequest
 public:
     CConnectionRequest(unsigned short port,
                        CRequestRateControl& rate_control,
-                       CFastMutex& mutex)
+                       CFastMutex& mutex,
+                       CSemaphore* start = NULL)
         : m_Port(port),
           m_RateControl(rate_control),
-          m_Mutex(mutex)
+          m_Mutex(mutex),
+          m_Start(start)
     {
     }
 
@@ -268,10 +334,14 @@ private:
     unsigned short m_Port;
     CRequestRateControl& m_RateControl;
     CFastMutex& m_Mutex;
+    CSemaphore* m_Start;  ///< To wait for the idle connections, if any
 };
 
 void CConnectionRequest::Process(void)
 {
+    if (m_Start)
+        m_Start->Wait();
+
     CTimeSpan sleep_time;
     do {
         {{
@@ -348,6 +418,18 @@ void CServerTestApp::Init(void)
                             "Maximum delay in milliseconds",
                             CArgDescriptions::eInteger, "1000");
 
+    arg_desc->AddDefaultKey("reactors", "N",
+                            "Number of server epoll reactor threads "
+                            "(0 means poll)",
+                            CArgDescriptions::eInteger, "0");
+    arg_desc->SetConstraint("reactors", new CArgAllow_Integers(0, 64));
+
+    arg_desc->AddDefaultKey("idle", "N",
+                            "Number of idle connections to keep open "
+                            "while the requests are made",
+                            CArgDescriptions::eInteger, "0");
+    arg_desc->SetConstraint("idle", new CArgAllow_Integers(0, 100000));
+
     SetupArgDescriptions(arg_desc.release());
 }
 
@@ -397,8 +479,13 @@ int CServerTestApp::Run(void)
     params.init_threads = args["srvthreads"].AsInteger();
     params.max_threads = args["maxsrvthreads"].AsInteger();
     params.accept_timeout = &kAcceptTimeout;
+    params.reactor_threads = args["reactors"].AsInteger();
 
     int max_number_of_clients = args["requests"].AsInteger();
+    int idle_count = args["idle"].AsInteger();
+
+    if (params.max_connections < unsigned(idle_count + max_number_of_clients))
+        params.max_connections = idle_count + max_number_of_clients;
 
     CTestServer server(max_number_of_clients, args["maxdelay"].AsInteger());
     server.SetParameters(params);
@@ -407,19 +494,39 @@ int CServerTestApp::Run(void)
     server.StartListening();
 
     CStdPoolOfThreads pool(args["maxclthreads"].AsInteger(),
-                           max_number_of_clients);
+                           max_number_of_clients + 1);
 
     pool.Spawn(args["clthreads"].AsInteger());
 
+    SIdleConnections idle(idle_count);
+    CSemaphore* start = NULL;
+    if (idle_count > 0) {
+        pool.AcceptRequest(CRef<ncbi::CStdRequest>
+            (new CIdleConnectionsRequest(port, max_number_of_clients, idle)));
+        start = &idle.m_Ready;
+    }
+
     for (int i = max_number_of_clients;  i > 0;  i--) {
         pool.AcceptRequest(CRef<ncbi::CStdRequest>
-            (new CConnectionRequest(port, rate_control, rate_mutex)));
+            (new CConnectionRequest(port, rate_control, rate_mutex, start)));
     }
 
     server.Run();
 
     pool.KillAllThreads(true);
 
+    if (idle_count > 0) {
+        double user_time, system_time;
+        CCurrentProcess::GetTimes(NULL, &user_time, &system_time);
+        ERR_POST(Info << "Processed " << max_number_of_clients
+                 << " requests with " << idle.m_Sockets.size()
+                 << " idle connections and "
+                 << params.reactor_threads << " reactor(s) in "
+                 << idle.m_Watch.Elapsed() << " s, CPU time: user "
+                 << user_time - idle.m_UserTime << " s, system "
+                 << system_time - idle.m_SystemTime << " s");
+    }
+
     return 0;
 }
 
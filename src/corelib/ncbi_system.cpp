@@ -1291,6 +1291,24 @@ bool MemoryAdvise(void* addr, size_t len, EMemoryAdvise advise)
             CNcbiError::Set(CNcbiError::eNotSupported);
             return false;
         #endif
+    case eMADV_HugePage:
+        #if defined(MADV_HUGEPAGE)
+            adv = MADV_HUGEPAGE;
+            break;
+        #else
+            ERR_POST_X_ONCE(12, Warning << "MADV_HUGEPAGE not supported");
+            CNcbiError::Set(CNcbiError::eNotSupported);
+            return false;
+        #endif
+    case eMADV_NoHugePage:
+        #if defined(MADV_NOHUGEPAGE)
+            adv = MADV_NOHUGEPAGE;
+            break;
+        #else
+            ERR_POST_X_ONCE(12, Warning << "MADV_NOHUGEPAGE not supported");
+            CNcbiError::Set(CNcbiError::eNotSupported);
+            return false;
+        #endif
     default:
         _TROUBLE;
         return false;
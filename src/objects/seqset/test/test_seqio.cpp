@@ -36,11 +36,19 @@
 #include <serial/objostr.hpp>
 #include <serial/objistrxml.hpp>
 #include <serial/objostrxml.hpp>
+#include <serial/objistrjson.hpp>
 #include <serial/objhook.hpp>
 #include <serial/objcopy.hpp>
 #include <corelib/ncbifile.hpp>
 #include <common/test_data_path.h>
 #include <objects/seqset/Seq_entry.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACaa.hpp>
 #include <corelib/test_boost.hpp>
 #include <objects/general/Object_id.hpp>
 #include <objects/seqloc/Seq_id.hpp>
@@ -401,3 +409,106 @@ BOOST_AUTO_TEST_CASE(s_TestAsnSerializationCopy)
         CFile(loc_name).Remove();
     }
 }
+
+
+template<class TStream>
+static void s_TestReadSpeed(ESerialDataFormat format, const char* ext)
+{
+    typedef CSeq_entry TObject;
+    string src_dir = CDirEntry::MakePath(NCBI_GetTestDataPath(),
+                                         "objects/seqset/test");
+    string in_name = CDirEntry::MakePath(src_dir, "seq_entry1", ext);
+    string data;
+    {
+        CNcbiIfstream in(in_name.c_str(), IOS_BASE::in | IOS_BASE::binary);
+        if ( !in ) {
+            LOG_POST("Cannot open " << in_name);
+            return;
+        }
+        NcbiStreamToString(&data, in);
+    }
+
+    // compare char by char and bulk scanning readers on in-memory data
+    const int kRepeat = 20;
+    TObject obj[2];
+    for ( int fast = 0; fast < 2; ++fast ) {
+        CSysWatch sw;
+        for ( int i = 0; i < kRepeat; ++i ) {
+            unique_ptr<CObjectIStream> in(
+                CObjectIStream::CreateFromBuffer(format,
+                                                 data.data(), data.size()));
+            dynamic_cast<TStream*>(in.get())->SetFastScan(fast != 0);
+            obj[fast].Reset();
+            *in >> obj[fast];
+        }
+        LOG_POST(sw.Elapsed() << "s:  Read x" << kRepeat
+                 << (fast ? ", fast scan" : ""));
+    }
+    BOOST_CHECK(obj[0].Equals(obj[1]));
+}
+
+BOOST_AUTO_TEST_CASE(s_TestJsonReadSpeed)
+{
+    LOG_POST("-------------------------------------------------");
+    LOG_POST("TestJsonReadSpeed");
+    s_TestReadSpeed<CObjectIStreamJson>(eSerial_Json, ".json");
+}
+
+BOOST_AUTO_TEST_CASE(s_TestXmlReadSpeed)
+{
+    LOG_POST("-------------------------------------------------");
+    LOG_POST("TestXmlReadSpeed");
+    s_TestReadSpeed<CObjectIStreamXml>(eSerial_Xml, ".xml");
+}
+
+BOOST_AUTO_TEST_CASE(s_TestParallelWrite)
+{
+    LOG_POST("-------------------------------------------------");
+    LOG_POST("TestParallelWrite");
+    // the set is built here, so that the test doesn't depend on test data;
+    // long sequences make the text output wrap lines
+    CSeq_entry set;
+    for ( int i = 0; i < 200; ++i ) {
+        CRef<CSeq_entry> entry(new CSeq_entry);
+        CBioseq& seq = entry->SetSeq();
+        CRef<CSeq_id> id(new CSeq_id);
+        id->SetLocal().SetStr("seq" + NStr::IntToString(i));
+        seq.SetId().push_back(id);
+        CRef<CSeqdesc> desc(new CSeqdesc);
+        desc->SetTitle("Test sequence " + NStr::IntToString(i));
+        seq.SetDescr().Set().push_back(desc);
+        string residues;
+        for ( int j = 0; j < 100 + i*7; ++j ) {
+            residues += "ACDEFGHIKLMNPQRSTVWY"[(i + j*j) % 20];
+        }
+        CSeq_inst& inst = seq.SetInst();
+        inst.SetRepr(CSeq_inst::eRepr_raw);
+        inst.SetMol(CSeq_inst::eMol_aa);
+        inst.SetLength(TSeqPos(residues.size()));
+        inst.SetSeq_data().SetIupacaa().Set(residues);
+        set.SetSet().SetSeq_set().push_back(entry);
+    }
+
+    // parallel writing must not change the output
+    ESerialDataFormat fmt[] = { eSerial_AsnText, eSerial_AsnBinary };
+    for ( auto f : fmt ) {
+        string data[2];
+        string position[2];
+        for ( int parallel = 0; parallel < 2; ++parallel ) {
+            CSysWatch sw;
+            CNcbiOstrstream str;
+            {
+                unique_ptr<CObjectOStream> out(CObjectOStream::Open(f, str));
+                out->SetWriteThreads(parallel ? 4 : 0);
+                *out << set;
+                position[parallel] = out->GetPosition();
+            }
+            data[parallel] = CNcbiOstrstreamToString(str);
+            LOG_POST(sw.Elapsed() << "s:  Write " <<
+                     (f == eSerial_AsnText ? "text" : "binary") <<
+                     (parallel ? ", 4 threads" : ""));
+        }
+        BOOST_CHECK(data[0] == data[1]);
+        BOOST_CHECK_EQUAL(position[0], position[1]);
+    }
+}
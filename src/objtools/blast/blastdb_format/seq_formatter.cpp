@@ -279,17 +279,60 @@ string CBlastDB_SeqFormatter::x_GetSeqMask(CSeqDB::TOID oid, int algo_id)
 	return CBlastSeqUtil::GetMasksString(masks);
 }
 
-void CBlastDB_SeqFormatter::x_GetSeq(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string & seq)
+TSeqRange CBlastDB_SeqFormatter::x_GetSeqRange(CSeqDB::TOID oid, const TSeqRange & config_range)
 {
 	TSeqRange r;
-	if(config.m_SeqRange.NotEmpty()) {
+	if(config_range.NotEmpty()) {
 		TSeqPos length = m_BlastDb.GetSeqLength(oid);
-	    r = config.m_SeqRange;
-	    if((TSeqPos)length <= config.m_SeqRange.GetTo()) {
+	    r = config_range;
+	    if((TSeqPos)length <= config_range.GetTo()) {
 	    	r.SetTo(length-1);
 	    }
 	}
-	if(r.Empty()) {
+	return r;
+}
+
+// Upper limit of the sequence data kept by Prefetch(); the sequences beyond
+// it are fetched one at a time by Write()
+static const size_t kMaxPrefetchedBytes = 64 * 1024 * 1024;
+
+void CBlastDB_SeqFormatter::Prefetch(const vector<CSeqDB::TOID> & oids,
+                                     const vector<TSeqRange> & ranges)
+{
+	m_PrefetchedSeqs.clear();
+	if ( !(m_OtherFields & (1 << e_seq)) ) {
+		m_BlastDb.PrefetchSequences(oids);
+		return;
+	}
+
+	vector<CSeqDB::TOID> fetch_oids;
+	vector<TSeqRange> fetch_ranges;
+	size_t bytes = 0;
+	for (size_t i = 0; i < oids.size() && bytes < kMaxPrefetchedBytes; i++) {
+		if (oids[i] < 0) {
+			continue;
+		}
+		TSeqRange r = x_GetSeqRange(oids[i], ranges[i]);
+		bytes += r.Empty() ? m_BlastDb.GetSeqLength(oids[i]) : r.GetLength();
+		fetch_oids.push_back(oids[i]);
+		fetch_ranges.push_back(r.Empty() ? TSeqRange() : r);
+	}
+
+	vector<string> seqs;
+	m_BlastDb.GetSequencesAsStrings(fetch_oids, seqs, &fetch_ranges);
+	for (size_t i = 0; i < fetch_oids.size(); i++) {
+		m_PrefetchedSeqs[make_pair(fetch_oids[i], fetch_ranges[i])].swap(seqs[i]);
+	}
+}
+
+void CBlastDB_SeqFormatter::x_GetSeq(CSeqDB::TOID oid, const CBlastDB_FormatterConfig & config, string & seq)
+{
+	TSeqRange r = x_GetSeqRange(oid, config.m_SeqRange);
+	auto prefetched = m_PrefetchedSeqs.find(make_pair(oid, r.Empty() ? TSeqRange() : r));
+	if(prefetched != m_PrefetchedSeqs.end()) {
+		seq = prefetched->second;
+	}
+	else if(r.Empty()) {
 	   	m_BlastDb.GetSequenceAsString(oid, seq);
 	}
 	else {
@@ -1196,6 +1196,85 @@ void CSeqDB::GetSequenceAsString(int                 oid,
     output.swap(result);
 }
 
+/// Number of sequences decoded between read-ahead requests in
+/// CSeqDB::GetSequencesAsStrings.
+static const size_t kSeqDBBatchPrefetchSize = 4096;
+
+void CSeqDB::GetSequencesAsStrings(const vector<TOID>      & oids,
+                                   vector<string>          & output,
+                                   const vector<TSeqRange> * ranges) const
+{
+    CSeqUtil::ECoding code_to = ((GetSequenceType() == CSeqDB::eProtein)
+                                 ? CSeqUtil::e_Ncbieaa
+                                 : CSeqUtil::e_Iupacna);
+
+    GetSequencesAsStrings(oids, code_to, output, ranges);
+}
+
+void CSeqDB::GetSequencesAsStrings(const vector<TOID>      & oids,
+                                   CSeqUtil::ECoding         coding,
+                                   vector<string>          & output,
+                                   const vector<TSeqRange> * ranges) const
+{
+    if (ranges && ranges->size() != oids.size()) {
+        NCBI_THROW(CSeqDBException, eArgErr,
+                   "Number of ranges does not match the number of OIDs.");
+    }
+
+    output.clear();
+    output.resize(oids.size());
+
+    // Visit the requests in OID order, which is also volume and file
+    // offset order; ties keep the caller's order.
+    vector<size_t> order(oids.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(),
+                [&oids](size_t a, size_t b) { return oids[a] < oids[b]; });
+
+    vector<TOID> window;
+    window.reserve(kSeqDBBatchPrefetchSize);
+
+    // Read-ahead for the next window is requested before the current
+    // one is decoded, so the I/O overlaps the decoding.
+    auto prefetch = [&](size_t from) {
+        window.clear();
+        size_t to = min(from + kSeqDBBatchPrefetchSize, order.size());
+        for (size_t i = from; i < to; i++) {
+            window.push_back(oids[order[i]]);
+        }
+        m_Impl->PrefetchSeqData(window);
+    };
+
+    if ( !order.empty() ) {
+        prefetch(0);
+    }
+    size_t prev = order.size();
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i % kSeqDBBatchPrefetchSize == 0 &&
+            i + kSeqDBBatchPrefetchSize < order.size()) {
+            prefetch(i + kSeqDBBatchPrefetchSize);
+        }
+
+        size_t idx = order[i];
+        TSeqRange range = ranges ? (*ranges)[idx] : TSeqRange();
+
+        if (prev != order.size() && oids[prev] == oids[idx] &&
+            (!ranges || (*ranges)[prev] == range)) {
+            output[idx] = output[prev];
+        } else {
+            GetSequenceAsString(oids[idx], coding, output[idx], range);
+        }
+        prev = idx;
+    }
+}
+
+void CSeqDB::PrefetchSequences(const vector<TOID> & oids) const
+{
+    m_Impl->PrefetchSeqData(oids);
+}
+
 #if ((!defined(NCBI_COMPILER_WORKSHOP) || (NCBI_COMPILER_VERSION  > 550)) && \
      (!defined(NCBI_COMPILER_MIPSPRO)) )
 void CSeqDB::ListColumns(vector<string> & titles)
@@ -1780,6 +1859,11 @@ void CSeqDB::SetMMapStrategy(CMemoryFile_Base::EMemMapAdvise strategy)
     m_Impl->SetMMapStrategy(strategy);
 }
 
+void CSeqDB::GetAtlasStats(SSeqDBAtlasStats & stats) const
+{
+    m_Impl->GetAtlasStats(stats);
+}
+
 
 END_NCBI_SCOPE
 
@@ -100,15 +100,88 @@ TOut SeqDB_CheckLength(TIn value)
 
 const int CSeqDBAtlas::kDefaultMaxFileDescriptors;
 
+/// Read the page fault counters of the current process.
+/// @param minor_faults Minor (soft) page faults [out]
+/// @param major_faults Major (hard) page faults [out]
+static void s_GetPageFaults(Int8 & minor_faults, Int8 & major_faults)
+{
+    minor_faults = major_faults = 0;
+#if defined(NCBI_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        minor_faults = usage.ru_minflt;
+        major_faults = usage.ru_majflt;
+    }
+#endif
+}
+
+/// Check whether transparent huge pages are enabled, so that huge page
+/// advice is not tried (and reported as failed) for every mapped file.
+static bool s_IsHugePageSupported(void)
+{
+#if defined(NCBI_OS_LINUX)
+    CNcbiIfstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    string mode;
+    if (getline(in, mode)) {
+        return mode.find("[never]") == NPOS;
+    }
+#endif
+    return false;
+}
+
+/// Parse the list of madvise() hints applied to newly mapped files.
+///
+/// The list is a comma or space separated combination of "random",
+/// "sequential", "willneed" (also spelled "populate", pages are read
+/// ahead as soon as the file is mapped) and "hugepage".
+/// @param value The value of NCBI_BLAST_MMAP_ADVICE [in]
+/// @param advice The parsed hints [out]
+static void
+s_ParseMMapAdvice(const string & value,
+                  vector<CMemoryFile_Base::EMemMapAdvise> & advice)
+{
+    vector<string> tokens;
+    NStr::Split(value, ", ", tokens, NStr::fSplit_Tokenize);
+    ITERATE(vector<string>, token, tokens) {
+        if (NStr::EqualNocase(*token, "random")) {
+            advice.push_back(CMemoryFile_Base::eMMA_Random);
+        } else if (NStr::EqualNocase(*token, "sequential")) {
+            advice.push_back(CMemoryFile_Base::eMMA_Sequential);
+        } else if (NStr::EqualNocase(*token, "willneed") ||
+                   NStr::EqualNocase(*token, "populate")) {
+            advice.push_back(CMemoryFile_Base::eMMA_WillNeed);
+        } else if (NStr::EqualNocase(*token, "hugepage")) {
+            if (s_IsHugePageSupported()) {
+                advice.push_back(CMemoryFile_Base::eMMA_HugePage);
+            } else {
+                LOG_POST(Warning << "Ignoring NCBI_BLAST_MMAP_ADVICE value "
+                         "hugepage: transparent huge pages are not enabled");
+            }
+        } else {
+            LOG_POST(Warning << "Ignoring unknown NCBI_BLAST_MMAP_ADVICE "
+                     "value: " << *token);
+        }
+    }
+}
+
 CSeqDBAtlas::CSeqDBAtlas(bool use_atlas_lock)
      :m_UseLock           (use_atlas_lock),
       m_MaxFileSize       (0),      
-      m_SearchPath        (GenerateSearchPath()),
-      m_MMapStrategy      (CMemoryFile_Base::eMMA_Normal)
+      m_MMapStrategy      (CMemoryFile_Base::eMMA_Normal),
+      m_MappedBytes       (0),
+      m_PeakMappedBytes   (0),
+      m_MapCount          (0),
+      m_RemapCount        (0),
+      m_SearchPath        (GenerateSearchPath())
 {
     m_OpenedFilesCount = 0;
     m_MaxOpenedFilesCount = 0;
+    s_GetPageFaults(m_StartMinorFaults, m_StartMajorFaults);
     CNcbiEnvironment env;
+    const string & MMAP_ADVICE_STRING = env.Get("NCBI_BLAST_MMAP_ADVICE");
+    if (MMAP_ADVICE_STRING != kEmptyStr) {
+        s_ParseMMapAdvice(MMAP_ADVICE_STRING, m_MMapAdvice);
+    }
     m_MaxFileDescriptors = CSeqDBAtlas::kDefaultMaxFileDescriptors;
     const string & MAX_FD_STRING = env.Get("NCBI_BLAST_MAX_FILE_DESCRIPTORS");
     if (MAX_FD_STRING != kEmptyStr) {
@@ -144,13 +217,36 @@ CMemoryFile* CSeqDBAtlas::GetMemoryFile(const string& fileName)
     	//LOG_POST(Info << "File: " << fileName << " count " << it->second.get()->m_Count);
         return it->second.get();
     }
-    CAtlasMappedFile* file(new CAtlasMappedFile(fileName, m_MMapStrategy));
+    CAtlasMappedFile* file(new CAtlasMappedFile(fileName, m_MMapStrategy,
+                                                m_MMapAdvice));
     m_FileMemMap[fileName].reset(file);
    	_TRACE("Open File: " << fileName);
     ChangeOpenedFilseCount(CSeqDBAtlas::eFileCounterIncrement);
+    m_MapCount++;
+    if (m_UnmappedFiles.erase(fileName) > 0) {
+        m_RemapCount++;
+    }
+    m_MappedBytes += file->GetSize();
+    m_PeakMappedBytes = max(m_PeakMappedBytes, m_MappedBytes);
     return file;
 }
 
+void CSeqDBAtlas::GetStats(SSeqDBAtlasStats & stats) const
+{
+    {
+        std::lock_guard<std::mutex> guard(m_FileMemMapMutex);
+        stats.mapped_files = m_OpenedFilesCount;
+        stats.peak_mapped_files = m_MaxOpenedFilesCount;
+        stats.mapped_bytes = m_MappedBytes;
+        stats.peak_mapped_bytes = m_PeakMappedBytes;
+        stats.map_count = m_MapCount;
+        stats.remap_count = m_RemapCount;
+    }
+    s_GetPageFaults(stats.minor_faults, stats.major_faults);
+    stats.minor_faults -= m_StartMinorFaults;
+    stats.major_faults -= m_StartMajorFaults;
+}
+
 void CSeqDBAtlas::SetMMapStrategy(CMemoryFile_Base::EMemMapAdvise strategy)
 {
     std::lock_guard<std::mutex> guard(m_FileMemMapMutex);
@@ -172,6 +268,10 @@ CMemoryFile* CSeqDBAtlas::ReturnMemoryFile(const string& fileName)
    	//LOG_POST(Info << "Return File: " << fileName << "count " << it->second.get()->m_Count);
    	if ((GetOpenedFilseCount() > m_MaxFileDescriptors) &&
    		(it->second.get()->m_isIsam) && (it->second.get()->m_Count == 0)) {
+   		m_MappedBytes -= it->second->GetSize();
+   		if (m_UnmappedFiles.size() < kMaxUnmappedFiles) {
+   			m_UnmappedFiles.insert(fileName);
+   		}
    		m_FileMemMap.erase(it);
    		LOG_POST(Info << "Unmap max file descriptor reached: " << fileName);
    		ChangeOpenedFilseCount(CSeqDBAtlas::eFileCounterDecrement);
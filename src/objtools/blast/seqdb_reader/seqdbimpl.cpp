@@ -790,6 +790,40 @@ int CSeqDBImpl::GetAmbigPartialSeq(int                oid,
 	    NCBI_THROW(CSeqDBException, eArgErr, CSeqDB::kOidNotFound);
 }
 
+void CSeqDBImpl::PrefetchSeqData(const vector<int> & oids) const
+{
+    CHECK_MARKER();
+
+    vector<int> sorted(oids);
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+
+    const CSeqDBVol * cur_vol = NULL;
+    vector<int> vol_oids;
+
+    ITERATE(vector<int>, oid, sorted) {
+        if (*oid < 0) {
+            continue;
+        }
+        int vol_oid = 0;
+        const CSeqDBVol * vol = m_VolSet.FindVol(*oid, vol_oid);
+        if ( !vol ) {
+            continue;
+        }
+        if (vol != cur_vol) {
+            if (cur_vol) {
+                cur_vol->PrefetchSeqData(vol_oids);
+            }
+            cur_vol = vol;
+            vol_oids.clear();
+        }
+        vol_oids.push_back(vol_oid);
+    }
+    if (cur_vol) {
+        cur_vol->PrefetchSeqData(vol_oids);
+    }
+}
+
 list< CRef<CSeq_id> > CSeqDBImpl::GetSeqIDs(int oid)
 {
     CHECK_MARKER();
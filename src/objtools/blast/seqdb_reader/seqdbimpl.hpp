@@ -390,6 +390,15 @@ public:
                            CSeqDB::TSequenceRanges  * partial_ranges,
                            CSeqDB::TSequenceRanges  * masks) const;
 
+    /// Prefetch the sequence data for a set of OIDs.
+    ///
+    /// The OIDs are sorted and grouped by volume, and each volume is
+    /// asked to read ahead the regions holding their sequence data.
+    ///
+    /// @param oids
+    ///   The OIDs of the sequences, in any order. [in]
+    void PrefetchSeqData(const vector<int> & oids) const;
+
     /// Returns any resources associated with the sequence.
     ///
     /// Calls to GetSequence (but not GetBioseq())
@@ -1063,6 +1072,13 @@ public:
         m_Atlas.SetMMapStrategy(strategy);
     }
 
+    /// Get memory mapping statistics of the atlas.
+    /// @param stats The statistics are returned here.
+    void GetAtlasStats(SSeqDBAtlasStats & stats) const
+    {
+        m_Atlas.GetStats(stats);
+    }
+
     /// Set the membership bit of all volumes
     void SetVolsMemBit(int mbit);
 
@@ -44,6 +44,7 @@
 #include <serial/serial.hpp>
 #include <corelib/ncbimtx.hpp>
 #include <corelib/ncbi_safe_static.hpp>
+#include <corelib/ncbi_system.hpp>
 
 #include <sstream>
 
@@ -1598,6 +1599,67 @@ int CSeqDBVol::GetAmbigPartialSeq(int                oid,
     return base_length;
 }
 
+/// Regions closer than this many bytes are prefetched as one region.
+static const CSeqDBVol::TIndx kSeqDBPrefetchGap = 64 * 1024;
+
+/// Ask the kernel to read ahead a region of a mapped sequence file.
+/// @param seq   The sequence file. [in]
+/// @param start The first byte of the region. [in]
+/// @param end   The byte just past the region. [in]
+static void s_SeqDBPrefetchRegion(const CSeqDBSeqFile & seq,
+                                  CSeqDBVol::TIndx      start,
+                                  CSeqDBVol::TIndx      end)
+{
+    static const size_t kPageSize = GetVirtualMemoryPageSize();
+
+    const char * ptr = seq.GetFileDataPtr(start);
+    if ( !ptr  ||  end <= start ) {
+        return;
+    }
+    // madvise() wants a page aligned address.
+    size_t shift = reinterpret_cast<size_t>(ptr) % kPageSize;
+    MemoryAdvise(const_cast<char*>(ptr - shift),
+                 static_cast<size_t>(end - start) + shift,
+                 eMADV_WillNeed);
+}
+
+void CSeqDBVol::PrefetchSeqData(const vector<int> & oids) const
+{
+    if (oids.empty()) return;
+
+    if (!m_SeqFileOpened) x_OpenSeqFile();
+    if (m_Seq.Empty()) return;
+
+    const int num_oids = m_Idx->GetNumOIDs();
+    TIndx region_start = -1;
+    TIndx region_end = -1;
+
+    ITERATE(vector<int>, oid, oids) {
+        if (*oid < 0  ||  *oid >= num_oids) {
+            continue;
+        }
+        // For nucleotide volumes the ambiguity data follows the packed
+        // sequence, so the region ends where the next sequence starts.
+        TIndx start = 0, end = 0;
+        m_Idx->GetSeqStart(*oid, start);
+        m_Idx->GetSeqStart(*oid + 1, end);
+
+        if (region_start >= 0  &&  start >= region_end  &&
+            start - region_end <= kSeqDBPrefetchGap) {
+            region_end = end;
+            continue;
+        }
+        if (region_start >= 0) {
+            s_SeqDBPrefetchRegion(*m_Seq, region_start, region_end);
+        }
+        region_start = start;
+        region_end = end;
+    }
+    if (region_start >= 0) {
+        s_SeqDBPrefetchRegion(*m_Seq, region_start, region_end);
+    }
+}
+
 
 
 
@@ -304,6 +304,15 @@ int CSeqDBPerfApp::x_RandomSeqs()
 	}
     CStopWatch sw;
     sw.Start();
+    if (GetArgs()["batch_fetch"]) {
+        vector<string> seqs;
+        m_BlastDb->GetSequencesAsStrings(test_oids, seqs);
+        x_UpdateMemoryUsage();
+        sw.Stop();
+        cout << "Time to retrieve " << test_size << " seqs in a batch: "
+             << sw.AsSmartString() << endl;
+        return 0;
+    }
 #pragma omp parallel for default(none) num_threads(m_NumThreads) schedule(guided) if (m_NumThreads > 1) \
         shared( m_BlastDb, m_NumThreads, test_size, test_oids)
 	for (size_t i=0; i < test_size; i++) {
@@ -367,6 +376,10 @@ void CSeqDBPerfApp::Init()
                       "Retrieve random seq data", true);
     arg_desc->AddFlag("get_metadata",
                       "Retrieve BLAST database metadata", true);
+    arg_desc->AddFlag("batch_fetch",
+                      "Retrieve the random seqs with one batched call", true);
+    arg_desc->SetDependency("batch_fetch", CArgDescriptions::eRequires,
+                            "random_seqs");
 
     arg_desc->SetDependency("scan_compressed", CArgDescriptions::eExcludes,
                             "scan_uncompressed");
@@ -380,6 +393,8 @@ void CSeqDBPerfApp::Init()
                             "random_seqs");
 
     arg_desc->AddFlag("mm_random", "Set madvise random", true);
+    arg_desc->AddFlag("atlas_stats",
+                      "Report memory mapping statistics", true);
 
     arg_desc->AddDefaultKey("num_threads", "number",
                             "Number of threads to use (requires OpenMP)",
@@ -412,6 +427,11 @@ int CSeqDBPerfApp::Run(void)
             status = x_ScanDatabase();
         }
         x_ReportMemUsage();
+        if (args["atlas_stats"] && m_BlastDb.NotEmpty()) {
+            SSeqDBAtlasStats stats;
+            m_BlastDb->GetAtlasStats(stats);
+            cout << "Atlas statistics: " << stats << endl;
+        }
     } catch (const CSeqDBException& e) {
         ERR_POST(Error << "BLAST Database error: " << e.GetMsg());
         status = 1;
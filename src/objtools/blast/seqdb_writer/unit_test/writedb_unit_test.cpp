@@ -1315,6 +1315,36 @@ BOOST_AUTO_TEST_CASE(MultiVolume)
     s_WrapUpFiles(f);
 }
 
+BOOST_AUTO_TEST_CASE(MultiThreadedConversion)
+{
+    CSeqDBExpert src("data/writedb_prot", CSeqDB::eProtein);
+
+    CRef<CWriteDB> db(new CWriteDB("w-multithread",
+                                   CWriteDB::eProtein,
+                                   "multithreaded title",
+                                   CWriteDB::eFullIndex));
+    db->SetNumThreads(4);
+    // Force volume breaks in the middle of a converted batch.
+    db->SetMaxVolumeLetters(500);
+
+    int count = 0;
+    for(int oid = 0; src.CheckOrFindOID(oid); oid++) {
+        db->AddSequence(*src.GetBioseq(oid));
+        count++;
+    }
+    db->Close();
+
+    vector<string> files;
+    db->ListFiles(files);
+    db.Reset();
+
+    CSeqDB dst("w-multithread", CSeqDB::eProtein);
+    BOOST_REQUIRE_EQUAL(count, dst.GetNumOIDs());
+
+    s_TestDatabase(src, "w-multithread", "multithreaded title");
+    s_WrapUpFiles(files);
+}
+
 BOOST_AUTO_TEST_CASE(UsPatId)
 {
 
@@ -75,6 +75,7 @@ CWriteDB_Impl::CWriteDB_Impl(const string & dbname,
       m_ParseIDs         (parse_ids),
       m_UseGiMask        (use_gi_mask),
       m_DbVersion        (dbver),
+      m_NumThreads       (1),
       m_Pig              (0),
       m_Hash             (0),
       m_SeqLength        (0),
@@ -329,6 +330,7 @@ void CWriteDB_Impl::Close()
     m_Closed = true;
 
     x_Publish();
+    x_FlushPending();
     m_Sequence.erase();
     m_Ambig.erase();
 
@@ -924,39 +926,51 @@ void CWriteDB_Impl::x_CookHeader()
 
 void CWriteDB_Impl::x_CookIds()
 {
-    if (! m_Ids.empty()) {
+    x_CookIds(m_Deflines, m_BinHdr, m_Ids);
+}
+
+void CWriteDB_Impl::x_CookIds(CConstRef<CBlast_def_line_set> & deflines,
+                              const string                   & bin_hdr,
+                              vector< CRef<CSeq_id> >        & ids)
+{
+    if (! ids.empty()) {
         return;
     }
 
-    if (m_Deflines.Empty()) {
-        if (m_BinHdr.empty()) {
+    if (deflines.Empty()) {
+        if (bin_hdr.empty()) {
             NCBI_THROW(CWriteDBException,
                        eArgErr,
                        "Error: Cannot find IDs or deflines.");
         }
 
-        x_SetDeflinesFromBinary(m_BinHdr, m_Deflines);
+        x_SetDeflinesFromBinary(bin_hdr, deflines);
     }
 
-    ITERATE(list< CRef<CBlast_def_line> >, iter, m_Deflines->Get()) {
-        const list< CRef<CSeq_id> > & ids = (**iter).GetSeqid();
-        // m_Ids.insert(m_Ids.end(), ids.begin(), ids.end());
+    ITERATE(list< CRef<CBlast_def_line> >, iter, deflines->Get()) {
+        const list< CRef<CSeq_id> > & seqids = (**iter).GetSeqid();
+        // ids.insert(ids.end(), seqids.begin(), seqids.end());
         // Spelled out for WorkShop. :-/
         // ID-6757 : STL containers have efficient internal memory maintenance,
         // the following line is, on the contrary, very inefficient. 
-        // m_Ids.reserve(m_Ids.size() + ids.size());
-        ITERATE (list<CRef<CSeq_id> >, it, ids) {
-            m_Ids.push_back(*it);
+        // ids.reserve(ids.size() + seqids.size());
+        ITERATE (list<CRef<CSeq_id> >, it, seqids) {
+            ids.push_back(*it);
         }
     }
 }
 
 void CWriteDB_Impl::x_MaskSequence()
+{
+    x_MaskSequence(m_Sequence);
+}
+
+void CWriteDB_Impl::x_MaskSequence(string & sequence) const
 {
     // Scan and mask the sequence itself.
-    for(unsigned i = 0; i < m_Sequence.size(); i++) {
-        if (m_MaskLookup[m_Sequence[i] & 0xFF] != 0) {
-            m_Sequence[i] = m_MaskByte[0];
+    for(unsigned i = 0; i < sequence.size(); i++) {
+        if (m_MaskLookup[sequence[i] & 0xFF] != 0) {
+            sequence[i] = m_MaskByte[0];
         }
     }
 }
@@ -991,47 +1005,56 @@ void CWriteDB_Impl::x_CookSequence()
     if (! m_Sequence.empty())
         return;
 
-    if (! (m_Bioseq.NotEmpty() && m_Bioseq->CanGetInst())) {
+    x_CookSequence(m_Bioseq, m_SeqVector, m_Protein, m_Sequence, m_Ambig);
+}
+
+void CWriteDB_Impl::x_CookSequence(const CConstRef<CBioseq> & bioseq,
+                                   CSeqVector               & seq_vector,
+                                   bool                       protein,
+                                   string                   & sequence,
+                                   string                   & ambig)
+{
+    if (! (bioseq.NotEmpty() && bioseq->CanGetInst())) {
         NCBI_THROW(CWriteDBException,
                    eArgErr,
                    "Need sequence data.");
     }
 
-    const CSeq_inst & si = m_Bioseq->GetInst();
+    const CSeq_inst & si = bioseq->GetInst();
 
-    if (m_Bioseq->GetInst().CanGetSeq_data()) {
+    if (bioseq->GetInst().CanGetSeq_data()) {
         const CSeq_data & sd = si.GetSeq_data();
 
         string msg;
 
         switch(sd.Which()) {
         case CSeq_data::e_Ncbistdaa:
-            WriteDB_StdaaToBinary(si, m_Sequence);
+            WriteDB_StdaaToBinary(si, sequence);
             break;
 
         case CSeq_data::e_Ncbieaa:
-            WriteDB_EaaToBinary(si, m_Sequence);
+            WriteDB_EaaToBinary(si, sequence);
             break;
 
         case CSeq_data::e_Iupacaa:
-            WriteDB_IupacaaToBinary(si, m_Sequence);
+            WriteDB_IupacaaToBinary(si, sequence);
             break;
 
         case CSeq_data::e_Ncbi2na:
-            WriteDB_Ncbi2naToBinary(si, m_Sequence);
+            WriteDB_Ncbi2naToBinary(si, sequence);
             break;
 
         case CSeq_data::e_Ncbi4na:
-            WriteDB_Ncbi4naToBinary(si, m_Sequence, m_Ambig);
+            WriteDB_Ncbi4naToBinary(si, sequence, ambig);
             break;
 
         case CSeq_data::e_Iupacna:
-             WriteDB_IupacnaToBinary(si, m_Sequence, m_Ambig);
+             WriteDB_IupacnaToBinary(si, sequence, ambig);
              break;
 
         default:
             msg = "Unable to process sequence for entry [";
-            msg += (m_Bioseq->GetId().front())->GetSeqIdString(false);
+            msg += (bioseq->GetId().front())->GetSeqIdString(false);
             msg += "].";
         }
 
@@ -1039,7 +1062,7 @@ void CWriteDB_Impl::x_CookSequence()
             NCBI_THROW(CWriteDBException, eArgErr, msg);
         }
     } else {
-        int sz = m_SeqVector.size();
+        int sz = seq_vector.size();
 
         if (sz == 0) {
             NCBI_THROW(CWriteDBException,
@@ -1048,19 +1071,19 @@ void CWriteDB_Impl::x_CookSequence()
                        "and no Bioseq_Handle available.");
         }
 
-        if (m_Protein) {
+        if (protein) {
             // I add one to the string length to allow the "i+1" in
             // the loop to be done safely.
 
-            m_Sequence.reserve(sz);
-            m_SeqVector.GetSeqData(0, sz, m_Sequence);
+            sequence.reserve(sz);
+            seq_vector.GetSeqData(0, sz, sequence);
         } else {
             // I add one to the string length to allow the "i+1" in the
             // loop to be done safely.
 
             string na8;
             na8.reserve(sz + 1);
-            m_SeqVector.GetSeqData(0, sz, na8);
+            seq_vector.GetSeqData(0, sz, na8);
             na8.resize(sz + 1);
 
             string na4;
@@ -1073,8 +1096,8 @@ void CWriteDB_Impl::x_CookSequence()
             WriteDB_Ncbi4naToBinary(na4.data(),
                                     (int) na4.size(),
                                     (int) si.GetLength(),
-                                    m_Sequence,
-                                    m_Ambig);
+                                    sequence,
+                                    ambig);
         }
     }
 }
@@ -1132,7 +1155,17 @@ void CWriteDB_Impl::x_Publish()
         return;
     }
 
+    if (m_NumThreads > 1) {
+        x_QueueSequence();
+        return;
+    }
+
+    x_CookData();
+    x_WriteSequence();
+}
 
+void CWriteDB_Impl::x_WriteSequence()
+{
     if(m_DbVersion == eBDB_Version5 && m_Lmdbdb.Empty()) {
         const string lmdb_fname_w_path = BuildLMDBFileName(m_Dbname, m_Protein);
         Uint8 map_size = 0;
@@ -1153,8 +1186,6 @@ void CWriteDB_Impl::x_Publish()
         }
     }
 
-    x_CookData();
-
     bool done = false;
 
     if (! m_Volume.Empty()) {
@@ -1239,6 +1270,143 @@ void CWriteDB_Impl::x_Publish()
     }
 }
 
+/// Number of sequences converted together when running multithreaded.
+static const size_t kWriteDBPendingBatchSize = 4096;
+
+void CWriteDB_Impl::SetNumThreads(int num_threads)
+{
+    x_FlushPending();
+#ifdef _OPENMP
+    m_NumThreads = max(num_threads, 1);
+#else
+    m_NumThreads = 1;
+#endif
+}
+
+void CWriteDB_Impl::x_SwapPending(SPendingSequence & pending)
+{
+    pending.bioseq.Swap(m_Bioseq);
+    swap(pending.seq_vector, m_SeqVector);
+    pending.deflines.Swap(m_Deflines);
+    pending.ids.swap(m_Ids);
+    pending.linkouts.swap(m_Linkouts);
+    pending.memberships.swap(m_Memberships);
+    swap(pending.pig, m_Pig);
+    swap(pending.hash, m_Hash);
+    swap(pending.seq_length, m_SeqLength);
+    pending.sequence.swap(m_Sequence);
+    pending.ambig.swap(m_Ambig);
+    pending.bin_hdr.swap(m_BinHdr);
+    pending.tax_ids.swap(m_TaxIds);
+    pending.blobs.swap(m_Blobs);
+    pending.have_blob.swap(m_HaveBlob);
+}
+
+void CWriteDB_Impl::x_QueueSequence()
+{
+    unique_ptr<SPendingSequence> pending(new SPendingSequence());
+    pending->oid = -1;
+    x_SwapPending(*pending);
+
+    // The blobs went with the queued sequence; the next sequence needs
+    // its own set.
+    m_Blobs.resize(pending->blobs.size());
+    NON_CONST_ITERATE(vector< CRef<CBlastDbBlob> >, iter, m_Blobs) {
+        iter->Reset(new CBlastDbBlob);
+    }
+    m_HaveBlob.assign(pending->have_blob.size(), 0);
+
+    m_Pending.push_back(std::move(pending));
+
+    if (m_Pending.size() >= kWriteDBPendingBatchSize) {
+        x_FlushPending();
+    }
+}
+
+void CWriteDB_Impl::x_CookPending(SPendingSequence & pending) const
+{
+    x_ExtractDeflines(pending.bioseq,
+                      pending.deflines,
+                      pending.bin_hdr,
+                      pending.memberships,
+                      pending.linkouts,
+                      pending.pig,
+                      pending.tax_ids,
+                      pending.oid,
+                      m_ParseIDs,
+                      m_LongSeqId,
+                      m_limitDefline,
+                      m_ScanBioseq4CFastaReaderUsrObjct);
+    x_CookIds(pending.deflines, pending.bin_hdr, pending.ids);
+
+    if (pending.sequence.empty()) {
+        x_CookSequence(pending.bioseq,
+                       pending.seq_vector,
+                       m_Protein,
+                       pending.sequence,
+                       pending.ambig);
+    }
+
+    if (m_Protein && m_MaskedLetters.size()) {
+        x_MaskSequence(pending.sequence);
+    }
+}
+
+void CWriteDB_Impl::x_FlushPending()
+{
+    if (m_Pending.empty()) {
+        return;
+    }
+
+    // Without parsed ids the header depends on the OID; assume that
+    // all pending sequences go to the current volume and rebuild the
+    // header while writing if that turns out to be wrong.
+    if (! m_ParseIDs) {
+        int oid = m_Volume.NotEmpty() ? m_Volume->GetOID() : 0;
+        NON_CONST_ITERATE(vector< unique_ptr<SPendingSequence> >, it,
+                          m_Pending) {
+            (*it)->oid = oid++;
+        }
+    }
+
+    const int num_pending = static_cast<int>(m_Pending.size());
+    #pragma omp parallel for num_threads(m_NumThreads) schedule(dynamic, 16)
+    for (int i = 0; i < num_pending; i++) {
+        SPendingSequence & pending = *m_Pending[i];
+        try {
+            x_CookPending(pending);
+        } catch (...) {
+            pending.error = std::current_exception();
+        }
+    }
+
+    // Write in input order by swapping each queued sequence into the
+    // accumulated sequence members; a sequence still being built by
+    // the caller is set aside meanwhile.
+    vector< unique_ptr<SPendingSequence> > pending_list;
+    pending_list.swap(m_Pending);
+
+    SPendingSequence current = SPendingSequence();
+    x_SwapPending(current);
+
+    NON_CONST_ITERATE(vector< unique_ptr<SPendingSequence> >, it,
+                      pending_list) {
+        SPendingSequence & pending = **it;
+        if (pending.error) {
+            x_SwapPending(current);
+            std::rethrow_exception(pending.error);
+        }
+        x_SwapPending(pending);
+
+        if (! m_ParseIDs  &&  m_Volume.NotEmpty()  &&
+            pending.oid != m_Volume->GetOID()) {
+            x_CookHeader();
+        }
+        x_WriteSequence();
+    }
+    x_SwapPending(current);
+}
+
 void CWriteDB_Impl::SetDeflines(const CBlast_def_line_set & deflines)
 {
     CRef<CBlast_def_line_set>
@@ -1494,6 +1662,9 @@ int CWriteDB_Impl::CreateColumn(const string & title, bool mbo)
 {
     _ASSERT(FindColumn(title) == -1);
 
+    // Queued sequences carry blobs for the existing columns only.
+    x_FlushPending();
+
     size_t col_id = m_Blobs.size() / 2;
 
     _ASSERT(m_HaveBlob.size()     == col_id);
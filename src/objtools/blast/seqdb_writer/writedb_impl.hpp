@@ -211,6 +211,17 @@ public:
     /// @param sz Maximum sequence letters per volume.
     void SetMaxVolumeLetters(Uint8 sz);
 
+    /// Set the number of threads used to convert sequences.
+    ///
+    /// With more than one thread, published sequences are queued and
+    /// converted (header serialization, sequence packing and masking)
+    /// in parallel batches; the converted sequences are then appended
+    /// to the volumes in their original order by the calling thread.
+    /// The database produced is identical to the single threaded case.
+    ///
+    /// @param num_threads Number of conversion threads.
+    void SetNumThreads(int num_threads);
+
     /// Extract deflines from a CBioseq.
     ///
     /// Given a CBioseq, this method extracts and returns header info
@@ -390,6 +401,7 @@ private:
     bool          m_ParseIDs;         ///< Generate ISAM files
     bool          m_UseGiMask;        ///< Generate GI-based mask files
     EBlastDbVersion m_DbVersion;      ///< BLASTDB version
+    int           m_NumThreads;       ///< Sequence conversion threads.
 
     /// Column titles.
     vector<string> m_ColumnTitles;
@@ -406,11 +418,56 @@ private:
     vector< CRef<CWriteDB_GiMask> > m_GiMasks;
 #endif
 
+    /// Sequence queued for conversion when running multithreaded.
+    ///
+    /// This holds the same per-sequence data as the accumulated
+    /// sequence members of this class, and is swapped with them when
+    /// the sequence is queued and again when it is written.
+    struct SPendingSequence {
+        CConstRef<CBioseq>             bioseq;
+        CSeqVector                     seq_vector;
+        CConstRef<CBlast_def_line_set> deflines;
+        vector< CRef<CSeq_id> >        ids;
+        vector< vector<int> >          linkouts;
+        vector< vector<int> >          memberships;
+        int                            pig;
+        int                            hash;
+        int                            seq_length;
+        string                         sequence;
+        string                         ambig;
+        string                         bin_hdr;
+        set<TTaxId>                    tax_ids;
+        vector< CRef<CBlastDbBlob> >   blobs;
+        vector<int>                    have_blob;
+        /// Volume OID the header was built for (if ids are not parsed).
+        int                            oid;
+        /// Exception thrown while converting this sequence.
+        std::exception_ptr             error;
+    };
+
+    /// Sequences waiting to be converted and written, in input order.
+    vector< unique_ptr<SPendingSequence> > m_Pending;
+
     // Functions
 
     /// Flush accumulated sequence data to volume.
     void x_Publish();
 
+    /// Append the cooked current sequence to the current volume.
+    void x_WriteSequence();
+
+    /// Move the accumulated sequence data to the conversion queue.
+    void x_QueueSequence();
+
+    /// Convert the queued sequences in parallel and write them.
+    void x_FlushPending();
+
+    /// Exchange the accumulated sequence data with a queued sequence.
+    void x_SwapPending(SPendingSequence & pending);
+
+    /// Convert the data of a queued sequence.
+    void x_CookPending(SPendingSequence & pending) const;
+
     /// Compute name of alias file produced.
     string x_MakeAliasName();
 
@@ -429,18 +486,42 @@ private:
     /// Collect ids for ISAM files.
     void x_CookIds();
 
+    /// Collect ids for ISAM files from deflines or a binary header.
+    /// @param deflines Deflines of the sequence. [in|out]
+    /// @param bin_hdr Binary header, used if deflines are empty. [in]
+    /// @param ids The collected ids. [out]
+    static void x_CookIds(CConstRef<CBlast_def_line_set> & deflines,
+                          const string                   & bin_hdr,
+                          vector< CRef<CSeq_id> >        & ids);
+
     /// Compute the length of the current sequence.
     int x_ComputeSeqLength();
 
     /// Convert sequence data into usable forms.
     void x_CookSequence();
 
+    /// Convert sequence data into the packed on-disk format.
+    /// @param bioseq Bioseq holding the sequence data. [in]
+    /// @param seq_vector Used if the Bioseq has no sequence data. [in]
+    /// @param protein True for protein sequences. [in]
+    /// @param sequence The packed sequence. [out]
+    /// @param ambig The packed ambiguities. [out]
+    static void x_CookSequence(const CConstRef<CBioseq> & bioseq,
+                               CSeqVector               & seq_vector,
+                               bool                       protein,
+                               string                   & sequence,
+                               string                   & ambig);
+
     /// Prepare column data to be appended to disk.
     void x_CookColumns();
 
     /// Replace masked input letters with m_MaskByte value.
     void x_MaskSequence();
 
+    /// Replace masked input letters with m_MaskByte value.
+    /// @param sequence The packed protein sequence. [in|out]
+    void x_MaskSequence(string & sequence) const;
+
     /// Get binary version of deflines from 'user' data in Bioseq.
     ///
     /// Some CBioseq objects (e.g. those from CSeqDB) have an ASN.1
@@ -84,7 +84,7 @@ ERW_Result SPSG_BlobReader::x_Read(SPSG_Reply::SItem& src, void* buf, size_t cou
 
     CheckForNewChunks(src.chunks);
 
-    for (; m_Chunk < m_Data.size(); ++m_Chunk) {
+    for (; m_Chunk < m_Data.size(); x_NextChunk()) {
         auto& data = m_Data[m_Chunk];
 
         // Chunk has not been received yet
@@ -100,35 +100,85 @@ ERW_Result SPSG_BlobReader::x_Read(SPSG_Reply::SItem& src, void* buf, size_t cou
         m_Index += to_copy;
 
         if (!count) return eRW_Success;
+    }
+
+    return src.expected.Cmp<equal_to>(src.received) ? eRW_Eof : eRW_Success;
+}
 
-        m_Index = 0;
+ERW_Result SPSG_BlobReader::x_Get(SPSG_Reply::SItem& src, const char*& data, size_t& size)
+{
+    size = 0;
+
+    CheckForNewChunks(src.chunks);
+
+    for (; m_Chunk < m_Data.size(); x_NextChunk()) {
+        auto& chunk = m_Data[m_Chunk];
+
+        // Chunk has not been received yet
+        if (chunk.empty()) return eRW_Success;
+
+        if (m_Index < chunk.size()) {
+            data = chunk.data() + m_Index;
+            size = chunk.size() - m_Index;
+            m_Index = chunk.size();
+            return eRW_Success;
+        }
     }
 
     return src.expected.Cmp<equal_to>(src.received) ? eRW_Eof : eRW_Success;
 }
 
-ERW_Result SPSG_BlobReader::Read(void* buf, size_t count, size_t* bytes_read)
+void SPSG_BlobReader::x_NextChunk()
+{
+    // The chunk has been read completely, no need to keep it any longer
+    SPSG_Chunk().swap(m_Data[m_Chunk++]);
+    m_Index = 0;
+}
+
+template <class TImpl>
+ERW_Result SPSG_BlobReader::x_Wait(TImpl impl, bool wait)
 {
-    size_t read;
     const auto kSeconds = TPSG_ReaderTimeout::GetDefault();
     CDeadline deadline(kSeconds);
 
     auto src_locked = m_Src.GetLock();
 
     do {
-        auto rv = x_Read(*src_locked, buf, count, &read);
+        size_t read;
+        auto rv = impl(*src_locked, read);
 
         if ((rv != eRW_Success) || (read != 0)) {
-            if (bytes_read) *bytes_read = read;
             return rv;
         }
     }
-    while (m_Src.WaitUntil(src_locked, deadline));
+    while (wait && m_Src.WaitUntil(src_locked, deadline));
+
+    if (!wait) return eRW_Success;
 
     NCBI_THROW_FMT(CPSG_Exception, eTimeout, "Timeout on reading (after " << kSeconds << " seconds)");
     return eRW_Error;
 }
 
+ERW_Result SPSG_BlobReader::Read(void* buf, size_t count, size_t* bytes_read)
+{
+    if (bytes_read) *bytes_read = 0;
+
+    return x_Wait([&](SPSG_Reply::SItem& src, size_t& read) {
+            auto rv = x_Read(src, buf, count, &read);
+            if (bytes_read) *bytes_read = read;
+            return rv;
+        }, true);
+}
+
+ERW_Result SPSG_BlobReader::Get(const char*& data, size_t& size, bool wait)
+{
+    return x_Wait([&](SPSG_Reply::SItem& src, size_t& read) {
+            auto rv = x_Get(src, data, size);
+            read = size;
+            return rv;
+        }, wait);
+}
+
 ERW_Result SPSG_BlobReader::PendingCount(size_t* count)
 {
     assert(count);
@@ -166,6 +216,55 @@ void SPSG_BlobReader::CheckForNewChunks(vector<SPSG_Chunk>& chunks)
     }
 }
 
+bool SPSG_BlobStreambuf::x_Get(bool wait)
+{
+    const char* data = nullptr;
+    size_t size = 0;
+
+    // The chunk of the current get area is released by Get()
+    setg(nullptr, nullptr, nullptr);
+
+    // Exceptions (e.g. reading timeout) are reported the same way CRWStreambuf does,
+    // instead of silently turning into badbit
+    const char* const kMessage = "SPSG_BlobStreambuf::x_Get(): SPSG_BlobReader::Get()";
+    ERW_Result rv;
+
+    try {
+        rv = Get(data, size, wait);
+    }
+    catch (CException& e) {
+        NCBI_REPORT_EXCEPTION(kMessage, e);
+        rv = eRW_Error;
+    }
+    catch (exception& e) {
+        ERR_POST(Error << '[' << kMessage << "] Exception: " << e.what());
+        rv = eRW_Error;
+    }
+
+    if (rv == eRW_Error) THROW1_TRACE(IOS_BASE::failure, "eRW_Error");
+    if (rv != eRW_Success) return false;
+
+    // The data are not modified, the get area is only read from
+    auto begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+    return true;
+}
+
+SPSG_BlobStreambuf::int_type SPSG_BlobStreambuf::underflow()
+{
+    if ((gptr() >= egptr()) && !x_Get(true)) return traits_type::eof();
+
+    return traits_type::to_int_type(*gptr());
+}
+
+streamsize SPSG_BlobStreambuf::showmanyc()
+{
+    // No data at hand and no more data to come
+    if (!x_Get(false)) return -1;
+
+    return egptr() - gptr();
+}
+
 
 const char* s_GetRequestTypeName(CPSG_Request::EType type)
 {
@@ -38,15 +38,13 @@
 #include "psg_client_transport.hpp"
 
 #include <corelib/reader_writer.hpp>
-#include <corelib/rwstream.hpp>
 
 #include <unordered_map>
 #include <mutex>
 
 BEGIN_NCBI_SCOPE
 
-// ICC does not like this array to be a direct base of SPSG_RStream
-struct SPSG_BlobReader : IReader, protected array<char, 64 * 1024>
+struct SPSG_BlobReader : IReader
 {
     using TStats = pair<bool, weak_ptr<SPSG_Stats>>;
     SPSG_BlobReader(SPSG_Reply::SItem::TTS& src, TStats stats = TStats());
@@ -54,9 +52,18 @@ struct SPSG_BlobReader : IReader, protected array<char, 64 * 1024>
     ERW_Result Read(void* buf, size_t count, size_t* bytes_read = 0);
     ERW_Result PendingCount(size_t* count);
 
+    // Gives out the rest of the current chunk in place (without copying),
+    // the data stay valid until the next call. Waits for the chunk if needed
+    ERW_Result Get(const char*& data, size_t& size, bool wait = true);
+
 private:
+    template <class TImpl>
+    ERW_Result x_Wait(TImpl impl, bool wait);
+
     void CheckForNewChunks(vector<SPSG_Chunk>& chunks);
     ERW_Result x_Read(SPSG_Reply::SItem& src, void* buf, size_t count, size_t* bytes_read);
+    ERW_Result x_Get(SPSG_Reply::SItem& src, const char*& data, size_t& size);
+    void x_NextChunk();
 
     SPSG_Reply::SItem::TTS& m_Src;
     TStats m_Stats;
@@ -65,12 +72,29 @@ private:
     size_t m_Index = 0;
 };
 
-struct SPSG_RStream : private SPSG_BlobReader, public CRStream
+// Uses the received chunks as the get area,
+// so the blob data are only copied once (into user buffers)
+struct SPSG_BlobStreambuf : streambuf, private SPSG_BlobReader
+{
+    template <class... TArgs>
+    SPSG_BlobStreambuf(TArgs&&... args) :
+        SPSG_BlobReader(std::forward<TArgs>(args)...)
+    {}
+
+protected:
+    int_type underflow() override;
+    streamsize showmanyc() override;
+
+private:
+    bool x_Get(bool wait);
+};
+
+struct SPSG_RStream : private SPSG_BlobStreambuf, public istream
 {
     template <class... TArgs>
     SPSG_RStream(TArgs&&... args) :
-        SPSG_BlobReader(std::forward<TArgs>(args)...),
-        CRStream(this, size(), data())
+        SPSG_BlobStreambuf(std::forward<TArgs>(args)...),
+        istream(this)
     {}
 };
 
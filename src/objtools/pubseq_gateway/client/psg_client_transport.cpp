@@ -853,6 +853,11 @@ SPSG_Request::EStateResult SPSG_Request::StateArgs(const char*& data, size_t& le
     if (size) {
         m_State = &SPSG_Request::StateData;
         m_Buffer.data_to_read = size;
+
+        // So the data are copied only once, even if coming in many frames.
+        // The size comes from the server, so a chunk bigger than that grows as usual
+        const size_t kMaxReserve = 4 * 1024 * 1024;
+        m_Buffer.chunk.reserve(min(size, kMaxReserve));
     } else {
         m_State = &SPSG_Request::StatePrefix;
         return Add();
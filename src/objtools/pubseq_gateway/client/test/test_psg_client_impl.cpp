@@ -701,6 +701,67 @@ BOOST_AUTO_TEST_CASE(StreamRead)
     MtReading<SStreamRead>();
 }
 
+BOOST_AUTO_TEST_CASE(StreamThroughput)
+{
+    // The data come in the default HTTP/2 DATA frame size
+    const size_t kFrameSize = 16 * 1024;
+    const size_t kChunkSize = 1024 * 1024;
+    const size_t kChunks = 4;
+
+    const SPSG_Params params;
+    auto reply = make_shared<SPSG_Reply>("", params, make_shared<TPSG_Queue>());
+    SPSG_TimedRequest request(make_shared<SPSG_Request>(string(), reply, CDiagContext::GetRequestContext().Clone(), params));
+
+    vector<char> src_chunk(kChunkSize);
+    r.Fill(src_chunk.data(), src_chunk.size());
+
+    string src;
+    auto add_args = [&](vector<string> args) { string s; s_OutputArgs(s, r, std::move(args)); src += s; };
+
+    add_args(s_GetBlobMetaArgs(1, "id", kChunks + 1));
+
+    for (size_t i = 0; i < kChunks; ++i) {
+        add_args(s_GetBlobDataArgs(1, "id", i, kChunkSize));
+        src.append(src_chunk.data(), src_chunk.size());
+    }
+
+    add_args(s_GetReplyMetaArgs(kChunks + 2));
+
+    CStopWatch sw(CStopWatch::eStart);
+
+    thread receiver([&]() {
+        auto [processor_id, req] = request.Get();
+        BOOST_REQUIRE_MESSAGE_MT_SAFE(req != nullptr, "No request to receive data for");
+
+        for (size_t i = 0; i < src.size(); i += kFrameSize) {
+            auto result = req->OnReplyData(processor_id, src.data() + i, min(kFrameSize, src.size() - i), false);
+            if (result != SPSG_Request::eContinue) break;
+        }
+
+        req->OnReplyDone(processor_id)->SetComplete();
+    });
+
+    auto new_item = reply->GetNextItem(CDeadline(60, 0));
+    BOOST_REQUIRE_MESSAGE(new_item && new_item.value(), "No blob item received");
+
+    SPSG_RStream is(*new_item.value());
+    vector<char> dst_chunk(kChunkSize);
+    size_t received = 0;
+
+    while (is.read(dst_chunk.data(), dst_chunk.size())) {
+        BOOST_REQUIRE_MESSAGE(equal(dst_chunk.begin(), dst_chunk.end(), src_chunk.begin()), "Received data does not match expected");
+        received += is.gcount();
+    }
+
+    receiver.join();
+
+    const auto elapsed = sw.Elapsed();
+
+    BOOST_REQUIRE_MESSAGE(is.eof() && !is.gcount(), "Received a partial chunk");
+    BOOST_REQUIRE_MESSAGE(received == kChunks * kChunkSize, "Received less data than sent");
+    BOOST_TEST_MESSAGE("Blob stream throughput: " << received / elapsed / 1024 / 1024 << " MB/s");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(PSG)
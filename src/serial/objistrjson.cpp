@@ -34,12 +34,21 @@
 #include <corelib/ncbistd.hpp>
 #include <corelib/ncbi_limits.h>
 
+#include <corelib/ncbi_param.hpp>
+
 #include <serial/objistrjson.hpp>
 
 #define NCBI_USE_ERRCODE_X   Serial_OStream
 
 BEGIN_NCBI_SCOPE
 
+NCBI_PARAM_DECL(bool, SERIAL, JSON_FAST_SCAN);
+NCBI_PARAM_DEF_EX(bool, SERIAL, JSON_FAST_SCAN, true,
+                  eParam_NoThread, SERIAL_JSON_FAST_SCAN);
+typedef NCBI_PARAM_TYPE(SERIAL, JSON_FAST_SCAN) TJsonFastScan;
+static CSafeStatic<TJsonFastScan> s_JsonFastScan;
+
+
 CObjectIStream* CObjectIStream::CreateObjectIStreamJson()
 {
     return new CObjectIStreamJson();
@@ -52,6 +61,7 @@ CObjectIStreamJson::CObjectIStreamJson(void)
     m_BlockStart(false),
     m_ExpectValue(false),
     m_GotNameless(false),
+    m_FastScan(s_JsonFastScan->Get()),
     m_Closing(0),
     m_StringEncoding( eEncoding_UTF8 ),
     m_BinaryFormat(eDefault)
@@ -65,6 +75,7 @@ CObjectIStreamJson::CObjectIStreamJson(CNcbiIstream& in, EOwnership deleteIn)
     m_BlockStart(false),
     m_ExpectValue(false),
     m_GotNameless(false),
+    m_FastScan(s_JsonFastScan->Get()),
     m_Closing(0),
     m_StringEncoding( eEncoding_UTF8 ),
     m_BinaryFormat(eDefault)
@@ -128,6 +139,16 @@ void CObjectIStreamJson::SetBinaryDataFormat(CObjectIStreamJson::EBinaryDataForm
     m_BinaryFormat = fmt;
 }
 
+void CObjectIStreamJson::SetFastScan(bool set)
+{
+    m_FastScan = set;
+}
+
+bool CObjectIStreamJson::GetFastScan(void) const
+{
+    return m_FastScan;
+}
+
 char CObjectIStreamJson::GetChar(void)
 {
     return m_Input.GetChar();
@@ -310,12 +331,70 @@ TUnicodeSymbol CObjectIStreamJson::ReadUtf8Char(char c)
     return chU;
 }
 
+// Copy (or skip, if 'str' is null) the chars of a string value which need
+// no decoding, up to the closing quote or the next char that does
+void CObjectIStreamJson::x_ScanString(string* str, EStringType type)
+{
+    if ( !m_FastScan  ||  !m_Utf8Buf.empty() ) {
+        return;
+    }
+    EEncoding enc_out(type == eStringTypeUTF8 ? eEncoding_UTF8 : m_StringEncoding);
+    m_Input.ExtractPlainChars(str, '\"', '\\',
+        enc_out == eEncoding_UTF8  ||  enc_out == eEncoding_Unknown);
+}
+
+// Same for unquoted data; returns true if the end of data is found
+bool CObjectIStreamJson::x_ScanData(string& str, EStringType type)
+{
+    if ( !m_FastScan  ||  !m_Utf8Buf.empty() ) {
+        return false;
+    }
+    EEncoding enc_out(type == eStringTypeUTF8 ? eEncoding_UTF8 : m_StringEncoding);
+    bool raw8 = enc_out == eEncoding_UTF8  ||  enc_out == eEncoding_Unknown;
+    for (;;) {
+        size_t avail = m_Input.GetAvailableChars();
+        const char* pos = m_Input.GetCurrentPos();
+        const char* end = pos;
+        for ( ; end != pos + avail; ++end ) {
+            switch ( *end ) {
+            case ',': case ']': case '}': case ' ': case '\r': case '\n':
+            case '\0':
+                str.append(pos, end - pos);
+                m_Input.SkipChars(end - pos);
+                return true;
+            case '\\':
+                break;
+            default:
+                if ( raw8  ||  (*end & 0x80) == 0 ) {
+                    continue;
+                }
+                break;
+            }
+            break;
+        }
+        str.append(pos, end - pos);
+        m_Input.SkipChars(end - pos);
+        if ( end != pos + avail ) {
+            return false;
+        }
+    }
+}
+
 string CObjectIStreamJson::x_ReadString(EStringType type)
+{
+    string str;
+    x_ReadString(str, type);
+    str.reserve(str.size());
+    return str;
+}
+
+void CObjectIStreamJson::x_ReadString(string& str, EStringType type)
 {
     m_ExpectValue = false;
     Expect('\"',true);
-    string str;
+    str.erase();
     for (;;) {
+        x_ScanString(&str, type);
         bool encoded = false;
         char c = ReadEncodedChar(type, encoded);
         if (!encoded) {
@@ -331,14 +410,15 @@ string CObjectIStreamJson::x_ReadString(EStringType type)
             str.reserve(str.size()*2);
         }
     }
-    str.reserve(str.size());
-    return str;
 }
 
 void CObjectIStreamJson::x_ReadData(string& str, EStringType type /*= eStringTypeVisible*/)
 {
     SkipWhiteSpace();
     for (;;) {
+        if (x_ScanData(str, type)) {
+            break;
+        }
         bool encoded = false;
         char c = ReadEncodedChar(type, encoded);
         if (!encoded && strchr(",]} \r\n", c)) {
@@ -373,6 +453,9 @@ void  CObjectIStreamJson::x_SkipData(void)
     m_ExpectValue = false;
     char to = GetChar(true);
     for (;;) {
+        if (to == '\"') {
+            x_ScanString(0, eStringTypeUTF8);
+        }
         bool encoded = false;
         char c = ReadEncodedChar(eStringTypeUTF8, encoded);
         if (!encoded) {
@@ -389,14 +472,14 @@ void  CObjectIStreamJson::x_SkipData(void)
     }
 }
 
-string CObjectIStreamJson::ReadKey(void)
+const string& CObjectIStreamJson::ReadKey(void)
 {
     if (!m_RejectedTag.empty()) {
-        m_LastTag = m_RejectedTag;
+        m_LastTag.swap(m_RejectedTag);
         m_RejectedTag.erase();
     } else {
         SkipWhiteSpace();
-        m_LastTag = x_ReadString(eStringTypeVisible);
+        x_ReadString(m_LastTag, eStringTypeVisible);
         Expect(':', true);
         SkipWhiteSpace();
     }
@@ -810,7 +893,7 @@ void CObjectIStreamJson::EndClass(void)
 TMemberIndex CObjectIStreamJson::FindDeep(
     const CItemsInfo& items, const CTempString& name, bool& deep) const
 {
-    TMemberIndex i = items.Find(name);
+    TMemberIndex i = m_FastScan ? FindMember(items, name) : items.Find(name);
     if (i != kInvalidMember) {
         deep = false;
         return i;
@@ -854,6 +937,35 @@ TMemberIndex CObjectIStreamJson::FindDeep(
     return kInvalidMember;
 }
 
+TMemberIndex CObjectIStreamJson::FindMember(
+    const CItemsInfo& items, const CTempString& name) const
+{
+    // members usually come in the order of their declaration,
+    // so first try the one following the member found last time
+    size_t depth = GetStackDepth();
+    if (m_MemberHints.size() <= depth) {
+        m_MemberHints.resize(depth + 1,
+            make_pair((const CItemsInfo*)nullptr, kInvalidMember));
+    }
+    pair<const CItemsInfo*, TMemberIndex>& hint = m_MemberHints[depth];
+    TMemberIndex i;
+    if (hint.first == &items) {
+        i = hint.second + 1;
+        if (i > items.LastIndex()) {
+            i = items.FirstIndex();
+        }
+        if (name == items.GetItemInfo(i)->GetId().GetName()) {
+            hint.second = i;
+            return i;
+        }
+    }
+    i = items.Find(name);
+    if (i != kInvalidMember) {
+        hint = make_pair(&items, i);
+    }
+    return i;
+}
+
 TMemberIndex CObjectIStreamJson::BeginClassMember(const CClassTypeInfo* classType)
 {
     TMemberIndex first = classType->GetMembers().FirstIndex();
@@ -880,9 +992,9 @@ TMemberIndex CObjectIStreamJson::BeginClassMember(const CClassTypeInfo* classTyp
             }
         }
     }
-    string tagName = ReadKey();
+    CTempString tagName = ReadKey();
 
-    if (tagName[0] == '#') {
+    if (!tagName.empty() && tagName[0] == '#') {
         tagName = tagName.substr(1);
         TopFrame().SetNotag();
         m_GotNameless = true;
@@ -964,8 +1076,8 @@ TMemberIndex CObjectIStreamJson::BeginClassMember(const CClassTypeInfo* classTyp
             }
         }
     }
-    string tagName = ReadKey();
-    if (tagName[0] == '#') {
+    CTempString tagName = ReadKey();
+    if (!tagName.empty() && tagName[0] == '#') {
         tagName = tagName.substr(1);
         TopFrame().SetNotag();
     }
@@ -1018,7 +1130,7 @@ TMemberIndex CObjectIStreamJson::BeginChoiceVariant(const CChoiceTypeInfo* choic
 {
     if ( !NextElement() )
         return kInvalidMember;
-    string tagName = ReadKey();
+    CTempString tagName = ReadKey();
     bool deep = false;
     TMemberIndex ind = FindDeep(choiceType->GetVariants(), tagName, deep);
     if ( ind == kInvalidMember ) {
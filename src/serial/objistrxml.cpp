@@ -46,6 +46,12 @@
 
 BEGIN_NCBI_SCOPE
 
+NCBI_PARAM_DECL(bool, SERIAL, XML_FAST_SCAN);
+NCBI_PARAM_DEF_EX(bool, SERIAL, XML_FAST_SCAN, true,
+                  eParam_NoThread, SERIAL_XML_FAST_SCAN);
+typedef NCBI_PARAM_TYPE(SERIAL, XML_FAST_SCAN) TXmlFastScan;
+static CSafeStatic<TXmlFastScan> s_XmlFastScan;
+
 static
 const char* s_SchemaInstanceNamespace = "http://www.w3.org/2001/XMLSchema-instance";
 
@@ -60,7 +66,8 @@ CObjectIStreamXml::CObjectIStreamXml(void)
       m_StdXml(false), m_Doctype_found(false), m_IsNil(false),
       m_Encoding( eEncoding_Unknown ),
       m_StringEncoding( eEncoding_UTF8 ),
-      m_SkipNextTag(false)
+      m_SkipNextTag(false),
+      m_FastScan(s_XmlFastScan->Get())
 {
     m_Utf8Pos = m_Utf8Buf.begin();
 }
@@ -71,7 +78,8 @@ CObjectIStreamXml::CObjectIStreamXml(CNcbiIstream& in, EOwnership deleteIn)
       m_StdXml(false), m_Doctype_found(false), m_IsNil(false),
       m_Encoding( eEncoding_Unknown ),
       m_StringEncoding( eEncoding_UTF8 ),
-      m_SkipNextTag(false)
+      m_SkipNextTag(false),
+      m_FastScan(s_XmlFastScan->Get())
 {
     m_Utf8Pos = m_Utf8Buf.begin();
     Open(in, deleteIn);
@@ -115,6 +123,16 @@ EEncoding CObjectIStreamXml::GetDefaultStringEncoding(void) const
     return m_StringEncoding;
 }
 
+void CObjectIStreamXml::SetFastScan(bool set)
+{
+    m_FastScan = set;
+}
+
+bool CObjectIStreamXml::GetFastScan(void) const
+{
+    return m_FastScan;
+}
+
 bool CObjectIStreamXml::EndOfData(void)
 {
     if (CObjectIStream::EndOfData()) {
@@ -153,7 +171,7 @@ Type CObjectIStreamXml::x_UseMemberDefault(void)
     return GetMemberDefault() ? CTypeConverter<Type>::Get(GetMemberDefault()) : Type();
 }
 
-static inline
+static constexpr
 bool IsBaseChar(char c)
 {
     return
@@ -164,43 +182,43 @@ bool IsBaseChar(char c)
         (c >= '\xF8' && c <= '\xFF');
 }
 
-static inline
+static constexpr
 bool IsDigit(char c)
 {
     return c >= '0' && c <= '9';
 }
 
-static inline
+static constexpr
 bool IsIdeographic(char /*c*/)
 {
     return false;
 }
 
-static inline
+static constexpr
 bool IsLetter(char c)
 {
     return IsBaseChar(c) || IsIdeographic(c);
 }
 
-static inline
+static constexpr
 bool IsFirstNameChar(char c)
 {
     return IsLetter(c) || c == '_' || c == ':';
 }
 
-static inline
+static constexpr
 bool IsCombiningChar(char /*c*/)
 {
     return false;
 }
 
-static inline
+static constexpr
 bool IsExtender(char c)
 {
     return c == '\xB7';
 }
 
-static inline
+static constexpr
 bool IsNameChar(char c)
 {
     return IsFirstNameChar(c) ||
@@ -208,6 +226,24 @@ bool IsNameChar(char c)
         IsCombiningChar(c) || IsExtender(c);
 }
 
+// name chars lookup table
+struct SXmlNameChars
+{
+    constexpr SXmlNameChars(void)
+        : m_IsNameChar()
+    {
+        for (int i = 0; i < 256; ++i) {
+            m_IsNameChar[i] = IsNameChar(char(i));
+        }
+    }
+    bool operator()(char c) const
+    {
+        return m_IsNameChar[(unsigned char)c];
+    }
+    bool m_IsNameChar[256];
+};
+static constexpr SXmlNameChars s_IsNameChar;
+
 static inline
 bool IsWhiteSpace(char c)
 {
@@ -439,7 +475,7 @@ CTempString CObjectIStreamXml::ReadName(char c)
 
     // find end of tag name
     size_t i = 1, iColon = 0;
-    while ( IsNameChar(c = m_Input.PeekChar(i)) ) {
+    while ( s_IsNameChar(c = m_Input.PeekChar(i)) ) {
         if (!m_Doctype_found && c == ':') {
             iColon = i+1;
         }
@@ -448,7 +484,7 @@ CTempString CObjectIStreamXml::ReadName(char c)
 
     // save beginning of tag name
     const char* ptr = m_Input.GetCurrentPos();
-    m_LastTag = string(ptr+iColon, i-iColon);
+    m_LastTag.assign(ptr+iColon, i-iColon);
     string ns_prefix;
     if (iColon > 1) {
         ns_prefix = string(ptr, iColon-1);
@@ -868,6 +904,19 @@ int CObjectIStreamXml::x_ReadEncodedChar(char endingChar, EStringType type, bool
     return c;
 }
 
+void CObjectIStreamXml::x_ScanPlainChars(string& str, char endingChar,
+                                         EStringType type)
+{
+    // extract in bulk the chars which x_ReadEncodedChar() would return as is
+    if (!m_FastScan || !m_Utf8Buf.empty()) {
+        return;
+    }
+    EEncoding enc_out( type == eStringTypeUTF8 ? eEncoding_UTF8 : m_StringEncoding);
+    EEncoding enc_in(m_Encoding == eEncoding_Unknown ? eEncoding_UTF8 : m_Encoding);
+    m_Input.ExtractPlainChars(&str, endingChar, '&',
+        enc_out == eEncoding_Unknown || enc_in == enc_out);
+}
+
 TUnicodeSymbol CObjectIStreamXml::ReadUtf8Char(char c)
 {
     size_t more = 0;
@@ -899,6 +948,7 @@ void CObjectIStreamXml::ReadAttributeValue(string& value, bool skipClosing)
     m_Input.SkipChar();
     bool encoded = false;
     for ( ;; ) {
+        x_ScanPlainChars(value, startChar, eStringTypeUTF8);
         int c = ReadEncodedChar(startChar,eStringTypeUTF8,encoded);
         if ( c < 0 )
             break;
@@ -1318,6 +1368,9 @@ void CObjectIStreamXml::ReadTagData(string& str, EStringType type)
     bool CR = false;
     try {
         for ( ;; ) {
+            if (!CR) {
+                x_ScanPlainChars(str, m_Attlist ? '\"' : '<', type);
+            }
             int c = ReadEncodedChar(m_Attlist ? '\"' : '<', type, encoded);
             if ( c < 0 ) {
                 if (m_Attlist || !ReadCDSection(str)) {
@@ -2304,6 +2357,18 @@ CObjectIStreamXml::BeginClassMember(const CClassTypeInfo* classType,
         tagName = RejectedName();
     }
 
+    if (m_FastScan && !x_IsStdXml() && !tagName.empty() &&
+        FetchFrameFromTop(1).GetFrameType() == TFrame::eFrameClass &&
+        FetchFrameFromTop(1).GetTypeInfo() == classType &&
+        !classType->GetName().empty()) {
+        // the tag is "ClassName_member"; match it as a whole
+        const TMemberTags& tags = x_GetMemberTags(classType);
+        for (TMemberIndex i = pos; i < tags.size(); ++i) {
+            if (!tags[i].empty() && tagName == tags[i]) {
+                return i;
+            }
+        }
+    }
     TMemberIndex ind = classType->GetMembers().Find(tagName);
     if (ind == kInvalidMember) {
         ind = classType->GetMembers().FindDeep(tagName, pos);
@@ -2370,6 +2435,28 @@ CObjectIStreamXml::BeginClassMember(const CClassTypeInfo* classType,
     return index;
 }
 
+const CObjectIStreamXml::TMemberTags&
+CObjectIStreamXml::x_GetMemberTags(const CClassTypeInfo* classType)
+{
+    TMemberTags& tags = m_MemberTags[classType];
+    if (tags.empty()) {
+        const CItemsInfo& items = classType->GetItems();
+        tags.resize(items.LastIndex() + 1);
+        for (CItemsInfo::CIterator i(items); i.Valid(); ++i) {
+            const CMemberId& id = items.GetItemInfo(i)->GetId();
+            if (id.IsAttlist() || id.HasNotag() || id.GetName().empty()) {
+                continue;
+            }
+            string tag = classType->GetName() + '_' + id.GetName();
+            // BeginClassMember() gives priority to members of notag members
+            if (items.FindDeep(tag, items.FirstIndex()) == kInvalidMember) {
+                tags[*i] = tag;
+            }
+        }
+    }
+    return tags;
+}
+
 void CObjectIStreamXml::EndClassMember(void)
 {
     m_SkipNextTag = false;
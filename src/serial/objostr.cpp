@@ -62,6 +62,11 @@
 #include <serial/serialimpl.hpp>
 #include <serial/error_codes.hpp>
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+
 #if defined(NCBI_OS_MSWIN)
 #  include <corelib/ncbi_os_mswin.hpp>
 #  include <io.h> 
@@ -80,6 +85,12 @@ NCBI_PARAM_DEF(bool, SERIAL, FastWriteDouble, true);
 typedef NCBI_PARAM_TYPE(SERIAL, FastWriteDouble) TFastWriteDouble;
 static CSafeStatic<TFastWriteDouble> s_FastWriteDouble;
 
+NCBI_PARAM_DECL(unsigned, SERIAL, WRITE_THREADS);
+NCBI_PARAM_DEF_EX(unsigned, SERIAL, WRITE_THREADS, 0,
+                  eParam_NoThread, SERIAL_WRITE_THREADS);
+typedef NCBI_PARAM_TYPE(SERIAL, WRITE_THREADS) TWriteThreads;
+static CSafeStatic<TWriteThreads> s_WriteThreads;
+
 
 CObjectOStream* CObjectOStream::Open(ESerialDataFormat format,
                                      const string& fileName,
@@ -310,7 +321,8 @@ CObjectOStream::CObjectOStream(ESerialDataFormat format,
       m_TypeAlias(nullptr),
       m_NonPrintSubst('#'),
       m_FixMethod(x_GetFixCharsMethodDefault()),
-      m_VerifyData(x_GetVerifyDataDefault())
+      m_VerifyData(x_GetVerifyDataDefault()),
+      m_WriteThreads(s_WriteThreads->Get())
 {
 }
 
@@ -855,6 +867,191 @@ void CObjectOStream::WriteContainerElement(const CConstObjectInfo& element)
     EndContainerElement();
 }
 
+bool CObjectOStream::WriteContainerElementsInParallel(
+    const CContainerTypeInfo* cType, TConstObjectPtr containerPtr)
+{
+    if ( m_WriteThreads < 2  ||  m_Objects  ||
+         !m_ObjectHookKey.IsEmpty()  ||
+         !m_ClassMemberHookKey.IsEmpty()  ||
+         !m_ChoiceVariantHookKey.IsEmpty()  ||
+         !m_PathWriteObjectHooks.IsEmpty()  ||
+         !m_PathWriteMemberHooks.IsEmpty()  ||
+         !m_PathWriteVariantHooks.IsEmpty() ) {
+        return false;
+    }
+    // only elements which take some time to write are worth it
+    TTypeInfo elementType = cType->GetElementType();
+    const CPointerTypeInfo* pointerType =
+        dynamic_cast<const CPointerTypeInfo*>(elementType);
+    TTypeInfo realType =
+        pointerType ? pointerType->GetPointedType() : elementType;
+    if ( realType->GetTypeFamily() != eTypeFamilyClass  &&
+         realType->GetTypeFamily() != eTypeFamilyChoice ) {
+        return false;
+    }
+    // with few elements the threads cost more than they save
+    const size_t kMinParallelElements = 64;
+    if ( cType->GetElementCount(containerPtr) <
+         max(kMinParallelElements, 4*size_t(m_WriteThreads)) ) {
+        return false;
+    }
+    vector<TConstObjectPtr> elements;
+    CContainerTypeInfo::CConstIterator i;
+    if ( cType->InitIterator(i, containerPtr) ) {
+        do {
+            TConstObjectPtr elementPtr = cType->GetElementPtr(i);
+            if ( pointerType &&
+                 !pointerType->GetObjectPointer(elementPtr) ) {
+                if ( GetVerifyData() == eSerialVerifyData_Yes ) {
+                    ThrowError(fUnassigned,
+                               "NULL element while writing container "+
+                               cType->GetName());
+                }
+                continue;
+            }
+            elements.push_back(elementPtr);
+        } while ( cType->NextElement(i) );
+    }
+
+    // each worker writes a batch of consecutive elements into one buffer
+    struct SBatch {
+        string         m_Data;
+        vector<size_t> m_Ends;
+        exception_ptr  m_Error;
+    };
+    const size_t kMaxBatchSize = 64;
+    size_t batch_size = elements.size() / (m_WriteThreads * 8);
+    batch_size = max(size_t(1), min(kMaxBatchSize, batch_size));
+    const size_t batch_count = (elements.size() + batch_size - 1) / batch_size;
+    auto write_batch = [this, &elements, elementType](SBatch& batch,
+                                                      size_t begin,
+                                                      size_t end) {
+        batch.m_Ends.reserve(end - begin);
+        CNcbiOstrstream str;
+        {
+            unique_ptr<CObjectOStream> out(OpenElementStream(str));
+            for ( size_t k = begin; k < end; ++k ) {
+                out->WriteParallelElement(elements[k], elementType);
+                out->FlushBuffer();
+                batch.m_Ends.push_back((size_t)NcbiStreamposToInt8(str.tellp()));
+            }
+        }
+        batch.m_Data = CNcbiOstrstreamToString(str);
+    };
+
+    // a fixed pool of workers takes batches in order; finished batches wait
+    // in a bounded queue (two per worker) to be copied into the output
+    const size_t kMaxReady = 2*size_t(m_WriteThreads);
+    mutex                mtx;
+    condition_variable   cond;
+    map<size_t, SBatch>  ready;    // finished batches by index
+    size_t               next = 0; // next batch to be taken by a worker
+    size_t               done = 0; // number of batches copied into the output
+    bool                 stop = false;
+    auto worker = [&]() {
+        for ( ;; ) {
+            size_t index;
+            {
+                unique_lock<mutex> lock(mtx);
+                cond.wait(lock, [&]() {
+                    return stop  ||  next >= batch_count  ||
+                        next < done + kMaxReady;
+                });
+                if ( stop  ||  next >= batch_count ) {
+                    return;
+                }
+                index = next++;
+            }
+            SBatch batch;
+            try {
+                write_batch(batch, index*batch_size,
+                            min((index+1)*batch_size, elements.size()));
+            }
+            catch ( ... ) {
+                batch.m_Error = current_exception();
+            }
+            {
+                lock_guard<mutex> lock(mtx);
+                ready[index] = std::move(batch);
+            }
+            cond.notify_all();
+        }
+    };
+    vector<thread> workers;
+    auto stop_workers = [&]() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stop = true;
+        }
+        cond.notify_all();
+        for ( auto& t : workers ) {
+            t.join();
+        }
+        workers.clear();
+    };
+    size_t thread_count = min(size_t(m_WriteThreads), batch_count);
+    try {
+        for ( size_t t = 0; t < thread_count; ++t ) {
+            workers.emplace_back(worker);
+        }
+        while ( done < batch_count ) {
+            SBatch batch;
+            {
+                unique_lock<mutex> lock(mtx);
+                cond.wait(lock, [&]() { return ready.count(done) != 0; });
+                auto it = ready.find(done);
+                batch = std::move(it->second);
+                ready.erase(it);
+                ++done;
+            }
+            cond.notify_all();
+            if ( batch.m_Error ) {
+                rethrow_exception(batch.m_Error);
+            }
+            size_t pos = 0;
+            for ( size_t end : batch.m_Ends ) {
+                PutParallelElement(batch.m_Data.data() + pos, end - pos);
+                pos = end;
+            }
+        }
+    }
+    catch ( ... ) {
+        stop_workers();
+        throw;
+    }
+    stop_workers();
+    return true;
+}
+
+CObjectOStream* CObjectOStream::OpenElementStream(CNcbiOstream& out) const
+{
+    CObjectOStream* stream = Open(GetDataFormat(), out, eNoOwnership);
+    stream->m_Flags = m_Flags;
+    stream->m_ParseDelayBuffers = m_ParseDelayBuffers;
+    stream->m_WriteNamedIntegersByValue = m_WriteNamedIntegersByValue;
+    stream->m_FastWriteDouble = m_FastWriteDouble;
+    stream->m_EnforceWritingDefaults = m_EnforceWritingDefaults;
+    stream->m_NonPrintSubst = m_NonPrintSubst;
+    stream->m_FixMethod = m_FixMethod;
+    stream->m_VerifyData = m_VerifyData;
+    stream->m_WriteThreads = 0;
+    stream->SetCanceledCallback(m_Output.GetCanceledCallback());
+    stream->SetUseIndentation(GetUseIndentation());
+    stream->SetUseEol(GetUseEol());
+    return stream;
+}
+
+void CObjectOStream::WriteParallelElement(TConstObjectPtr elementPtr,
+                                          TTypeInfo elementType)
+{
+    WriteObject(elementPtr, elementType);
+}
+
+void CObjectOStream::PutParallelElement(const char* data, size_t length)
+{
+    m_Output.Write(data, length);
+}
+
 void CObjectOStream::CopyContainer(const CContainerTypeInfo* cType,
                                    CObjectStreamCopier& copier)
 {
@@ -1190,6 +1387,16 @@ void CObjectOStream::SetCanceledCallback(const ICanceled* callback)
     m_Output.SetCanceledCallback(callback);
 }
 
+void CObjectOStream::SetWriteThreads(unsigned threads)
+{
+    m_WriteThreads = threads;
+}
+
+unsigned CObjectOStream::GetWriteThreads(void) const
+{
+    return m_WriteThreads;
+}
+
 void CObjectOStream::SetFormattingFlags(TSerial_Format_Flags flags)
 {
     TSerial_Format_Flags accepted =
@@ -582,8 +582,11 @@ void CObjectOStreamAsn::WriteContainer(const CContainerTypeInfo* cType,
     BEGIN_OBJECT_FRAME2(eFrameArray, cType);
     StartBlock();
     
+    // line wrapping depends on the line length, which is reset at EOL only
+    bool parallel = GetUseEol() &&
+        WriteContainerElementsInParallel(cType, containerPtr);
     CContainerTypeInfo::CConstIterator i;
-    if ( cType->InitIterator(i, containerPtr) ) {
+    if ( !parallel && cType->InitIterator(i, containerPtr) ) {
         TTypeInfo elementType = cType->GetElementType();
         BEGIN_OBJECT_FRAME2(eFrameArrayElement, elementType);
 
@@ -614,6 +617,34 @@ void CObjectOStreamAsn::WriteContainer(const CContainerTypeInfo* cType,
     END_OBJECT_FRAME();
 }
 
+CObjectOStream* CObjectOStreamAsn::OpenElementStream(CNcbiOstream& out) const
+{
+    CObjectOStreamAsn* stream =
+        static_cast<CObjectOStreamAsn*>(CObjectOStream::OpenElementStream(out));
+    // elements start at the current indentation, see WriteParallelElement()
+    stream->m_Output.IncIndentLevel(m_Output.GetIndentLevel(1));
+    return stream;
+}
+
+void CObjectOStreamAsn::WriteParallelElement(TConstObjectPtr elementPtr,
+                                             TTypeInfo elementType)
+{
+    // the same as NextElement(), but the comma is put by the main stream
+    m_BlockStart = false;
+    m_Output.PutEol();
+    WriteObject(elementPtr, elementType);
+}
+
+void CObjectOStreamAsn::PutParallelElement(const char* data, size_t length)
+{
+    if ( m_BlockStart )
+        m_BlockStart = false;
+    else
+        m_Output.PutChar(',');
+    // keep line numbers of GetPosition() right
+    m_Output.WriteLines(data, length);
+}
+
 void CObjectOStreamAsn::CopyContainer(const CContainerTypeInfo* cType,
                                       CObjectStreamCopier& copier)
 {
@@ -1238,8 +1238,16 @@ void CObjectOStreamAsnBinary::WriteContainer(const CContainerTypeInfo* cType,
     m_SkipNextTag = cType->IsTagImplicit();
 #endif
     
+    // elements are self-contained as constructed values use indefinite
+    // length, so they can be written independently
+#if CHECK_OUTSTREAM_INTEGRITY
+    bool parallel = false;
+#else
+    bool parallel = !m_SkipNextTag &&
+        WriteContainerElementsInParallel(cType, containerPtr);
+#endif
     CContainerTypeInfo::CConstIterator i;
-    if ( cType->InitIterator(i, containerPtr) ) {
+    if ( !parallel && cType->InitIterator(i, containerPtr) ) {
         TTypeInfo elementType = cType->GetElementType();
         BEGIN_OBJECT_FRAME2(eFrameArrayElement, elementType);
 
@@ -1274,6 +1282,14 @@ void CObjectOStreamAsnBinary::WriteContainer(const CContainerTypeInfo* cType,
 #endif
 }
 
+CObjectOStream* CObjectOStreamAsnBinary::OpenElementStream(CNcbiOstream& out) const
+{
+    CObjectOStreamAsnBinary* stream = static_cast<CObjectOStreamAsnBinary*>(
+        CObjectOStream::OpenElementStream(out));
+    stream->m_CStyleBigInt = m_CStyleBigInt;
+    return stream;
+}
+
 void CObjectOStreamAsnBinary::CopyContainer(const CContainerTypeInfo* cType,
                                             CObjectStreamCopier& copier)
 {
@@ -37,6 +37,13 @@
 #include <util/error_codes.hpp>
 #include <algorithm>
 
+#if NCBI_SSE >= 20
+#  include <emmintrin.h>
+#  if defined(NCBI_COMPILER_MSVC)
+#    include <intrin.h>
+#  endif
+#endif
+
 
 #define NCBI_USE_ERRCODE_X   Util_Stream
 
@@ -51,6 +58,55 @@ size_t BiggerBufferSize(size_t size) THROWS1_NONE
     return size * 2;
 }
 
+#if NCBI_SSE >= 20
+// index of the lowest bit set in a non-zero mask
+static inline
+unsigned FirstBit(unsigned mask)
+{
+#  if defined(NCBI_COMPILER_MSVC)
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return (unsigned) i;
+#  else
+    return (unsigned) __builtin_ctz(mask);
+#  endif
+}
+#endif
+
+// find the first char in [pos, end) which is either 'stop1' or 'stop2',
+// a control char, or a non-ASCII char unless 'allow8bit' is set
+static inline
+const char* FindSpecialChar(const char* pos, const char* end,
+                            char stop1, char stop2, bool allow8bit)
+{
+#if NCBI_SSE >= 20
+    const __m128i c1   = _mm_set1_epi8(stop1);
+    const __m128i c2   = _mm_set1_epi8(stop2);
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    for ( ; end - pos >= 16; pos += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, c1), _mm_cmpeq_epi8(v, c2));
+        // (unsigned) v <= 0x1F
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+        unsigned mask = (unsigned) _mm_movemask_epi8(m);
+        if ( !allow8bit ) {
+            mask |= (unsigned) _mm_movemask_epi8(v);
+        }
+        if ( mask ) {
+            return pos + FirstBit(mask);
+        }
+    }
+#endif
+    for ( ; pos < end; ++pos ) {
+        unsigned char c = *pos;
+        if ( c == (unsigned char) stop1  ||  c == (unsigned char) stop2  ||
+             c < 0x20  ||  (c >= 0x80  &&  !allow8bit) ) {
+            break;
+        }
+    }
+    return pos;
+}
+
 
 CIStreamBuffer::CIStreamBuffer(void)
     THROWS1((bad_alloc))
@@ -229,9 +285,21 @@ char CIStreamBuffer::SkipSpaces(void)
     //     end == m_DataEndPos
     //     pos < end
     for (;;) {
-        // we use do{}while() cycle because
-        // condition is true at the beginning ( pos < end )
-        do {
+#if NCBI_SSE >= 20
+        // check 16 chars at a time (indentation often takes several)
+        const __m128i space = _mm_set1_epi8(' ');
+        for ( ; end - pos >= 16; pos += 16 ) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            unsigned mask =
+                ~(unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, space)) & 0xFFFF;
+            if ( mask ) {
+                pos += FirstBit(mask);
+                m_CurrentPos = pos;
+                return *pos;
+            }
+        }
+#endif
+        for ( ; pos < end; ++pos ) {
             // cache current char
             char c = *pos;
             if ( c != ' ' ) { // it's not space (' ')
@@ -241,7 +309,7 @@ char CIStreamBuffer::SkipSpaces(void)
                 return c;
             }
             // skip space char
-        } while ( ++pos < end );
+        }
         // here pos == end == m_DataEndPos
         // point m_CurrentPos to end of buffer
         m_CurrentPos = pos;
@@ -306,6 +374,28 @@ size_t CIStreamBuffer::PeekFindChar(char c, size_t limit)
 }
 
 
+char CIStreamBuffer::ExtractPlainChars(string* str, char stop1, char stop2,
+                                       bool allow8bit)
+    THROWS1((CIOException))
+{
+    for (;;) {
+        const char* pos = m_CurrentPos;
+        if ( pos >= m_DataEndPos ) {
+            pos = FillBuffer(pos);
+        }
+        const char* end = m_DataEndPos;
+        const char* found = FindSpecialChar(pos, end, stop1, stop2, allow8bit);
+        if ( str ) {
+            str->append(pos, found - pos);
+        }
+        m_CurrentPos = found;
+        if ( found != end ) {
+            return *found;
+        }
+    }
+}
+
+
 bool CIStreamBuffer::TrySetCurrentPos(const char* pos)
 {
     if (m_BufferPos == 0 && pos >= m_Buffer && pos <= m_DataEndPos) {
@@ -1161,6 +1251,24 @@ void COStreamBuffer::Write(const char* data, size_t dataLength)
 }
 
 
+void COStreamBuffer::WriteLines(const char* data, size_t dataLength)
+    THROWS1((CIOException, bad_alloc))
+{
+    const char* end = data + dataLength;
+    const char* lineStart = data;
+    for ( const char* eol = data;
+          (eol = (const char*)memchr(eol, '\n', end - eol)) != 0; ) {
+        ++m_Line;
+        lineStart = ++eol;
+    }
+    if ( lineStart == data )
+        m_LineLength += dataLength;
+    else
+        m_LineLength = end - lineStart;
+    Write(data, dataLength);
+}
+
+
 void COStreamBuffer::Write(CByteSourceReader& reader)
     THROWS1((CIOException, bad_alloc))
 {